@@ -0,0 +1,107 @@
+// Times the tokenizer and parser on a large script and counts the heap
+// allocations each makes, through a counting operator new.
+//
+//   xmake build parse_bench
+//   xmake run parse_bench              (a generated script of 50k lines)
+//   xmake run parse_bench script.nyx   (any other script)
+//
+// The generated script is the same on every run, so counts can be compared
+// between builds.
+
+#include "tokenizer/Tokenizer.h"
+#include "parser/Parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+
+namespace {
+    size_t allocations = 0;
+
+    // Functions of eight lines each, with the statements and expressions
+    // that make up most scripts.
+    std::string generateScript(size_t lines) {
+        std::string source;
+        for (size_t i = 0; i * 8 < lines; ++i) {
+            std::string n = std::to_string(i);
+            source += "func fn" + n + "(a, b, c) = {\n";
+            source += "    auto x" + n + " = a * (b + c) - [1, 2, 3][1] / 4;\n";
+            source += "    if (x" + n + " >= 10 and not (a == b) or c != 3) {\n";
+            source += "        output(\"value #{x" + n + "} from fn" + n + "\");\n";
+            source += "    } else { x" + n + " = x" + n + " % 7; }\n";
+            source += "    for (auto k = 0; k < len(a); k++) { put(k); }\n";
+            source += "    return x" + n + ";\n";
+            source += "}\n";
+        }
+        return source;
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void* operator new(size_t size) {
+    ++allocations;
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+int main(int argc, char** argv) {
+    std::string source;
+    if (argc > 1) {
+        std::ifstream file(argv[1], std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "Could not open '%s'.\n", argv[1]);
+            return 1;
+        }
+        source.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    } else {
+        source = generateScript(50000);
+    }
+    size_t lines = static_cast<size_t>(std::count(source.begin(), source.end(), '\n'));
+
+    // The best of five runs for the times; the counts are the same each run.
+    const int RUNS = 5;
+    double best_tokenize = 0, best_parse = 0;
+    size_t token_count = 0, tokenize_allocations = 0, parse_allocations = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        size_t before = allocations;
+        Nyx::Tokenizer tokenizer(source);
+        std::vector<Nyx::Token> tokens = tokenizer.tokenize();
+        double tokenize_ms = millisecondsSince(start);
+        tokenize_allocations = allocations - before;
+        token_count = tokens.size();
+
+        start = std::chrono::steady_clock::now();
+        before = allocations;
+        Nyx::Parser parser(std::move(tokens));
+        auto program = parser.parse();
+        double parse_ms = millisecondsSince(start);
+        parse_allocations = allocations - before;
+
+        if (run == 0 || tokenize_ms < best_tokenize) best_tokenize = tokenize_ms;
+        if (run == 0 || parse_ms < best_parse) best_parse = parse_ms;
+    }
+
+    std::printf("lines: %zu  tokens: %zu\n", lines, token_count);
+    std::printf("tokenize: %.1f ms, %zu allocations (%.2f per token)\n", best_tokenize, tokenize_allocations,
+                static_cast<double>(tokenize_allocations) / static_cast<double>(token_count));
+    std::printf("parse:    %.1f ms, %zu allocations (%.2f per token)\n", best_parse, parse_allocations,
+                static_cast<double>(parse_allocations) / static_cast<double>(token_count));
+    return 0;
+}
@@ -1,9 +1,16 @@
 #include "./Nyx.h"
 #include "./common/Utils.h"
 #include "./interpreter/Interpreter.h"
+#include "./common/GarbageCollector.h"
+#include "./common/HeapAccounting.h"
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <filesystem>
 
@@ -16,43 +23,104 @@ namespace {
         }
         return false;
     }
+
+    bool loadScript(const std::string& script_path_arg, std::string& canonical_path_out, std::string& source_out) {
+        if (!has_nyx_extension(script_path_arg)) {
+            std::cerr << "Error: Input file must have the .nyx extension. Provided: " << script_path_arg << std::endl;
+            return false;
+        }
+
+        std::filesystem::path script_file_fs_path(script_path_arg);
+
+        try {
+            canonical_path_out = std::filesystem::canonical(std::filesystem::absolute(script_file_fs_path)).string();
+        } catch (const std::filesystem::filesystem_error& e) {
+            std::cerr << "Error: Cannot access script file '" << script_path_arg << "': " << e.what() << std::endl;
+            return false;
+        }
+
+        std::ifstream file(canonical_path_out);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file '" << canonical_path_out << "'" << std::endl;
+            return false;
+        }
+
+        source_out.assign((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    int interpretScript(const std::string& source_code, const std::string& canonical_script_path_str, const std::vector<std::string>& script_args) {
+        int exit_code = 0;
+        Nyx::Interpreter lang_interpreter;
+        try {
+            lang_interpreter.interpret(source_code, canonical_script_path_str, script_args);
+        } catch (const Nyx::Common::NyxException &e) {
+            std::cerr << "Error (Nyx Framework): " << e.what() << std::endl;
+            exit_code = 1;
+        } catch (const std::exception &e) {
+            std::cerr << "Unexpected system error during script execution: " << e.what() << std::endl;
+            exit_code = 1;
+        }
+        return exit_code;
+    }
 }
 
 int runNyxScript(const std::string& script_path_arg, const std::vector<std::string>& script_args) {
-    if (!has_nyx_extension(script_path_arg)) {
-        std::cerr << "Error: Input file must have the .nyx extension. Provided: " << script_path_arg << std::endl;
+    std::string canonical_script_path_str;
+    std::string source_code;
+    if (!loadScript(script_path_arg, canonical_script_path_str, source_code)) {
         return 1;
     }
 
-    std::filesystem::path script_file_fs_path(script_path_arg);
-    std::string canonical_script_path_str;
+    int exit_code = interpretScript(source_code, canonical_script_path_str, script_args);
 
-    try {
-        canonical_script_path_str = std::filesystem::canonical(std::filesystem::absolute(script_file_fs_path)).string();
-    } catch (const std::filesystem::filesystem_error& e) {
-        std::cerr << "Error: Cannot access script file '" << script_path_arg << "': " << e.what() << std::endl;
-        return 1;
+    if (std::getenv("NYX_GC_STATS")) {
+        std::cerr << GarbageCollector::current().report() << std::endl;
     }
+    return exit_code;
+}
 
-    std::ifstream file(canonical_script_path_str);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file '" << canonical_script_path_str << "'" << std::endl;
+int runNyxScriptIsolates(const std::string& script_path_arg, const std::vector<std::string>& script_args, unsigned isolate_count) {
+    std::string canonical_script_path_str;
+    std::string source_code;
+    if (!loadScript(script_path_arg, canonical_script_path_str, source_code)) {
         return 1;
     }
 
-    std::string source_code((std::istreambuf_iterator<char>(file)),
-                             std::istreambuf_iterator<char>());
-    file.close();
-    
-    Nyx::Interpreter lang_interpreter;
-    try {
-        lang_interpreter.interpret(source_code, canonical_script_path_str, script_args);
-    } catch (const Nyx::Common::NyxException &e) {
-        std::cerr << "Error (Nyx Framework): " << e.what() << std::endl;
-        return 1;
-    } catch (const std::exception &e) {
-        std::cerr << "Unexpected system error during script execution: " << e.what() << std::endl;
-        return 1;
+    // Each thread gets its own Interpreter, collector and heap accountant;
+    // the limit from --max-heap applies to each of them separately.
+    size_t heap_limit = HeapAccounting::limit();
+    bool print_gc_stats = std::getenv("NYX_GC_STATS") != nullptr;
+    std::vector<int> exit_codes(isolate_count, 0);
+    std::vector<std::thread> threads;
+    threads.reserve(isolate_count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < isolate_count; ++i) {
+        threads.emplace_back([&, i]() {
+            HeapAccounting::setLimit(heap_limit);
+            exit_codes[i] = interpretScript(source_code, canonical_script_path_str, script_args);
+            if (print_gc_stats) {
+                std::cerr << "isolate " + std::to_string(i) + ": " + GarbageCollector::current().report() + "\n";
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(3)
+            << "isolates: " << isolate_count << " runs in " << seconds << " s ("
+            << (seconds > 0.0 ? isolate_count / seconds : 0.0) << " runs/s)";
+    std::cerr << summary.str() << std::endl;
+
+    for (int code : exit_codes) {
+        if (code != 0) {
+            return code;
+        }
     }
     return 0;
 }
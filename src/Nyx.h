@@ -6,6 +6,9 @@
 
 namespace Nyx {
     int runNyxScript(const std::string& script_path_str, const std::vector<std::string>& script_args);
+    // Runs `isolate_count` copies of the script at once, each on its own thread
+    // with its own Interpreter, and reports the wall time on stderr.
+    int runNyxScriptIsolates(const std::string& script_path_str, const std::vector<std::string>& script_args, unsigned isolate_count);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "./Bytes.h"
+#include "./HeapAccounting.h"
+
+namespace Nyx {
+
+NyxBytes::Storage::Storage(std::string bytes) : content(std::move(bytes)) {
+    HeapAccounting::allocate(HeapKind::ARRAYS, sizeof(Storage) + content.size());
+}
+
+NyxBytes::Storage::~Storage() {
+    HeapAccounting::release(HeapKind::ARRAYS, sizeof(Storage) + content.size());
+}
+
+NyxBytes::NyxBytes(size_t byte_count)
+    : storage(std::make_shared<Storage>(std::string(byte_count, '\0'))), length(byte_count) {}
+
+NyxBytes::NyxBytes(const std::uint8_t* bytes, size_t byte_count)
+    : storage(std::make_shared<Storage>(std::string(reinterpret_cast<const char*>(bytes), byte_count))), length(byte_count) {}
+
+NyxBytes::NyxBytes(std::shared_ptr<Storage> shared_storage, size_t start, size_t byte_count)
+    : storage(std::move(shared_storage)), offset(start), length(byte_count) {}
+
+std::shared_ptr<NyxBytes> NyxBytes::adopt(std::string content) {
+    size_t byte_count = content.size();
+    return std::shared_ptr<NyxBytes>(new NyxBytes(std::make_shared<Storage>(std::move(content)), 0, byte_count));
+}
+
+std::shared_ptr<NyxBytes> NyxBytes::slice(size_t start, size_t end) const {
+    return std::shared_ptr<NyxBytes>(new NyxBytes(storage, offset + start, end - start));
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Nyx {
+
+// A mutable run of raw bytes (see std:bytes). Like numeric arrays, byte
+// buffers are shared by reference. A slice is a window onto the buffer it
+// was taken from rather than a copy, so slicing a large file into records
+// costs nothing, and writing through a slice changes the original.
+class NyxBytes {
+public:
+    // Zero-filled.
+    explicit NyxBytes(size_t length);
+    NyxBytes(const std::uint8_t* data, size_t length);
+
+    NyxBytes(const NyxBytes&) = delete;
+    NyxBytes& operator=(const NyxBytes&) = delete;
+
+    // Takes over `content` without copying it.
+    static std::shared_ptr<NyxBytes> adopt(std::string content);
+
+    size_t size() const { return length; }
+    std::uint8_t* data() { return storage->bytes() + offset; }
+    const std::uint8_t* data() const { return storage->bytes() + offset; }
+    std::uint8_t get(size_t index) const { return data()[index]; }
+    void set(size_t index, std::uint8_t value) { data()[index] = value; }
+
+    // Shares this buffer's bytes [start, end); the caller checks the bounds.
+    std::shared_ptr<NyxBytes> slice(size_t start, size_t end) const;
+    std::string toString() const { return std::string(reinterpret_cast<const char*>(data()), length); }
+
+private:
+    // The bytes themselves, shared by a buffer and its slices. Held as a
+    // string so that files and strings can be adopted without a copy.
+    struct Storage {
+        explicit Storage(std::string content);
+        ~Storage();
+        std::uint8_t* bytes() { return reinterpret_cast<std::uint8_t*>(content.data()); }
+        std::string content;
+    };
+
+    NyxBytes(std::shared_ptr<Storage> storage, size_t offset, size_t length);
+
+    std::shared_ptr<Storage> storage;
+    size_t offset = 0;
+    size_t length = 0;
+};
+
+}
@@ -0,0 +1,218 @@
+#include "./Fiber.h"
+#include "./Utils.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <atomic>
+#include <fstream>
+#include <vector>
+#endif
+
+namespace Nyx {
+
+namespace {
+    thread_local Fiber* current_fiber = nullptr;
+}
+
+#if defined(_WIN32)
+
+struct Fiber::Native {
+    LPVOID handle = nullptr;
+    LPVOID caller = nullptr;
+
+    static VOID CALLBACK entry(LPVOID parameter) {
+        Fiber& fiber = *static_cast<Fiber*>(parameter);
+        fiber.run();
+        SwitchToFiber(fiber.native->caller);
+    }
+};
+
+#else
+
+struct Fiber::Native {
+    ucontext_t context;
+    ucontext_t caller;
+    void* mapping = nullptr;
+    size_t mapping_bytes = 0;
+
+    // makecontext only passes int arguments, so the fiber being started is
+    // found through current_fiber. Returning switches to `caller` (uc_link).
+    static void entry() {
+        current_fiber->run();
+    }
+};
+
+namespace {
+    // The guard page splits each stack into two mappings, and Linux caps the
+    // mappings a process may have (vm.max_map_count, 65530 by default). At
+    // the cap even malloc fails, so stacks stop well short of it.
+    std::atomic<size_t> mapped_stacks{0};
+
+    size_t stackLimit() {
+        static const size_t limit = []() {
+            size_t max_maps = 65530;
+#if defined(__linux__)
+            std::ifstream setting("/proc/sys/vm/max_map_count");
+            setting >> max_maps;
+#endif
+            return max_maps > 16384 ? (max_maps - 8192) / 2 : max_maps / 4;
+        }();
+        return limit;
+    }
+
+    void unmapStack(void* address, size_t bytes) {
+        munmap(address, bytes);
+        mapped_stacks.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    struct StackMapping {
+        void* address;
+        size_t bytes;
+    };
+
+    // Fibers tend to come and go in loops, and a fresh mapping is faulted
+    // in page by page, so each thread keeps a few released stacks to reuse.
+    struct StackPool {
+        static constexpr size_t CAPACITY = 16;
+        std::vector<StackMapping> free_stacks;
+
+        ~StackPool() {
+            for (const StackMapping& stack : free_stacks) unmapStack(stack.address, stack.bytes);
+        }
+
+        void* take(size_t bytes) {
+            for (size_t i = free_stacks.size(); i-- > 0;) {
+                if (free_stacks[i].bytes == bytes) {
+                    void* address = free_stacks[i].address;
+                    free_stacks.erase(free_stacks.begin() + static_cast<std::ptrdiff_t>(i));
+                    return address;
+                }
+            }
+            return nullptr;
+        }
+
+        void give(void* address, size_t bytes) {
+            if (free_stacks.size() < CAPACITY) {
+                free_stacks.push_back({address, bytes});
+            } else {
+                unmapStack(address, bytes);
+            }
+        }
+    };
+
+    thread_local StackPool stack_pool;
+}
+
+#endif
+
+Fiber::Fiber(std::function<void()> fiber_body, size_t stack_size)
+    : body(std::move(fiber_body)), stack_bytes(stack_size), native(std::make_unique<Native>()) {
+#if defined(_WIN32)
+    // CreateFiber would commit the whole stack; this only reserves it.
+    native->handle = CreateFiberEx(64 * 1024, stack_size, 0, &Native::entry, this);
+    if (!native->handle) {
+        throw Common::NyxRuntimeException("Could not allocate a fiber stack.", 0);
+    }
+#else
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    stack_size = (stack_size + page - 1) / page * page;
+    stack_bytes = stack_size;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+#endif
+    void* mapping = stack_pool.take(stack_size + page);
+    if (!mapping) {
+        if (mapped_stacks.fetch_add(1, std::memory_order_relaxed) >= stackLimit()) {
+            mapped_stacks.fetch_sub(1, std::memory_order_relaxed);
+            throw Common::NyxRuntimeException("Could not allocate a fiber stack: " + std::to_string(stackLimit()) +
+                                              " generators and green threads are already running.", 0);
+        }
+        // The lowest page stays inaccessible, so an overflow faults instead
+        // of overwriting other memory.
+        mapping = mmap(nullptr, stack_size + page, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (mapping == MAP_FAILED) {
+            mapped_stacks.fetch_sub(1, std::memory_order_relaxed);
+            throw Common::NyxRuntimeException("Could not allocate a fiber stack.", 0);
+        }
+        mprotect(mapping, page, PROT_NONE);
+    }
+    native->mapping = mapping;
+    native->mapping_bytes = stack_size + page;
+
+    getcontext(&native->context);
+    native->context.uc_stack.ss_sp = static_cast<char*>(mapping) + page;
+    native->context.uc_stack.ss_size = stack_size;
+    native->context.uc_link = &native->caller;
+    makecontext(&native->context, &Native::entry, 0);
+#endif
+}
+
+Fiber::~Fiber() {
+#if defined(_WIN32)
+    if (native->handle) DeleteFiber(native->handle);
+#else
+    if (native->mapping) stack_pool.give(native->mapping, native->mapping_bytes);
+#endif
+}
+
+void Fiber::run() {
+    // Stacks grow down from here, give or take the few frames that led here.
+    char marker;
+    stack_floor = reinterpret_cast<std::uintptr_t>(&marker) - stack_bytes;
+    try {
+        body();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    state = State::FINISHED;
+}
+
+void Fiber::resume() {
+    Fiber* resumer = current_fiber;
+    current_fiber = this;
+    state = State::RUNNING;
+#if defined(_WIN32)
+    if (!IsThreadAFiber()) {
+        ConvertThreadToFiber(nullptr);
+    }
+    native->caller = GetCurrentFiber();
+    SwitchToFiber(native->handle);
+#else
+    swapcontext(&native->caller, &native->context);
+#endif
+    current_fiber = resumer;
+    if (error) {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+Fiber* Fiber::current() {
+    return current_fiber;
+}
+
+bool Fiber::stackNearlyFull() {
+    Fiber* fiber = current_fiber;
+    if (!fiber) return false;
+    char marker;
+    std::uintptr_t here = reinterpret_cast<std::uintptr_t>(&marker);
+    return here < fiber->stack_floor + STACK_RESERVE;
+}
+
+void Fiber::suspend() {
+    Fiber* fiber = current_fiber;
+    fiber->state = State::SUSPENDED;
+#if defined(_WIN32)
+    SwitchToFiber(fiber->native->caller);
+#else
+    swapcontext(&fiber->native->context, &fiber->native->caller);
+#endif
+}
+
+}
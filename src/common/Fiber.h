@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+
+namespace Nyx {
+
+// Runs a function on a stack of its own, so that it can stop part way with
+// suspend() and carry on from there when it is next resumed. Fibers are
+// cooperative and stay on the thread that created them. The stack is
+// reserved up front but only the pages it touches take memory, so it is as
+// large as a main thread's stack on 64-bit systems.
+//
+// Destroying a suspended fiber frees its stack without unwinding it, so
+// owners make the body return first.
+class Fiber {
+public:
+    static constexpr size_t DEFAULT_STACK_SIZE = sizeof(void*) >= 8 ? 8 * 1024 * 1024 : 1024 * 1024;
+    // What stackNearlyFull() leaves for the frames between two checks.
+    static constexpr size_t STACK_RESERVE = 256 * 1024;
+
+    // Throws NyxRuntimeException if the stack cannot be allocated.
+    explicit Fiber(std::function<void()> body, size_t stack_size = DEFAULT_STACK_SIZE);
+    ~Fiber();
+    Fiber(const Fiber&) = delete;
+    Fiber& operator=(const Fiber&) = delete;
+
+    // Runs the body until it suspends or returns, rethrowing whatever it
+    // threw. Must not be called on a finished or running fiber.
+    void resume();
+    bool finished() const { return state == State::FINISHED; }
+
+    // The fiber running on this thread, or null outside any fiber.
+    static Fiber* current();
+    // Returns from the current fiber's resume(); the body continues from
+    // here when it is resumed again.
+    static void suspend();
+    // True when the current fiber has less than STACK_RESERVE of its stack
+    // left; always false outside any fiber.
+    static bool stackNearlyFull();
+
+private:
+    enum class State { READY, RUNNING, SUSPENDED, FINISHED };
+    struct Native;
+
+    void run();
+
+    std::function<void()> body;
+    size_t stack_bytes;
+    std::uintptr_t stack_floor = 0;
+    State state = State::READY;
+    std::exception_ptr error;
+    std::unique_ptr<Native> native;
+};
+
+}
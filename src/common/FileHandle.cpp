@@ -0,0 +1,295 @@
+#include "./FileHandle.h"
+#include "./Utils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Nyx {
+
+NyxFile::NyxFile(std::string path, Mode mode) : file_path(std::move(path)), open_mode(mode) {}
+
+std::shared_ptr<NyxFile> NyxFile::openForReading(const std::string& path) {
+    std::shared_ptr<NyxFile> handle(new NyxFile(path, Mode::READ));
+    handle->file = std::fopen(path.c_str(), "rb");
+    if (!handle->file) {
+        throw Common::NyxRuntimeException("Could not open file '" + path + "' for reading.", 0);
+    }
+#if !defined(_WIN32)
+    // A mapped file is read straight out of the page cache, with no copy
+    // into a buffer first. Small files are cheaper to read than to map.
+    struct stat info;
+    int fd = fileno(handle->file);
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && static_cast<size_t>(info.st_size) >= MAP_THRESHOLD) {
+        size_t size = static_cast<size_t>(info.st_size);
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            handle->mapping = static_cast<char*>(mapped);
+            handle->mapping_size = size;
+            std::fclose(handle->file);
+            handle->file = nullptr;
+            return handle;
+        }
+    }
+#endif
+    // The handle buffers reads itself, so the stream does not need to.
+    std::setvbuf(handle->file, nullptr, _IONBF, 0);
+    handle->buffer.resize(READ_BUFFER_SIZE);
+    return handle;
+}
+
+std::shared_ptr<NyxFile> NyxFile::openForWriting(const std::string& path, Mode mode, size_t buffer_size) {
+    std::shared_ptr<NyxFile> handle(new NyxFile(path, mode));
+    handle->file = std::fopen(path.c_str(), mode == Mode::APPEND ? "ab" : "wb");
+    if (!handle->file) {
+        throw Common::NyxRuntimeException("Could not open file '" + path + "' for " +
+                                          (mode == Mode::APPEND ? "appending." : "writing."), 0);
+    }
+    std::setvbuf(handle->file, nullptr, _IONBF, 0);
+    handle->buffer.resize(buffer_size);
+    return handle;
+}
+
+NyxFile::~NyxFile() {
+    // A failed final flush has nowhere to be reported from here.
+    try {
+        close();
+    } catch (const Common::NyxRuntimeException&) {
+    }
+}
+
+void NyxFile::close() {
+    if (file) {
+        std::FILE* closing = file;
+        bool flushed = true;
+        if (open_mode != Mode::READ && buffer_end > 0) {
+            flushed = std::fwrite(buffer.data(), 1, buffer_end, closing) == buffer_end;
+            buffer_end = 0;
+        }
+        file = nullptr;
+        buffer.clear();
+        buffer.shrink_to_fit();
+        if (std::fclose(closing) != 0 || !flushed) {
+            throw Common::NyxRuntimeException("Could not write to file '" + file_path + "'.", 0);
+        }
+    }
+#if !defined(_WIN32)
+    if (mapping) {
+        munmap(mapping, mapping_size);
+        mapping = nullptr;
+    }
+#endif
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+std::string NyxFile::describe() const {
+    return std::string(isOpen() ? "<file " : "<closed file ") + file_path + ">";
+}
+
+void NyxFile::expectOpen() const {
+    if (!isOpen()) {
+        throw Common::NyxRuntimeException("File '" + file_path + "' is closed.", 0);
+    }
+}
+
+void NyxFile::expectMode(bool writing) const {
+    expectOpen();
+    if ((open_mode != Mode::READ) != writing) {
+        throw Common::NyxRuntimeException("File '" + file_path + "' was not opened for " + (writing ? "writing." : "reading."), 0);
+    }
+}
+
+const char* NyxFile::unread() const {
+    return mapping ? mapping + mapping_position : buffer.data() + buffer_start;
+}
+
+size_t NyxFile::unreadSize() const {
+    return mapping ? mapping_size - mapping_position : buffer_end - buffer_start;
+}
+
+void NyxFile::consume(size_t bytes) {
+    if (mapping) {
+        mapping_position += bytes;
+#if !defined(_WIN32)
+        // Otherwise a file read to the end stays resident as a whole.
+        size_t read_through = mapping_position / MAP_RELEASE_STEP * MAP_RELEASE_STEP;
+        if (read_through > mapping_released) {
+            madvise(mapping + mapping_released, read_through - mapping_released, MADV_DONTNEED);
+            mapping_released = read_through;
+        }
+#endif
+    } else {
+        buffer_start += bytes;
+    }
+}
+
+bool NyxFile::refill() {
+    if (mapping || at_end) return false;
+    size_t kept = buffer_end - buffer_start;
+    if (buffer_start > 0) {
+        std::memmove(buffer.data(), buffer.data() + buffer_start, kept);
+        buffer_start = 0;
+        buffer_end = kept;
+    }
+    if (buffer_end == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+    size_t count = std::fread(buffer.data() + buffer_end, 1, buffer.size() - buffer_end, file);
+    if (count == 0) {
+        at_end = true;
+        return false;
+    }
+    buffer_end += count;
+    return true;
+}
+
+bool NyxFile::readLine(std::string& line) {
+    expectMode(false);
+    // Bytes already searched are not searched again after a refill.
+    size_t searched = 0;
+    for (;;) {
+        const char* start = unread();
+        size_t available = unreadSize();
+        const void* newline = available > searched ? std::memchr(start + searched, '\n', available - searched) : nullptr;
+        if (newline) {
+            size_t length = static_cast<size_t>(static_cast<const char*>(newline) - start);
+            size_t stored = length > 0 && start[length - 1] == '\r' ? length - 1 : length;
+            line.assign(start, stored);
+            consume(length + 1);
+            return true;
+        }
+        searched = available;
+        if (!refill()) {
+            start = unread();
+            available = unreadSize();
+            if (available == 0) return false;
+            size_t stored = start[available - 1] == '\r' ? available - 1 : available;
+            line.assign(start, stored);
+            consume(available);
+            return true;
+        }
+    }
+}
+
+bool NyxFile::readChunk(size_t max_bytes, std::string& chunk) {
+    expectMode(false);
+    if (mapping) {
+        size_t count = std::min(max_bytes, unreadSize());
+        if (count == 0) return false;
+        chunk.assign(unread(), count);
+        consume(count);
+        return true;
+    }
+    // Buffered bytes first, then large reads go straight into the result.
+    size_t buffered = std::min(max_bytes, unreadSize());
+    chunk.assign(unread(), buffered);
+    consume(buffered);
+    if (buffered < max_bytes && !at_end) {
+        size_t wanted = max_bytes - buffered;
+        if (wanted >= buffer.size()) {
+            chunk.resize(max_bytes);
+            size_t count = std::fread(chunk.data() + buffered, 1, wanted, file);
+            if (count < wanted) at_end = true;
+            chunk.resize(buffered + count);
+        } else if (refill()) {
+            size_t count = std::min(wanted, unreadSize());
+            chunk.append(unread(), count);
+            consume(count);
+        }
+    }
+    return !chunk.empty();
+}
+
+size_t NyxFile::peek(size_t max_bytes, const char*& data) {
+    expectMode(false);
+    if (unreadSize() == 0) refill();
+    data = unread();
+    return std::min(max_bytes, unreadSize());
+}
+
+void NyxFile::skip(size_t bytes) {
+    consume(std::min(bytes, unreadSize()));
+}
+
+void NyxFile::writeOut(const char* data, size_t size) {
+    if (size > 0 && std::fwrite(data, 1, size, file) != size) {
+        throw Common::NyxRuntimeException("Could not write to file '" + file_path + "'.", 0);
+    }
+}
+
+void NyxFile::write(const char* data, size_t size) {
+    expectMode(true);
+    if (buffer_end + size <= buffer.size()) {
+        std::memcpy(buffer.data() + buffer_end, data, size);
+        buffer_end += size;
+        return;
+    }
+    flush();
+    // What would not fit in an empty buffer skips it.
+    if (size >= buffer.size()) {
+        writeOut(data, size);
+    } else {
+        std::memcpy(buffer.data(), data, size);
+        buffer_end = size;
+    }
+}
+
+void NyxFile::flush() {
+    expectMode(true);
+    size_t pending = buffer_end;
+    buffer_end = 0;
+    writeOut(buffer.data(), pending);
+}
+
+void NyxFile::sync() {
+    flush();
+#if defined(_WIN32)
+    int synced = _commit(_fileno(file));
+#else
+    int synced = fsync(fileno(file));
+#endif
+    if (synced != 0) {
+        throw Common::NyxRuntimeException("Could not sync file '" + file_path + "' to storage.", 0);
+    }
+}
+
+std::string readWholeFile(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw Common::NyxRuntimeException("Could not open file '" + path + "' for reading.", 0);
+    }
+    std::string content;
+    std::error_code size_error;
+    auto file_size = std::filesystem::file_size(path, size_error);
+    size_t length = 0;
+    if (!size_error && file_size > 0) {
+        content.resize(static_cast<size_t>(file_size));
+        length = std::fread(content.data(), 1, content.size(), file);
+    }
+    // Files that report no size (pipes, /proc) or that grew since are read
+    // to the end in blocks.
+    if (length == content.size()) {
+        char block[65536];
+        size_t count;
+        while ((count = std::fread(block, 1, sizeof(block), file)) > 0) {
+            content.resize(length);
+            content.append(block, count);
+            length += count;
+        }
+    }
+    std::fclose(file);
+    content.resize(length);
+    return content;
+}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Nyx {
+
+// An open file, as returned by io.open. Reads go through a buffer of the
+// handle's own, so a line or chunk costs one copy into the string returned
+// rather than a stream call per character. Large files opened for reading
+// are mapped into memory instead where the platform allows it. Writes
+// collect in a buffer too and reach the file when it fills, on flush() or
+// on close(). Handles are shared by reference and close themselves when
+// released.
+class NyxFile {
+public:
+    enum class Mode { READ, WRITE, APPEND };
+
+    static constexpr size_t READ_BUFFER_SIZE = 64 * 1024;
+    static constexpr size_t DEFAULT_WRITE_BUFFER_SIZE = 64 * 1024;
+    // Files opened for reading at least this large are mapped.
+    static constexpr size_t MAP_THRESHOLD = 1024 * 1024;
+    // Mapped pages behind the read position are let go in steps this size.
+    static constexpr size_t MAP_RELEASE_STEP = 16 * 1024 * 1024;
+
+    // Throws NyxRuntimeException if the file cannot be opened.
+    static std::shared_ptr<NyxFile> openForReading(const std::string& path);
+    // WRITE truncates the file, APPEND adds to its end; either creates it.
+    // With a `buffer_size` of 0 every write goes straight to the file.
+    static std::shared_ptr<NyxFile> openForWriting(const std::string& path, Mode mode, size_t buffer_size);
+    ~NyxFile();
+    NyxFile(const NyxFile&) = delete;
+    NyxFile& operator=(const NyxFile&) = delete;
+
+    // Stores the next line in `line`, without its "\n" or "\r\n", and returns
+    // true; returns false at the end of the file. A last line with no newline
+    // still counts.
+    bool readLine(std::string& line);
+    // Stores up to `max_bytes` bytes in `chunk` and returns true; returns
+    // false at the end of the file.
+    bool readChunk(size_t max_bytes, std::string& chunk);
+    // Points `data` at up to `max_bytes` of the next unread bytes without
+    // copying them (straight into the mapping, if mapped) and returns how
+    // many there are, 0 at the end of the file. They stay valid until the
+    // next read or close; skip() moves past them.
+    size_t peek(size_t max_bytes, const char*& data);
+    // Moves past `bytes` bytes returned by peek().
+    void skip(size_t bytes);
+
+    void write(const char* data, size_t size);
+    // Hands buffered writes to the operating system.
+    void flush();
+    // Flushes, then waits until the operating system has stored the file.
+    void sync();
+    // Flushes first if writing. Throws NyxRuntimeException if that fails,
+    // but the file is closed either way.
+    void close();
+
+    bool isOpen() const { return file != nullptr || mapping != nullptr; }
+    bool isMapped() const { return mapping != nullptr; }
+    Mode mode() const { return open_mode; }
+    const std::string& path() const { return file_path; }
+    std::string describe() const;
+
+private:
+    NyxFile(std::string path, Mode mode);
+
+    void expectOpen() const;
+    void expectMode(bool writing) const;
+    void writeOut(const char* data, size_t size);
+    // Moves unread bytes to the front of the buffer and reads more after
+    // them. Returns false if nothing more could be read.
+    bool refill();
+    const char* unread() const;
+    size_t unreadSize() const;
+    void consume(size_t bytes);
+
+    std::string file_path;
+    Mode open_mode;
+    std::FILE* file = nullptr;
+    // Reading: bytes [buffer_start, buffer_end) are read but not consumed.
+    // Writing: bytes [0, buffer_end) are written but not flushed.
+    std::vector<char> buffer;
+    size_t buffer_start = 0;
+    size_t buffer_end = 0;
+    bool at_end = false;
+
+    // When mapped, `mapping` holds the whole file and there is no buffer.
+    char* mapping = nullptr;
+    size_t mapping_size = 0;
+    size_t mapping_position = 0;
+    size_t mapping_released = 0;
+};
+
+// Reads a whole file with one sized read rather than through a stream.
+// Throws NyxRuntimeException if it cannot be opened.
+std::string readWholeFile(const std::string& path);
+
+}
@@ -0,0 +1,272 @@
+#include "./GarbageCollector.h"
+#include "./HeapAccounting.h"
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace Nyx {
+
+namespace {
+    constexpr unsigned char STATE_TRACKED = 0;
+    constexpr unsigned char STATE_COLLECTING = 1;
+    constexpr unsigned char STATE_REACHABLE = 2;
+    constexpr unsigned char STATE_UNREACHABLE = 3;
+
+    void unlink(GcNode* node) {
+        node->gc_prev->gc_next = node->gc_next;
+        node->gc_next->gc_prev = node->gc_prev;
+        node->gc_prev = nullptr;
+        node->gc_next = nullptr;
+    }
+
+    void append(GcNode& list, GcNode* node) {
+        node->gc_prev = list.gc_prev;
+        node->gc_next = &list;
+        list.gc_prev->gc_next = node;
+        list.gc_prev = node;
+    }
+
+    void splice(GcNode& from, GcNode& to) {
+        if (from.gc_next == &from) return;
+        from.gc_next->gc_prev = to.gc_prev;
+        to.gc_prev->gc_next = from.gc_next;
+        from.gc_prev->gc_next = &to;
+        to.gc_prev = from.gc_prev;
+        from.gc_prev = &from;
+        from.gc_next = &from;
+    }
+}
+
+class GarbageCollector::SubtractInternalReferences : public GcVisitor {
+public:
+    void visit(const GcObject* object) override {
+        GcObject* target = const_cast<GcObject*>(object);
+        if (target && target->gc_state == STATE_COLLECTING) {
+            --target->gc_refs;
+        }
+    }
+};
+
+class GarbageCollector::MarkReachable : public GcVisitor {
+public:
+    explicit MarkReachable(std::vector<GcObject*>& pending) : pending(pending) {}
+
+    void visit(const GcObject* object) override {
+        GcObject* target = const_cast<GcObject*>(object);
+        if (target && target->gc_state == STATE_COLLECTING) {
+            target->gc_state = STATE_REACHABLE;
+            pending.push_back(target);
+        }
+    }
+
+private:
+    std::vector<GcObject*>& pending;
+};
+
+GcObject::GcObject() : gc_owner(&GarbageCollector::current()) {
+    gc_owner->track(this);
+}
+
+GcObject::GcObject(const GcObject&)
+    : GcNode(), std::enable_shared_from_this<GcObject>(), gc_owner(&GarbageCollector::current()) {
+    gc_owner->track(this);
+}
+
+GcObject::~GcObject() {
+    if (gc_owner) {
+        gc_owner->untrack(this);
+    }
+}
+
+GarbageCollector& GarbageCollector::current() {
+    thread_local GarbageCollector collector;
+    return collector;
+}
+
+GarbageCollector::GarbageCollector() {
+    for (GcNode& head : generations) {
+        head.gc_prev = &head;
+        head.gc_next = &head;
+    }
+}
+
+GarbageCollector::~GarbageCollector() {
+    // The thread is exiting while objects it created are still alive (held by
+    // another thread, or leaked). They are reference counted as usual from now
+    // on; only cycle detection is lost.
+    for (GcNode& head : generations) {
+        while (head.gc_next != &head) {
+            GcObject* object = static_cast<GcObject*>(head.gc_next);
+            unlink(object);
+            object->gc_owner = nullptr;
+        }
+    }
+}
+
+void GarbageCollector::track(GcObject* object) {
+    object->gc_generation = 0;
+    object->gc_state = STATE_TRACKED;
+    append(generations[0], object);
+    ++generation_sizes[0];
+}
+
+void GarbageCollector::untrack(GcObject* object) {
+    if (!object->gc_next) return;
+    unlink(object);
+    if (object->gc_state != STATE_UNREACHABLE) {
+        --generation_sizes[object->gc_generation];
+    }
+}
+
+void GarbageCollector::collectScheduled() {
+    int generation = 0;
+    for (int g = GENERATIONS - 1; g > 0; --g) {
+        if (younger_collections[g] >= thresholds[g]) {
+            generation = g;
+            break;
+        }
+    }
+    collect(generation);
+}
+
+size_t GarbageCollector::collect(int generation) {
+    if (collecting) return 0;
+    if (generation < 0) generation = 0;
+    if (generation >= GENERATIONS) generation = GENERATIONS - 1;
+
+    auto start = std::chrono::steady_clock::now();
+    collecting = true;
+
+    GcNode& young = generations[generation];
+    for (int g = 0; g < generation; ++g) {
+        splice(generations[g], young);
+        generation_sizes[generation] += generation_sizes[g];
+        generation_sizes[g] = 0;
+    }
+
+    // Start from each object's strong count. An object not owned by a
+    // shared_ptr cannot be referenced by others, so it counts as a root.
+    for (GcNode* node = young.gc_next; node != &young; node = node->gc_next) {
+        GcObject* object = static_cast<GcObject*>(node);
+        long strong_count = object->weak_from_this().use_count();
+        object->gc_refs = strong_count > 0 ? strong_count : 1;
+        object->gc_state = STATE_COLLECTING;
+    }
+
+    // Remove the references held by objects in this set; whatever is left
+    // comes from outside it.
+    SubtractInternalReferences subtract;
+    for (GcNode* node = young.gc_next; node != &young; node = node->gc_next) {
+        static_cast<GcObject*>(node)->gcTraverse(subtract);
+    }
+
+    std::vector<GcObject*> pending;
+    for (GcNode* node = young.gc_next; node != &young; node = node->gc_next) {
+        GcObject* object = static_cast<GcObject*>(node);
+        if (object->gc_refs > 0) {
+            object->gc_state = STATE_REACHABLE;
+            pending.push_back(object);
+        }
+    }
+    MarkReachable mark(pending);
+    while (!pending.empty()) {
+        GcObject* object = pending.back();
+        pending.pop_back();
+        object->gcTraverse(mark);
+    }
+
+    // Survivors move up a generation. The rest are kept alive by the
+    // `garbage` handles while their references are cleared, so nothing is
+    // destroyed until every cycle has been broken.
+    int target = generation + 1 < GENERATIONS ? generation + 1 : generation;
+    GcNode survivors;
+    survivors.gc_prev = &survivors;
+    survivors.gc_next = &survivors;
+    GcNode unreachable;
+    unreachable.gc_prev = &unreachable;
+    unreachable.gc_next = &unreachable;
+    std::vector<std::shared_ptr<GcObject>> garbage;
+    size_t survivor_count = 0;
+
+    while (young.gc_next != &young) {
+        GcObject* object = static_cast<GcObject*>(young.gc_next);
+        unlink(object);
+        if (object->gc_state == STATE_REACHABLE) {
+            object->gc_state = STATE_TRACKED;
+            object->gc_generation = static_cast<unsigned char>(target);
+            append(survivors, object);
+            ++survivor_count;
+        } else {
+            object->gc_state = STATE_UNREACHABLE;
+            append(unreachable, object);
+            garbage.push_back(object->shared_from_this());
+        }
+    }
+    generation_sizes[generation] = 0;
+    generation_sizes[target] += survivor_count;
+    splice(survivors, generations[target]);
+
+    for (const auto& object : garbage) {
+        object->gcClear();
+    }
+    size_t freed = garbage.size();
+    garbage.clear();
+
+    // Only possible if a gcTraverse override missed a reference it holds.
+    while (unreachable.gc_next != &unreachable) {
+        GcObject* object = static_cast<GcObject*>(unreachable.gc_next);
+        unlink(object);
+        object->gc_state = STATE_TRACKED;
+        object->gc_generation = static_cast<unsigned char>(target);
+        append(generations[target], object);
+        ++generation_sizes[target];
+        --freed;
+    }
+
+    ++collections[generation];
+    if (generation + 1 < GENERATIONS) {
+        ++younger_collections[generation + 1];
+    }
+    for (int g = 1; g <= generation; ++g) {
+        younger_collections[g] = 0;
+    }
+    objects_freed += freed;
+    collecting = false;
+
+    last_pause_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    total_pause_ms += last_pause_ms;
+    if (last_pause_ms > max_pause_ms) {
+        max_pause_ms = last_pause_ms;
+    }
+    return freed;
+}
+
+GcStats GarbageCollector::stats() const {
+    GcStats result;
+    for (int g = 0; g < GENERATIONS; ++g) {
+        result.generation_sizes[g] = generation_sizes[g];
+        result.tracked_objects += generation_sizes[g];
+        result.collections[g] = collections[g];
+    }
+    result.objects_freed = objects_freed;
+    result.last_pause_ms = last_pause_ms;
+    result.max_pause_ms = max_pause_ms;
+    result.total_pause_ms = total_pause_ms;
+    return result;
+}
+
+std::string GarbageCollector::report() const {
+    GcStats current_stats = stats();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "gc: " << current_stats.tracked_objects << " objects tracked ("
+        << current_stats.generation_sizes[0] << "/" << current_stats.generation_sizes[1] << "/" << current_stats.generation_sizes[2] << " by generation), "
+        << current_stats.collections[0] << "/" << current_stats.collections[1] << "/" << current_stats.collections[2] << " collections, "
+        << current_stats.objects_freed << " objects freed, pauses: "
+        << current_stats.total_pause_ms << " ms total, " << current_stats.max_pause_ms << " ms max; heap "
+        << HeapAccounting::formatBytes(HeapAccounting::liveBytes()) << " (" << HeapAccounting::breakdown() << ")";
+    return out.str();
+}
+
+}
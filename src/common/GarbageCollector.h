@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace Nyx {
+
+class GcObject;
+class GarbageCollector;
+
+// Receives each tracked object that a GcObject holds a strong reference to.
+class GcVisitor {
+public:
+    virtual ~GcVisitor() = default;
+    virtual void visit(const GcObject* object) = 0;
+};
+
+struct GcNode {
+    GcNode* gc_prev = nullptr;
+    GcNode* gc_next = nullptr;
+};
+
+// Base for runtime objects that can end up in reference cycles: environments,
+// closures, modules, struct instances and maps. They stay owned by shared_ptr and
+// are freed by reference counting as before; the collector only looks for
+// groups that are kept alive by nothing but each other, and breaks them with
+// gcClear().
+class GcObject : public GcNode, public std::enable_shared_from_this<GcObject> {
+public:
+    GcObject();
+    GcObject(const GcObject& other);
+    GcObject& operator=(const GcObject&) { return *this; }
+    virtual ~GcObject();
+
+    // Must report every GcObject held through a shared_ptr, once per reference.
+    virtual void gcTraverse(GcVisitor& visitor) const = 0;
+    // Drops every reference gcTraverse reports.
+    virtual void gcClear() = 0;
+
+private:
+    friend class GarbageCollector;
+
+    GarbageCollector* gc_owner; // collector of the thread that created the object
+    long gc_refs = 0;
+    unsigned char gc_generation = 0;
+    unsigned char gc_state = 0;
+};
+
+struct GcStats {
+    size_t tracked_objects = 0;
+    size_t generation_sizes[3] = {0, 0, 0};
+    size_t collections[3] = {0, 0, 0};
+    size_t objects_freed = 0;
+    double last_pause_ms = 0.0;
+    double max_pause_ms = 0.0;
+    double total_pause_ms = 0.0;
+};
+
+// Generational cycle collector over the shared_ptr heap. Roots are never
+// enumerated: an object's strong count minus the references other tracked
+// objects hold to it tells whether anything outside the heap (the C++ stack,
+// module caches, the interpreter) still points at it. New objects start in
+// generation 0; survivors move up, and older generations are scanned less
+// often, so a pause only covers the objects created since the last one.
+//
+// There is one collector per thread, and objects are tracked by the collector
+// of the thread that created them. Separate interpreters running on separate
+// threads therefore never touch each other's lists. An object must not be
+// mutated or destroyed on another thread while its own thread is running.
+class GarbageCollector {
+public:
+    static constexpr int GENERATIONS = 3;
+
+    // The calling thread's collector.
+    static GarbageCollector& current();
+    ~GarbageCollector();
+
+    // Called at statement boundaries, where every live object is owned by a
+    // shared_ptr somewhere.
+    void collectIfNeeded() {
+        if (generation_sizes[0] >= thresholds[0] && !collecting) {
+            collectScheduled();
+        }
+    }
+
+    // Collects `generation` and every younger one; returns the number of
+    // objects freed.
+    size_t collect(int generation = GENERATIONS - 1);
+
+    GcStats stats() const;
+    std::string report() const;
+
+private:
+    friend class GcObject;
+    class SubtractInternalReferences;
+    class MarkReachable;
+
+    GarbageCollector();
+
+    void track(GcObject* object);
+    void untrack(GcObject* object);
+    void collectScheduled();
+
+    GcNode generations[GENERATIONS];
+    size_t generation_sizes[GENERATIONS] = {0, 0, 0};
+    size_t thresholds[GENERATIONS] = {700, 10, 10};
+    size_t younger_collections[GENERATIONS] = {0, 0, 0};
+    bool collecting = false;
+
+    size_t collections[GENERATIONS] = {0, 0, 0};
+    size_t objects_freed = 0;
+    double last_pause_ms = 0.0;
+    double max_pause_ms = 0.0;
+    double total_pause_ms = 0.0;
+};
+
+}
@@ -0,0 +1,273 @@
+#include "./HashTable.h"
+#include "./HeapAccounting.h"
+#include "./Utils.h"
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+namespace Nyx {
+
+namespace {
+    // splitmix64's finalizer: every input bit affects every output bit, so
+    // both the slot index (low bits) and the tag (high bits) are well spread.
+    std::uint64_t mixBits(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    constexpr std::uint64_t BOOLEAN_SEED = 0x6a09e667f3bcc908ULL;
+    constexpr std::uint64_t NUMBER_SEED = 0xbb67ae8584caa73bULL;
+    constexpr std::uint64_t STRING_SEED = 0x3c6ef372fe94f82bULL;
+    constexpr std::uint64_t LIST_SEED = 0xa54ff53a5f1d36f1ULL;
+
+    const std::string* keyText(const NyxValue& key) {
+        if (const auto* text = std::get_if<std::string>(&key.data)) return text;
+        if (const auto* frozen = std::get_if<FrozenValuePtr>(&key.data)) {
+            if (*frozen && (*frozen)->kind == NyxFrozenValue::Kind::STRING) return &(*frozen)->text;
+        }
+        return nullptr;
+    }
+
+    const NyxList* keyElements(const NyxValue& key) {
+        if (const auto* list = std::get_if<NyxList>(&key.data)) return list;
+        if (const auto* frozen = std::get_if<FrozenValuePtr>(&key.data)) {
+            if (*frozen && (*frozen)->kind == NyxFrozenValue::Kind::LIST) return &(*frozen)->elements;
+        }
+        return nullptr;
+    }
+
+    size_t slotCountFor(size_t entries) {
+        // Leaves the table at most 2/3 full after a rebuild.
+        size_t slot_count = 8;
+        while (slot_count * 2 < entries * 3) {
+            slot_count *= 2;
+        }
+        return slot_count;
+    }
+}
+
+std::uint64_t hashKey(const NyxValue& key, int line) {
+    const auto& data = key.data;
+    if (const bool* flag = std::get_if<bool>(&data)) {
+        return mixBits(BOOLEAN_SEED + (*flag ? 1 : 0));
+    }
+    if (const double* number = std::get_if<double>(&data)) {
+        if (std::isnan(*number)) {
+            throw Common::NyxRuntimeException("NaN cannot be used as a map key or set element.", line);
+        }
+        double normalized = *number == 0.0 ? 0.0 : *number; // -0 == 0
+        std::uint64_t bits;
+        std::memcpy(&bits, &normalized, sizeof(bits));
+        return mixBits(bits ^ NUMBER_SEED);
+    }
+    if (const std::string* text = keyText(key)) {
+        return mixBits(std::hash<std::string_view>()(std::string_view(*text)) ^ STRING_SEED);
+    }
+    if (const NyxList* elements = keyElements(key)) {
+        std::uint64_t hash = LIST_SEED ^ elements->size();
+        for (const NyxValue& element : *elements) {
+            hash = mixBits(hash + hashKey(element, line));
+        }
+        return hash;
+    }
+    throw Common::NyxRuntimeException("Values of type " + nyxValueTypeToString(key) +
+                                      " cannot be used as map keys or set elements (use numbers, booleans, strings or lists of them).", line);
+}
+
+bool keysEqual(const NyxValue& a, const NyxValue& b) {
+    if (const double* number = std::get_if<double>(&a.data)) {
+        const double* other = std::get_if<double>(&b.data);
+        return other && *number == *other;
+    }
+    if (const bool* flag = std::get_if<bool>(&a.data)) {
+        const bool* other = std::get_if<bool>(&b.data);
+        return other && *flag == *other;
+    }
+    if (const std::string* text = keyText(a)) {
+        const std::string* other = keyText(b);
+        return other && *text == *other;
+    }
+    if (const NyxList* elements = keyElements(a)) {
+        const NyxList* other = keyElements(b);
+        if (!other || elements->size() != other->size()) return false;
+        for (size_t i = 0; i < elements->size(); ++i) {
+            if (!keysEqual((*elements)[i], (*other)[i])) return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+NyxHashTable::NyxHashTable(bool with_values) : with_values(with_values) {
+    updateAccounting();
+}
+
+NyxHashTable::NyxHashTable(const NyxHashTable& other)
+    : with_values(other.with_values), slots(other.slots), hashes(other.hashes), keys(other.keys), values(other.values),
+      live_count(other.live_count), used_slots(other.used_slots) {
+    updateAccounting();
+}
+
+NyxHashTable::~NyxHashTable() {
+    HeapAccounting::release(HeapKind::MAPS, charged_bytes);
+}
+
+size_t NyxHashTable::findSlot(const NyxValue& key, std::uint64_t hash) const {
+    if (slots.empty()) return NOT_FOUND;
+    size_t mask = slots.size() - 1;
+    auto tag = static_cast<std::uint32_t>(hash >> 32);
+    for (size_t position = hash & mask;; position = (position + 1) & mask) {
+        const Slot& slot = slots[position];
+        if (slot.entry == EMPTY) return NOT_FOUND;
+        if (slot.entry >= 0 && slot.tag == tag && keysEqual(keys[slot.entry], key)) return position;
+    }
+}
+
+size_t NyxHashTable::find(const NyxValue& key, int line) const {
+    size_t position = findSlot(key, hashKey(key, line));
+    return position == NOT_FOUND ? NOT_FOUND : static_cast<size_t>(slots[position].entry);
+}
+
+size_t NyxHashTable::insert(const NyxValue& key, bool& inserted, int line) {
+    std::uint64_t hash = hashKey(key, line);
+    size_t position = findSlot(key, hash);
+    inserted = position == NOT_FOUND;
+    return inserted ? addEntry(NyxValue(key), hash) : static_cast<size_t>(slots[position].entry);
+}
+
+size_t NyxHashTable::insert(NyxValue&& key, bool& inserted, int line) {
+    std::uint64_t hash = hashKey(key, line);
+    size_t position = findSlot(key, hash);
+    inserted = position == NOT_FOUND;
+    return inserted ? addEntry(std::move(key), hash) : static_cast<size_t>(slots[position].entry);
+}
+
+size_t NyxHashTable::addEntry(NyxValue&& key, std::uint64_t hash) {
+    if ((used_slots + 1) * 4 > slots.size() * 3) {
+        rebuild(slotCountFor(live_count + 1));
+    }
+
+    size_t entry = keys.size();
+    size_t mask = slots.size() - 1;
+    size_t position = hash & mask;
+    for (; slots[position].entry >= 0; position = (position + 1) & mask) {}
+    if (slots[position].entry == EMPTY) {
+        ++used_slots;
+    }
+    slots[position] = Slot{static_cast<std::uint32_t>(hash >> 32), static_cast<std::int32_t>(entry)};
+    hashes.push_back(hash);
+    keys.push_back(std::move(key));
+    if (with_values) {
+        values.emplace_back();
+    }
+    ++live_count;
+    ++layout_version;
+    updateAccounting();
+    return entry;
+}
+
+bool NyxHashTable::remove(const NyxValue& key, int line) {
+    size_t position = findSlot(key, hashKey(key, line));
+    if (position == NOT_FOUND) {
+        return false;
+    }
+    size_t entry = static_cast<size_t>(slots[position].entry);
+    slots[position].entry = DELETED;
+    keys[entry] = NyxValue();
+    if (with_values) {
+        values[entry] = NyxValue();
+    }
+    --live_count;
+    ++layout_version;
+    // Keep iteration proportional to the live entries.
+    if (keys.size() >= 32 && live_count * 4 < keys.size()) {
+        rebuild(slotCountFor(live_count));
+    }
+    return true;
+}
+
+void NyxHashTable::clear() {
+    // Swapping first means values destroyed here cannot observe a half-cleared
+    // table (a value's destructor may drop the last reference to this map).
+    std::vector<NyxValue> old_keys, old_values;
+    old_keys.swap(keys);
+    old_values.swap(values);
+    slots.clear();
+    hashes.clear();
+    live_count = 0;
+    used_slots = 0;
+    ++layout_version;
+    updateAccounting();
+}
+
+void NyxHashTable::reserve(size_t count) {
+    if (count * 4 > slots.size() * 3) {
+        rebuild(slotCountFor(count));
+    }
+    HeapAccounting::checkAllocation(count * (sizeof(std::uint64_t) + (with_values ? 2 : 1) * sizeof(NyxValue)), 0);
+    hashes.reserve(count);
+    keys.reserve(count);
+    if (with_values) values.reserve(count);
+    updateAccounting();
+}
+
+void NyxHashTable::rebuild(size_t slot_count) {
+    HeapAccounting::checkAllocation(slot_count * sizeof(Slot), 0);
+    if (live_count != keys.size()) {
+        size_t kept = 0;
+        for (size_t entry = 0; entry < keys.size(); ++entry) {
+            if (!isLive(entry)) continue;
+            if (kept != entry) {
+                hashes[kept] = hashes[entry];
+                keys[kept] = std::move(keys[entry]);
+                if (with_values) values[kept] = std::move(values[entry]);
+            }
+            ++kept;
+        }
+        hashes.resize(kept);
+        keys.resize(kept);
+        if (with_values) values.resize(kept);
+    }
+
+    slots.assign(slot_count, Slot{0, EMPTY});
+    size_t mask = slot_count - 1;
+    for (size_t entry = 0; entry < keys.size(); ++entry) {
+        size_t position = hashes[entry] & mask;
+        while (slots[position].entry != EMPTY) {
+            position = (position + 1) & mask;
+        }
+        slots[position] = Slot{static_cast<std::uint32_t>(hashes[entry] >> 32), static_cast<std::int32_t>(entry)};
+    }
+    used_slots = keys.size();
+    ++layout_version;
+    updateAccounting();
+}
+
+// Keys and values account for their own strings and lists; this covers the
+// table's arrays.
+void NyxHashTable::updateAccounting() {
+    size_t bytes = sizeof(NyxHashTable) + slots.capacity() * sizeof(Slot) + hashes.capacity() * sizeof(std::uint64_t) +
+                   (keys.capacity() + values.capacity()) * sizeof(NyxValue);
+    HeapAccounting::adjust(HeapKind::MAPS, static_cast<std::int64_t>(bytes) - static_cast<std::int64_t>(charged_bytes));
+    charged_bytes = bytes;
+}
+
+void NyxMap::gcTraverse(GcVisitor& visitor) const {
+    for (size_t entry = 0; entry < table.entryLimit(); ++entry) {
+        if (table.isLive(entry)) {
+            gcTraverseValue(table.valueAt(entry), visitor);
+        }
+    }
+}
+
+void NyxMap::gcClear() {
+    table.clear();
+}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "./Value.h"
+
+namespace Nyx {
+
+// Keys of maps and elements of sets must be hashable: numbers (other than
+// NaN), booleans, strings and lists of hashable values, frozen or not. Equal
+// keys hash equally, and a frozen string or list equals its ordinary
+// counterpart, as with `==`. Throws NyxRuntimeException (reporting `line`)
+// for other values.
+std::uint64_t hashKey(const NyxValue& key, int line = 0);
+bool keysEqual(const NyxValue& a, const NyxValue& b);
+
+// Open-addressing hash table behind maps and sets. Entries are kept in
+// insertion order in parallel vectors of hashes, keys and (for maps) values.
+// The slot array only holds 32 bits of each hash and an entry number, so
+// linear probing walks 8-byte slots and reads an entry only when those bits
+// match. Slots are at most 3/4 used. Removing a key leaves a hole in the
+// entries, squeezed out the next time the slots are rebuilt.
+class NyxHashTable {
+public:
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+    explicit NyxHashTable(bool with_values);
+    NyxHashTable(const NyxHashTable& other);
+    NyxHashTable& operator=(const NyxHashTable&) = delete;
+    ~NyxHashTable();
+
+    size_t size() const { return live_count; }
+
+    // The entry number of `key`, or NOT_FOUND. These throw, reporting `line`,
+    // if `key` is not hashable.
+    size_t find(const NyxValue& key, int line = 0) const;
+    // The entry number of `key`, adding it (with a null value) if missing.
+    size_t insert(const NyxValue& key, bool& inserted, int line = 0);
+    size_t insert(NyxValue&& key, bool& inserted, int line = 0);
+    bool remove(const NyxValue& key, int line = 0);
+    void clear();
+    // Makes room for `count` entries in all, so adding that many allocates
+    // nothing more.
+    void reserve(size_t count);
+
+    // Entry numbers run from 0 to entryLimit(); removed ones are holes.
+    size_t entryLimit() const { return keys.size(); }
+    bool isLive(size_t entry) const { return !std::holds_alternative<std::monostate>(keys[entry].data); }
+    const NyxValue& keyAt(size_t entry) const { return keys[entry]; }
+    NyxValue& valueAt(size_t entry) { return values[entry]; }
+    const NyxValue& valueAt(size_t entry) const { return values[entry]; }
+
+    // Changes whenever a key is added or removed (and entry numbers may
+    // move), but not when a value is replaced.
+    std::uint64_t layoutVersion() const { return layout_version; }
+
+private:
+    struct Slot {
+        std::uint32_t tag;   // upper half of the hash
+        std::int32_t entry;  // EMPTY, DELETED or an entry number
+    };
+    static constexpr std::int32_t EMPTY = -1;
+    static constexpr std::int32_t DELETED = -2;
+
+    size_t findSlot(const NyxValue& key, std::uint64_t hash) const;
+    size_t addEntry(NyxValue&& key, std::uint64_t hash);
+    void rebuild(size_t slot_count);
+    void updateAccounting();
+
+    bool with_values;
+    std::vector<Slot> slots;
+    std::vector<std::uint64_t> hashes;
+    std::vector<NyxValue> keys;
+    std::vector<NyxValue> values;
+    size_t live_count = 0;
+    size_t used_slots = 0; // live and deleted
+    std::uint64_t layout_version = 0;
+    size_t charged_bytes = 0;
+};
+
+// A hash map (`{key: value}`). Maps are shared by reference like struct
+// instances, and their values can refer back to them, so they take part in
+// cycle collection.
+struct NyxMap : public GcObject {
+    NyxHashTable table{true};
+
+    NyxMap() = default;
+    NyxMap(const NyxMap& other) : GcObject(other), table(other.table) {}
+
+    void gcTraverse(GcVisitor& visitor) const override;
+    void gcClear() override;
+};
+
+// A hash set (`{a, b}`), shared by reference. Elements are hashable values,
+// which never refer to collected objects.
+struct NyxSet {
+    NyxHashTable table{false};
+};
+
+}
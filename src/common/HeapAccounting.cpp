@@ -0,0 +1,129 @@
+#include "./HeapAccounting.h"
+#include "./GarbageCollector.h"
+#include "./Utils.h"
+#include <cctype>
+#include <cstdio>
+
+namespace Nyx {
+
+thread_local HeapAccounting* HeapAccounting::active = nullptr;
+
+HeapAccounting& HeapAccounting::threadAccountant() {
+    thread_local HeapAccounting accountant;
+    return accountant;
+}
+
+const char* heapKindName(HeapKind kind) {
+    switch (kind) {
+        case HeapKind::STRINGS: return "strings";
+        case HeapKind::LISTS: return "lists";
+        case HeapKind::ARRAYS: return "arrays";
+        case HeapKind::MAPS: return "maps";
+        case HeapKind::STRUCTS: return "structs";
+        case HeapKind::ENVIRONMENTS: return "environments";
+        case HeapKind::FUNCTIONS: return "functions";
+        case HeapKind::AST: return "AST";
+    }
+    return "unknown";
+}
+
+size_t HeapAccounting::liveBytes(HeapKind kind) {
+    std::int64_t value = current().counters[static_cast<size_t>(kind)].load(std::memory_order_relaxed);
+    return value > 0 ? static_cast<size_t>(value) : 0;
+}
+
+size_t HeapAccounting::liveBytes() {
+    size_t total = 0;
+    for (size_t i = 0; i < HEAP_KIND_COUNT; ++i) {
+        total += liveBytes(static_cast<HeapKind>(i));
+    }
+    return total;
+}
+
+void HeapAccounting::checkAllocation(size_t additional_bytes, int line) {
+    size_t current_limit = limit();
+    if (current_limit == 0 || liveBytes() + additional_bytes <= current_limit) {
+        return;
+    }
+
+    // Unreachable cycles still count until collected; try that first.
+    GarbageCollector::current().collect();
+    size_t live = liveBytes();
+    if (live + additional_bytes <= current_limit) {
+        return;
+    }
+
+    std::string message = "Heap limit of " + formatBytes(current_limit) + " exceeded";
+    if (additional_bytes > 0) {
+        message += " (allocating " + formatBytes(additional_bytes) + " with " + formatBytes(live) + " live)";
+    } else {
+        message += " (" + formatBytes(live) + " live)";
+    }
+    message += ": " + breakdown() + ".";
+    throw Common::NyxRuntimeException(message, line);
+}
+
+void HeapAccounting::enforceLimit(int line) {
+    checkAllocation(0, line);
+}
+
+std::string HeapAccounting::breakdown() {
+    std::string result;
+    for (size_t i = 0; i < HEAP_KIND_COUNT; ++i) {
+        HeapKind kind = static_cast<HeapKind>(i);
+        if (!result.empty()) result += ", ";
+        result += std::string(heapKindName(kind)) + " " + formatBytes(liveBytes(kind));
+    }
+    return result;
+}
+
+std::string HeapAccounting::formatBytes(size_t bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit < 4) {
+        value /= 1024.0;
+        ++unit;
+    }
+    char buffer[32];
+    if (unit == 0) {
+        std::snprintf(buffer, sizeof(buffer), "%zu B", bytes);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.1f %s", value, units[unit]);
+    }
+    return buffer;
+}
+
+bool HeapAccounting::parseSize(const std::string& text, size_t& bytes_out) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    size_t position = 0;
+    unsigned long long value = 0;
+    try {
+        value = std::stoull(text, &position);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    unsigned long long multiplier = 1;
+    if (position < text.size()) {
+        switch (std::toupper(static_cast<unsigned char>(text[position]))) {
+            case 'K': multiplier = 1ULL << 10; break;
+            case 'M': multiplier = 1ULL << 20; break;
+            case 'G': multiplier = 1ULL << 30; break;
+            default: return false;
+        }
+        ++position;
+        if (position < text.size() && std::toupper(static_cast<unsigned char>(text[position])) == 'B') {
+            ++position;
+        }
+    }
+    if (position != text.size()) {
+        return false;
+    }
+    bytes_out = static_cast<size_t>(value * multiplier);
+    return true;
+}
+
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Nyx {
+
+enum class HeapKind {
+    STRINGS,
+    LISTS,
+    ARRAYS,
+    MAPS,
+    STRUCTS,
+    ENVIRONMENTS,
+    FUNCTIONS,
+    AST,
+};
+
+constexpr size_t HEAP_KIND_COUNT = 8;
+
+const char* heapKindName(HeapKind kind);
+
+// Live byte counts per kind of runtime object, plus an optional limit.
+// Counters are only touched when an object owns heap memory (a string past
+// its inline buffer, a non-empty list or array, a scope, a node), so the
+// accounting stays on in every build. The limit is 0 (unlimited) unless set
+// with --max-heap.
+//
+// Each thread has its own counters and limit, so interpreters on separate
+// threads are accounted (and limited) separately. The static functions act on
+// the calling thread's accountant.
+class HeapAccounting {
+public:
+    static void allocate(HeapKind kind, size_t bytes) {
+        current().counters[static_cast<size_t>(kind)].fetch_add(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+    }
+
+    static void release(HeapKind kind, size_t bytes) {
+        current().counters[static_cast<size_t>(kind)].fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+    }
+
+    static void adjust(HeapKind kind, std::int64_t delta) {
+        if (delta != 0) {
+            current().counters[static_cast<size_t>(kind)].fetch_add(delta, std::memory_order_relaxed);
+        }
+    }
+
+    static size_t liveBytes(HeapKind kind);
+    static size_t liveBytes();
+
+    static void setLimit(size_t bytes) { current().limit_bytes.store(bytes, std::memory_order_relaxed); }
+    static size_t limit() { return current().limit_bytes.load(std::memory_order_relaxed); }
+
+    static bool overLimit() {
+        size_t current_limit = limit();
+        return current_limit != 0 && liveBytes() > current_limit;
+    }
+
+    // Throws NyxRuntimeException if `additional_bytes` more would exceed the
+    // limit even after a full garbage collection.
+    static void checkAllocation(size_t additional_bytes, int line);
+    // Same as checkAllocation(0, line), for use after memory has grown.
+    static void enforceLimit(int line);
+
+    // "strings 1.2 MB, lists 300 B, ..." for error messages and reports.
+    static std::string breakdown();
+    static std::string formatBytes(size_t bytes);
+    // Accepts a byte count with an optional K, M or G suffix ("512M").
+    static bool parseSize(const std::string& text, size_t& bytes_out);
+
+    static HeapAccounting& current() {
+        if (!active) {
+            active = &threadAccountant();
+        }
+        return *active;
+    }
+
+    // Charges everything the calling thread allocates to `owner` until
+    // destroyed, for helper threads that build data on another thread's
+    // behalf (module prefetching).
+    class Adopt {
+    public:
+        explicit Adopt(HeapAccounting& owner) : previous(active) { active = &owner; }
+        ~Adopt() { active = previous; }
+        Adopt(const Adopt&) = delete;
+        Adopt& operator=(const Adopt&) = delete;
+
+    private:
+        HeapAccounting* previous;
+    };
+
+private:
+    static HeapAccounting& threadAccountant();
+    static thread_local HeapAccounting* active;
+
+    std::atomic<std::int64_t> counters[HEAP_KIND_COUNT] = {};
+    std::atomic<size_t> limit_bytes{0};
+};
+
+// Bytes a string keeps outside its own object; short strings stored inline
+// cost nothing extra.
+inline size_t stringHeapBytes(const std::string& text) {
+    const char* buffer = text.data();
+    const char* object = reinterpret_cast<const char*>(&text);
+    if (buffer >= object && buffer < object + sizeof(std::string)) {
+        return 0;
+    }
+    return text.capacity() + 1;
+}
+
+}
@@ -0,0 +1,45 @@
+#include "./Iterator.h"
+#include "./NumericArray.h"
+
+namespace Nyx {
+
+namespace {
+    const NyxList* listOf(const NyxValue& value) {
+        if (const auto* list = std::get_if<NyxList>(&value.data)) return list;
+        if (const auto* frozen = std::get_if<FrozenValuePtr>(&value.data)) {
+            if (*frozen && (*frozen)->kind == NyxFrozenValue::Kind::LIST) return &(*frozen)->elements;
+        }
+        return nullptr;
+    }
+}
+
+ItemCursor::ItemCursor(const NyxValue& iterable) : list(listOf(iterable)) {
+    if (const auto* numeric = std::get_if<NumericArrayPtr>(&iterable.data)) {
+        array = numeric->get();
+    } else if (const auto* lazy = std::get_if<IteratorPtr>(&iterable.data)) {
+        iterator = lazy->get();
+    }
+}
+
+bool ItemCursor::accepts(const NyxValue& value) {
+    if (listOf(value)) return true;
+    if (const auto* numeric = std::get_if<NumericArrayPtr>(&value.data)) return *numeric != nullptr;
+    if (const auto* lazy = std::get_if<IteratorPtr>(&value.data)) return *lazy != nullptr;
+    return false;
+}
+
+bool ItemCursor::next(Interpreter& interpreter, NyxValue& item) {
+    if (list) {
+        if (position >= list->size()) return false;
+        item = (*list)[position++];
+        return true;
+    }
+    if (array) {
+        if (position >= array->size()) return false;
+        item = NyxValue(array->get(position++));
+        return true;
+    }
+    return iterator && iterator->next(interpreter, item);
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "./Value.h"
+
+namespace Nyx {
+
+class Interpreter;
+
+// A lazy sequence: generators, and the ranges and pipelines built by
+// std:list. Items are produced one at a time as next() is called, so a
+// pipeline over a million items never holds more than one of them. An
+// iterator is used up as it is read and is shared by reference, like a map.
+class NyxIterator : public GcObject {
+public:
+    // Stores the next item in `item` and returns true, or returns false once
+    // the sequence is over (and keeps returning false). Callbacks run on
+    // `interpreter`. Throws NyxRuntimeException as the code it runs does.
+    virtual bool next(Interpreter& interpreter, NyxValue& item) = 0;
+    virtual std::string describe() const { return "<iterator>"; }
+
+    // Iterators that hold no collected objects need not report any.
+    void gcTraverse(GcVisitor&) const override {}
+    void gcClear() override {}
+};
+
+// Reads the items of a list, frozen list, numeric array or iterator in turn,
+// for natives that accept any of them. `iterable` must outlive the cursor.
+class ItemCursor {
+public:
+    explicit ItemCursor(const NyxValue& iterable);
+
+    static bool accepts(const NyxValue& value);
+    bool next(Interpreter& interpreter, NyxValue& item);
+
+private:
+    const NyxList* list = nullptr;
+    const NyxNumericArray* array = nullptr;
+    NyxIterator* iterator = nullptr;
+    size_t position = 0;
+};
+
+}
@@ -0,0 +1,63 @@
+#include "./NumericArray.h"
+#include "./HeapAccounting.h"
+
+namespace Nyx {
+
+NyxNumericArray::NyxNumericArray(ElementType type, size_t element_count) : element_type(type), length(element_count) {
+    switch (element_type) {
+        case ElementType::FLOAT64: float64_elements.resize(length); break;
+        case ElementType::INT32: int32_elements.resize(length); break;
+        case ElementType::UINT8: uint8_elements.resize(length); break;
+    }
+    HeapAccounting::allocate(HeapKind::ARRAYS, sizeof(NyxNumericArray) + byteSize());
+}
+
+NyxNumericArray::~NyxNumericArray() {
+    HeapAccounting::release(HeapKind::ARRAYS, sizeof(NyxNumericArray) + byteSize());
+}
+
+void* NyxNumericArray::rawData() {
+    switch (element_type) {
+        case ElementType::FLOAT64: return float64_elements.data();
+        case ElementType::INT32: return int32_elements.data();
+        case ElementType::UINT8: return uint8_elements.data();
+    }
+    return nullptr;
+}
+
+const void* NyxNumericArray::rawData() const {
+    return const_cast<NyxNumericArray*>(this)->rawData();
+}
+
+size_t NyxNumericArray::elementSize(ElementType type) {
+    switch (type) {
+        case ElementType::FLOAT64: return sizeof(double);
+        case ElementType::INT32: return sizeof(std::int32_t);
+        case ElementType::UINT8: return sizeof(std::uint8_t);
+    }
+    return 0;
+}
+
+const char* NyxNumericArray::typeName(ElementType type) {
+    switch (type) {
+        case ElementType::FLOAT64: return "float64";
+        case ElementType::INT32: return "int32";
+        case ElementType::UINT8: return "uint8";
+    }
+    return "unknown";
+}
+
+bool NyxNumericArray::parseType(const std::string& name, ElementType& type_out) {
+    if (name == "float64") {
+        type_out = ElementType::FLOAT64;
+    } else if (name == "int32") {
+        type_out = ElementType::INT32;
+    } else if (name == "uint8") {
+        type_out = ElementType::UINT8;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+}
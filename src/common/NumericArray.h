@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nyx {
+
+// A packed array of numbers of one element type (see std:array). Elements
+// are stored unboxed, so kernels run over plain memory and a million
+// float64 elements take 8 MB instead of a list's fat values.
+//
+// Unlike lists, arrays are shared by reference: assigning or passing one
+// does not copy it, and `a[i] = x` changes it for every holder. Arrays hold
+// no other values, so they need no garbage collection.
+class NyxNumericArray {
+public:
+    enum class ElementType { FLOAT64, INT32, UINT8 };
+
+    // Zero-filled.
+    NyxNumericArray(ElementType type, size_t length);
+    ~NyxNumericArray();
+
+    NyxNumericArray(const NyxNumericArray&) = delete;
+    NyxNumericArray& operator=(const NyxNumericArray&) = delete;
+
+    ElementType type() const { return element_type; }
+    size_t size() const { return length; }
+    size_t byteSize() const { return length * elementSize(element_type); }
+
+    double get(size_t index) const {
+        switch (element_type) {
+            case ElementType::FLOAT64: return float64_elements[index];
+            case ElementType::INT32: return int32_elements[index];
+            case ElementType::UINT8: return uint8_elements[index];
+        }
+        return 0.0;
+    }
+
+    // Converts to the element type, see toInt32() and toUInt8().
+    void set(size_t index, double value) {
+        switch (element_type) {
+            case ElementType::FLOAT64: float64_elements[index] = value; break;
+            case ElementType::INT32: int32_elements[index] = toInt32(value); break;
+            case ElementType::UINT8: uint8_elements[index] = toUInt8(value); break;
+        }
+    }
+
+    double* float64Data() { return float64_elements.data(); }
+    const double* float64Data() const { return float64_elements.data(); }
+    std::int32_t* int32Data() { return int32_elements.data(); }
+    const std::int32_t* int32Data() const { return int32_elements.data(); }
+    std::uint8_t* uint8Data() { return uint8_elements.data(); }
+    const std::uint8_t* uint8Data() const { return uint8_elements.data(); }
+    void* rawData();
+    const void* rawData() const;
+
+    static size_t elementSize(ElementType type);
+    // "float64", "int32" or "uint8".
+    static const char* typeName(ElementType type);
+    static bool parseType(const std::string& name, ElementType& type_out);
+
+    // Integer elements truncate toward zero and saturate at the ends of
+    // their range; NaN becomes 0.
+    static std::int32_t toInt32(double value) {
+        if (!(value > -2147483648.0)) return value != value ? 0 : INT32_MIN;
+        if (value >= 2147483647.0) return INT32_MAX;
+        return static_cast<std::int32_t>(value);
+    }
+    static std::uint8_t toUInt8(double value) {
+        if (!(value > 0.0)) return 0;
+        if (value >= 255.0) return 255;
+        return static_cast<std::uint8_t>(value);
+    }
+
+private:
+    ElementType element_type;
+    size_t length;
+    // Only the vector for element_type is used.
+    std::vector<double> float64_elements;
+    std::vector<std::int32_t> int32_elements;
+    std::vector<std::uint8_t> uint8_elements;
+};
+
+}
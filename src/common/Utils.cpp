@@ -62,5 +62,14 @@ bool isSimpleNumeric(const std::string& s) {
     return std::all_of(s.begin(), s.end(), [](char c){ return std::isdigit(static_cast<unsigned char>(c)); });
 }
 
+std::uint64_t hashBytes(const char* data, size_t length) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 }
 }
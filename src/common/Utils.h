@@ -4,6 +4,7 @@
 #include <vector>
 #include <cctype>
 #include <stdexcept>
+#include <cstdint>
 
 namespace Nyx {
 namespace Common {
@@ -16,6 +17,8 @@ bool isValidIdentifier(const std::string& s);
 
 bool isSimpleNumeric(const std::string& s);
 
+std::uint64_t hashBytes(const char* data, size_t length);
+
 class NyxException : public std::runtime_error {
 public:
     NyxException(const std::string& message) : std::runtime_error(message) {}
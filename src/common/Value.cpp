@@ -1,11 +1,20 @@
 #include "../common/Value.h"
 #include "../interpreter/Interpreter.h" 
 #include "../interpreter/Environment.h" 
+#include "../interpreter/EventLoop.h"
 #include "../stdlib/sdl_module.h"
 #include "../tokenizer/Token.h"
+#include "./Utils.h"
+#include "./NumericArray.h"
+#include "./HashTable.h"
+#include "./Iterator.h"
+#include "./FileHandle.h"
+#include "./Bytes.h"
+#include "../stdlib/regex_engine.h"
 #include <iomanip>
 #include <sstream>
 #include <map>
+#include <set>
 
 
 namespace Nyx {
@@ -21,6 +30,152 @@ NyxStructInstance::NyxStructInstance(StructDefinitionPtr def) : definition(std::
     if (definition) {
         field_values.resize(definition->field_names_in_order.size(), NyxValue(std::monostate{}));
     }
+    HeapAccounting::allocate(HeapKind::STRUCTS, sizeof(NyxStructInstance) + field_values.capacity() * sizeof(NyxValue));
+}
+
+NyxStructInstance::~NyxStructInstance() {
+    // gcClear() empties field_values but keeps its capacity.
+    HeapAccounting::release(HeapKind::STRUCTS, sizeof(NyxStructInstance) + field_values.capacity() * sizeof(NyxValue));
+}
+
+void NyxStructInstance::gcTraverse(GcVisitor& visitor) const {
+    for (const NyxValue& field : field_values) {
+        gcTraverseValue(field, visitor);
+    }
+}
+
+void NyxStructInstance::gcClear() {
+    field_values.clear();
+}
+
+void gcTraverseValue(const NyxValue& value, GcVisitor& visitor) {
+    const auto& data = value.data;
+    if (std::holds_alternative<UserDefinedFunctionPtr>(data)) {
+        visitor.visit(std::get<UserDefinedFunctionPtr>(data).get());
+    } else if (std::holds_alternative<StructInstancePtr>(data)) {
+        visitor.visit(std::get<StructInstancePtr>(data).get());
+    } else if (std::holds_alternative<NyxModule>(data)) {
+        visitor.visit(std::get<NyxModule>(data).get());
+    } else if (std::holds_alternative<MapPtr>(data)) {
+        visitor.visit(std::get<MapPtr>(data).get());
+    } else if (std::holds_alternative<IteratorPtr>(data)) {
+        visitor.visit(std::get<IteratorPtr>(data).get());
+    } else if (std::holds_alternative<GreenThreadPtr>(data)) {
+        visitor.visit(std::get<GreenThreadPtr>(data).get());
+    } else if (std::holds_alternative<NyxList>(data)) {
+        for (const NyxValue& element : std::get<NyxList>(data)) {
+            gcTraverseValue(element, visitor);
+        }
+    }
+}
+
+bool isThreadNeutral(const NyxValue& value) {
+    const auto& data = value.data;
+    return std::holds_alternative<std::monostate>(data) ||
+           std::holds_alternative<bool>(data) ||
+           std::holds_alternative<double>(data) ||
+           std::holds_alternative<FrozenValuePtr>(data) ||
+           std::holds_alternative<StructDefinitionPtr>(data) ||
+           std::holds_alternative<NativeFunctionPtr>(data) ||
+           std::holds_alternative<TaskFuturePtr>(data) ||
+           std::holds_alternative<ChannelPtr>(data) ||
+           std::holds_alternative<RegexPtr>(data);
+}
+
+namespace {
+    // Struct instances are memoized both ways so that an instance reachable
+    // along several paths stays a single instance.
+    class Freezer {
+    public:
+        NyxValue freeze(const NyxValue& value) {
+            if (isThreadNeutral(value)) {
+                return value;
+            }
+            const auto& data = value.data;
+            auto frozen = std::make_shared<NyxFrozenValue>();
+            if (const auto* text = std::get_if<std::string>(&data)) {
+                frozen->kind = NyxFrozenValue::Kind::STRING;
+                frozen->text = *text;
+            } else if (const auto* list = std::get_if<NyxList>(&data)) {
+                frozen->kind = NyxFrozenValue::Kind::LIST;
+                frozen->elements.reserve(list->size());
+                for (const NyxValue& element : *list) {
+                    frozen->elements.push_back(freeze(element));
+                }
+            } else if (const auto* instance = std::get_if<StructInstancePtr>(&data); instance && *instance) {
+                const NyxStructInstance* source = instance->get();
+                auto done = frozen_instances.find(source);
+                if (done != frozen_instances.end()) {
+                    return NyxValue(done->second);
+                }
+                if (!in_progress.insert(source).second) {
+                    throw Common::NyxRuntimeException("Cannot freeze a struct instance that contains itself.", 0);
+                }
+                frozen->kind = NyxFrozenValue::Kind::STRUCT_INSTANCE;
+                frozen->definition = source->definition;
+                frozen->elements.reserve(source->field_values.size());
+                for (const NyxValue& field : source->field_values) {
+                    frozen->elements.push_back(freeze(field));
+                }
+                in_progress.erase(source);
+                frozen_instances[source] = frozen;
+            } else {
+                throw Common::NyxRuntimeException("Values of type " + nyxValueTypeToString(value) + " cannot be frozen.", 0);
+            }
+            return NyxValue(FrozenValuePtr(std::move(frozen)));
+        }
+
+    private:
+        std::map<const NyxStructInstance*, FrozenValuePtr> frozen_instances;
+        std::set<const NyxStructInstance*> in_progress;
+    };
+
+    class Thawer {
+    public:
+        NyxValue thaw(const NyxValue& value) {
+            const auto* frozen_ptr = std::get_if<FrozenValuePtr>(&value.data);
+            if (!frozen_ptr || !*frozen_ptr) {
+                return value;
+            }
+            const NyxFrozenValue& frozen = **frozen_ptr;
+            switch (frozen.kind) {
+                case NyxFrozenValue::Kind::STRING:
+                    return NyxValue(frozen.text);
+                case NyxFrozenValue::Kind::LIST: {
+                    NyxList list;
+                    list.reserve(frozen.elements.size());
+                    for (const NyxValue& element : frozen.elements) {
+                        list.push_back(thaw(element));
+                    }
+                    return NyxValue(std::move(list));
+                }
+                case NyxFrozenValue::Kind::STRUCT_INSTANCE: {
+                    auto done = thawed_instances.find(&frozen);
+                    if (done != thawed_instances.end()) {
+                        return NyxValue(done->second);
+                    }
+                    auto instance = std::make_shared<NyxStructInstance>(frozen.definition);
+                    thawed_instances[&frozen] = instance;
+                    for (size_t i = 0; i < frozen.elements.size() && i < instance->field_values.size(); ++i) {
+                        instance->field_values[i] = thaw(frozen.elements[i]);
+                    }
+                    return NyxValue(instance);
+                }
+            }
+            return NyxValue();
+        }
+
+    private:
+        std::map<const NyxFrozenValue*, StructInstancePtr> thawed_instances;
+    };
+}
+
+NyxValue freezeValue(const NyxValue& value) {
+    return Freezer().freeze(value);
+}
+
+NyxValue thawValue(const NyxValue& value) {
+    return Thawer().thaw(value);
 }
 
 std::string nyxValueToString(const NyxValue& value_holder) {
@@ -96,6 +251,69 @@ std::string nyxValueToString(const NyxValue& value_holder) {
             return ss.str();
         }
         return "<struct_instance null_ptr>";
+    } else if (std::holds_alternative<TaskFuturePtr>(var_data)) {
+        return "<task>";
+    } else if (std::holds_alternative<FrozenValuePtr>(var_data)) {
+        return nyxValueToString(thawValue(value_holder));
+    } else if (std::holds_alternative<ChannelPtr>(var_data)) {
+        return "<channel>";
+    } else if (std::holds_alternative<NumericArrayPtr>(var_data)) {
+        const auto& array = std::get<NumericArrayPtr>(var_data);
+        if (!array) return "<array null_ptr>";
+        std::stringstream ss;
+        ss << NyxNumericArray::typeName(array->type()) << "[";
+        for (size_t i = 0; i < array->size(); ++i) {
+            if (i > 0) ss << ", ";
+            ss << nyxValueToString(NyxValue(array->get(i)));
+        }
+        ss << "]";
+        return ss.str();
+    } else if (std::holds_alternative<MapPtr>(var_data) || std::holds_alternative<SetPtr>(var_data)) {
+        const MapPtr* map = std::get_if<MapPtr>(&var_data);
+        const NyxHashTable* table = map ? (*map ? &(*map)->table : nullptr)
+                                        : (std::get<SetPtr>(var_data) ? &std::get<SetPtr>(var_data)->table : nullptr);
+        if (!table) return map ? "<map null_ptr>" : "<set null_ptr>";
+        // Strings are quoted as in lists. An empty set prints as set{} so it
+        // cannot be mistaken for an empty map.
+        auto quoted = [](const NyxValue& element) {
+            return std::holds_alternative<std::string>(element.data) ? "\"" + nyxValueToString(element) + "\"" : nyxValueToString(element);
+        };
+        std::stringstream ss;
+        ss << (!map && table->size() == 0 ? "set{" : "{");
+        bool first = true;
+        for (size_t entry = 0; entry < table->entryLimit(); ++entry) {
+            if (!table->isLive(entry)) continue;
+            if (!first) ss << ", ";
+            ss << quoted(table->keyAt(entry));
+            if (map) ss << ": " << quoted(table->valueAt(entry));
+            first = false;
+        }
+        ss << "}";
+        return ss.str();
+    } else if (const auto* iterator = std::get_if<IteratorPtr>(&var_data)) {
+        return *iterator ? (*iterator)->describe() : "<iterator null_ptr>";
+    } else if (const auto* thread = std::get_if<GreenThreadPtr>(&var_data)) {
+        return *thread ? (*thread)->describe() : "<green thread null_ptr>";
+    } else if (const auto* file = std::get_if<FilePtr>(&var_data)) {
+        return *file ? (*file)->describe() : "<file null_ptr>";
+    } else if (const auto* bytes = std::get_if<BytesPtr>(&var_data)) {
+        if (!*bytes) return "<bytes null_ptr>";
+        // Long buffers show their start only.
+        constexpr size_t SHOWN = 64;
+        static const char digits[] = "0123456789abcdef";
+        const NyxBytes& buffer = **bytes;
+        std::string text = "bytes[";
+        for (size_t i = 0; i < buffer.size() && i < SHOWN; ++i) {
+            if (i > 0) text += ' ';
+            text += digits[buffer.get(i) >> 4];
+            text += digits[buffer.get(i) & 0x0f];
+        }
+        if (buffer.size() > SHOWN) {
+            text += " ... (" + std::to_string(buffer.size()) + " bytes)";
+        }
+        return text + "]";
+    } else if (const auto* regex = std::get_if<RegexPtr>(&var_data)) {
+        return *regex ? (*regex)->describe() : "<regex null_ptr>";
     }
     return "[Unknown NyxValue]";
 }
@@ -124,6 +342,32 @@ std::string nyxValueTypeToString(const NyxValue& value_holder) {
         }
         return "STRUCT_INSTANCE";
      }
+    else if (std::holds_alternative<TaskFuturePtr>(var_data)) { return "TASK"; }
+    else if (std::holds_alternative<FrozenValuePtr>(var_data)) {
+        const auto& frozen = std::get<FrozenValuePtr>(var_data);
+        if (frozen && frozen->kind == NyxFrozenValue::Kind::STRING) return "FROZEN_STRING";
+        if (frozen && frozen->kind == NyxFrozenValue::Kind::LIST) return "FROZEN_LIST";
+        if (frozen && frozen->definition) return "FROZEN_STRUCT<" + frozen->definition->name + ">";
+        return "FROZEN_VALUE";
+    }
+    else if (std::holds_alternative<ChannelPtr>(var_data)) { return "CHANNEL"; }
+    else if (std::holds_alternative<MapPtr>(var_data)) { return "MAP"; }
+    else if (std::holds_alternative<SetPtr>(var_data)) { return "SET"; }
+    else if (std::holds_alternative<IteratorPtr>(var_data)) { return "ITERATOR"; }
+    else if (std::holds_alternative<GreenThreadPtr>(var_data)) { return "GREEN_THREAD"; }
+    else if (std::holds_alternative<FilePtr>(var_data)) { return "FILE"; }
+    else if (std::holds_alternative<BytesPtr>(var_data)) { return "BYTES"; }
+    else if (std::holds_alternative<RegexPtr>(var_data)) { return "REGEX"; }
+    else if (std::holds_alternative<NumericArrayPtr>(var_data)) {
+        const auto& array = std::get<NumericArrayPtr>(var_data);
+        if (!array) return "ARRAY";
+        switch (array->type()) {
+            case NyxNumericArray::ElementType::FLOAT64: return "FLOAT64_ARRAY";
+            case NyxNumericArray::ElementType::INT32: return "INT32_ARRAY";
+            case NyxNumericArray::ElementType::UINT8: return "UINT8_ARRAY";
+        }
+        return "ARRAY";
+    }
     return "UNKNOWN_TYPE";
 }
 
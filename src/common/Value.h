@@ -7,6 +7,8 @@
 #include <memory>
 #include <functional>
 #include <map> 
+#include "./GarbageCollector.h"
+#include "./HeapAccounting.h"
 
 namespace Nyx {
 
@@ -20,6 +22,17 @@ struct NyxSDLRendererWrapper;
 struct NyxSDLFontWrapper;
 struct NyxSDLSurfaceWrapper;
 struct NyxSDLTextureWrapper;
+struct NyxTaskFuture;
+struct NyxFrozenValue;
+class NyxChannel;
+class NyxNumericArray;
+struct NyxMap;
+struct NyxSet;
+class NyxIterator;
+class GreenThread;
+class NyxFile;
+class NyxBytes;
+class NyxRegex;
 
 struct NyxStructDefinition; 
 struct NyxStructInstance;  
@@ -36,6 +49,17 @@ using SDLSurfaceNyxPtr = std::shared_ptr<NyxSDLSurfaceWrapper>;
 using SDLTextureNyxPtr = std::shared_ptr<NyxSDLTextureWrapper>;
 using StructDefinitionPtr = std::shared_ptr<NyxStructDefinition>;
 using StructInstancePtr = std::shared_ptr<NyxStructInstance>;
+using TaskFuturePtr = std::shared_ptr<NyxTaskFuture>;
+using FrozenValuePtr = std::shared_ptr<const NyxFrozenValue>;
+using ChannelPtr = std::shared_ptr<NyxChannel>;
+using NumericArrayPtr = std::shared_ptr<NyxNumericArray>;
+using MapPtr = std::shared_ptr<NyxMap>;
+using SetPtr = std::shared_ptr<NyxSet>;
+using IteratorPtr = std::shared_ptr<NyxIterator>;
+using GreenThreadPtr = std::shared_ptr<GreenThread>;
+using FilePtr = std::shared_ptr<NyxFile>;
+using BytesPtr = std::shared_ptr<NyxBytes>;
+using RegexPtr = std::shared_ptr<const NyxRegex>;
 
 
 struct NyxValueData {
@@ -54,7 +78,18 @@ struct NyxValueData {
         SDLSurfaceNyxPtr,
         SDLTextureNyxPtr,
         StructDefinitionPtr, 
-        StructInstancePtr  
+        StructInstancePtr,
+        TaskFuturePtr,
+        FrozenValuePtr,
+        ChannelPtr,
+        NumericArrayPtr,
+        MapPtr,
+        SetPtr,
+        IteratorPtr,
+        GreenThreadPtr,
+        FilePtr,
+        BytesPtr,
+        RegexPtr
     > data;
 
     NyxValueData();
@@ -86,6 +121,34 @@ struct NyxValueData {
     NyxValueData(StructDefinitionPtr&& val);    
     NyxValueData(const StructInstancePtr& val); 
     NyxValueData(StructInstancePtr&& val);    
+    NyxValueData(const TaskFuturePtr& val);
+    NyxValueData(TaskFuturePtr&& val);
+    NyxValueData(const FrozenValuePtr& val);
+    NyxValueData(FrozenValuePtr&& val);
+    NyxValueData(const ChannelPtr& val);
+    NyxValueData(ChannelPtr&& val);
+    NyxValueData(const NumericArrayPtr& val);
+    NyxValueData(NumericArrayPtr&& val);
+    NyxValueData(const MapPtr& val);
+    NyxValueData(MapPtr&& val);
+    NyxValueData(const SetPtr& val);
+    NyxValueData(SetPtr&& val);
+    NyxValueData(const IteratorPtr& val);
+    NyxValueData(IteratorPtr&& val);
+    NyxValueData(const GreenThreadPtr& val);
+    NyxValueData(GreenThreadPtr&& val);
+    NyxValueData(const FilePtr& val);
+    NyxValueData(FilePtr&& val);
+    NyxValueData(const BytesPtr& val);
+    NyxValueData(BytesPtr&& val);
+    NyxValueData(const RegexPtr& val);
+    NyxValueData(RegexPtr&& val);
+
+    NyxValueData(const NyxValueData& other);
+    NyxValueData(NyxValueData&& other) noexcept;
+    NyxValueData& operator=(const NyxValueData& other);
+    NyxValueData& operator=(NyxValueData&& other) noexcept;
+    ~NyxValueData();
 
     template<
         typename T,
@@ -95,19 +158,33 @@ struct NyxValueData {
         >
     >
     NyxValueData(T&& value);
+
+private:
+    // Strings and lists report the buffer they own to HeapAccounting. List
+    // elements are values themselves and account for their own buffers.
+    size_t ownedHeapBytes() const;
+    HeapKind ownedHeapKind() const;
+    void accountOwnedBytes() const {
+        HeapAccounting::adjust(ownedHeapKind(), static_cast<std::int64_t>(ownedHeapBytes()));
+    }
 };
 
 using NyxValue = NyxValueData;
 using NyxList = std::vector<NyxValue>; 
 using NativeFunctionCallback = NyxValue (*)(Interpreter&, const std::vector<NyxValue>&);
+// For natives that return an updated copy of their first argument: makes the
+// same change to `target` itself, given the remaining arguments. Used for
+// `x = f(x, ...)`, where x's old value is about to be dropped anyway.
+using NativeInPlaceCallback = void (*)(Interpreter&, NyxValue& target, const std::vector<NyxValue>& rest);
 
 struct NyxNativeFunction {
     std::string name;
     NativeFunctionCallback callback;
     int arity; 
+    NativeInPlaceCallback in_place;
 
-    NyxNativeFunction(std::string n, NativeFunctionCallback cb, int ar) 
-        : name(std::move(n)), callback(cb), arity(ar) {}
+    NyxNativeFunction(std::string n, NativeFunctionCallback cb, int ar, NativeInPlaceCallback ip = nullptr) 
+        : name(std::move(n)), callback(cb), arity(ar), in_place(ip) {}
 };
 
 struct Token; 
@@ -120,11 +197,31 @@ struct NyxStructDefinition {
     NyxStructDefinition(std::string n, const std::vector<Token>& field_tokens); 
 };
 
-struct NyxStructInstance {
+struct NyxStructInstance : public GcObject {
     StructDefinitionPtr definition;
     std::vector<NyxValue> field_values;
 
     NyxStructInstance(StructDefinitionPtr def);
+    ~NyxStructInstance() override;
+
+    void gcTraverse(GcVisitor& visitor) const override;
+    void gcClear() override;
+};
+
+// An immutable string, list or struct instance made by freezeValue(). Any
+// number of isolates may hold and read the same frozen value at once, so it
+// crosses between tasks by reference instead of being copied. Elements and
+// fields hold only values that are safe to share the same way: null,
+// booleans, numbers, other frozen values, struct definitions, native
+// functions, tasks and channels. Frozen data is not charged to any isolate's
+// heap and is never traced by a collector (it cannot form cycles).
+struct NyxFrozenValue {
+    enum class Kind { STRING, LIST, STRUCT_INSTANCE };
+
+    Kind kind = Kind::STRING;
+    std::string text;               // STRING
+    std::vector<NyxValue> elements; // LIST elements or STRUCT_INSTANCE fields
+    StructDefinitionPtr definition; // STRUCT_INSTANCE
 };
 
 
@@ -132,11 +229,11 @@ inline NyxValueData::NyxValueData() : data(std::monostate{}) {}
 inline NyxValueData::NyxValueData(std::monostate val) : data(val) {}
 inline NyxValueData::NyxValueData(bool val) : data(val) {}
 inline NyxValueData::NyxValueData(double val) : data(val) {}
-inline NyxValueData::NyxValueData(const char* val) : data(std::string(val)) {}
-inline NyxValueData::NyxValueData(const std::string& val) : data(val) {}
-inline NyxValueData::NyxValueData(std::string&& val) : data(std::move(val)) {}
-inline NyxValueData::NyxValueData(const std::vector<NyxValueData>& val) : data(val) {}
-inline NyxValueData::NyxValueData(std::vector<NyxValueData>&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const char* val) : data(std::string(val)) { accountOwnedBytes(); }
+inline NyxValueData::NyxValueData(const std::string& val) : data(val) { accountOwnedBytes(); }
+inline NyxValueData::NyxValueData(std::string&& val) : data(std::move(val)) { accountOwnedBytes(); }
+inline NyxValueData::NyxValueData(const std::vector<NyxValueData>& val) : data(val) { accountOwnedBytes(); }
+inline NyxValueData::NyxValueData(std::vector<NyxValueData>&& val) : data(std::move(val)) { accountOwnedBytes(); }
 inline NyxValueData::NyxValueData(const UserDefinedFunctionPtr& val) : data(val) {}
 inline NyxValueData::NyxValueData(UserDefinedFunctionPtr&& val) : data(std::move(val)) {}
 inline NyxValueData::NyxValueData(const NyxModule& val) : data(val) {}
@@ -157,13 +254,124 @@ inline NyxValueData::NyxValueData(const StructDefinitionPtr& val) : data(val) {}
 inline NyxValueData::NyxValueData(StructDefinitionPtr&& val) : data(std::move(val)) {}
 inline NyxValueData::NyxValueData(const StructInstancePtr& val) : data(val) {}
 inline NyxValueData::NyxValueData(StructInstancePtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const TaskFuturePtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(TaskFuturePtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const FrozenValuePtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(FrozenValuePtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const ChannelPtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(ChannelPtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const NumericArrayPtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(NumericArrayPtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const MapPtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(MapPtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const SetPtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(SetPtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const IteratorPtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(IteratorPtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const GreenThreadPtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(GreenThreadPtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const FilePtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(FilePtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const BytesPtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(BytesPtr&& val) : data(std::move(val)) {}
+inline NyxValueData::NyxValueData(const RegexPtr& val) : data(val) {}
+inline NyxValueData::NyxValueData(RegexPtr&& val) : data(std::move(val)) {}
 
 
 template<typename T, typename U>
-NyxValueData::NyxValueData(T&& value) : data(std::forward<T>(value)) {}
+NyxValueData::NyxValueData(T&& value) : data(std::forward<T>(value)) { accountOwnedBytes(); }
+
+inline size_t NyxValueData::ownedHeapBytes() const {
+    if (const auto* text = std::get_if<std::string>(&data)) {
+        return stringHeapBytes(*text);
+    }
+    if (const auto* list = std::get_if<std::vector<NyxValueData>>(&data)) {
+        return list->capacity() * sizeof(NyxValueData);
+    }
+    return 0;
+}
+
+inline HeapKind NyxValueData::ownedHeapKind() const {
+    return std::holds_alternative<std::string>(data) ? HeapKind::STRINGS : HeapKind::LISTS;
+}
+
+inline NyxValueData::NyxValueData(const NyxValueData& other) : data(other.data) {
+    accountOwnedBytes();
+}
+
+// A moved-from string or list is left empty and its buffer now belongs to
+// this value, so the bytes already recorded stay correct.
+inline NyxValueData::NyxValueData(NyxValueData&& other) noexcept : data(std::move(other.data)) {}
+
+inline NyxValueData& NyxValueData::operator=(const NyxValueData& other) {
+    if (this != &other) {
+        HeapKind old_kind = ownedHeapKind();
+        std::int64_t old_bytes = static_cast<std::int64_t>(ownedHeapBytes());
+        data = other.data;
+        HeapKind new_kind = ownedHeapKind();
+        std::int64_t delta = static_cast<std::int64_t>(ownedHeapBytes());
+        if (new_kind == old_kind) {
+            delta -= old_bytes;
+        } else {
+            HeapAccounting::adjust(old_kind, -old_bytes);
+        }
+        HeapAccounting::adjust(new_kind, delta);
+    }
+    return *this;
+}
+
+// Move assignment may leave either buffer behind in `other` (std::string
+// swaps heap buffers), so both sides are measured again afterwards.
+inline NyxValueData& NyxValueData::operator=(NyxValueData&& other) noexcept {
+    if (this != &other) {
+        HeapKind old_kind = ownedHeapKind();
+        std::int64_t old_bytes = static_cast<std::int64_t>(ownedHeapBytes());
+        std::int64_t other_bytes = static_cast<std::int64_t>(other.ownedHeapBytes());
+        data = std::move(other.data);
+        HeapKind new_kind = ownedHeapKind();
+        std::int64_t delta = static_cast<std::int64_t>(ownedHeapBytes() + other.ownedHeapBytes()) - other_bytes;
+        if (new_kind == old_kind) {
+            delta -= old_bytes;
+        } else {
+            HeapAccounting::adjust(old_kind, -old_bytes);
+        }
+        HeapAccounting::adjust(new_kind, delta);
+    }
+    return *this;
+}
+
+inline NyxValueData::~NyxValueData() {
+    HeapAccounting::adjust(ownedHeapKind(), -static_cast<std::int64_t>(ownedHeapBytes()));
+}
+
+// Runs `edit` on the list held by `value`. Copies and assignments keep the
+// heap accounting of lists up to date, but a list changed where it lives has
+// to report its new capacity itself.
+template<typename Edit>
+void editListInPlace(NyxValue& value, Edit&& edit) {
+    NyxList& list = std::get<NyxList>(value.data);
+    std::int64_t old_bytes = static_cast<std::int64_t>(list.capacity() * sizeof(NyxValue));
+    edit(list);
+    HeapAccounting::adjust(HeapKind::LISTS, static_cast<std::int64_t>(list.capacity() * sizeof(NyxValue)) - old_bytes);
+}
 
 std::string nyxValueToString(const NyxValue& value);
 std::string nyxValueTypeToString(const NyxValue& value);
 std::ostream& operator<<(std::ostream& os, const NyxValue& value);
 
+// Reports the collector-tracked objects a value holds, looking inside lists.
+void gcTraverseValue(const NyxValue& value, GcVisitor& visitor);
+
+// True for values that hold no isolate-owned data and may be handed to
+// another thread as they are.
+bool isThreadNeutral(const NyxValue& value);
+// Returns an immutable copy of a string, list or struct instance (nested ones
+// included); frozen and other thread-neutral values come back unchanged.
+// Throws NyxRuntimeException for functions, modules, SDL handles and cyclic
+// structs.
+NyxValue freezeValue(const NyxValue& value);
+// Returns an ordinary, mutable copy of a frozen value; other values are
+// returned unchanged.
+NyxValue thawValue(const NyxValue& value);
+
 }
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace Nyx {
+
+constexpr const char* NYX_VERSION = "0.0.1";
+
+}
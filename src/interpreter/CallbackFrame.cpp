@@ -0,0 +1,74 @@
+#include "./CallbackFrame.h"
+#include "./Interpreter.h"
+#include "./Environment.h"
+#include "../common/Utils.h"
+
+namespace Nyx {
+
+CallbackFrame::CallbackFrame(Interpreter& interpreter, const NyxValue& callee_value, size_t argument_count, const std::string& function_name)
+    : interpreter(interpreter), callee(callee_value), arguments(argument_count) {
+    std::string expected = "'" + function_name + "' expects a function taking " + std::to_string(argument_count) +
+                           (argument_count == 1 ? " argument" : " arguments");
+    if (const auto* user_function = std::get_if<UserDefinedFunctionPtr>(&callee.data); user_function && *user_function) {
+        function = user_function->get();
+        if (function->arity() != argument_count) {
+            throw Common::NyxRuntimeException(expected + ", got one taking " + std::to_string(function->arity()) + ".", 0);
+        }
+    } else if (const auto* native = std::get_if<NativeFunctionPtr>(&callee.data); native && *native) {
+        if ((*native)->arity != -1 && static_cast<size_t>((*native)->arity) != argument_count) {
+            throw Common::NyxRuntimeException(expected + ", got one taking " + std::to_string((*native)->arity) + ".", 0);
+        }
+    } else {
+        throw Common::NyxRuntimeException(expected + ", got " + nyxValueTypeToString(callee) + ".", 0);
+    }
+}
+
+NyxValue CallbackFrame::call(const NyxValue& argument) {
+    arguments[0] = argument;
+    return invoke();
+}
+
+NyxValue CallbackFrame::call(const NyxValue& first, const NyxValue& second) {
+    arguments[0] = first;
+    arguments[1] = second;
+    return invoke();
+}
+
+void CallbackFrame::gcTraverse(GcVisitor& visitor) const {
+    gcTraverseValue(callee, visitor);
+    visitor.visit(scope.get());
+}
+
+void CallbackFrame::gcClear() {
+    callee = NyxValue();
+    function = nullptr;
+    scope.reset();
+}
+
+NyxValue CallbackFrame::invoke() {
+    if (!function) {
+        const NyxNativeFunction& native = *std::get<NativeFunctionPtr>(callee.data);
+        return native.callback(interpreter, arguments);
+    }
+
+    const auto& params = function->declaration_node->params;
+    if (!scope) {
+        scope = std::make_shared<Environment>(function->closure_environment);
+    }
+    for (size_t i = 0; i < params.size(); ++i) {
+        scope->define(params[i].lexeme, arguments[i]);
+    }
+    NyxValue result;
+    try {
+        result = interpreter.executeFunctionIn(*function, scope);
+    } catch (...) {
+        scope.reset();
+        throw;
+    }
+    if (scope.use_count() != 1 || scope->localBindings().size() != params.size()) {
+        scope.reset();
+    }
+    return result;
+}
+
+}
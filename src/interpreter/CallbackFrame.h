@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../common/Value.h"
+
+namespace Nyx {
+
+class Interpreter;
+class Environment;
+class NyxDefinedFunction;
+
+// Calls one function value many times, as the std:list higher-order
+// functions do. The callee is checked once, the argument vector is reused,
+// and a user function's scope is reused for the next call as long as the
+// body left nothing behind in it: no closure kept it alive and it declared
+// no locals. Otherwise the next call gets a fresh scope, as any call would.
+class CallbackFrame {
+public:
+    // Throws NyxRuntimeException, naming `function_name`, unless `callee` is
+    // a function that takes `argument_count` arguments.
+    CallbackFrame(Interpreter& interpreter, const NyxValue& callee, size_t argument_count, const std::string& function_name);
+
+    NyxValue call(const NyxValue& argument);
+    NyxValue call(const NyxValue& first, const NyxValue& second);
+
+    Interpreter& owner() const { return interpreter; }
+    // For frames kept inside a collected object, which reports and drops
+    // the frame's references along with its own.
+    void gcTraverse(GcVisitor& visitor) const;
+    void gcClear();
+
+private:
+    NyxValue invoke();
+
+    Interpreter& interpreter;
+    NyxValue callee;
+    const NyxDefinedFunction* function = nullptr; // null for native callees
+    std::vector<NyxValue> arguments;
+    std::shared_ptr<Environment> scope;
+};
+
+}
@@ -0,0 +1,206 @@
+#include "./Channel.h"
+#include "./TaskScheduler.h"
+#include "../common/Utils.h"
+
+#include <cstdint>
+#include <thread>
+
+namespace Nyx {
+
+ChannelMessage::ChannelMessage(const NyxValue& message_value) {
+    if (isThreadNeutral(message_value)) {
+        value = message_value;
+    } else {
+        copy = std::make_unique<ValueSnapshot>(std::vector<NyxValue>{message_value});
+    }
+}
+
+NyxValue ChannelMessage::take() {
+    if (copy) {
+        NyxValue result = copy->materialize()[0];
+        copy.reset();
+        return result;
+    }
+    return std::move(value);
+}
+
+NyxChannel::NyxChannel(size_t capacity) : cell_count(capacity), cells(new Cell[capacity]) {
+    for (size_t i = 0; i < cell_count; ++i) {
+        cells[i].sequence.store(2 * i, std::memory_order_relaxed);
+    }
+}
+
+size_t NyxChannel::size() const {
+    size_t received = recv_position.load(std::memory_order_acquire);
+    size_t sent = send_position.load(std::memory_order_acquire);
+    return sent > received ? sent - received : 0;
+}
+
+// A cell is free for the producer at position p when its sequence is 2p, and
+// holds a message for the consumer at position p when its sequence is 2p + 1.
+// (Doubling keeps "full" and "free for the next lap" apart even when the ring
+// has a single cell.) Claiming a position is a single compare-exchange; the
+// sequence store that follows the copy publishes the cell to the other side.
+bool NyxChannel::trySend(ChannelMessage& message) {
+    if (isClosed()) {
+        throw Common::NyxRuntimeException("Cannot send on a closed channel.", 0);
+    }
+    size_t position = send_position.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = cells[position % cell_count];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto lag = static_cast<std::intptr_t>(sequence - 2 * position);
+        if (lag == 0) {
+            if (send_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.message = std::move(message);
+                cell.sequence.store(2 * position + 1, std::memory_order_release);
+                wakeWaiters();
+                return true;
+            }
+        } else if (lag < 0) {
+            return false; // full
+        } else {
+            position = send_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+NyxChannel::RecvStatus NyxChannel::tryRecv(ChannelMessage& message) {
+    // Check for closing first: a message sent before close() must still be
+    // found by the attempt below.
+    bool was_closed = isClosed();
+    size_t position = recv_position.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = cells[position % cell_count];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto lag = static_cast<std::intptr_t>(sequence - (2 * position + 1));
+        if (lag == 0) {
+            if (recv_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                message = std::move(cell.message);
+                cell.message = ChannelMessage();
+                cell.sequence.store(2 * (position + cell_count), std::memory_order_release);
+                wakeWaiters();
+                return RecvStatus::RECEIVED;
+            }
+        } else if (lag < 0) {
+            return was_closed ? RecvStatus::CLOSED : RecvStatus::EMPTY;
+        } else {
+            position = recv_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool NyxChannel::canSend() const {
+    size_t position = send_position.load(std::memory_order_acquire);
+    size_t sequence = cells[position % cell_count].sequence.load(std::memory_order_acquire);
+    return static_cast<std::intptr_t>(sequence - 2 * position) >= 0;
+}
+
+bool NyxChannel::canRecv() const {
+    size_t position = recv_position.load(std::memory_order_acquire);
+    size_t sequence = cells[position % cell_count].sequence.load(std::memory_order_acquire);
+    return static_cast<std::intptr_t>(sequence - (2 * position + 1)) >= 0;
+}
+
+// Waiters announce themselves before their last check of the buffer, and
+// senders and receivers look for waiters only after changing it; the fences
+// make sure one of the two sides sees the other.
+void NyxChannel::wakeWaiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) > 0) {
+        TaskScheduler::shared().notifyAll();
+    }
+}
+
+// Parking costs a futex sleep and wake-up, far more than one message, so a
+// waiter first yields a few times to let the other side catch up.
+bool NyxChannel::spinUntil(const std::function<bool()>& ready) {
+    for (int attempt = 0; attempt < SPIN_ATTEMPTS; ++attempt) {
+        if (ready()) {
+            return true;
+        }
+        std::this_thread::yield();
+    }
+    return ready();
+}
+
+void NyxChannel::send(ChannelMessage message) {
+    while (!trySend(message)) {
+        if (spinUntil([this]() { return isClosed() || canSend(); })) {
+            continue;
+        }
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        TaskScheduler::shared().waitBlocking([this]() { return isClosed() || canSend(); });
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+NyxChannel::RecvStatus NyxChannel::recv(ChannelMessage& message, Deadline deadline) {
+    while (true) {
+        RecvStatus status = tryRecv(message);
+        if (status != RecvStatus::EMPTY) {
+            return status;
+        }
+        if (spinUntil([this]() { return isClosed() || canRecv(); })) {
+            continue;
+        }
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        bool ready = TaskScheduler::shared().waitBlocking([this]() { return isClosed() || canRecv(); }, deadline);
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+        if (!ready) {
+            return tryRecv(message);
+        }
+    }
+}
+
+void NyxChannel::close() {
+    closed.store(true, std::memory_order_release);
+    TaskScheduler::shared().notifyAll();
+}
+
+long NyxChannel::select(const std::vector<ChannelPtr>& channels, ChannelMessage& message, RecvStatus& status,
+                        Deadline deadline) {
+    // Start each scan one channel further along so that a busy channel early
+    // in the list cannot starve the others.
+    static thread_local size_t rotation = 0;
+    size_t count = channels.size();
+    auto scan = [&]() -> long {
+        size_t start = rotation++;
+        for (size_t offset = 0; offset < count; ++offset) {
+            size_t index = (start + offset) % count;
+            status = channels[index]->tryRecv(message);
+            if (status != RecvStatus::EMPTY) {
+                return static_cast<long>(index);
+            }
+        }
+        return -1;
+    };
+
+    while (true) {
+        long index = scan();
+        if (index >= 0) {
+            return index;
+        }
+        auto any_ready = [&]() {
+            for (const ChannelPtr& channel : channels) {
+                if (channel->isClosed() || channel->canRecv()) return true;
+            }
+            return false;
+        };
+        if (spinUntil(any_ready)) {
+            continue;
+        }
+        for (const ChannelPtr& channel : channels) {
+            channel->waiters.fetch_add(1, std::memory_order_seq_cst);
+        }
+        bool ready = TaskScheduler::shared().waitBlocking(any_ready, deadline);
+        for (const ChannelPtr& channel : channels) {
+            channel->waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (!ready) {
+            return scan();
+        }
+    }
+}
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "./ValueSnapshot.h"
+
+namespace Nyx {
+
+// A value on its way through a channel. Thread-neutral values (numbers,
+// frozen values, channels, ...) travel as they are, which for frozen strings,
+// lists and structs costs one reference count; anything else travels as a
+// deep copy made on the sending thread.
+class ChannelMessage {
+public:
+    ChannelMessage() = default;
+    // Throws NyxRuntimeException for values that cannot leave their isolate.
+    explicit ChannelMessage(const NyxValue& value);
+
+    // Builds the value on the receiving thread.
+    NyxValue take();
+
+private:
+    NyxValue value;
+    std::unique_ptr<ValueSnapshot> copy;
+};
+
+// Bounded multi-producer, multi-consumer channel shared between isolates.
+// The buffer is a lock-free ring (after Dmitry Vyukov's bounded MPMC queue):
+// every cell carries a sequence number that tells producers and consumers
+// whose turn it is, so trySend and tryRecv never take a lock. Blocking
+// operations park through TaskScheduler::waitBlocking and are only woken
+// when someone is actually waiting.
+class NyxChannel {
+public:
+    enum class RecvStatus { RECEIVED, EMPTY, CLOSED };
+    using Deadline = std::optional<std::chrono::steady_clock::time_point>;
+
+    explicit NyxChannel(size_t capacity);
+
+    size_t capacity() const { return cell_count; }
+    // Messages currently buffered; only a hint while others are using it.
+    size_t size() const;
+    bool isClosed() const { return closed.load(std::memory_order_acquire); }
+
+    // Returns false when the buffer is full. Throws when the channel is closed.
+    bool trySend(ChannelMessage& message);
+    // Waits for room. Throws when the channel is or becomes closed.
+    void send(ChannelMessage message);
+    RecvStatus tryRecv(ChannelMessage& message);
+    // Waits for a message; returns CLOSED once the channel is closed and
+    // drained, or EMPTY if the deadline passes first.
+    RecvStatus recv(ChannelMessage& message, Deadline deadline = std::nullopt);
+    // Wakes every waiter; buffered messages can still be received.
+    void close();
+
+    // Waits until one of the channels has a message or is closed and drained,
+    // then receives from it (when several are ready, successive calls start
+    // looking at successive channels). Returns that channel's index, or -1 if
+    // the deadline passes first.
+    static long select(const std::vector<ChannelPtr>& channels, ChannelMessage& message, RecvStatus& status,
+                       Deadline deadline = std::nullopt);
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        ChannelMessage message;
+    };
+
+    static constexpr int SPIN_ATTEMPTS = 32;
+
+    bool canSend() const;
+    bool canRecv() const;
+    void wakeWaiters();
+    static bool spinUntil(const std::function<bool()>& ready);
+
+    size_t cell_count;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> send_position{0};
+    alignas(64) std::atomic<size_t> recv_position{0};
+    alignas(64) std::atomic<size_t> waiters{0};
+    std::atomic<bool> closed{false};
+};
+
+}
@@ -2,13 +2,33 @@
 
 namespace Nyx {
 
-Environment::Environment() : enclosing(nullptr) {}
+namespace {
+    // A std::map node: the key/value pair plus three links and a colour.
+    size_t entryBytes(const std::string& name) {
+        return sizeof(std::pair<const std::string, NyxValue>) + 4 * sizeof(void*) + stringHeapBytes(name);
+    }
+}
+
+Environment::Environment() : enclosing(nullptr), accounted_bytes(sizeof(Environment)) {
+    HeapAccounting::allocate(HeapKind::ENVIRONMENTS, accounted_bytes);
+}
 
 Environment::Environment(std::shared_ptr<Environment> enclosing_scope)
-   : enclosing(std::move(enclosing_scope)) {}
+   : enclosing(std::move(enclosing_scope)), accounted_bytes(sizeof(Environment)) {
+    HeapAccounting::allocate(HeapKind::ENVIRONMENTS, accounted_bytes);
+}
+
+Environment::~Environment() {
+    HeapAccounting::release(HeapKind::ENVIRONMENTS, accounted_bytes);
+}
 
 void Environment::define(const std::string& name, const NyxValue& value) {
-    values[name] = value;
+    auto result = values.insert_or_assign(name, value);
+    if (result.second) {
+        size_t bytes = entryBytes(result.first->first);
+        accounted_bytes += bytes;
+        HeapAccounting::allocate(HeapKind::ENVIRONMENTS, bytes);
+    }
 }
 
 std::optional<NyxValue> Environment::get(const std::string& name) const {
@@ -23,19 +43,49 @@ std::optional<NyxValue> Environment::get(const std::string& name) const {
 }
 
 bool Environment::assign(const std::string& name, const NyxValue& value) {
-    auto it = values.find(name);
-    if (it != values.end()) {
-        values[name] = value;
-        return true;
+    NyxValue* binding = lookup(name);
+    if (!binding) {
+        return false;
     }
-    if (enclosing) {
-        return enclosing->assign(name, value);
+    *binding = value;
+    return true;
+}
+
+bool Environment::assign(const std::string& name, NyxValue&& value) {
+    NyxValue* binding = lookup(name);
+    if (!binding) {
+        return false;
+    }
+    *binding = std::move(value);
+    return true;
+}
+
+NyxValue* Environment::lookup(const std::string& name) {
+    for (Environment* scope = this; scope; scope = scope->enclosing.get()) {
+        auto it = scope->values.find(name);
+        if (it != scope->values.end()) {
+            return &it->second;
+        }
     }
-    return false;
+    return nullptr;
 }
 
 bool Environment::isDefinedLocally(const std::string& name) const {
     return values.count(name) > 0;
 }
 
+void Environment::gcTraverse(GcVisitor& visitor) const {
+    visitor.visit(enclosing.get());
+    for (const auto& entry : values) {
+        gcTraverseValue(entry.second, visitor);
+    }
+}
+
+void Environment::gcClear() {
+    values.clear();
+    enclosing.reset();
+    HeapAccounting::release(HeapKind::ENVIRONMENTS, accounted_bytes - sizeof(Environment));
+    accounted_bytes = sizeof(Environment);
+}
+
 }
@@ -7,19 +7,29 @@
 
 namespace Nyx {
 
-class Environment {
+class Environment : public GcObject {
 public:
     Environment();
     explicit Environment(std::shared_ptr<Environment> enclosing_scope);
+    ~Environment() override;
 
     void define(const std::string& name, const NyxValue& value);
     std::optional<NyxValue> get(const std::string& name) const;
     bool assign(const std::string& name, const NyxValue& value);
+    bool assign(const std::string& name, NyxValue&& value);
+    // The binding of `name` in this scope or an enclosing one, or null. Stays
+    // valid until the binding's scope is destroyed or cleared.
+    NyxValue* lookup(const std::string& name);
     bool isDefinedLocally(const std::string& name) const;
+    const std::map<std::string, NyxValue>& localBindings() const { return values; }
+
+    void gcTraverse(GcVisitor& visitor) const override;
+    void gcClear() override;
 
     std::shared_ptr<Environment> enclosing;
 private:
     std::map<std::string, NyxValue> values;
+    size_t accounted_bytes = 0; // object plus map nodes, reported as HeapKind::ENVIRONMENTS
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,627 @@
+#include "./EventLoop.h"
+#include "./Interpreter.h"
+#include "./TaskScheduler.h"
+#include "../common/Utils.h"
+
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+
+#if defined(_WIN32)
+#include <condition_variable>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#else
+#include <poll.h>
+#endif
+extern char** environ;
+#endif
+
+namespace Nyx {
+
+namespace {
+    // Thrown where a green thread waits, to unwind it when it is cancelled.
+    struct GreenThreadCancelled {};
+
+    thread_local std::unique_ptr<EventLoop> current_loop;
+
+#if !defined(_WIN32)
+    void setNonBlocking(int fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+}
+
+GreenThread::GreenThread(Interpreter& owner_interpreter, NyxValue callee_value, std::vector<NyxValue> call_arguments)
+    : owner(&owner_interpreter), callee(std::move(callee_value)), arguments(std::move(call_arguments)) {
+    HeapAccounting::allocate(HeapKind::FUNCTIONS, sizeof(GreenThread));
+}
+
+GreenThread::~GreenThread() {
+    reportUnobservedFailure();
+    HeapAccounting::release(HeapKind::FUNCTIONS, sizeof(GreenThread));
+}
+
+void GreenThread::reportUnobservedFailure() {
+    if (!error || observed) return;
+    observed = true;
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        std::cerr << "Green thread " << describe() << " failed and was never awaited: " << e.what() << std::endl;
+    } catch (...) {
+    }
+}
+
+NyxValue GreenThread::outcome() {
+    observed = true;
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return result;
+}
+
+std::string GreenThread::describe() const {
+    if (const auto* function = std::get_if<UserDefinedFunctionPtr>(&callee.data); function && *function) {
+        return "<green thread " + (*function)->name() + ">";
+    }
+    if (const auto* native = std::get_if<NativeFunctionPtr>(&callee.data); native && *native) {
+        return "<green thread " + (*native)->name + ">";
+    }
+    return "<green thread>";
+}
+
+void GreenThread::gcTraverse(GcVisitor& visitor) const {
+    gcTraverseValue(callee, visitor);
+    for (const NyxValue& argument : arguments) {
+        gcTraverseValue(argument, visitor);
+    }
+    gcTraverseValue(result, visitor);
+    for (const auto& waiter : waiters) {
+        visitor.visit(waiter.get());
+    }
+}
+
+// Unfinished threads are held by the loop, so only finished ones get here.
+void GreenThread::gcClear() {
+    reportUnobservedFailure();
+    callee = NyxValue();
+    arguments.clear();
+    result = NyxValue();
+    waiters.clear();
+}
+
+// Work finished on other threads, handed back to the loop's thread. The
+// jobs hold the inbox rather than the loop, so a late report is harmless.
+struct EventLoop::Inbox {
+    std::mutex mutex;
+    std::vector<std::function<void()>> callbacks;
+#if defined(_WIN32)
+    std::condition_variable posted;
+#elif defined(__linux__)
+    int wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+    int wake_pipe[2] = {-1, -1};
+#endif
+
+    Inbox() {
+#if !defined(_WIN32) && !defined(__linux__)
+        if (pipe(wake_pipe) == 0) {
+            setNonBlocking(wake_pipe[0]);
+            setNonBlocking(wake_pipe[1]);
+        }
+#endif
+    }
+
+    ~Inbox() {
+#if defined(__linux__)
+        if (wake_fd >= 0) close(wake_fd);
+#elif !defined(_WIN32)
+        if (wake_pipe[0] >= 0) close(wake_pipe[0]);
+        if (wake_pipe[1] >= 0) close(wake_pipe[1]);
+#endif
+    }
+
+    void post(std::function<void()> callback) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            callbacks.push_back(std::move(callback));
+        }
+#if defined(_WIN32)
+        posted.notify_one();
+#elif defined(__linux__)
+        std::uint64_t one = 1;
+        ssize_t ignored = write(wake_fd, &one, sizeof(one));
+        (void)ignored;
+#else
+        char byte = 0;
+        ssize_t ignored = write(wake_pipe[1], &byte, 1);
+        (void)ignored;
+#endif
+    }
+
+    void clearWakeup() {
+#if defined(__linux__)
+        std::uint64_t count;
+        ssize_t ignored = read(wake_fd, &count, sizeof(count));
+        (void)ignored;
+#elif !defined(_WIN32)
+        char bytes[64];
+        while (read(wake_pipe[0], bytes, sizeof(bytes)) > 0) {
+        }
+#endif
+    }
+};
+
+#if !defined(_WIN32)
+struct EventLoop::ChildProcess {
+    pid_t pid = -1;
+    std::string output;
+    bool exited = false;
+    int status = 0;
+};
+#endif
+
+EventLoop& EventLoop::current() {
+    if (!current_loop) {
+        current_loop.reset(new EventLoop());
+    }
+    return *current_loop;
+}
+
+EventLoop* EventLoop::currentIfStarted() {
+    return current_loop.get();
+}
+
+EventLoop::EventLoop() : inbox(std::make_shared<Inbox>()) {
+#if defined(__linux__)
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epoll_fd < 0 || timer_fd < 0 || inbox->wake_fd < 0) {
+        throw Common::NyxRuntimeException("Could not start the event loop.", 0);
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = inbox->wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, inbox->wake_fd, &event);
+    event.data.fd = timer_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &event);
+#endif
+}
+
+EventLoop::~EventLoop() {
+#if !defined(_WIN32)
+    for (const auto& watcher : watchers) {
+        close(watcher.first);
+    }
+#endif
+#if defined(__linux__)
+    close(epoll_fd);
+    close(timer_fd);
+#endif
+}
+
+std::shared_ptr<GreenThread> EventLoop::spawn(Interpreter& owner, NyxValue callee, std::vector<NyxValue> arguments) {
+    auto thread = std::make_shared<GreenThread>(owner, std::move(callee), std::move(arguments));
+    live.insert(thread);
+    thread->queued = true;
+    ready.push_back(thread);
+    return thread;
+}
+
+std::shared_ptr<GreenThread> EventLoop::runningWaiter() const {
+    return running ? std::static_pointer_cast<GreenThread>(running->shared_from_this()) : nullptr;
+}
+
+void EventLoop::wake(const std::shared_ptr<GreenThread>& thread) {
+    if (!thread || thread->finished() || thread->queued || thread.get() == running) return;
+    thread->queued = true;
+    ready.push_back(thread);
+}
+
+void EventLoop::waitUntil(const std::function<bool()>& done) {
+    if (!running) {
+        runUntil(done);
+        return;
+    }
+    if (Fiber::current() != running->fiber.get()) {
+        throw Common::NyxRuntimeException("A green thread cannot wait inside a generator body.", 0);
+    }
+    while (!done()) {
+        suspendRunning();
+    }
+}
+
+void EventLoop::runUntil(const std::function<bool()>& done) {
+    for (;;) {
+        drainInbox();
+        fireDueTimers();
+        if (done()) return;
+        if (!ready.empty()) {
+            // Threads woken by this batch wait for the next one, after timers
+            // and completions have had their turn.
+            for (size_t batch = ready.size(); batch > 0 && !ready.empty(); --batch) {
+                std::shared_ptr<GreenThread> thread = std::move(ready.front());
+                ready.pop_front();
+                resume(thread);
+            }
+            continue;
+        }
+        bool idle = timers.empty() && pending_elsewhere == 0;
+#if !defined(_WIN32)
+        idle = idle && watchers.empty();
+#endif
+        if (idle) {
+            throw Common::NyxRuntimeException("Waiting forever: every green thread is waiting and no timer or I/O is pending.", 0);
+        }
+        waitForEvents(timers.empty() ? std::nullopt : std::optional<Clock::time_point>(timers.top().deadline));
+    }
+}
+
+void EventLoop::resume(const std::shared_ptr<GreenThread>& thread) {
+    thread->queued = false;
+    if (thread->finished()) return;
+    if (!thread->fiber) {
+        GreenThread* body = thread.get();
+        try {
+            thread->fiber = std::make_unique<Fiber>([body]() {
+                try {
+                    body->result = body->owner->callFunction(body->callee, body->arguments, 0);
+                } catch (const GreenThreadCancelled&) {
+                } catch (...) {
+                    body->error = std::current_exception();
+                }
+            });
+        } catch (...) {
+            thread->error = std::current_exception();
+            finish(thread);
+            return;
+        }
+    }
+
+    Interpreter& owner = *thread->owner;
+    std::shared_ptr<Environment> saved_environment = owner.environment;
+    int saved_line = owner.current_line;
+    NyxGenerator* saved_generator = owner.running_generator;
+    owner.running_generator = nullptr;
+    GreenThread* previous = running;
+    running = thread.get();
+    thread->state = GreenThread::State::RUNNING;
+
+    thread->fiber->resume();
+
+    running = previous;
+    owner.environment = std::move(saved_environment);
+    owner.current_line = saved_line;
+    owner.running_generator = saved_generator;
+    if (thread->fiber->finished()) {
+        finish(thread);
+    }
+}
+
+void EventLoop::finish(const std::shared_ptr<GreenThread>& thread) {
+    thread->state = GreenThread::State::FINISHED;
+    thread->fiber.reset();
+    for (const auto& waiter : thread->waiters) {
+        wake(waiter);
+    }
+    thread->waiters.clear();
+    live.erase(thread);
+}
+
+void EventLoop::suspendRunning() {
+    GreenThread& self = *running;
+    Interpreter& owner = *self.owner;
+    std::shared_ptr<Environment> environment = owner.environment;
+    int line = owner.current_line;
+    self.state = GreenThread::State::WAITING;
+    Fiber::suspend();
+    owner.environment = std::move(environment);
+    owner.current_line = line;
+    if (self.cancelling) {
+        throw GreenThreadCancelled{};
+    }
+}
+
+void EventLoop::cancel(const std::shared_ptr<GreenThread>& thread) {
+    if (thread->finished()) return;
+    if (!thread->fiber) {
+        finish(thread);
+        return;
+    }
+    thread->cancelling = true;
+    resume(thread);
+}
+
+void EventLoop::sleepFor(double seconds) {
+    auto fired = std::make_shared<bool>(false);
+    std::shared_ptr<GreenThread> waiter = runningWaiter();
+    auto delay = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    addTimer(Clock::now() + delay, [this, fired, waiter]() {
+        *fired = true;
+        wake(waiter);
+    });
+    waitUntil([&fired]() { return *fired; });
+}
+
+void EventLoop::await(GreenThread& target) {
+    if (target.finished()) return;
+    if (&target == running) {
+        throw Common::NyxRuntimeException("A green thread cannot await itself.", 0);
+    }
+    if (std::shared_ptr<GreenThread> waiter = runningWaiter()) {
+        target.waiters.push_back(std::move(waiter));
+    }
+    waitUntil([&target]() { return target.finished(); });
+}
+
+void EventLoop::runElsewhere(std::function<void()> work) {
+    struct Job {
+        bool done = false;
+        std::exception_ptr error;
+    };
+    auto job = std::make_shared<Job>();
+    // Only the loop's thread may drop a green thread, so the pool holds a
+    // weak reference.
+    std::weak_ptr<GreenThread> waiter = runningWaiter();
+    ++pending_elsewhere;
+    TaskScheduler::shared().submit([job, work = std::move(work), box = inbox, waiter]() {
+        std::exception_ptr error;
+        try {
+            work();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        box->post([job, error, waiter]() {
+            EventLoop& loop = EventLoop::current();
+            --loop.pending_elsewhere;
+            job->done = true;
+            job->error = error;
+            loop.wake(waiter.lock());
+        });
+    });
+    waitUntil([&job]() { return job->done; });
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
+
+void EventLoop::addTimer(Clock::time_point deadline, std::function<void()> fire) {
+    timers.push(Timer{deadline, next_timer_sequence++, std::move(fire)});
+}
+
+bool EventLoop::fireDueTimers() {
+    bool fired = false;
+    Clock::time_point now = Clock::now();
+    while (!timers.empty() && timers.top().deadline <= now) {
+        std::function<void()> fire = std::move(const_cast<Timer&>(timers.top()).fire);
+        timers.pop();
+        fire();
+        fired = true;
+    }
+    return fired;
+}
+
+bool EventLoop::drainInbox() {
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(inbox->mutex);
+        callbacks.swap(inbox->callbacks);
+    }
+    for (auto& callback : callbacks) {
+        callback();
+    }
+    return !callbacks.empty();
+}
+
+void EventLoop::waitForEvents(std::optional<Clock::time_point> deadline) {
+#if defined(__linux__)
+    // steady_clock is CLOCK_MONOTONIC, so deadlines carry over as they are.
+    itimerspec spec{};
+    if (deadline) {
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline->time_since_epoch()).count();
+        if (nanoseconds <= 0) nanoseconds = 1;
+        spec.it_value.tv_sec = static_cast<time_t>(nanoseconds / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+    }
+    timerfd_settime(timer_fd, deadline ? TFD_TIMER_ABSTIME : 0, &spec, nullptr);
+
+    epoll_event events[64];
+    int count = epoll_wait(epoll_fd, events, 64, -1);
+    for (int i = 0; i < count; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == inbox->wake_fd) {
+            inbox->clearWakeup();
+        } else if (fd == timer_fd) {
+            std::uint64_t expirations;
+            ssize_t ignored = read(timer_fd, &expirations, sizeof(expirations));
+            (void)ignored;
+        } else if (auto watcher = watchers.find(fd); watcher != watchers.end()) {
+            std::function<void()> on_readable = watcher->second;
+            on_readable();
+        }
+    }
+#elif !defined(_WIN32)
+    std::vector<pollfd> fds;
+    fds.push_back({inbox->wake_pipe[0], POLLIN, 0});
+    for (const auto& watcher : watchers) {
+        fds.push_back({watcher.first, POLLIN, 0});
+    }
+    int timeout_ms = -1;
+    if (deadline) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*deadline - Clock::now()).count();
+        timeout_ms = remaining > 0 ? static_cast<int>(remaining) : 0;
+    }
+    if (poll(fds.data(), fds.size(), timeout_ms) <= 0) return;
+    if (fds[0].revents) inbox->clearWakeup();
+    for (size_t i = 1; i < fds.size(); ++i) {
+        if (!fds[i].revents) continue;
+        if (auto watcher = watchers.find(fds[i].fd); watcher != watchers.end()) {
+            std::function<void()> on_readable = watcher->second;
+            on_readable();
+        }
+    }
+#else
+    std::unique_lock<std::mutex> lock(inbox->mutex);
+    auto posted = [this]() { return !inbox->callbacks.empty(); };
+    if (deadline) {
+        inbox->posted.wait_until(lock, *deadline, posted);
+    } else {
+        inbox->posted.wait(lock, posted);
+    }
+#endif
+}
+
+void EventLoop::runAll() {
+    if (running) {
+        throw Common::NyxRuntimeException("A green thread cannot wait for all green threads, itself included.", 0);
+    }
+    runUntil([this]() { return live.empty(); });
+}
+
+void EventLoop::finishThreadsOf(const Interpreter& owner) {
+    try {
+        for (;;) {
+            std::vector<std::shared_ptr<GreenThread>> owned;
+            for (const auto& thread : live) {
+                if (thread->owner == &owner) owned.push_back(thread);
+            }
+            if (owned.empty()) return;
+            for (const auto& thread : owned) {
+                await(*thread);
+            }
+        }
+    } catch (...) {
+        // Threads left waiting for something that will never come.
+    }
+    std::vector<std::shared_ptr<GreenThread>> stuck;
+    for (const auto& thread : live) {
+        if (thread->owner == &owner) stuck.push_back(thread);
+    }
+    for (const auto& thread : stuck) {
+        cancel(thread);
+    }
+}
+
+#if !defined(_WIN32)
+
+void EventLoop::watchReadable(int fd, std::function<void()> on_readable) {
+    watchers[fd] = std::move(on_readable);
+#if defined(__linux__)
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+#endif
+}
+
+void EventLoop::unwatch(int fd) {
+#if defined(__linux__)
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+    watchers.erase(fd);
+}
+
+// A child can close its output before it exits, so exit is polled for.
+void EventLoop::reapChild(const std::shared_ptr<ChildProcess>& child, const std::shared_ptr<GreenThread>& waiter) {
+    int wait_status = 0;
+    pid_t reaped = waitpid(child->pid, &wait_status, WNOHANG);
+    if (reaped == 0 || (reaped < 0 && errno == EINTR)) {
+        addTimer(Clock::now() + std::chrono::milliseconds(1), [this, child, waiter]() { reapChild(child, waiter); });
+        return;
+    }
+    if (reaped == child->pid) {
+        child->status = WIFEXITED(wait_status) ? WEXITSTATUS(wait_status) : 128 + WTERMSIG(wait_status);
+    } else {
+        child->status = -1;
+    }
+    child->exited = true;
+    wake(waiter);
+}
+
+void EventLoop::runCommand(const std::string& command, std::string& output, int& status) {
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) {
+        throw Common::NyxRuntimeException("Could not create a pipe for '" + command + "'.", 0);
+    }
+    setNonBlocking(pipe_fds[0]);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, pipe_fds[0]);
+    posix_spawn_file_actions_addclose(&actions, pipe_fds[1]);
+    std::string shell = "/bin/sh";
+    std::string flag = "-c";
+    std::string command_line = command;
+    char* argv[] = {shell.data(), flag.data(), command_line.data(), nullptr};
+
+    auto child = std::make_shared<ChildProcess>();
+    int spawn_error = posix_spawn(&child->pid, shell.c_str(), &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipe_fds[1]);
+    if (spawn_error != 0) {
+        close(pipe_fds[0]);
+        throw Common::NyxRuntimeException("Could not run '" + command + "'.", 0);
+    }
+
+    int fd = pipe_fds[0];
+    std::shared_ptr<GreenThread> waiter = runningWaiter();
+    watchReadable(fd, [this, fd, child, waiter]() {
+        char buffer[65536];
+        for (;;) {
+            ssize_t count = read(fd, buffer, sizeof(buffer));
+            if (count > 0) {
+                child->output.append(buffer, static_cast<size_t>(count));
+                continue;
+            }
+            if (count < 0 && errno == EINTR) continue;
+            if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+            break;
+        }
+        // End of output (or a read error): this lambda is destroyed by
+        // unwatch, so keep what it holds first.
+        std::shared_ptr<ChildProcess> process = child;
+        std::shared_ptr<GreenThread> waiting = waiter;
+        unwatch(fd);
+        close(fd);
+        reapChild(process, waiting);
+    });
+    waitUntil([&child]() { return child->exited; });
+    output = std::move(child->output);
+    status = child->status;
+}
+
+#else
+
+void EventLoop::runCommand(const std::string& command, std::string& output, int& status) {
+    auto collected = std::make_shared<std::string>();
+    auto exit_status = std::make_shared<int>(-1);
+    runElsewhere([command, collected, exit_status]() {
+        FILE* pipe = _popen(command.c_str(), "rb");
+        if (!pipe) {
+            throw Common::NyxRuntimeException("Could not run '" + command + "'.", 0);
+        }
+        char buffer[65536];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+            collected->append(buffer, count);
+        }
+        *exit_status = _pclose(pipe);
+    });
+    output = std::move(*collected);
+    status = *exit_status;
+}
+
+#endif
+
+}
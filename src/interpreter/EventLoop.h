@@ -0,0 +1,149 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../common/Fiber.h"
+#include "../common/Value.h"
+
+namespace Nyx {
+
+class Interpreter;
+
+// A function call running as a green thread (see std:async). It runs on a
+// fiber of the thread that spawned it, in turn with the others, and gives way
+// only where it waits: for a timer, for I/O, or for another green thread.
+class GreenThread : public GcObject {
+public:
+    GreenThread(Interpreter& owner, NyxValue callee, std::vector<NyxValue> arguments);
+    ~GreenThread() override;
+
+    bool finished() const { return state == State::FINISHED; }
+    // The call's result, or rethrows what it threw. Only once finished.
+    NyxValue outcome();
+    std::string describe() const;
+
+    void gcTraverse(GcVisitor& visitor) const override;
+    void gcClear() override;
+
+private:
+    friend class EventLoop;
+    enum class State { READY, RUNNING, WAITING, FINISHED };
+
+    void reportUnobservedFailure();
+
+    Interpreter* owner;
+    NyxValue callee;
+    std::vector<NyxValue> arguments;
+    NyxValue result;
+    std::exception_ptr error;
+    bool observed = false;   // outcome() was read; unread failures are reported
+    std::unique_ptr<Fiber> fiber;
+    State state = State::READY;
+    bool queued = false;     // in the ready queue
+    bool cancelling = false;
+    std::vector<std::shared_ptr<GreenThread>> waiters;
+};
+
+// One per OS thread, like the garbage collector. Green threads that are ready
+// run in the order they became ready; when none is, the loop sleeps until the
+// next timer is due or another thread reports finished work. On Linux it
+// sleeps in epoll, with a timerfd for deadlines (so wakeups are not rounded
+// to milliseconds) and an eventfd for completions. Other POSIX systems use
+// poll(), and Windows a condition variable.
+//
+// Code outside any green thread (the script itself) drives the loop while it
+// waits, so spawned threads make progress exactly when the script waits.
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static EventLoop& current();
+    // The current thread's loop if it has been started, else null.
+    static EventLoop* currentIfStarted();
+    ~EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    std::shared_ptr<GreenThread> spawn(Interpreter& owner, NyxValue callee, std::vector<NyxValue> arguments);
+
+    // Returns once `done()` holds. A green thread is suspended until an event
+    // wakes it; elsewhere the loop runs. Throws NyxRuntimeException if nothing
+    // left could ever make `done()` true, or if called from a generator body
+    // inside a green thread, which cannot be suspended.
+    void waitUntil(const std::function<bool()>& done);
+    void sleepFor(double seconds);
+    void await(GreenThread& target);
+    // Runs `work` on the task pool and waits for it; `work` must not touch
+    // interpreter values. Rethrows what it threw.
+    void runElsewhere(std::function<void()> work);
+    // Runs a shell command and waits for it to exit, collecting its standard
+    // output. `status` is the exit code, or 128 plus the signal that ended it.
+    void runCommand(const std::string& command, std::string& output, int& status);
+
+    // Runs every green thread on this OS thread to completion. Must not be
+    // called from a green thread.
+    void runAll();
+
+    // Runs the green threads spawned by `owner` to completion, then unwinds
+    // any that wait forever. Called when the interpreter ends.
+    void finishThreadsOf(const Interpreter& owner);
+
+private:
+    struct Inbox;
+    struct ChildProcess;
+    struct Timer {
+        Clock::time_point deadline;
+        std::uint64_t sequence;
+        std::function<void()> fire;
+        bool operator>(const Timer& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    EventLoop();
+
+    void runUntil(const std::function<bool()>& done);
+    void resume(const std::shared_ptr<GreenThread>& thread);
+    void finish(const std::shared_ptr<GreenThread>& thread);
+    void suspendRunning();
+    void wake(const std::shared_ptr<GreenThread>& thread);
+    std::shared_ptr<GreenThread> runningWaiter() const;
+    void cancel(const std::shared_ptr<GreenThread>& thread);
+    void addTimer(Clock::time_point deadline, std::function<void()> fire);
+    bool fireDueTimers();
+    bool drainInbox();
+    void waitForEvents(std::optional<Clock::time_point> deadline);
+#if !defined(_WIN32)
+    void watchReadable(int fd, std::function<void()> on_readable);
+    void unwatch(int fd);
+    void reapChild(const std::shared_ptr<ChildProcess>& child, const std::shared_ptr<GreenThread>& waiter);
+#endif
+
+    std::unordered_set<std::shared_ptr<GreenThread>> live;
+    std::deque<std::shared_ptr<GreenThread>> ready;
+    GreenThread* running = nullptr;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::uint64_t next_timer_sequence = 0;
+    size_t pending_elsewhere = 0; // runElsewhere() jobs not yet reported back
+    std::shared_ptr<Inbox> inbox;
+#if !defined(_WIN32)
+    std::unordered_map<int, std::function<void()>> watchers;
+#endif
+#if defined(__linux__)
+    int epoll_fd = -1;
+    int timer_fd = -1;
+#endif
+};
+
+}
@@ -0,0 +1,138 @@
+#include "./Generator.h"
+#include "./Interpreter.h"
+#include "./Environment.h"
+#include "../common/Utils.h"
+
+namespace Nyx {
+
+namespace {
+    // Thrown at a pending yield to unwind a generator that is being dropped.
+    // It is not a NyxRuntimeException, so no Nyx-level handler stops it.
+    struct GeneratorCancelled {};
+}
+
+NyxGenerator::NyxGenerator(const FunctionDeclarationStatement* declaration_node, std::shared_ptr<Environment> function_scope)
+    : declaration(declaration_node), scope(std::move(function_scope)) {
+    HeapAccounting::allocate(HeapKind::FUNCTIONS, sizeof(NyxGenerator));
+}
+
+NyxGenerator::~NyxGenerator() {
+    cancel();
+    HeapAccounting::release(HeapKind::FUNCTIONS, sizeof(NyxGenerator));
+}
+
+std::string NyxGenerator::describe() const {
+    return "<generator " + (declaration ? declaration->name.lexeme : std::string("anonymous")) + ">";
+}
+
+bool NyxGenerator::next(Interpreter& interpreter, NyxValue& item) {
+    if (abandoned) {
+        throw Common::NyxRuntimeException("Generator '" + declaration->name.lexeme +
+                                         "' was stopped when the module that started it finished loading.", 0);
+    }
+    if (state == State::DONE) return false;
+    if (state == State::RUNNING) {
+        throw Common::NyxRuntimeException("Generator '" + declaration->name.lexeme + "' is already running.", 0);
+    }
+
+    // The caller's reference may be the only one, and the body may drop it.
+    std::shared_ptr<GcObject> keep_alive = shared_from_this();
+    if (!fiber) {
+        owner = &interpreter;
+        fiber = std::make_unique<Fiber>([this]() {
+            try {
+                owner->runGeneratorBody(*this);
+            } catch (const GeneratorCancelled&) {
+            }
+        });
+    }
+    owner->suspended_generators.erase(this);
+
+    std::shared_ptr<Environment> caller_environment = owner->environment;
+    int caller_line = owner->current_line;
+    NyxGenerator* caller_generator = owner->running_generator;
+    owner->running_generator = this;
+    state = State::RUNNING;
+    try {
+        fiber->resume();
+    } catch (...) {
+        owner->environment = std::move(caller_environment);
+        owner->current_line = caller_line;
+        owner->running_generator = caller_generator;
+        finish();
+        throw;
+    }
+    owner->environment = std::move(caller_environment);
+    owner->current_line = caller_line;
+    owner->running_generator = caller_generator;
+
+    if (fiber->finished()) {
+        finish();
+        return false;
+    }
+    state = State::SUSPENDED;
+    owner->suspended_generators.insert(this);
+    item = std::move(yielded);
+    yielded = NyxValue();
+    return true;
+}
+
+void NyxGenerator::yield(NyxValue value) {
+    yielded = std::move(value);
+    std::shared_ptr<Environment> body_environment = owner->environment;
+    int body_line = owner->current_line;
+    Fiber::suspend();
+    owner->environment = std::move(body_environment);
+    owner->current_line = body_line;
+    if (cancelling) {
+        throw GeneratorCancelled{};
+    }
+}
+
+void NyxGenerator::cancel() {
+    if (state == State::SUSPENDED) {
+        std::shared_ptr<Environment> caller_environment = owner->environment;
+        int caller_line = owner->current_line;
+        NyxGenerator* caller_generator = owner->running_generator;
+        owner->running_generator = this;
+        state = State::RUNNING;
+        cancelling = true;
+        try {
+            fiber->resume();
+        } catch (...) {
+            // Whatever the unwinding body threw has nowhere to go.
+        }
+        owner->environment = std::move(caller_environment);
+        owner->current_line = caller_line;
+        owner->running_generator = caller_generator;
+    }
+    finish();
+}
+
+void NyxGenerator::abandon() {
+    cancel();
+    abandoned = true;
+}
+
+void NyxGenerator::finish() {
+    if (owner) {
+        owner->suspended_generators.erase(this);
+        owner = nullptr;
+    }
+    state = State::DONE;
+    fiber.reset();
+    scope.reset();
+    yielded = NyxValue();
+}
+
+// While the body is suspended its frames also hold the scope, so the
+// collector counts everything the body can reach as in use.
+void NyxGenerator::gcTraverse(GcVisitor& visitor) const {
+    visitor.visit(scope.get());
+}
+
+void NyxGenerator::gcClear() {
+    cancel();
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "../common/Fiber.h"
+#include "../common/Iterator.h"
+#include "../parser/AstNodes.h"
+
+namespace Nyx {
+
+class Interpreter;
+class Environment;
+
+// The iterator returned by calling a function that contains `yield`. The body
+// runs on a fiber of its own, a step at a time: each next() runs it up to its
+// following yield, or to its end. Nothing runs until the first next().
+//
+// A started generator belongs to the interpreter that first resumed it, since
+// that interpreter's frames are on its stack. Dropping a suspended generator,
+// or the interpreter it belongs to, unwinds its body at the pending yield.
+// The collector cannot see the references on a suspended body's stack, so it
+// counts them as outside ones: a suspended generator that is only held by a
+// cycle running through its own scope stays until its interpreter ends.
+class NyxGenerator : public NyxIterator {
+public:
+    NyxGenerator(const FunctionDeclarationStatement* declaration, std::shared_ptr<Environment> scope);
+    ~NyxGenerator() override;
+
+    bool next(Interpreter& interpreter, NyxValue& item) override;
+    std::string describe() const override;
+
+    // Called by the body's `yield`: hands `value` to next() and waits to be
+    // resumed.
+    void yield(NyxValue value);
+    // Unwinds a suspended body and releases it; next() then throws.
+    void abandon();
+
+    void gcTraverse(GcVisitor& visitor) const override;
+    void gcClear() override;
+
+private:
+    friend class Interpreter;
+    enum class State { READY, RUNNING, SUSPENDED, DONE };
+
+    void cancel();
+    void finish();
+
+    const FunctionDeclarationStatement* declaration;
+    std::shared_ptr<Environment> scope;
+    std::unique_ptr<Fiber> fiber;
+    Interpreter* owner = nullptr;
+    NyxValue yielded;
+    State state = State::READY;
+    bool cancelling = false;
+    bool abandoned = false;
+};
+
+}
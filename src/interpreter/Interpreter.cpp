@@ -1,43 +1,164 @@
 #include "./Interpreter.h"
+#include "./ModuleCache.h"
+#include "./TaskScheduler.h"
+#include "./Generator.h"
+#include "./EventLoop.h"
 #include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <sstream> 
 #include <fstream>
 #include <filesystem>
+#include <set>
 #include "../common/ControlFlow.h"
+#include "../common/Fiber.h"
+#include "../common/HashTable.h"
+#include "../common/Iterator.h"
+#include "../common/NumericArray.h"
+#include "../common/Bytes.h"
 #include "../tokenizer/Tokenizer.h"
 #include "../parser/Parser.h"
 #include "../stdlib/native_stdlib.h"
+#include "../stdlib/native_module_table.h"
 
 namespace Nyx {
 
-std::map<std::string, NyxValue> Interpreter::loaded_modules_cache;
-std::map<std::string, Interpreter::NativeModuleBuilder> Interpreter::native_module_builders;
-bool Interpreter::core_modules_registered = false;
+namespace {
+    // Resolves an array or bytes subscript, counting negative indices from
+    // the end as lists do.
+    size_t packedElementIndex(const char* kind, size_t size, const NyxValue& index_value, int line) {
+        if (!std::holds_alternative<double>(index_value.data)) {
+            throw Common::NyxRuntimeException(std::string(kind) + " index must be a number.", line);
+        }
+        double raw_index = std::get<double>(index_value.data);
+        if (std::trunc(raw_index) != raw_index) {
+            throw Common::NyxRuntimeException(std::string(kind) + " index must be an integer.", line);
+        }
+        long long requested_index = static_cast<long long>(raw_index);
+        long long array_size = static_cast<long long>(size);
+        long long effective_index = requested_index < 0 ? array_size + requested_index : requested_index;
+        if (effective_index < 0 || effective_index >= array_size) {
+            throw Common::NyxRuntimeException(std::string(kind) + " index out of bounds. Requested: " + std::to_string(requested_index) +
+                                             ", Size: " + std::to_string(array_size), line);
+        }
+        return static_cast<size_t>(effective_index);
+    }
+
+    size_t arrayElementIndex(const NyxNumericArray& array, const NyxValue& index_value, int line) {
+        return packedElementIndex("Array", array.size(), index_value, line);
+    }
+
+    size_t bytesElementIndex(const NyxBytes& bytes, const NyxValue& index_value, int line) {
+        return packedElementIndex("Bytes", bytes.size(), index_value, line);
+    }
+
+    // How a missing map key is shown in errors: strings quoted, as maps print them.
+    std::string describeMapKey(const NyxValue& key) {
+        if (const auto* text = std::get_if<std::string>(&key.data)) return "\"" + *text + "\"";
+        return nyxValueToString(key);
+    }
+
+    enum class Effects { NONE, MODULE_LOADS, ANY };
+
+    // What evaluating `expr` might change. Reading a module member can run the
+    // module's top-level code the first time; other reads change nothing.
+    Effects effectsOf(const Expression& expr) {
+        if (dynamic_cast<const LiteralExpression*>(&expr) || dynamic_cast<const IdentifierExpression*>(&expr)) {
+            return Effects::NONE;
+        }
+        if (const auto* unary = dynamic_cast<const UnaryExpression*>(&expr)) {
+            return effectsOf(*unary->right);
+        }
+        if (const auto* binary = dynamic_cast<const BinaryExpression*>(&expr)) {
+            return std::max(effectsOf(*binary->left), effectsOf(*binary->right));
+        }
+        if (const auto* len_expr = dynamic_cast<const LenExpression*>(&expr)) {
+            return effectsOf(*len_expr->argument);
+        }
+        if (const auto* subscript = dynamic_cast<const SubscriptExpression*>(&expr)) {
+            return std::max(effectsOf(*subscript->object), effectsOf(*subscript->index));
+        }
+        if (const auto* member = dynamic_cast<const MemberAccessExpression*>(&expr)) {
+            return std::max(Effects::MODULE_LOADS, effectsOf(*member->object));
+        }
+        return Effects::ANY;
+    }
+}
 
-Interpreter::Interpreter() {
+std::map<std::string, const NativeModuleTable*> Interpreter::native_module_tables;
+std::mutex Interpreter::native_module_tables_mutex;
+
+Interpreter::Interpreter() : Interpreter(std::make_shared<ModuleRegistry>(), std::make_shared<TaskGroup>()) {
+}
+
+Interpreter::Interpreter(std::shared_ptr<ModuleRegistry> module_registry, std::shared_ptr<TaskGroup> tasks)
+    : modules(std::move(module_registry)), task_group(std::move(tasks)) {
     globals = std::make_shared<Environment>();
     environment = globals;
     current_script_directory = "";
 
-    if (!core_modules_registered) {
-        registerNyxStandardLibrary(*this);
-        core_modules_registered = true;
+    static std::once_flag core_modules_registered;
+    std::call_once(core_modules_registered, [this]() { registerNyxStandardLibrary(*this); });
+}
+
+Interpreter::~Interpreter() {
+    // Green threads and started generators run on stacks that go through
+    // this interpreter, so they cannot outlive it.
+    if (EventLoop* loop = EventLoop::currentIfStarted()) {
+        loop->finishThreadsOf(*this);
+    }
+    while (!suspended_generators.empty()) {
+        NyxGenerator* generator = *suspended_generators.begin();
+        std::shared_ptr<GcObject> keep_alive = generator->shared_from_this();
+        generator->abandon();
+    }
+    if (is_module_interpreter) {
+        return;
     }
+    // Tasks spawned from here run code (and read ASTs) owned by this
+    // interpreter, so they have to finish first.
+    task_group->wait();
+
+    // Globals and the functions defined in them refer to each other. Drop this
+    // interpreter's roots and reclaim those cycles now, so a thread that runs
+    // many scripts in turn does not carry the previous ones until its next
+    // full collection.
+    environment.reset();
+    globals.reset();
+    modules.reset();
+    main_ast_program.clear();
+    GarbageCollector::current().collect();
 }
 
-void Interpreter::registerNativeModule(const std::string& name, NativeModuleBuilder builder) {
-    native_module_builders[name] = builder;
+void Interpreter::registerNativeModule(const std::string& name, const NativeModuleTable& table) {
+    std::lock_guard<std::mutex> lock(native_module_tables_mutex);
+    native_module_tables[name] = &table;
+}
+
+const NativeModuleTable* Interpreter::findNativeModule(const std::string& name) {
+    std::lock_guard<std::mutex> lock(native_module_tables_mutex);
+    auto it = native_module_tables.find(name);
+    return it != native_module_tables.end() ? it->second : nullptr;
 }
 
 NyxValue Interpreter::evaluate(const Expression& expr) {
+    current_line = expr.token.line;
     return expr.accept(*this);
 }
 
 void Interpreter::execute(const Statement& stmt) {
+    safepoint();
     stmt.accept(*this);
 }
 
+void Interpreter::safepoint() {
+    GarbageCollector::current().collectIfNeeded();
+    if (HeapAccounting::overLimit()) {
+        HeapAccounting::enforceLimit(current_line);
+    }
+}
+
 bool Interpreter::isDoubleInteger(double n) const {
     return std::trunc(n) == n;
 }
@@ -57,6 +178,32 @@ bool Interpreter::isTruthy(const NyxValue& value_holder) const {
     if (std::holds_alternative<SDLFontNyxPtr>(value)) return std::get<SDLFontNyxPtr>(value) != nullptr;
     if (std::holds_alternative<SDLSurfaceNyxPtr>(value)) return std::get<SDLSurfaceNyxPtr>(value) != nullptr;
     if (std::holds_alternative<SDLTextureNyxPtr>(value)) return std::get<SDLTextureNyxPtr>(value) != nullptr;
+    if (std::holds_alternative<TaskFuturePtr>(value)) return std::get<TaskFuturePtr>(value) != nullptr;
+    if (std::holds_alternative<FrozenValuePtr>(value)) {
+        const auto& frozen = std::get<FrozenValuePtr>(value);
+        if (!frozen) return false;
+        if (frozen->kind == NyxFrozenValue::Kind::STRING) return !frozen->text.empty();
+        if (frozen->kind == NyxFrozenValue::Kind::LIST) return !frozen->elements.empty();
+        return true;
+    }
+    if (std::holds_alternative<ChannelPtr>(value)) return std::get<ChannelPtr>(value) != nullptr;
+    if (std::holds_alternative<NumericArrayPtr>(value)) {
+        const auto& array = std::get<NumericArrayPtr>(value);
+        return array && array->size() > 0;
+    }
+    if (std::holds_alternative<MapPtr>(value)) {
+        const auto& map = std::get<MapPtr>(value);
+        return map && map->table.size() > 0;
+    }
+    if (std::holds_alternative<SetPtr>(value)) {
+        const auto& set = std::get<SetPtr>(value);
+        return set && set->table.size() > 0;
+    }
+    if (std::holds_alternative<IteratorPtr>(value)) return true;
+    if (std::holds_alternative<GreenThreadPtr>(value)) return true;
+    if (std::holds_alternative<FilePtr>(value)) return true;
+    if (const auto* bytes = std::get_if<BytesPtr>(&value)) return *bytes && (*bytes)->size() > 0;
+    if (std::holds_alternative<RegexPtr>(value)) return true;
     return false;
 }
 
@@ -64,6 +211,14 @@ bool Interpreter::isEqual(const NyxValue& a_holder, const NyxValue& b_holder) co
     const auto& a_data = a_holder.data;
     const auto& b_data = b_holder.data;
 
+    // A frozen value equals its ordinary counterpart.
+    const auto* frozen_a = std::get_if<FrozenValuePtr>(&a_data);
+    const auto* frozen_b = std::get_if<FrozenValuePtr>(&b_data);
+    if (frozen_a || frozen_b) {
+        if (frozen_a && frozen_b && *frozen_a == *frozen_b) return true;
+        return isEqual(frozen_a ? thawValue(a_holder) : a_holder, frozen_b ? thawValue(b_holder) : b_holder);
+    }
+
     if (a_data.index() != b_data.index()) return false;
 
     if (std::holds_alternative<std::monostate>(a_data)) return true;
@@ -104,6 +259,36 @@ bool Interpreter::isEqual(const NyxValue& a_holder, const NyxValue& b_holder) co
     if (std::holds_alternative<SDLTextureNyxPtr>(a_data)) {
         return std::get<SDLTextureNyxPtr>(a_data) == std::get<SDLTextureNyxPtr>(b_data);
     }
+    if (std::holds_alternative<TaskFuturePtr>(a_data)) {
+        return std::get<TaskFuturePtr>(a_data) == std::get<TaskFuturePtr>(b_data);
+    }
+    if (std::holds_alternative<ChannelPtr>(a_data)) {
+        return std::get<ChannelPtr>(a_data) == std::get<ChannelPtr>(b_data);
+    }
+    if (std::holds_alternative<NumericArrayPtr>(a_data)) {
+        return std::get<NumericArrayPtr>(a_data) == std::get<NumericArrayPtr>(b_data);
+    }
+    if (std::holds_alternative<MapPtr>(a_data)) {
+        return std::get<MapPtr>(a_data) == std::get<MapPtr>(b_data);
+    }
+    if (std::holds_alternative<SetPtr>(a_data)) {
+        return std::get<SetPtr>(a_data) == std::get<SetPtr>(b_data);
+    }
+    if (std::holds_alternative<IteratorPtr>(a_data)) {
+        return std::get<IteratorPtr>(a_data) == std::get<IteratorPtr>(b_data);
+    }
+    if (std::holds_alternative<GreenThreadPtr>(a_data)) {
+        return std::get<GreenThreadPtr>(a_data) == std::get<GreenThreadPtr>(b_data);
+    }
+    if (std::holds_alternative<FilePtr>(a_data)) {
+        return std::get<FilePtr>(a_data) == std::get<FilePtr>(b_data);
+    }
+    if (std::holds_alternative<BytesPtr>(a_data)) {
+        return std::get<BytesPtr>(a_data) == std::get<BytesPtr>(b_data);
+    }
+    if (std::holds_alternative<RegexPtr>(a_data)) {
+        return std::get<RegexPtr>(a_data) == std::get<RegexPtr>(b_data);
+    }
     
     return false;
 }
@@ -131,6 +316,11 @@ void Interpreter::executeBlock(const std::vector<std::unique_ptr<Statement>>& st
 
 
 void Interpreter::visitExpressionStatement(const ExpressionStatement& stmt) {
+    if (const auto* assignment = dynamic_cast<const AssignmentExpression*>(stmt.expression.get())) {
+        current_line = assignment->token.line;
+        assign(*assignment, false);
+        return;
+    }
     evaluate(*stmt.expression);
 }
 
@@ -188,7 +378,25 @@ void Interpreter::visitReturnStatement(const ReturnStatement& stmt) {
     throw Common::NyxReturnSignal(value);
 }
 
-std::string Interpreter::resolveModulePath(const std::string& importing_file_dir, const std::string& module_path_literal) const {
+void Interpreter::visitYieldStatement(const YieldStatement& stmt) {
+    NyxValue value = evaluate(*stmt.value);
+    if (!running_generator) {
+        throw Common::NyxRuntimeException("'yield' outside a running generator.", stmt.keyword.line);
+    }
+    running_generator->yield(std::move(value));
+}
+
+void Interpreter::runGeneratorBody(NyxGenerator& generator) {
+    environment = generator.scope;
+    try {
+        for (const auto& stmt_ptr : generator.declaration->body->statements) {
+            if (stmt_ptr) execute(*stmt_ptr);
+        }
+    } catch (const Common::NyxReturnSignal&) {
+    }
+}
+
+std::string Interpreter::resolveModulePath(const std::string& importing_file_dir, const std::string& module_path_literal) {
     std::filesystem::path raw_module_path(module_path_literal);
     std::filesystem::path base_import_dir(importing_file_dir);
     std::filesystem::path combined_path;
@@ -210,55 +418,143 @@ std::string Interpreter::resolveModulePath(const std::string& importing_file_dir
 }
 
 void Interpreter::visitImportStatement(const ImportStatement& stmt) {
-    std::string module_path_or_name = stmt.path_literal.lexeme;
+    std::string module_key = stmt.path_literal.lexeme;
 
-    if (module_path_or_name.rfind("std:", 0) == 0) {
-        auto it_cache = loaded_modules_cache.find(module_path_or_name);
-        if (it_cache != loaded_modules_cache.end()) {
-            environment->define(stmt.alias_name.lexeme, it_cache->second);
-            return;
+    if (module_key.rfind("std:", 0) == 0) {
+        if (!findNativeModule(module_key)) {
+            throw Common::NyxRuntimeException("Unknown native module: '" + module_key + "'.", stmt.path_literal.line);
+        }
+    } else {
+        try {
+            module_key = resolveModulePath(this->current_script_directory, module_key);
+        } catch (const Common::NyxRuntimeException& e) {
+            throw Common::NyxRuntimeException(e.what(), stmt.path_literal.line);
         }
+    }
 
-        auto builder_it = native_module_builders.find(module_path_or_name);
-        if (builder_it != native_module_builders.end()) {
-            std::shared_ptr<Environment> module_env = builder_it->second();
-            
-            auto module_data = std::make_shared<NyxModuleData>();
-            module_data->environment = module_env;
-            module_data->path = module_path_or_name;
-            
-            NyxValue module_val(module_data);
-            loaded_modules_cache[module_path_or_name] = module_val;
-            environment->define(stmt.alias_name.lexeme, module_val);
-            return;
+    auto it_cache = modules->loaded_modules.find(module_key);
+    if (it_cache != modules->loaded_modules.end()) {
+        const NyxModule& cached_module = std::get<NyxModule>(it_cache->second.data);
+        if (!stmt.is_lazy) {
+            if (cached_module->load_state == NyxModuleData::LoadState::LOADING) {
+                throw Common::NyxRuntimeException("Circular import of module '" + module_key + "'.", stmt.path_literal.line);
+            }
+            ensureModuleLoaded(*cached_module, stmt.path_literal.line);
+        }
+        environment->define(stmt.alias_name.lexeme, it_cache->second);
+        return;
+    }
+
+    auto module_data = std::make_shared<NyxModuleData>();
+    module_data->path = module_key;
+    module_data->load_state = NyxModuleData::LoadState::PENDING;
+    module_data->importer_globals = this->globals;
+    module_data->import_line = stmt.path_literal.line;
+
+    NyxValue module_val(module_data);
+    modules->loaded_modules[module_key] = module_val;
+
+    if (!stmt.is_lazy) {
+        try {
+            loadModule(*module_data);
+        } catch (...) {
+            modules->loaded_modules.erase(module_key);
+            throw;
+        }
+    }
+    environment->define(stmt.alias_name.lexeme, module_val);
+}
+
+void Interpreter::loadModule(NyxModuleData& module_data) {
+    module_data.load_state = NyxModuleData::LoadState::LOADING;
+    std::shared_ptr<Environment> importer_globals = std::move(module_data.importer_globals);
+
+    try {
+        if (module_data.path.rfind("std:", 0) == 0) {
+            module_data.native_table = findNativeModule(module_data.path);
         } else {
-            throw Common::NyxRuntimeException("Unknown native module: '" + module_path_or_name + "'.", stmt.path_literal.line);
+            interpretModule(module_data, loadModuleProgram(module_data.path, module_data.import_line), importer_globals);
         }
+    } catch (...) {
+        module_data.load_state = NyxModuleData::LoadState::FAILED;
+        throw;
+    }
+    module_data.load_state = NyxModuleData::LoadState::LOADED;
+}
+
+void Interpreter::ensureModuleLoaded(NyxModuleData& module_data, int access_line) {
+    switch (module_data.load_state) {
+        case NyxModuleData::LoadState::LOADED:
+            return;
+        case NyxModuleData::LoadState::LOADING:
+            throw Common::NyxRuntimeException("Module '" + module_data.path + "' was accessed while it is still loading (circular import).", access_line);
+        case NyxModuleData::LoadState::FAILED:
+            throw Common::NyxRuntimeException(module_data.load_error, access_line);
+        case NyxModuleData::LoadState::PENDING:
+            break;
     }
 
-    std::string resolved_path_str;
     try {
-        resolved_path_str = resolveModulePath(this->current_script_directory, module_path_or_name);
-    } catch (const Common::NyxRuntimeException& e) {
-        throw Common::NyxRuntimeException(e.what(), stmt.path_literal.line);
+        loadModule(module_data);
+    } catch (const Common::NyxException& e) {
+        module_data.load_error = "Deferred load of module '" + module_data.path + "' (lazily imported at line " +
+                                 std::to_string(module_data.import_line) + ") failed: " + e.what();
+        throw Common::NyxRuntimeException(module_data.load_error, access_line);
     }
-    
-    auto it_cache = loaded_modules_cache.find(resolved_path_str);
-    if (it_cache != loaded_modules_cache.end()) {
-        environment->define(stmt.alias_name.lexeme, it_cache->second);
-        return;
+}
+
+std::optional<NyxValue> Interpreter::getModuleMember(NyxModuleData& module_data, const std::string& name) {
+    if (module_data.environment) {
+        std::optional<NyxValue> member_val = module_data.environment->get(name);
+        if (member_val || !module_data.native_table) {
+            return member_val;
+        }
+    }
+    if (!module_data.native_table) {
+        return std::nullopt;
+    }
+
+    const NativeModuleMember* member = module_data.native_table->find(name);
+    if (!member) {
+        return std::nullopt;
+    }
+    if (!member->callback) {
+        return NyxValue(member->constant);
+    }
+
+    // Functions are created once per module object so repeated lookups keep
+    // returning the same value.
+    if (!module_data.environment) {
+        module_data.environment = std::make_shared<Environment>();
+    }
+    NyxValue function_val(std::make_shared<NyxNativeFunction>(member->name, member->callback, member->arity, member->in_place));
+    module_data.environment->define(name, function_val);
+    return function_val;
+}
+
+std::vector<std::unique_ptr<Statement>> Interpreter::loadModuleProgram(const std::string& resolved_path, int import_line) {
+    auto it_prefetched = modules->prefetched_modules.find(resolved_path);
+    if (it_prefetched != modules->prefetched_modules.end()) {
+        std::cerr << it_prefetched->second.diagnostics;
+        std::vector<std::unique_ptr<Statement>> program = std::move(it_prefetched->second.program);
+        modules->prefetched_modules.erase(it_prefetched);
+        return program;
     }
 
-    std::ifstream file(resolved_path_str);
+    std::ifstream file(resolved_path);
     if (!file.is_open()) {
-        throw Common::NyxRuntimeException("Could not open module file '" + resolved_path_str + "'.", stmt.path_literal.line);
+        throw Common::NyxRuntimeException("Could not open module file '" + resolved_path + "'.", import_line);
     }
     std::string module_source_code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
     file.close();
 
-    NyxValue module_value = interpretModule(module_source_code, resolved_path_str);
-    loaded_modules_cache[resolved_path_str] = module_value;
-    environment->define(stmt.alias_name.lexeme, module_value);
+    try {
+        return compileSource(module_source_code, resolved_path);
+    } catch (const Common::NyxParserException& e) {
+        throw Common::NyxRuntimeException("Error tokenizing module '" + resolved_path + "': " + e.what(), 0);
+    } catch (const std::exception& e) {
+        throw Common::NyxRuntimeException("Error parsing module '" + resolved_path + "': " + e.what(), 0);
+    }
 }
 
 void Interpreter::visitTypedefStatement(const TypedefStatement& stmt) {
@@ -323,16 +619,38 @@ void Interpreter::visitForStatement(const ForStatement& stmt) {
 void Interpreter::visitForeachStatement(const ForeachStatement& stmt) {
     NyxValue iterable_value = evaluate(*stmt.iterable_expression);
 
-    if (!std::holds_alternative<NyxList>(iterable_value.data)) {
-        throw Common::NyxRuntimeException("Foreach loop requires a list as iterable.", stmt.iterable_expression->token.line);
+    const NyxList* list_ptr = std::get_if<NyxList>(&iterable_value.data);
+    if (const auto* frozen = std::get_if<FrozenValuePtr>(&iterable_value.data)) {
+        if (*frozen && (*frozen)->kind == NyxFrozenValue::Kind::LIST) list_ptr = &(*frozen)->elements;
+    }
+    const NumericArrayPtr* array_ptr = std::get_if<NumericArrayPtr>(&iterable_value.data);
+    const BytesPtr* bytes_ptr = std::get_if<BytesPtr>(&iterable_value.data);
+    if (bytes_ptr && !*bytes_ptr) bytes_ptr = nullptr;
+    const NyxHashTable* table_ptr = nullptr;
+    if (const auto* map = std::get_if<MapPtr>(&iterable_value.data); map && *map) table_ptr = &(*map)->table;
+    if (const auto* set = std::get_if<SetPtr>(&iterable_value.data); set && *set) table_ptr = &(*set)->table;
+    if (table_ptr) {
+        iterateKeys(stmt, iterable_value, *table_ptr);
+        return;
+    }
+    if (const auto* iterator = std::get_if<IteratorPtr>(&iterable_value.data); iterator && *iterator) {
+        iterateLazily(stmt, **iterator);
+        return;
+    }
+    if (!list_ptr && !(array_ptr && *array_ptr) && !bytes_ptr) {
+        throw Common::NyxRuntimeException("Foreach loop requires a list, array, bytes, map, set or iterator as iterable.", stmt.iterable_expression->token.line);
     }
 
-    const NyxList& list_data = std::get<NyxList>(iterable_value.data);
-
-    for (const NyxValue& item_in_list : list_data) {
+    // Arrays and bytes are read element by element, so the body sees later
+    // changes.
+    size_t item_count = list_ptr ? list_ptr->size() : bytes_ptr ? (*bytes_ptr)->size() : (*array_ptr)->size();
+    for (size_t item_index = 0; item_index < item_count; ++item_index) {
+        if (array_ptr && item_index >= (*array_ptr)->size()) break;
         std::shared_ptr<Environment> loop_iteration_env = std::make_shared<Environment>(environment);
         
-        NyxValue loop_var_value = item_in_list;
+        NyxValue loop_var_value = list_ptr ? (*list_ptr)[item_index]
+                                : bytes_ptr ? NyxValue(static_cast<double>((*bytes_ptr)->get(item_index)))
+                                : NyxValue((*array_ptr)->get(item_index));
 
 
         loop_iteration_env->define(stmt.loop_variable_token.lexeme, loop_var_value);
@@ -355,6 +673,63 @@ void Interpreter::visitForeachStatement(const ForeachStatement& stmt) {
     }
 }
 
+// Walks a map's keys or a set's elements in insertion order. `holder` keeps
+// the map or set alive; the body may change values but not add or remove keys.
+void Interpreter::iterateKeys(const ForeachStatement& stmt, const NyxValue& holder, const NyxHashTable& table) {
+    std::uint64_t layout_version = table.layoutVersion();
+    for (size_t entry = 0; entry < table.entryLimit(); ++entry) {
+        if (!table.isLive(entry)) continue;
+        std::shared_ptr<Environment> loop_iteration_env = std::make_shared<Environment>(environment);
+        loop_iteration_env->define(stmt.loop_variable_token.lexeme, table.keyAt(entry));
+
+        std::shared_ptr<Environment> previous_env = environment;
+        environment = loop_iteration_env;
+        try {
+            execute(*stmt.body_statement);
+        } catch (const Common::NyxBreakSignal&) {
+            environment = previous_env;
+            break;
+        } catch (const Common::NyxContinueSignal&) {
+            environment = previous_env;
+        } catch (...) {
+            environment = previous_env;
+            throw;
+        }
+        environment = previous_env;
+
+        if (table.layoutVersion() != layout_version) {
+            bool is_set = std::holds_alternative<SetPtr>(holder.data);
+            throw Common::NyxRuntimeException(std::string(is_set ? "Set elements" : "Map keys") + " were added or removed during foreach.",
+                                             stmt.iterable_expression->token.line);
+        }
+    }
+}
+
+// Reads an iterator an item at a time; breaking out leaves the rest unread.
+void Interpreter::iterateLazily(const ForeachStatement& stmt, NyxIterator& iterator) {
+    NyxValue item;
+    for (;;) {
+        if (!iterator.next(*this, item)) break;
+        std::shared_ptr<Environment> loop_iteration_env = std::make_shared<Environment>(environment);
+        loop_iteration_env->define(stmt.loop_variable_token.lexeme, std::move(item));
+
+        std::shared_ptr<Environment> previous_env = environment;
+        environment = loop_iteration_env;
+        try {
+            execute(*stmt.body_statement);
+        } catch (const Common::NyxBreakSignal&) {
+            environment = previous_env;
+            break;
+        } catch (const Common::NyxContinueSignal&) {
+            environment = previous_env;
+        } catch (...) {
+            environment = previous_env;
+            throw;
+        }
+        environment = previous_env;
+    }
+}
+
 void Interpreter::visitSwitchStatement(const SwitchStatement& stmt) {
     NyxValue condition_value = evaluate(*stmt.condition);
     int matched_case_index = -1;
@@ -467,15 +842,127 @@ void Interpreter::visitContinueStatement(const ContinueStatement& stmt) {
 }
 
 NyxValue Interpreter::visitAssignmentExpression(const AssignmentExpression& expr) {
-    NyxValue value_to_assign = evaluate(*expr.value);
+    return assign(expr, true);
+}
 
+// `xs = list.append(xs, v)` and `xs = xs + ys` would copy all of xs into a new
+// list and then copy that into the variable, making a loop of appends
+// quadratic. When the value is a list-updating native (or `+`) applied to the
+// variable being assigned, this changes the variable's list where it is
+// instead, so appends take amortized constant time. Returns false, having
+// evaluated nothing, when the assignment does not have that shape.
+//
+// The other operands are evaluated before the variable is read, rather than
+// after; the two orders only differ if those operands reassign the variable.
+bool Interpreter::updateListInPlace(const IdentifierExpression& target, const Expression& value_expr) {
+    if (const auto* call = dynamic_cast<const CallExpression*>(&value_expr)) {
+        if (call->arguments.empty()) return false;
+        const auto* first = dynamic_cast<const IdentifierExpression*>(call->arguments[0].get());
+        if (!first || first->name != target.name) return false;
+        // Only callees that can be evaluated twice harmlessly, in case this
+        // turns out not to be an updating native.
+        const auto* member = dynamic_cast<const MemberAccessExpression*>(call->callee.get());
+        if (!dynamic_cast<const IdentifierExpression*>(member ? member->object.get() : call->callee.get())) return false;
+
+        NyxValue callee = evaluate(*call->callee);
+        const auto* native_ptr = std::get_if<NativeFunctionPtr>(&callee.data);
+        if (!native_ptr || !*native_ptr || !(*native_ptr)->in_place) return false;
+        const NyxNativeFunction& native_function = **native_ptr;
+
+        std::vector<NyxValue> rest_args;
+        rest_args.reserve(call->arguments.size() - 1);
+        for (size_t i = 1; i < call->arguments.size(); ++i) {
+            rest_args.push_back(evaluate(*call->arguments[i]));
+        }
+        if (native_function.arity != -1 && call->arguments.size() != static_cast<size_t>(native_function.arity)) {
+            throw Common::NyxRuntimeException(
+                "Native function '" + native_function.name + "' expected " + std::to_string(native_function.arity) +
+                " arguments but got " + std::to_string(call->arguments.size()) + ".",
+                call->paren.line);
+        }
+        NyxValue* binding = environment->lookup(target.name);
+        if (!binding) {
+            throw Common::NyxRuntimeException("Undefined variable '" + target.name + "'.", first->token.line);
+        }
+        native_function.in_place(*this, *binding, rest_args);
+        return true;
+    }
+
+    if (const auto* binary = dynamic_cast<const BinaryExpression*>(&value_expr)) {
+        if (binary->operator_token.type != TokenType::PLUS) return false;
+        const auto* left = dynamic_cast<const IdentifierExpression*>(binary->left.get());
+        if (!left || left->name != target.name) return false;
+        NyxValue* binding = environment->lookup(target.name);
+        if (!binding || !std::holds_alternative<NyxList>(binding->data)) return false;
+
+        NyxValue addition = evaluate(*binary->right);
+        if (std::holds_alternative<FrozenValuePtr>(addition.data)) addition = thawValue(addition);
+        binding = environment->lookup(target.name);
+        if (!binding || !std::holds_alternative<NyxList>(binding->data) || !std::holds_alternative<NyxList>(addition.data)) {
+            throw Common::NyxRuntimeException("Operands for '+' must be two numbers, two strings, or two lists.", binary->operator_token.line);
+        }
+        const NyxList& elements = std::get<NyxList>(addition.data);
+        HeapAccounting::checkAllocation(elements.size() * sizeof(NyxValue), binary->operator_token.line);
+        editListInPlace(*binding, [&](NyxList& list) { list.insert(list.end(), elements.begin(), elements.end()); });
+        return true;
+    }
+    return false;
+}
+
+NyxValue Interpreter::assign(const AssignmentExpression& expr, bool want_result) {
     if (auto id_target = dynamic_cast<const IdentifierExpression*>(expr.target.get())) {
-        if (!environment->assign(id_target->name, value_to_assign)) {
+        if (updateListInPlace(*id_target, *expr.value)) {
+            return want_result ? *environment->lookup(id_target->name) : NyxValue();
+        }
+        NyxValue value_to_assign = evaluate(*expr.value);
+        NyxValue* binding = environment->lookup(id_target->name);
+        if (!binding) {
             throw Common::NyxRuntimeException("Undefined variable '" + id_target->name + "' in assignment.", id_target->token.line);
         }
-    } else if (auto sub_target = dynamic_cast<const SubscriptExpression*>(expr.target.get())) {
+        if (!want_result) {
+            *binding = std::move(value_to_assign);
+            return NyxValue();
+        }
+        *binding = value_to_assign;
+        return value_to_assign;
+    }
+
+    NyxValue value_to_assign = evaluate(*expr.value);
+
+    if (auto sub_target = dynamic_cast<const SubscriptExpression*>(expr.target.get())) {
         NyxValue list_obj_holder = evaluate(*sub_target->object);
         
+        if (const auto* array = std::get_if<NumericArrayPtr>(&list_obj_holder.data); array && *array) {
+            // Arrays are shared, so they change in place whatever the target expression.
+            size_t element_index = arrayElementIndex(**array, evaluate(*sub_target->index), sub_target->closing_bracket.line);
+            if (!std::holds_alternative<double>(value_to_assign.data)) {
+                throw Common::NyxRuntimeException("Array elements must be numbers, got " + nyxValueTypeToString(value_to_assign) + ".", expr.equals_token.line);
+            }
+            (*array)->set(element_index, std::get<double>(value_to_assign.data));
+            return value_to_assign;
+        }
+        if (const auto* bytes = std::get_if<BytesPtr>(&list_obj_holder.data); bytes && *bytes) {
+            size_t element_index = bytesElementIndex(**bytes, evaluate(*sub_target->index), sub_target->closing_bracket.line);
+            if (!std::holds_alternative<double>(value_to_assign.data)) {
+                throw Common::NyxRuntimeException("Bytes elements must be numbers, got " + nyxValueTypeToString(value_to_assign) + ".", expr.equals_token.line);
+            }
+            (*bytes)->set(element_index, NyxNumericArray::toUInt8(std::get<double>(value_to_assign.data)));
+            return value_to_assign;
+        }
+        if (const auto* map = std::get_if<MapPtr>(&list_obj_holder.data); map && *map) {
+            // Maps are shared too; assigning adds the key if it is missing.
+            NyxValue key = evaluate(*sub_target->index);
+            bool inserted = false;
+            size_t entry = (*map)->table.insert(key, inserted, sub_target->closing_bracket.line);
+            (*map)->table.valueAt(entry) = value_to_assign;
+            return value_to_assign;
+        }
+        if (std::holds_alternative<SetPtr>(list_obj_holder.data)) {
+            throw Common::NyxRuntimeException("Cannot assign to subscript of a set (use map.add).", sub_target->token.line);
+        }
+        if (std::holds_alternative<FrozenValuePtr>(list_obj_holder.data)) {
+            throw Common::NyxRuntimeException("Cannot assign to subscript of a frozen value.", sub_target->token.line);
+        }
         if (!std::holds_alternative<NyxList>(list_obj_holder.data)) {
             throw Common::NyxRuntimeException("Cannot assign to subscript of non-list type.", sub_target->token.line);
         }
@@ -522,10 +1009,23 @@ NyxValue Interpreter::visitAssignmentExpression(const AssignmentExpression& expr
         
         if (std::holds_alternative<NyxModule>(object_val.data)) {
             auto module_data_ptr = std::get<NyxModule>(object_val.data);
-            if (!module_data_ptr || !module_data_ptr->environment) {
+            if (!module_data_ptr) {
                  throw Common::NyxRuntimeException("Invalid module object for member assignment.", member_target->token.line);
             }
-            if (!module_data_ptr->environment->assign(member_target->name.lexeme, value_to_assign)) {
+            ensureModuleLoaded(*module_data_ptr, member_target->name.line);
+            if (module_data_ptr->native_table) {
+                // Assigning to a table member shadows it in this module object's environment.
+                if (!module_data_ptr->environment) {
+                    module_data_ptr->environment = std::make_shared<Environment>();
+                }
+                if (!module_data_ptr->environment->isDefinedLocally(member_target->name.lexeme)) {
+                    std::optional<NyxValue> current_val = getModuleMember(*module_data_ptr, member_target->name.lexeme);
+                    if (current_val) {
+                        module_data_ptr->environment->define(member_target->name.lexeme, *current_val);
+                    }
+                }
+            }
+            if (!module_data_ptr->environment || !module_data_ptr->environment->assign(member_target->name.lexeme, value_to_assign)) {
                 throw Common::NyxRuntimeException("Cannot assign to undefined member '" + member_target->name.lexeme + "' in module '" + module_data_ptr->path + "'.", member_target->name.line);
             }
         } else if (std::holds_alternative<StructInstancePtr>(object_val.data)) {
@@ -543,6 +1043,8 @@ NyxValue Interpreter::visitAssignmentExpression(const AssignmentExpression& expr
                  throw Common::NyxRuntimeException("Field index out of bounds for struct '" + instance_ptr->definition->name + "'. This should not happen.", member_target->name.line);
             }
             instance_ptr->field_values[field_idx] = value_to_assign;
+        } else if (std::holds_alternative<FrozenValuePtr>(object_val.data)) {
+            throw Common::NyxRuntimeException("Cannot assign to field '" + member_target->name.lexeme + "' of a frozen value.", member_target->name.line);
         }
         else {
             throw Common::NyxRuntimeException("Base of member assignment '.' must be a module or a struct instance.", member_target->token.line);
@@ -585,6 +1087,33 @@ NyxValue Interpreter::visitPostfixUpdateExpression(const PostfixUpdateExpression
         return original_value_holder;
     } else if (auto sub_operand = dynamic_cast<const SubscriptExpression*>(expr.operand.get())) {
         NyxValue list_obj_holder = evaluate(*sub_operand->object);
+        if (const auto* array = std::get_if<NumericArrayPtr>(&list_obj_holder.data); array && *array) {
+            size_t element_index = arrayElementIndex(**array, evaluate(*sub_operand->index), sub_operand->closing_bracket.line);
+            double element_value = (*array)->get(element_index);
+            (*array)->set(element_index, expr.operator_token.type == TokenType::PLUS_PLUS ? element_value + 1.0 : element_value - 1.0);
+            return NyxValue(element_value);
+        }
+        if (const auto* bytes = std::get_if<BytesPtr>(&list_obj_holder.data); bytes && *bytes) {
+            size_t element_index = bytesElementIndex(**bytes, evaluate(*sub_operand->index), sub_operand->closing_bracket.line);
+            double element_value = (*bytes)->get(element_index);
+            (*bytes)->set(element_index, NyxNumericArray::toUInt8(expr.operator_token.type == TokenType::PLUS_PLUS ? element_value + 1.0 : element_value - 1.0));
+            return NyxValue(element_value);
+        }
+        if (const auto* map = std::get_if<MapPtr>(&list_obj_holder.data); map && *map) {
+            NyxValue key = evaluate(*sub_operand->index);
+            size_t entry = (*map)->table.find(key, sub_operand->closing_bracket.line);
+            if (entry == NyxHashTable::NOT_FOUND) {
+                throw Common::NyxRuntimeException("Key " + describeMapKey(key) + " not found in map.", sub_operand->closing_bracket.line);
+            }
+            NyxValue& element = (*map)->table.valueAt(entry);
+            if (!std::holds_alternative<double>(element.data)) {
+                throw Common::NyxRuntimeException("Element for '++/--' must be a number.", expr.operator_token.line);
+            }
+            NyxValue element_original_value = element;
+            double element_value = std::get<double>(element.data);
+            element = NyxValue(expr.operator_token.type == TokenType::PLUS_PLUS ? element_value + 1.0 : element_value - 1.0);
+            return element_original_value;
+        }
         if (!std::holds_alternative<NyxList>(list_obj_holder.data)) {
             throw Common::NyxRuntimeException("Operand for '++/--' with subscript must be a list.", sub_operand->token.line);
         }
@@ -649,6 +1178,10 @@ NyxValue Interpreter::visitBinaryExpression(const BinaryExpression& expr) {
     }
 
     NyxValue right_value_holder = evaluate(*expr.right);
+
+    // Operators work on ordinary copies of frozen operands.
+    if (std::holds_alternative<FrozenValuePtr>(left_value_holder.data)) left_value_holder = thawValue(left_value_holder);
+    if (std::holds_alternative<FrozenValuePtr>(right_value_holder.data)) right_value_holder = thawValue(right_value_holder);
     
     const auto& left_data = left_value_holder.data;
     const auto& right_data = right_value_holder.data;
@@ -659,11 +1192,13 @@ NyxValue Interpreter::visitBinaryExpression(const BinaryExpression& expr) {
                 return NyxValue(std::get<double>(left_data) + std::get<double>(right_data));
             }
             if (std::holds_alternative<std::string>(left_data) && std::holds_alternative<std::string>(right_data)) {
+                HeapAccounting::checkAllocation(std::get<std::string>(left_data).size() + std::get<std::string>(right_data).size(), expr.operator_token.line);
                 return NyxValue(std::get<std::string>(left_data) + std::get<std::string>(right_data));
             }
             if (std::holds_alternative<NyxList>(left_data) && std::holds_alternative<NyxList>(right_data)) {
-                NyxList result_list = std::get<NyxList>(left_data);
                 const auto& list_to_add = std::get<NyxList>(right_data);
+                HeapAccounting::checkAllocation((std::get<NyxList>(left_data).size() + list_to_add.size()) * sizeof(NyxValue), expr.operator_token.line);
+                NyxList result_list = std::get<NyxList>(left_data);
                 result_list.insert(result_list.end(), list_to_add.begin(), list_to_add.end());
                 return NyxValue(result_list);
             }
@@ -683,7 +1218,11 @@ NyxValue Interpreter::visitBinaryExpression(const BinaryExpression& expr) {
                 if (!isDoubleInteger(num_operand_double) || num_operand_double < 0) {
                     throw Common::NyxRuntimeException("List repetition count for '*' must be a non-negative integer.", expr.operator_token.line);
                 }
+                if (!list_operand.empty() && num_operand_double * list_operand.size() * sizeof(NyxValue) > static_cast<double>(SIZE_MAX)) {
+                    throw Common::NyxRuntimeException("List repetition result is too large.", expr.operator_token.line);
+                }
                 size_t repeat_count = static_cast<size_t>(num_operand_double);
+                HeapAccounting::checkAllocation(list_operand.size() * repeat_count * sizeof(NyxValue), expr.operator_token.line);
                 NyxList result_list;
                 result_list.reserve(list_operand.size() * repeat_count);
                 for (size_t i = 0; i < repeat_count; ++i) {
@@ -697,7 +1236,11 @@ NyxValue Interpreter::visitBinaryExpression(const BinaryExpression& expr) {
                 if (!isDoubleInteger(num_operand_double) || num_operand_double < 0) {
                     throw Common::NyxRuntimeException("List repetition count for '*' must be a non-negative integer.", expr.operator_token.line);
                 }
+                if (!list_operand.empty() && num_operand_double * list_operand.size() * sizeof(NyxValue) > static_cast<double>(SIZE_MAX)) {
+                    throw Common::NyxRuntimeException("List repetition result is too large.", expr.operator_token.line);
+                }
                 size_t repeat_count = static_cast<size_t>(num_operand_double);
+                HeapAccounting::checkAllocation(list_operand.size() * repeat_count * sizeof(NyxValue), expr.operator_token.line);
                 NyxList result_list;
                 result_list.reserve(list_operand.size() * repeat_count);
                 for (size_t i = 0; i < repeat_count; ++i) {
@@ -770,27 +1313,108 @@ NyxValue Interpreter::visitListLiteralExpression(const ListLiteralExpression& ex
     return NyxValue(elements_values);
 }
 
+NyxValue Interpreter::visitMapLiteralExpression(const MapLiteralExpression& expr) {
+    if (expr.is_set) {
+        auto set = std::make_shared<NyxSet>();
+        for (const auto& element_expr : expr.keys) {
+            bool inserted = false;
+            set->table.insert(evaluate(*element_expr), inserted, element_expr->token.line);
+        }
+        return NyxValue(set);
+    }
+
+    auto map = std::make_shared<NyxMap>();
+    for (size_t i = 0; i < expr.keys.size(); ++i) {
+        NyxValue key = evaluate(*expr.keys[i]);
+        NyxValue value = evaluate(*expr.values[i]);
+        bool inserted = false;
+        size_t entry = map->table.insert(key, inserted, expr.keys[i]->token.line);
+        map->table.valueAt(entry) = std::move(value);
+    }
+    return NyxValue(map);
+}
+
+const NyxValue* Interpreter::borrow(const Expression& expr, NyxValue& scratch) {
+    if (const auto* identifier = dynamic_cast<const IdentifierExpression*>(&expr)) {
+        current_line = identifier->token.line;
+        if (const NyxValue* value = environment->lookup(identifier->name)) {
+            return value;
+        }
+        throw Common::NyxRuntimeException("Undefined variable '" + identifier->name + "'.", identifier->token.line);
+    }
+    if (const auto* subscript = dynamic_cast<const SubscriptExpression*>(&expr)) {
+        return borrowSubscript(*subscript, scratch);
+    }
+    if (const auto* member = dynamic_cast<const MemberAccessExpression*>(&expr)) {
+        return borrowMember(*member, scratch);
+    }
+    scratch = evaluate(expr);
+    return &scratch;
+}
+
 NyxValue Interpreter::visitLenExpression(const LenExpression& expr) {
-    NyxValue argument_value_holder = evaluate(*expr.argument);
-    const auto& arg_data = argument_value_holder.data;
+    NyxValue scratch;
+    const auto& arg_data = borrow(*expr.argument, scratch)->data;
 
+    if (const auto* frozen = std::get_if<FrozenValuePtr>(&arg_data); frozen && *frozen) {
+        if ((*frozen)->kind == NyxFrozenValue::Kind::STRING) return NyxValue(static_cast<double>((*frozen)->text.length()));
+        if ((*frozen)->kind == NyxFrozenValue::Kind::LIST) return NyxValue(static_cast<double>((*frozen)->elements.size()));
+    }
     if (std::holds_alternative<NyxList>(arg_data)) {
         return NyxValue(static_cast<double>(std::get<NyxList>(arg_data).size()));
     } else if (std::holds_alternative<std::string>(arg_data)) {
         return NyxValue(static_cast<double>(std::get<std::string>(arg_data).length()));
+    } else if (const auto* array = std::get_if<NumericArrayPtr>(&arg_data); array && *array) {
+        return NyxValue(static_cast<double>((*array)->size()));
+    } else if (const auto* bytes = std::get_if<BytesPtr>(&arg_data); bytes && *bytes) {
+        return NyxValue(static_cast<double>((*bytes)->size()));
+    } else if (const auto* map = std::get_if<MapPtr>(&arg_data); map && *map) {
+        return NyxValue(static_cast<double>((*map)->table.size()));
+    } else if (const auto* set = std::get_if<SetPtr>(&arg_data); set && *set) {
+        return NyxValue(static_cast<double>((*set)->table.size()));
     }
-    throw Common::NyxRuntimeException("Operand for 'len' must be a list or a string.", expr.token.line);
+    throw Common::NyxRuntimeException("Operand for 'len' must be a list, an array, bytes, a map, a set or a string.", expr.token.line);
 }
 
 NyxValue Interpreter::visitSubscriptExpression(const SubscriptExpression& expr) {
-    NyxValue object_value_holder = evaluate(*expr.object);
-    const auto& object_data = object_value_holder.data;
+    NyxValue scratch;
+    const NyxValue* element = borrowSubscript(expr, scratch);
+    return element == &scratch ? std::move(scratch) : *element;
+}
+
+// Reads the subscripted value without copying the list, map or string it
+// comes from. The object is only borrowed when the index cannot change it;
+// an index that may load a module is evaluated before the object is looked
+// up again, since the module's code could reassign it.
+const NyxValue* Interpreter::borrowSubscript(const SubscriptExpression& expr, NyxValue& scratch) {
+    current_line = expr.token.line;
+    Effects index_effects = effectsOf(*expr.index);
+    NyxValue object_scratch;
+    const NyxValue* object_value = index_effects == Effects::ANY ? &(object_scratch = evaluate(*expr.object))
+                                                                 : borrow(*expr.object, object_scratch);
 
     NyxValue index_value_holder = evaluate(*expr.index);
     const auto& index_data = index_value_holder.data;
+    if (index_effects == Effects::MODULE_LOADS && object_value != &object_scratch) {
+        object_value = borrow(*expr.object, object_scratch);
+    }
+    const auto& object_data = object_value->data;
+    // Values inside a temporary object have to be copied out before it goes.
+    auto result = [&](const NyxValue& value) -> const NyxValue* {
+        if (object_value != &object_scratch) return &value;
+        scratch = value;
+        return &scratch;
+    };
+
+    const NyxList* list_ptr = std::get_if<NyxList>(&object_data);
+    const std::string* str_ptr = std::get_if<std::string>(&object_data);
+    if (const auto* frozen = std::get_if<FrozenValuePtr>(&object_data); frozen && *frozen) {
+        if ((*frozen)->kind == NyxFrozenValue::Kind::LIST) list_ptr = &(*frozen)->elements;
+        if ((*frozen)->kind == NyxFrozenValue::Kind::STRING) str_ptr = &(*frozen)->text;
+    }
 
-    if (std::holds_alternative<NyxList>(object_data)) {
-        const auto& list = std::get<NyxList>(object_data);
+    if (list_ptr) {
+        const auto& list = *list_ptr;
         if (!std::holds_alternative<double>(index_data)) {
             throw Common::NyxRuntimeException("List index must be a number.", expr.closing_bracket.line);
         }
@@ -817,10 +1441,10 @@ NyxValue Interpreter::visitSubscriptExpression(const SubscriptExpression& expr)
                                              ", Size: " + std::to_string(list_size), expr.closing_bracket.line);
         }
         size_t actual_index = static_cast<size_t>(requested_index);
-        return list[actual_index];
+        return result(list[actual_index]);
 
-    } else if (std::holds_alternative<std::string>(object_data)) {
-        const auto& str = std::get<std::string>(object_data);
+    } else if (str_ptr) {
+        const auto& str = *str_ptr;
         if (!std::holds_alternative<double>(index_data)) {
             throw Common::NyxRuntimeException("String index must be a number.", expr.closing_bracket.line);
         }
@@ -847,10 +1471,30 @@ NyxValue Interpreter::visitSubscriptExpression(const SubscriptExpression& expr)
                                              ", Size: " + std::to_string(str_len), expr.closing_bracket.line);
         }
         size_t actual_index = static_cast<size_t>(requested_index);
-        return NyxValue(std::string(1, str[actual_index]));
+        scratch = NyxValue(std::string(1, str[actual_index]));
+        return &scratch;
+    }
+    
+    if (const auto* array = std::get_if<NumericArrayPtr>(&object_data); array && *array) {
+        scratch = NyxValue((*array)->get(arrayElementIndex(**array, index_value_holder, expr.closing_bracket.line)));
+        return &scratch;
+    }
+    if (const auto* bytes = std::get_if<BytesPtr>(&object_data); bytes && *bytes) {
+        scratch = NyxValue(static_cast<double>((*bytes)->get(bytesElementIndex(**bytes, index_value_holder, expr.closing_bracket.line))));
+        return &scratch;
+    }
+    if (const auto* map = std::get_if<MapPtr>(&object_data); map && *map) {
+        size_t entry = (*map)->table.find(index_value_holder, expr.closing_bracket.line);
+        if (entry == NyxHashTable::NOT_FOUND) {
+            throw Common::NyxRuntimeException("Key " + describeMapKey(index_value_holder) + " not found in map.", expr.closing_bracket.line);
+        }
+        return result((*map)->table.valueAt(entry));
+    }
+    if (std::holds_alternative<SetPtr>(object_data)) {
+        throw Common::NyxRuntimeException("Sets cannot be subscripted (use map.has to test membership).", expr.token.line);
     }
     
-    throw Common::NyxRuntimeException("Subscript operator '[]' can only be used on lists or strings.", expr.token.line);
+    throw Common::NyxRuntimeException("Subscript operator '[]' can only be used on lists, arrays, bytes, maps or strings.", expr.token.line);
 }
 
 NyxValue Interpreter::visitInterpolatedStringExpression(const InterpolatedStringExpression& expr) {
@@ -871,58 +1515,78 @@ NyxValue Interpreter::visitInterpolatedStringExpression(const InterpolatedString
 
 NyxValue Interpreter::visitCallExpression(const CallExpression& expr) {
     NyxValue callee_value = evaluate(*expr.callee);
-    const auto& callee_data = callee_value.data;
 
     std::vector<NyxValue> evaluated_args;
     for (const auto& arg_expr : expr.arguments) {
         evaluated_args.push_back(evaluate(*arg_expr));
     }
 
+    return callFunction(callee_value, evaluated_args, expr.paren.line);
+}
+
+NyxValue Interpreter::callFunction(const NyxValue& callee_value, const std::vector<NyxValue>& evaluated_args, int line) {
+    const auto& callee_data = callee_value.data;
+
     if (std::holds_alternative<UserDefinedFunctionPtr>(callee_data)) {
         auto function_ptr = std::get<UserDefinedFunctionPtr>(callee_data);
         if (!function_ptr) {
-             throw Common::NyxRuntimeException("Attempted to call a null function pointer.", expr.paren.line);
+             throw Common::NyxRuntimeException("Attempted to call a null function pointer.", line);
         }
         const NyxDefinedFunction& function = *function_ptr;
         if (evaluated_args.size() != function.arity()) {
             throw Common::NyxRuntimeException("Expected " + std::to_string(function.arity()) +
                                             " arguments but got " + std::to_string(evaluated_args.size()) + ".",
-                                            expr.paren.line);
+                                            line);
         }
         return executeFunctionBody(function, evaluated_args);
     } else if (std::holds_alternative<NativeFunctionPtr>(callee_data)) {
         auto native_func_ptr = std::get<NativeFunctionPtr>(callee_data);
         if (!native_func_ptr) {
-            throw Common::NyxRuntimeException("Attempted to call a null native function pointer.", expr.paren.line);
+            throw Common::NyxRuntimeException("Attempted to call a null native function pointer.", line);
         }
         const NyxNativeFunction& native_function = *native_func_ptr;
         if (native_function.arity != -1 && evaluated_args.size() != static_cast<size_t>(native_function.arity)) {
              throw Common::NyxRuntimeException(
                 "Native function '" + native_function.name + "' expected " + std::to_string(native_function.arity) +
                 " arguments but got " + std::to_string(evaluated_args.size()) + ".",
-                expr.paren.line);
+                line);
         }
         return native_function.callback(*this, evaluated_args);
     }
     
-    throw Common::NyxRuntimeException("Can only call functions or native functions.", expr.paren.line);
+    throw Common::NyxRuntimeException("Can only call functions or native functions.", line);
 }
 
 NyxValue Interpreter::visitMemberAccessExpression(const MemberAccessExpression& expr) {
-    NyxValue object_val = evaluate(*expr.object);
+    NyxValue scratch;
+    const NyxValue* member = borrowMember(expr, scratch);
+    return member == &scratch ? std::move(scratch) : *member;
+}
+
+const NyxValue* Interpreter::borrowMember(const MemberAccessExpression& expr, NyxValue& scratch) {
+    current_line = expr.token.line;
+    NyxValue object_scratch;
+    const NyxValue& object_val = *borrow(*expr.object, object_scratch);
+    auto result = [&](const NyxValue& value) -> const NyxValue* {
+        if (&object_val != &object_scratch) return &value;
+        scratch = value;
+        return &scratch;
+    };
 
     if (std::holds_alternative<NyxModule>(object_val.data)) {
         auto module_data_ptr = std::get<NyxModule>(object_val.data);
-        if (!module_data_ptr || !module_data_ptr->environment) {
+        if (!module_data_ptr) {
              throw Common::NyxRuntimeException("Invalid module object.", expr.token.line);
         }
-        std::optional<NyxValue> member_val = module_data_ptr->environment->get(expr.name.lexeme);
+        ensureModuleLoaded(*module_data_ptr, expr.name.line);
+        std::optional<NyxValue> member_val = getModuleMember(*module_data_ptr, expr.name.lexeme);
         if (!member_val) {
             throw Common::NyxRuntimeException("Member '" + expr.name.lexeme + "' not found in module '" + module_data_ptr->path + "'.", expr.name.line);
         }
-        return *member_val;
+        scratch = std::move(*member_val);
+        return &scratch;
     } else if (std::holds_alternative<StructInstancePtr>(object_val.data)) {
-        auto instance_ptr = std::get<StructInstancePtr>(object_val.data);
+        const auto& instance_ptr = std::get<StructInstancePtr>(object_val.data);
         if (!instance_ptr || !instance_ptr->definition) {
             throw Common::NyxRuntimeException("Invalid struct instance.", expr.token.line);
         }
@@ -932,7 +1596,16 @@ NyxValue Interpreter::visitMemberAccessExpression(const MemberAccessExpression&
             throw Common::NyxRuntimeException("Struct '" + instance_ptr->definition->name + "' has no field named '" + field_name + "'.", expr.name.line);
         }
         size_t field_idx = it->second;
-        return instance_ptr->field_values[field_idx];
+        return result(instance_ptr->field_values[field_idx]);
+    } else if (const auto* frozen = std::get_if<FrozenValuePtr>(&object_val.data);
+               frozen && *frozen && (*frozen)->kind == NyxFrozenValue::Kind::STRUCT_INSTANCE) {
+        const NyxFrozenValue& instance = **frozen;
+        const std::string& field_name = expr.name.lexeme;
+        auto it = instance.definition->field_indices.find(field_name);
+        if (it == instance.definition->field_indices.end()) {
+            throw Common::NyxRuntimeException("Struct '" + instance.definition->name + "' has no field named '" + field_name + "'.", expr.name.line);
+        }
+        return result(instance.elements[it->second]);
     }
 
     throw Common::NyxRuntimeException("Base of member access '.' must be a module or struct instance.", expr.token.line);
@@ -946,16 +1619,36 @@ NyxValue Interpreter::executeFunctionBody(const NyxDefinedFunction& function, co
             func_env->define(function.declaration_node->params[i].lexeme, arguments[i]);
         }
     }
+    return executeFunctionIn(function, func_env);
+}
 
+NyxValue Interpreter::executeFunctionIn(const NyxDefinedFunction& function, const std::shared_ptr<Environment>& scope) {
+    if (function.declaration_node && function.declaration_node->is_generator) {
+        return NyxValue(IteratorPtr(std::make_shared<NyxGenerator>(function.declaration_node, scope)));
+    }
+    // Generator bodies and green threads run on fibers, whose stacks are
+    // fixed; running off the end of one would take the whole process down.
+    if (Fiber::stackNearlyFull()) {
+        throw Common::NyxRuntimeException(std::string("Calls are nested too deeply inside a ") +
+                                          (running_generator ? "generator" : "green thread") + " (its stack holds " +
+                                          std::to_string(Fiber::DEFAULT_STACK_SIZE / (1024 * 1024)) + " MiB).", current_line);
+    }
     std::shared_ptr<Environment> previous_env = this->environment;
-    this->environment = func_env;
+    this->environment = scope;
 
     try {
         if (function.declaration_node && function.declaration_node->body) {
             for (const auto& stmt_ptr : function.declaration_node->body->statements) {
-                if (stmt_ptr) {
-                    execute(*stmt_ptr);
+                if (!stmt_ptr) continue;
+                // A return directly in the body needs no unwinding, which
+                // makes small callbacks much cheaper to call.
+                if (const auto* return_stmt = dynamic_cast<const ReturnStatement*>(stmt_ptr.get())) {
+                    safepoint();
+                    NyxValue result = return_stmt->value ? evaluate(*return_stmt->value) : NyxValue(std::monostate{});
+                    this->environment = previous_env;
+                    return result;
                 }
+                execute(*stmt_ptr);
             }
         }
     } catch (const Common::NyxReturnSignal& ret_signal) {
@@ -970,41 +1663,44 @@ NyxValue Interpreter::executeFunctionBody(const NyxDefinedFunction& function, co
     return NyxValue(std::monostate{});
 }
 
-NyxValue Interpreter::interpretModule(const std::string& module_source_code, const std::string& module_path) {
-    Interpreter module_interpreter;
-    
-    std::filesystem::path fs_module_path(module_path);
-    module_interpreter.current_script_directory = fs_module_path.parent_path().string();
-    
-    module_interpreter.globals = std::make_shared<Environment>(this->globals); // Modules get their own globals, possibly inheriting from the main one or a base one
-    module_interpreter.environment = module_interpreter.globals;
-    module_interpreter.globals->define("nyx_null", NyxValue(std::monostate{}));
+std::vector<std::unique_ptr<Statement>> Interpreter::compileSource(const std::string& source_code, const std::string& source_path, std::ostream& diagnostics) {
+    std::vector<std::unique_ptr<Statement>> program;
+    if (!source_path.empty() && ModuleCache::load(source_path, source_code, program)) {
+        return program;
+    }
 
+    Tokenizer tokenizer(source_code, diagnostics);
+    std::vector<Token> tokens = tokenizer.tokenize();
+    bool tokenized_cleanly = std::none_of(tokens.begin(), tokens.end(), [](const Token& token) {
+        return token.type == TokenType::UNKNOWN;
+    });
 
-    Tokenizer tokenizer(module_source_code);
-    std::vector<Token> tokens;
-    try {
-        tokens = tokenizer.tokenize();
-    } catch (const Common::NyxParserException& e) {
-        throw Common::NyxRuntimeException("Error tokenizing module '" + module_path + "': " + e.what(), 0);
-    }
+    Parser parser(std::move(tokens), diagnostics);
+    program = parser.parse();
 
-    Parser parser(tokens);
-    std::vector<std::unique_ptr<Statement>> module_ast_nodes;
-     try {
-        module_ast_nodes = parser.parse();
-    } catch (const std::exception& e) {
-        throw Common::NyxRuntimeException("Error parsing module '" + module_path + "': " + e.what(), 0);
+    // Only cache programs that parsed without diagnostics, so a warm run
+    // reports exactly what a cold run would.
+    if (!source_path.empty() && tokenized_cleanly && !parser.hadError()) {
+        ModuleCache::store(source_path, source_code, program);
     }
+    return program;
+}
+
+void Interpreter::interpretModule(NyxModuleData& module_data, std::vector<std::unique_ptr<Statement>> module_ast_nodes, std::shared_ptr<Environment> importer_globals) {
+    Interpreter module_interpreter(modules, task_group);
+    module_interpreter.is_module_interpreter = true;
     
-    auto module_data = std::make_shared<NyxModuleData>();
-    module_data->environment = module_interpreter.globals;
-    module_data->ast_holder = std::move(module_ast_nodes);
-    module_data->path = module_path;
+    std::filesystem::path fs_module_path(module_data.path);
+    module_interpreter.current_script_directory = fs_module_path.parent_path().string();
+    
+    module_interpreter.globals = std::make_shared<Environment>(importer_globals); // Modules get their own globals, possibly inheriting from the main one or a base one
+    module_interpreter.environment = module_interpreter.globals;
+    module_interpreter.globals->define("nyx_null", NyxValue(std::monostate{}));
 
-    module_interpreter.executeProgram(module_data->ast_holder, module_interpreter.globals, module_interpreter.environment);
+    module_data.environment = module_interpreter.globals;
+    module_data.ast_holder = std::move(module_ast_nodes);
 
-    return NyxValue(module_data);
+    module_interpreter.executeProgram(module_data.ast_holder, module_interpreter.globals, module_interpreter.environment);
 }
 
 void Interpreter::executeProgram(const std::vector<std::unique_ptr<Statement>>& program, std::shared_ptr<Environment> execution_globals, std::shared_ptr<Environment> execution_env) {
@@ -1092,26 +1788,21 @@ void Interpreter::interpret(const std::string& source_code,
         current_script_directory = std::filesystem::current_path().string();
     }
 
-    Tokenizer tokenizer(source_code);
-    std::vector<Token> tokens;
     try {
-        tokens = tokenizer.tokenize();
+        main_ast_program = compileSource(source_code, script_path_str);
     } catch (const Common::NyxParserException& e) {
         std::cerr << e.what() << std::endl;
         return;
     } catch (const std::exception& e) {
-        std::cerr << "Fatal Tokenizer error: " << e.what() << std::endl;
+        std::cerr << "Fatal internal error during parsing phase: " << e.what() << std::endl;
         return;
     }
 
-    Parser parser(tokens);
-    
-    try {
-        main_ast_program = parser.parse();
-    } catch (const std::exception& e) {
-        std::cerr << "Fatal internal error during parsing phase: " << e.what() << std::endl;
-        return;
+    std::set<std::string> already_loaded;
+    for (const auto& entry : modules->loaded_modules) {
+        already_loaded.insert(entry.first);
     }
+    modules->prefetched_modules = ModulePrefetcher::prefetch(main_ast_program, current_script_directory, already_loaded);
     
     try {
         executeProgram(main_ast_program, this->globals, this->environment);
@@ -5,20 +5,50 @@
 #include <memory>
 #include <map>
 #include <functional>
+#include <iostream>
+#include <mutex>
+#include <set>
 
 #include "./Environment.h"
+#include "./ModulePrefetcher.h"
 #include "../parser/AstNodes.h"
 #include "../common/Value.h"
 #include "../common/Utils.h"
 namespace Nyx {
 
-struct NyxModuleData {
+class NativeModuleTable;
+class TaskGroup;
+class NyxHashTable;
+class NyxGenerator;
+
+struct NyxModuleData : public GcObject {
+    enum class LoadState { LOADED, PENDING, LOADING, FAILED };
+
     std::shared_ptr<Environment> environment;
     std::vector<std::unique_ptr<Statement>> ast_holder; 
     std::string path; 
+    const NativeModuleTable* native_table = nullptr; // std: modules; members materialize into environment on lookup
+
+    // A module imported with `import lazy` stays PENDING until its first member
+    // access; importer_globals and import_line are kept until then.
+    LoadState load_state = LoadState::LOADED;
+    std::shared_ptr<Environment> importer_globals;
+    int import_line = 0;
+    std::string load_error;
+
+    // A module's globals enclose its importer's, which in turn hold the module.
+    void gcTraverse(GcVisitor& visitor) const override {
+        visitor.visit(environment.get());
+        visitor.visit(importer_globals.get());
+    }
+
+    void gcClear() override {
+        environment.reset();
+        importer_globals.reset();
+    }
 };
 
-class NyxDefinedFunction {
+class NyxDefinedFunction : public GcObject {
 public:
     const FunctionDeclarationStatement* declaration_node; 
     std::shared_ptr<Environment> closure_environment;
@@ -29,6 +59,11 @@ public:
         if (declaration_node) {
             name_string = declaration_node->name.lexeme;
         }
+        HeapAccounting::allocate(HeapKind::FUNCTIONS, sizeof(NyxDefinedFunction));
+    }
+
+    ~NyxDefinedFunction() override {
+        HeapAccounting::release(HeapKind::FUNCTIONS, sizeof(NyxDefinedFunction));
     }
 
     size_t arity() const {
@@ -41,13 +76,33 @@ public:
     std::string name() const {
         return name_string;
     }
+
+    void gcTraverse(GcVisitor& visitor) const override {
+        visitor.visit(closure_environment.get());
+    }
+
+    void gcClear() override {
+        closure_environment.reset();
+    }
 };
 
+// Modules imported by one top-level interpreter, shared with the interpreters
+// it creates to run module bodies. Every top-level Interpreter has its own.
+struct ModuleRegistry {
+    std::map<std::string, NyxValue> loaded_modules;
+    std::map<std::string, PrefetchedModule> prefetched_modules;
+};
+
+// An Interpreter with everything it creates is an isolate: separate top-level
+// Interpreters share no mutable state and may run in parallel on different
+// threads. A single Interpreter, and the values it produces, must stay on the
+// thread that created it.
 class Interpreter : public StatementVisitor, public ExpressionVisitor {
 public:
-    using NativeModuleBuilder = std::function<std::shared_ptr<Environment>()>;
-
     Interpreter();
+    ~Interpreter() override;
+    Interpreter(const Interpreter&) = delete;
+    Interpreter& operator=(const Interpreter&) = delete;
     void interpret(const std::string& source_code, 
                    const std::string& script_path_str = "", 
                    const std::vector<std::string>& script_args = {}); 
@@ -68,6 +123,7 @@ public:
     void visitStructDeclarationStatement(const StructDeclarationStatement& stmt) override;
     void visitBreakStatement(const BreakStatement& stmt) override;
     void visitContinueStatement(const ContinueStatement& stmt) override;
+    void visitYieldStatement(const YieldStatement& stmt) override;
 
     NyxValue visitLiteralExpression(const LiteralExpression& expr) override;
     NyxValue visitIdentifierExpression(const IdentifierExpression& expr) override;
@@ -76,6 +132,7 @@ public:
     NyxValue visitBinaryExpression(const BinaryExpression& expr) override;
     NyxValue visitPostfixUpdateExpression(const PostfixUpdateExpression& expr) override;
     NyxValue visitListLiteralExpression(const ListLiteralExpression& expr) override;
+    NyxValue visitMapLiteralExpression(const MapLiteralExpression& expr) override;
     NyxValue visitLenExpression(const LenExpression& expr) override;
     NyxValue visitSubscriptExpression(const SubscriptExpression& expr) override;
     NyxValue visitInterpolatedStringExpression(const InterpolatedStringExpression& expr) override;
@@ -83,33 +140,80 @@ public:
     NyxValue visitMemberAccessExpression(const MemberAccessExpression& expr) override;
     NyxValue visitStructInitializerExpression(const StructInitializerExpression& expr) override;
 
-    void registerNativeModule(const std::string& name, NativeModuleBuilder builder);
+    void registerNativeModule(const std::string& name, const NativeModuleTable& table);
     std::shared_ptr<Environment> globals;
 
     bool isDoubleInteger(double n) const;
+    bool isTruthy(const NyxValue& value) const;
     NyxValue executeFunctionBody(const NyxDefinedFunction& function, const std::vector<NyxValue>& arguments);
+    // Runs `function` in `scope`, a child of its closure that already binds the parameters.
+    NyxValue executeFunctionIn(const NyxDefinedFunction& function, const std::shared_ptr<Environment>& scope);
+    // Calls a user-defined or native function value; `line` is used for errors.
+    NyxValue callFunction(const NyxValue& callee, const std::vector<NyxValue>& arguments, int line);
+
+    const std::string& scriptDirectory() const { return current_script_directory; }
+    void setScriptDirectory(const std::string& directory) { current_script_directory = directory; }
+    // Tasks spawned by this interpreter or its modules; waited for on destruction.
+    const std::shared_ptr<TaskGroup>& taskGroup() const { return task_group; }
+
+    static std::vector<std::unique_ptr<Statement>> compileSource(const std::string& source_code, const std::string& source_path, std::ostream& diagnostics = std::cerr);
+    static std::string resolveModulePath(const std::string& importing_file_dir, const std::string& module_path_literal);
 
 private:
+    friend class NyxGenerator;
+    friend class EventLoop;
+
+    Interpreter(std::shared_ptr<ModuleRegistry> module_registry, std::shared_ptr<TaskGroup> tasks);
+
     std::shared_ptr<Environment> environment;
     
     std::vector<std::unique_ptr<Statement>> main_ast_program; 
     std::string current_script_directory; 
+    int current_line = 0; // line of the last evaluated expression, for errors raised between statements
     
-    static std::map<std::string, NyxValue> loaded_modules_cache; 
-    static std::map<std::string, NativeModuleBuilder> native_module_builders; 
-    static bool core_modules_registered; 
-
-    NyxValue interpretModule(const std::string& module_source_code, const std::string& module_path);
+    std::shared_ptr<ModuleRegistry> modules;
+    std::shared_ptr<TaskGroup> task_group;
+    bool is_module_interpreter = false;
+
+    // The generator whose body is running, if any, and the started ones that
+    // wait at a yield with this interpreter's frames on their stacks.
+    NyxGenerator* running_generator = nullptr;
+    std::set<NyxGenerator*> suspended_generators;
+
+    // std: module tables are immutable and shared by every interpreter; the
+    // name map is filled once and only read afterwards.
+    static std::map<std::string, const NativeModuleTable*> native_module_tables;
+    static std::mutex native_module_tables_mutex;
+    static const NativeModuleTable* findNativeModule(const std::string& name);
+
+    void loadModule(NyxModuleData& module_data);
+    void ensureModuleLoaded(NyxModuleData& module_data, int access_line);
+    std::optional<NyxValue> getModuleMember(NyxModuleData& module_data, const std::string& name);
+    std::vector<std::unique_ptr<Statement>> loadModuleProgram(const std::string& resolved_path, int import_line);
+    void interpretModule(NyxModuleData& module_data, std::vector<std::unique_ptr<Statement>> module_ast_nodes, std::shared_ptr<Environment> importer_globals);
     void executeProgram(const std::vector<std::unique_ptr<Statement>>& program, std::shared_ptr<Environment> execution_globals, std::shared_ptr<Environment> execution_env);
 
     NyxValue evaluate(const Expression& expr);
+    // Evaluates `expr` without copying it when it names a stored value: a
+    // variable, or an element or field reached from one. Otherwise the value
+    // is computed into `scratch`. The result is only good until something else
+    // is evaluated or assigned.
+    const NyxValue* borrow(const Expression& expr, NyxValue& scratch);
+    const NyxValue* borrowSubscript(const SubscriptExpression& expr, NyxValue& scratch);
+    const NyxValue* borrowMember(const MemberAccessExpression& expr, NyxValue& scratch);
     void execute(const Statement& stmt);
+    // Runs a pending garbage collection and enforces --max-heap.
+    void safepoint();
     void executeBlock(const std::vector<std::unique_ptr<Statement>>& statements, std::shared_ptr<Environment> execution_environment);
+    void iterateKeys(const ForeachStatement& stmt, const NyxValue& holder, const NyxHashTable& table);
+    void iterateLazily(const ForeachStatement& stmt, NyxIterator& iterator);
+    void runGeneratorBody(NyxGenerator& generator);
+    // `want_result` is false for assignments used as statements, whose value
+    // is dropped.
+    NyxValue assign(const AssignmentExpression& expr, bool want_result);
+    bool updateListInPlace(const IdentifierExpression& target, const Expression& value_expr);
 
-    bool isTruthy(const NyxValue& value) const;
     bool isEqual(const NyxValue& a, const NyxValue& b) const;
-
-    std::string resolveModulePath(const std::string& importing_file_dir, const std::string& module_path_literal) const;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "./ModuleCache.h"
+#include "../parser/AstSerializer.h"
+#include "../common/Utils.h"
+#include "../common/Version.h"
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NYX_CACHE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Nyx {
+
+namespace {
+    const char CACHE_MAGIC[4] = {'N', 'Y', 'X', 'C'};
+
+    // Read-only view of a cache file: mapped where the platform allows it,
+    // otherwise read into memory.
+    class CacheFileView {
+    public:
+        explicit CacheFileView(const std::string& path) {
+#ifdef NYX_CACHE_USE_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            struct stat file_stat;
+            if (::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+                void* mapped = ::mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    mapped_data = mapped;
+                    data_ptr = static_cast<const char*>(mapped);
+                    data_size = static_cast<size_t>(file_stat.st_size);
+                }
+            }
+            ::close(fd);
+#else
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) return;
+            buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            data_ptr = buffer.data();
+            data_size = buffer.size();
+#endif
+        }
+
+        ~CacheFileView() {
+#ifdef NYX_CACHE_USE_MMAP
+            if (mapped_data) {
+                ::munmap(mapped_data, data_size);
+            }
+#endif
+        }
+
+        CacheFileView(const CacheFileView&) = delete;
+        CacheFileView& operator=(const CacheFileView&) = delete;
+
+        const char* data() const { return data_ptr; }
+        size_t size() const { return data_size; }
+
+    private:
+        const char* data_ptr = nullptr;
+        size_t data_size = 0;
+#ifdef NYX_CACHE_USE_MMAP
+        void* mapped_data = nullptr;
+#else
+        std::string buffer;
+#endif
+    };
+
+    std::string toHex(std::uint64_t value) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex(16, '0');
+        for (int i = 15; i >= 0; --i) {
+            hex[i] = digits[value & 0xF];
+            value >>= 4;
+        }
+        return hex;
+    }
+
+    std::string environmentValue(const char* name) {
+        const char* value = std::getenv(name);
+        return value ? std::string(value) : std::string();
+    }
+}
+
+const std::string& ModuleCache::cacheDirectory() {
+    static const std::string directory = []() -> std::string {
+        if (std::getenv("NYX_NO_CACHE")) {
+            return "";
+        }
+
+        std::filesystem::path base;
+        if (std::string dir = environmentValue("NYX_CACHE_DIR"); !dir.empty()) {
+            base = dir;
+        } else if (std::string xdg = environmentValue("XDG_CACHE_HOME"); !xdg.empty()) {
+            base = std::filesystem::path(xdg) / "nyx";
+        } else if (std::string home = environmentValue("HOME"); !home.empty()) {
+            base = std::filesystem::path(home) / ".cache" / "nyx";
+        } else if (std::string local = environmentValue("LOCALAPPDATA"); !local.empty()) {
+            base = std::filesystem::path(local) / "nyx";
+        } else {
+            return "";
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(base, ec);
+        if (ec || !std::filesystem::is_directory(base, ec)) {
+            return "";
+        }
+        return base.string();
+    }();
+    return directory;
+}
+
+std::string ModuleCache::entryPath(const std::string& canonical_path) {
+    std::uint64_t path_hash = Common::hashBytes(canonical_path.data(), canonical_path.size());
+    return (std::filesystem::path(cacheDirectory()) / (toHex(path_hash) + ".nyxc")).string();
+}
+
+bool ModuleCache::load(const std::string& canonical_path, const std::string& source_code, std::vector<std::unique_ptr<Statement>>& program_out) {
+    if (cacheDirectory().empty()) {
+        return false;
+    }
+
+    CacheFileView view(entryPath(canonical_path));
+    if (!view.data() || view.size() < sizeof(CACHE_MAGIC) ||
+        std::memcmp(view.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+        return false;
+    }
+
+    try {
+        AstReader header(view.data() + sizeof(CACHE_MAGIC), view.size() - sizeof(CACHE_MAGIC));
+        if (header.readU32() != AST_FORMAT_VERSION) return false;
+        if (header.readString() != NYX_VERSION) return false;
+        if (header.readString() != canonical_path) return false;
+        if (header.readU64() != source_code.size()) return false;
+        if (header.readU64() != Common::hashBytes(source_code.data(), source_code.size())) return false;
+
+        std::uint64_t payload_size = header.readU64();
+        std::uint64_t payload_hash = header.readU64();
+        if (header.remaining() != payload_size) return false;
+        const char* payload = view.data() + view.size() - payload_size;
+        if (Common::hashBytes(payload, static_cast<size_t>(payload_size)) != payload_hash) return false;
+
+        AstReader reader(payload, static_cast<size_t>(payload_size));
+        std::vector<std::unique_ptr<Statement>> program = reader.readProgram();
+        if (!reader.atEnd()) {
+            return false;
+        }
+        program_out = std::move(program);
+        return true;
+    } catch (const AstFormatError&) {
+        return false;
+    }
+}
+
+void ModuleCache::store(const std::string& canonical_path, const std::string& source_code, const std::vector<std::unique_ptr<Statement>>& program) {
+    if (cacheDirectory().empty()) {
+        return;
+    }
+
+    std::string payload;
+    AstWriter payload_writer(payload);
+    payload_writer.writeProgram(program);
+
+    std::string contents(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    AstWriter header(contents);
+    header.writeU32(AST_FORMAT_VERSION);
+    header.writeString(NYX_VERSION);
+    header.writeString(canonical_path);
+    header.writeU64(source_code.size());
+    header.writeU64(Common::hashBytes(source_code.data(), source_code.size()));
+    header.writeU64(payload.size());
+    header.writeU64(Common::hashBytes(payload.data(), payload.size()));
+    contents += payload;
+
+    // Write to a private temporary and rename it into place so that concurrent
+    // interpreters never observe a half-written entry.
+    std::string final_path = entryPath(canonical_path);
+    std::size_t unique = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                         static_cast<std::size_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::string temp_path = final_path + "." + toHex(unique) + ".tmp";
+
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return;
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        if (!out) {
+            out.close();
+            std::remove(temp_path.c_str());
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, final_path, ec);
+    if (ec) {
+        std::remove(temp_path.c_str());
+    }
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "../parser/AstNodes.h"
+
+namespace Nyx {
+
+// Persistent cache of parsed programs, stored as one .nyxc file per source
+// file. An entry is only used when its canonical path, source hash, interpreter
+// version and AST format version all match; anything else (stale, truncated or
+// corrupt) is ignored and rewritten after the source is parsed again.
+//
+// The cache lives in $NYX_CACHE_DIR, falling back to $XDG_CACHE_HOME/nyx and
+// then ~/.cache/nyx. Setting NYX_NO_CACHE disables it.
+class ModuleCache {
+public:
+    static bool load(const std::string& canonical_path, const std::string& source_code, std::vector<std::unique_ptr<Statement>>& program_out);
+    static void store(const std::string& canonical_path, const std::string& source_code, const std::vector<std::unique_ptr<Statement>>& program);
+
+private:
+    static const std::string& cacheDirectory();
+    static std::string entryPath(const std::string& canonical_path);
+};
+
+}
@@ -0,0 +1,124 @@
+#include "./ModulePrefetcher.h"
+#include "./Interpreter.h"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace Nyx {
+
+namespace {
+    void collectImports(const std::vector<std::unique_ptr<Statement>>& program,
+                        const std::string& importing_dir,
+                        std::vector<std::string>& resolved_paths) {
+        for (const auto& stmt : program) {
+            const auto* import_stmt = dynamic_cast<const ImportStatement*>(stmt.get());
+            if (!import_stmt || import_stmt->is_lazy) continue;
+
+            const std::string& path_literal = import_stmt->path_literal.lexeme;
+            if (path_literal.rfind("std:", 0) == 0) continue;
+
+            try {
+                resolved_paths.push_back(Interpreter::resolveModulePath(importing_dir, path_literal));
+            } catch (const Common::NyxRuntimeException&) {
+                // Left for visitImportStatement to report with the right line.
+            }
+        }
+    }
+}
+
+std::map<std::string, PrefetchedModule> ModulePrefetcher::prefetch(
+    const std::vector<std::unique_ptr<Statement>>& program,
+    const std::string& script_directory,
+    const std::set<std::string>& already_loaded) {
+
+    std::map<std::string, PrefetchedModule> results;
+
+    // With a single hardware thread there is nothing to overlap; imports are
+    // then parsed on demand exactly as before.
+    unsigned worker_count = std::thread::hardware_concurrency();
+    if (worker_count < 2) {
+        return results;
+    }
+
+    std::set<std::string> seen(already_loaded);
+    std::deque<std::string> pending;
+
+    std::vector<std::string> root_imports;
+    collectImports(program, script_directory, root_imports);
+    for (std::string& path : root_imports) {
+        if (seen.insert(path).second) {
+            pending.push_back(std::move(path));
+        }
+    }
+    if (pending.empty()) {
+        return results;
+    }
+
+    std::mutex mutex;
+    std::condition_variable work_changed;
+    size_t active_workers = 0;
+    HeapAccounting& accountant = HeapAccounting::current();
+
+    auto worker = [&]() {
+        HeapAccounting::Adopt adopt(accountant);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            work_changed.wait(lock, [&] { return !pending.empty() || active_workers == 0; });
+            if (pending.empty()) {
+                return;
+            }
+            std::string module_path = std::move(pending.front());
+            pending.pop_front();
+            ++active_workers;
+            lock.unlock();
+
+            PrefetchedModule module;
+            std::vector<std::string> nested_imports;
+            bool loaded = false;
+
+            std::ifstream file(module_path);
+            if (file.is_open()) {
+                std::string source_code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                std::ostringstream diagnostics;
+                try {
+                    module.program = Interpreter::compileSource(source_code, module_path, diagnostics);
+                    module.diagnostics = diagnostics.str();
+                    collectImports(module.program, std::filesystem::path(module_path).parent_path().string(), nested_imports);
+                    loaded = true;
+                } catch (const std::exception&) {
+                    // The import will parse it again on the main thread and report the failure there.
+                }
+            }
+
+            lock.lock();
+            if (loaded) {
+                results.emplace(module_path, std::move(module));
+                for (std::string& path : nested_imports) {
+                    if (seen.insert(path).second) {
+                        pending.push_back(std::move(path));
+                    }
+                }
+            }
+            --active_workers;
+            work_changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    for (unsigned i = 0; i < worker_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    return results;
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <map>
+#include <set>
+
+#include "../parser/AstNodes.h"
+
+namespace Nyx {
+
+struct PrefetchedModule {
+    std::vector<std::unique_ptr<Statement>> program;
+    std::string diagnostics; // tokenizer/parser output, replayed when the module is imported
+};
+
+// Walks the import graph reachable through top-level, non-lazy imports and
+// reads and parses every module it finds on a pool of worker threads. Nothing
+// is executed here; module bodies still run in program order as each import
+// statement is reached, taking their AST from the prefetched set.
+class ModulePrefetcher {
+public:
+    static std::map<std::string, PrefetchedModule> prefetch(
+        const std::vector<std::unique_ptr<Statement>>& program,
+        const std::string& script_directory,
+        const std::set<std::string>& already_loaded);
+};
+
+}
@@ -0,0 +1,234 @@
+#include "./TaskScheduler.h"
+
+#include <cstdlib>
+
+namespace Nyx {
+
+namespace {
+    thread_local TaskScheduler* worker_scheduler = nullptr;
+    thread_local size_t worker_index = 0;
+    thread_local bool is_standby = false; // standby threads have no queue of their own
+
+    size_t configuredWorkerCount() {
+        if (const char* value = std::getenv("NYX_TASK_WORKERS")) {
+            long count = std::strtol(value, nullptr, 10);
+            if (count > 0) {
+                return static_cast<size_t>(count);
+            }
+        }
+        unsigned hardware_threads = std::thread::hardware_concurrency();
+        return hardware_threads > 0 ? hardware_threads : 1;
+    }
+
+    bool popBack(std::mutex& mutex, std::deque<TaskScheduler::Job>& jobs, TaskScheduler::Job& job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.empty()) return false;
+        job = std::move(jobs.back());
+        jobs.pop_back();
+        return true;
+    }
+
+    bool popFront(std::mutex& mutex, std::deque<TaskScheduler::Job>& jobs, TaskScheduler::Job& job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.empty()) return false;
+        job = std::move(jobs.front());
+        jobs.pop_front();
+        return true;
+    }
+}
+
+void NyxTaskFuture::resolve(ValueSnapshot result_value) {
+    value = std::move(result_value);
+    settled.store(true, std::memory_order_release);
+    TaskScheduler::shared().notifyAll();
+}
+
+void NyxTaskFuture::reject(std::string message) {
+    has_error = true;
+    error_message = std::move(message);
+    settled.store(true, std::memory_order_release);
+    TaskScheduler::shared().notifyAll();
+}
+
+void TaskGroup::done() {
+    outstanding.fetch_sub(1, std::memory_order_release);
+    TaskScheduler::shared().notifyAll();
+}
+
+void TaskGroup::wait() {
+    if (outstanding.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    TaskScheduler::shared().waitUntil([this]() {
+        return outstanding.load(std::memory_order_acquire) == 0;
+    });
+}
+
+TaskScheduler& TaskScheduler::shared() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler() {
+    size_t count = configuredWorkerCount();
+    for (size_t i = 0; i < count; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    workers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        stopping = true;
+    }
+    state_changed.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (std::thread& thread : standby) {
+        thread.join();
+    }
+}
+
+void TaskScheduler::submit(Job job) {
+    if (worker_scheduler == this && !is_standby) {
+        WorkQueue& own = *queues[worker_index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.jobs.push_back(std::move(job));
+    } else {
+        std::lock_guard<std::mutex> lock(injected.mutex);
+        injected.jobs.push_back(std::move(job));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    notifyAll();
+}
+
+void TaskScheduler::notifyAll() {
+    {
+        // Taking the lock orders this wake-up after any waiter's last check.
+        std::lock_guard<std::mutex> lock(state_mutex);
+    }
+    state_changed.notify_all();
+}
+
+bool TaskScheduler::takeJob(Job& job) {
+    if (queued.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    bool found = false;
+    size_t count = queues.size();
+    if (worker_scheduler == this && !is_standby) {
+        found = popBack(queues[worker_index]->mutex, queues[worker_index]->jobs, job);
+    }
+    if (!found) {
+        found = popFront(injected.mutex, injected.jobs, job);
+    }
+    for (size_t offset = 1; !found && offset <= count; ++offset) {
+        WorkQueue& victim = *queues[(worker_index + offset) % count];
+        found = popFront(victim.mutex, victim.jobs, job);
+    }
+    if (found) {
+        queued.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return found;
+}
+
+void TaskScheduler::runJob(Job& job) {
+    try {
+        job();
+    } catch (...) {
+        // Jobs report their own failures through their future.
+    }
+    job = nullptr;
+}
+
+void TaskScheduler::workerLoop(size_t index) {
+    worker_scheduler = this;
+    worker_index = index;
+    while (true) {
+        Job job;
+        if (takeJob(job)) {
+            runJob(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(state_mutex);
+        if (stopping) {
+            return;
+        }
+        state_changed.wait(lock, [this]() {
+            return stopping || queued.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void TaskScheduler::standbyLoop(size_t index) {
+    worker_scheduler = this;
+    worker_index = index % queues.size();
+    is_standby = true;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            state_changed.wait(lock, [this, index]() {
+                return stopping || (blocked > index && queued.load(std::memory_order_acquire) > 0);
+            });
+            if (stopping) {
+                return;
+            }
+        }
+        Job job;
+        if (takeJob(job)) {
+            runJob(job);
+        }
+    }
+}
+
+bool TaskScheduler::waitBlocking(const std::function<bool()>& ready,
+                                 std::optional<std::chrono::steady_clock::time_point> deadline) {
+    bool is_pool_thread = worker_scheduler == this;
+    std::unique_lock<std::mutex> lock(state_mutex);
+    if (ready()) {
+        return true;
+    }
+    if (is_pool_thread) {
+        ++blocked;
+        if (blocked > standby.size()) {
+            size_t index = standby.size();
+            standby.emplace_back([this, index]() { standbyLoop(index); });
+        }
+        state_changed.notify_all();
+    }
+    bool result;
+    if (deadline) {
+        result = state_changed.wait_until(lock, *deadline, ready);
+    } else {
+        state_changed.wait(lock, ready);
+        result = true;
+    }
+    if (is_pool_thread) {
+        --blocked;
+    }
+    return result;
+}
+
+void TaskScheduler::waitUntil(const std::function<bool()>& ready) {
+    bool is_worker = worker_scheduler == this;
+    while (!ready()) {
+        if (is_worker) {
+            Job job;
+            if (takeJob(job)) {
+                runJob(job);
+                continue;
+            }
+        }
+        std::unique_lock<std::mutex> lock(state_mutex);
+        state_changed.wait(lock, [&]() {
+            return ready() || (is_worker && queued.load(std::memory_order_acquire) > 0);
+        });
+    }
+}
+
+}
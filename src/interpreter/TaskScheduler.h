@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./ValueSnapshot.h"
+
+namespace Nyx {
+
+// Outcome of a spawned task. Futures are shared by every isolate they are
+// passed to, so all members are safe to use from any thread; result() and
+// error() may only be read once isSettled() returns true.
+struct NyxTaskFuture {
+    bool isSettled() const { return settled.load(std::memory_order_acquire); }
+    bool failed() const { return has_error; }
+    const ValueSnapshot& result() const { return value; }
+    const std::string& error() const { return error_message; }
+
+    void resolve(ValueSnapshot result_value);
+    void reject(std::string message);
+
+private:
+    std::atomic<bool> settled{false};
+    bool has_error = false;
+    ValueSnapshot value;
+    std::string error_message;
+};
+
+// Tasks spawned by one interpreter that have not finished. The interpreter
+// waits for them before it frees the code they run.
+class TaskGroup {
+public:
+    void add() { outstanding.fetch_add(1, std::memory_order_relaxed); }
+    void done();
+    void wait();
+
+private:
+    std::atomic<size_t> outstanding{0};
+};
+
+// Process-wide work-stealing pool that runs tasks for every isolate. Each
+// worker pops its own queue from the back (so a task's children run while
+// their data is warm) and steals from the front of the others' queues when it
+// runs dry; jobs submitted from outside the pool go to a shared queue. The
+// pool starts one worker per hardware thread, or NYX_TASK_WORKERS.
+//
+// A job that blocks (on a channel, say) through waitBlocking() hands its place
+// to a standby thread, started on first need, so the pool still has
+// workerCount() threads taking jobs. Standby threads only run jobs while at
+// least as many pool threads are blocked, and otherwise sleep.
+class TaskScheduler {
+public:
+    using Job = std::function<void()>;
+
+    static TaskScheduler& shared();
+    ~TaskScheduler();
+
+    void submit(Job job);
+    // Blocks until ready() returns true. Worker threads keep running queued
+    // jobs meanwhile, so a task waiting on another cannot starve the pool.
+    void waitUntil(const std::function<bool()>& ready);
+    // Blocks until ready() returns true or the deadline passes, and returns
+    // the last result of ready(). Runs no other jobs on this thread: the job
+    // it would run may itself wait for the caller.
+    bool waitBlocking(const std::function<bool()>& ready,
+                      std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt);
+    // Wakes every waiter to re-check its condition.
+    void notifyAll();
+
+    size_t workerCount() const { return workers.size(); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    TaskScheduler();
+
+    bool takeJob(Job& job);
+    void runJob(Job& job);
+    void workerLoop(size_t index);
+    void standbyLoop(size_t index);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues; // one per worker
+    WorkQueue injected;                             // jobs from non-worker threads
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued{0};
+
+    std::mutex state_mutex;
+    std::condition_variable state_changed;
+    bool stopping = false;
+    size_t blocked = 0;                // pool threads inside waitBlocking()
+    std::vector<std::thread> standby;  // standby thread i runs jobs while blocked > i
+};
+
+}
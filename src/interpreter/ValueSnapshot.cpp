@@ -0,0 +1,452 @@
+#include "./ValueSnapshot.h"
+#include "./Interpreter.h"
+#include "./Environment.h"
+#include "../common/HashTable.h"
+#include "../common/Bytes.h"
+#include "../common/Utils.h"
+
+#include <cstring>
+#include <map>
+#include <set>
+
+namespace Nyx {
+
+namespace {
+    // Every identifier a function body mentions: variables, member names and
+    // struct type names. A superset of the names it can look up at run time.
+    class ReferencedNames : public StatementVisitor, public ExpressionVisitor {
+    public:
+        explicit ReferencedNames(std::set<std::string>& names_out) : names(names_out) {}
+
+        void collect(const FunctionDeclarationStatement& declaration) {
+            walk(declaration.body.get());
+        }
+
+        void visitExpressionStatement(const ExpressionStatement& stmt) override { walk(stmt.expression.get()); }
+        void visitBlockStatement(const BlockStatement& stmt) override {
+            for (const auto& statement : stmt.statements) walk(statement.get());
+        }
+        void visitVariableDeclarationStatement(const VariableDeclarationStatement& stmt) override { walk(stmt.initializer.get()); }
+        void visitOutputStatement(const OutputStatement& stmt) override { walk(stmt.argument.get()); }
+        void visitPutStatement(const PutStatement& stmt) override { walk(stmt.argument.get()); }
+        void visitFunctionDeclarationStatement(const FunctionDeclarationStatement& stmt) override { walk(stmt.body.get()); }
+        void visitReturnStatement(const ReturnStatement& stmt) override { walk(stmt.value.get()); }
+        void visitYieldStatement(const YieldStatement& stmt) override { walk(stmt.value.get()); }
+        void visitImportStatement(const ImportStatement&) override {}
+        void visitTypedefStatement(const TypedefStatement& stmt) override { walk(stmt.expression_to_check.get()); }
+        void visitIfStatement(const IfStatement& stmt) override {
+            walk(stmt.condition.get());
+            walk(stmt.then_branch.get());
+            walk(stmt.else_branch.get());
+        }
+        void visitForStatement(const ForStatement& stmt) override {
+            walk(stmt.initializer.get());
+            walk(stmt.condition.get());
+            walk(stmt.increment.get());
+            walk(stmt.body.get());
+        }
+        void visitForeachStatement(const ForeachStatement& stmt) override {
+            walk(stmt.iterable_expression.get());
+            walk(stmt.body_statement.get());
+        }
+        void visitSwitchStatement(const SwitchStatement& stmt) override {
+            walk(stmt.condition.get());
+            for (const CaseBlock& case_block : stmt.cases) {
+                walk(case_block.value_expression.get());
+                for (const auto& statement : case_block.statements) walk(statement.get());
+            }
+        }
+        void visitStructDeclarationStatement(const StructDeclarationStatement&) override {}
+        void visitBreakStatement(const BreakStatement&) override {}
+        void visitContinueStatement(const ContinueStatement&) override {}
+
+        NyxValue visitLiteralExpression(const LiteralExpression&) override { return NyxValue(); }
+        NyxValue visitIdentifierExpression(const IdentifierExpression& expr) override {
+            names.insert(expr.name);
+            return NyxValue();
+        }
+        NyxValue visitAssignmentExpression(const AssignmentExpression& expr) override {
+            walk(expr.target.get());
+            walk(expr.value.get());
+            return NyxValue();
+        }
+        NyxValue visitUnaryExpression(const UnaryExpression& expr) override {
+            walk(expr.right.get());
+            return NyxValue();
+        }
+        NyxValue visitBinaryExpression(const BinaryExpression& expr) override {
+            walk(expr.left.get());
+            walk(expr.right.get());
+            return NyxValue();
+        }
+        NyxValue visitPostfixUpdateExpression(const PostfixUpdateExpression& expr) override {
+            walk(expr.operand.get());
+            return NyxValue();
+        }
+        NyxValue visitListLiteralExpression(const ListLiteralExpression& expr) override {
+            for (const auto& element : expr.elements) walk(element.get());
+            return NyxValue();
+        }
+        NyxValue visitMapLiteralExpression(const MapLiteralExpression& expr) override {
+            for (const auto& key : expr.keys) walk(key.get());
+            for (const auto& value : expr.values) walk(value.get());
+            return NyxValue();
+        }
+        NyxValue visitLenExpression(const LenExpression& expr) override {
+            walk(expr.argument.get());
+            return NyxValue();
+        }
+        NyxValue visitSubscriptExpression(const SubscriptExpression& expr) override {
+            walk(expr.object.get());
+            walk(expr.index.get());
+            return NyxValue();
+        }
+        NyxValue visitInterpolatedStringExpression(const InterpolatedStringExpression& expr) override {
+            for (const auto& segment : expr.segments) {
+                if (const auto* part = std::get_if<std::unique_ptr<Expression>>(&segment)) {
+                    walk(part->get());
+                }
+            }
+            return NyxValue();
+        }
+        NyxValue visitCallExpression(const CallExpression& expr) override {
+            walk(expr.callee.get());
+            for (const auto& argument : expr.arguments) walk(argument.get());
+            return NyxValue();
+        }
+        NyxValue visitMemberAccessExpression(const MemberAccessExpression& expr) override {
+            walk(expr.object.get());
+            names.insert(expr.name.lexeme);
+            return NyxValue();
+        }
+        NyxValue visitStructInitializerExpression(const StructInitializerExpression& expr) override {
+            names.insert(expr.name_token.lexeme);
+            for (const auto& initializer : expr.initializers) walk(initializer.second.get());
+            return NyxValue();
+        }
+
+    private:
+        void walk(const Statement* stmt) {
+            if (stmt) stmt->accept(*this);
+        }
+        void walk(const Expression* expr) {
+            if (expr) expr->accept(*this);
+        }
+
+        std::set<std::string>& names;
+    };
+}
+
+class ValueSnapshot::Builder {
+public:
+    explicit Builder(ValueSnapshot& target) : snapshot(target) {}
+
+    Node capture(const NyxValue& value) {
+        Node node;
+        const auto& data = value.data;
+        if (std::holds_alternative<std::monostate>(data)) {
+            node.kind = Kind::NUL;
+        } else if (const bool* flag = std::get_if<bool>(&data)) {
+            node.kind = Kind::BOOLEAN;
+            node.boolean = *flag;
+        } else if (const double* number = std::get_if<double>(&data)) {
+            node.kind = Kind::NUMBER;
+            node.number = *number;
+        } else if (const std::string* text = std::get_if<std::string>(&data)) {
+            node.kind = Kind::STRING;
+            node.text = *text;
+        } else if (const NyxList* list = std::get_if<NyxList>(&data)) {
+            node.kind = Kind::LIST;
+            node.elements.reserve(list->size());
+            for (const NyxValue& element : *list) {
+                node.elements.push_back(capture(element));
+            }
+        } else if (const auto* function = std::get_if<UserDefinedFunctionPtr>(&data)) {
+            node.kind = Kind::FUNCTION;
+            node.index = captureFunction(**function);
+        } else if (const auto* module = std::get_if<NyxModule>(&data)) {
+            node.kind = Kind::MODULE;
+            node.index = captureModule(**module);
+        } else if (const auto* instance = std::get_if<StructInstancePtr>(&data)) {
+            node.kind = Kind::STRUCT_INSTANCE;
+            node.index = captureInstance(**instance);
+        } else if (const auto* array = std::get_if<NumericArrayPtr>(&data); array && *array) {
+            node.kind = Kind::ARRAY;
+            node.index = captureArray(**array);
+        } else if (const auto* bytes = std::get_if<BytesPtr>(&data); bytes && *bytes) {
+            // Copied: a slice arrives as a buffer of its own.
+            node.kind = Kind::BYTES;
+            node.text = (*bytes)->toString();
+        } else if (const auto* map = std::get_if<MapPtr>(&data); map && *map) {
+            node.kind = Kind::MAP;
+            node.index = captureMap(map->get(), (*map)->table, false);
+        } else if (const auto* set = std::get_if<SetPtr>(&data); set && *set) {
+            node.kind = Kind::MAP;
+            node.index = captureMap(set->get(), (*set)->table, true);
+        } else if (isThreadNeutral(value)) {
+            // Immutable (or internally synchronized) and safe to share.
+            node.kind = Kind::SHARED;
+            node.shared = value;
+        } else {
+            throw Common::NyxRuntimeException("Values of type " + nyxValueTypeToString(value) + " cannot be passed between tasks.", 0);
+        }
+        return node;
+    }
+
+    // Copies the bindings of every captured scope that some captured function
+    // may read. Capturing a binding can bring in new functions, and with them
+    // new names and scopes, so this repeats until nothing changes.
+    void finish() {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            std::vector<std::string> current_names(names.begin(), names.end());
+            for (size_t i = 0; i < environment_sources.size(); ++i) {
+                for (const std::string& name : current_names) {
+                    if (!examined_names[i].insert(name).second) continue;
+                    changed = true;
+                    const auto& bindings = environment_sources[i]->localBindings();
+                    auto it = bindings.find(name);
+                    if (it == bindings.end()) continue;
+                    Node node = capture(it->second);
+                    snapshot.environments[i].bindings.emplace_back(name, std::move(node));
+                }
+            }
+        }
+    }
+
+private:
+    size_t captureFunction(const NyxDefinedFunction& function) {
+        auto found = function_indices.find(&function);
+        if (found != function_indices.end()) return found->second;
+
+        size_t index = snapshot.functions.size();
+        function_indices[&function] = index;
+        snapshot.functions.push_back(FunctionEntry{function.declaration_node, -1});
+        if (function.declaration_node && scanned_declarations.insert(function.declaration_node).second) {
+            ReferencedNames collector(names);
+            collector.collect(*function.declaration_node);
+        }
+        long closure = captureEnvironment(function.closure_environment);
+        snapshot.functions[index].closure = closure;
+        return index;
+    }
+
+    size_t captureModule(const NyxModuleData& module) {
+        auto found = module_indices.find(&module);
+        if (found != module_indices.end()) return found->second;
+
+        if (module.load_state == NyxModuleData::LoadState::PENDING) {
+            throw Common::NyxRuntimeException("Module '" + module.path + "' is imported lazily and has not been loaded yet, so it cannot be passed between tasks.", 0);
+        }
+        size_t index = snapshot.modules.size();
+        module_indices[&module] = index;
+        ModuleEntry entry;
+        entry.path = module.path;
+        entry.native_table = module.native_table;
+        entry.failed = module.load_state == NyxModuleData::LoadState::FAILED;
+        entry.load_error = module.load_error;
+        snapshot.modules.push_back(std::move(entry));
+        // Native module members are recreated from the table on first use.
+        if (!module.native_table) {
+            long environment = captureEnvironment(module.environment);
+            snapshot.modules[index].environment = environment;
+        }
+        return index;
+    }
+
+    size_t captureInstance(const NyxStructInstance& instance) {
+        auto found = instance_indices.find(&instance);
+        if (found != instance_indices.end()) return found->second;
+
+        size_t index = snapshot.instances.size();
+        instance_indices[&instance] = index;
+        snapshot.instances.push_back(InstanceEntry{instance.definition, {}});
+        std::vector<Node> fields;
+        fields.reserve(instance.field_values.size());
+        for (const NyxValue& field : instance.field_values) {
+            fields.push_back(capture(field));
+        }
+        snapshot.instances[index].fields = std::move(fields);
+        return index;
+    }
+
+    size_t captureArray(const NyxNumericArray& array) {
+        auto found = array_indices.find(&array);
+        if (found != array_indices.end()) return found->second;
+
+        size_t index = snapshot.arrays.size();
+        array_indices[&array] = index;
+        ArrayEntry entry;
+        entry.type = array.type();
+        entry.length = array.size();
+        entry.bytes.assign(static_cast<const char*>(array.rawData()), array.byteSize());
+        snapshot.arrays.push_back(std::move(entry));
+        return index;
+    }
+
+    size_t captureMap(const void* identity, const NyxHashTable& table, bool is_set) {
+        auto found = map_indices.find(identity);
+        if (found != map_indices.end()) return found->second;
+
+        size_t index = snapshot.maps.size();
+        map_indices[identity] = index;
+        snapshot.maps.push_back(MapEntry{is_set, {}, {}});
+        MapEntry entry{is_set, {}, {}};
+        entry.keys.reserve(table.size());
+        for (size_t i = 0; i < table.entryLimit(); ++i) {
+            if (!table.isLive(i)) continue;
+            entry.keys.push_back(capture(table.keyAt(i)));
+            if (!is_set) entry.values.push_back(capture(table.valueAt(i)));
+        }
+        snapshot.maps[index] = std::move(entry);
+        return index;
+    }
+
+    long captureEnvironment(const std::shared_ptr<Environment>& environment) {
+        if (!environment) return -1;
+        auto found = environment_indices.find(environment.get());
+        if (found != environment_indices.end()) return static_cast<long>(found->second);
+
+        size_t index = snapshot.environments.size();
+        environment_indices[environment.get()] = index;
+        snapshot.environments.emplace_back();
+        environment_sources.push_back(environment.get());
+        examined_names.emplace_back();
+        long enclosing = captureEnvironment(environment->enclosing);
+        snapshot.environments[index].enclosing = enclosing;
+        return static_cast<long>(index);
+    }
+
+    ValueSnapshot& snapshot;
+    std::set<std::string> names;
+    std::set<const FunctionDeclarationStatement*> scanned_declarations;
+    std::map<const NyxDefinedFunction*, size_t> function_indices;
+    std::map<const NyxModuleData*, size_t> module_indices;
+    std::map<const NyxStructInstance*, size_t> instance_indices;
+    std::map<const NyxNumericArray*, size_t> array_indices;
+    std::map<const void*, size_t> map_indices; // maps and sets
+    std::map<const Environment*, size_t> environment_indices;
+    std::vector<const Environment*> environment_sources;
+    std::vector<std::set<std::string>> examined_names;
+};
+
+ValueSnapshot::ValueSnapshot(const std::vector<NyxValue>& values) {
+    Builder builder(*this);
+    roots.reserve(values.size());
+    for (const NyxValue& value : values) {
+        roots.push_back(builder.capture(value));
+    }
+    builder.finish();
+}
+
+std::vector<NyxValue> ValueSnapshot::materialize() const {
+    BuiltObjects built;
+    built.environments.reserve(environments.size());
+    for (size_t i = 0; i < environments.size(); ++i) {
+        built.environments.push_back(std::make_shared<Environment>());
+    }
+    for (size_t i = 0; i < environments.size(); ++i) {
+        if (environments[i].enclosing >= 0) {
+            built.environments[i]->enclosing = built.environments[environments[i].enclosing];
+        }
+    }
+
+    built.modules.reserve(modules.size());
+    for (const ModuleEntry& entry : modules) {
+        auto module = std::make_shared<NyxModuleData>();
+        module->path = entry.path;
+        module->native_table = entry.native_table;
+        if (entry.environment >= 0) {
+            module->environment = built.environments[entry.environment];
+        }
+        module->load_state = entry.failed ? NyxModuleData::LoadState::FAILED : NyxModuleData::LoadState::LOADED;
+        module->load_error = entry.load_error;
+        built.modules.emplace_back(std::move(module));
+    }
+
+    built.functions.reserve(functions.size());
+    for (const FunctionEntry& entry : functions) {
+        std::shared_ptr<Environment> closure = entry.closure >= 0 ? built.environments[entry.closure] : nullptr;
+        built.functions.emplace_back(std::make_shared<NyxDefinedFunction>(entry.declaration, std::move(closure)));
+    }
+
+    built.instances.reserve(instances.size());
+    for (const InstanceEntry& entry : instances) {
+        built.instances.push_back(std::make_shared<NyxStructInstance>(entry.definition));
+    }
+
+    built.arrays.reserve(arrays.size());
+    for (const ArrayEntry& entry : arrays) {
+        auto array = std::make_shared<NyxNumericArray>(entry.type, entry.length);
+        if (!entry.bytes.empty()) {
+            std::memcpy(array->rawData(), entry.bytes.data(), entry.bytes.size());
+        }
+        built.arrays.push_back(std::move(array));
+    }
+
+    built.maps.reserve(maps.size());
+    for (const MapEntry& entry : maps) {
+        if (entry.is_set) {
+            built.maps.emplace_back(std::make_shared<NyxSet>());
+        } else {
+            built.maps.emplace_back(std::make_shared<NyxMap>());
+        }
+    }
+
+    for (size_t i = 0; i < environments.size(); ++i) {
+        for (const auto& binding : environments[i].bindings) {
+            built.environments[i]->define(binding.first, materializeNode(binding.second, built));
+        }
+    }
+    for (size_t i = 0; i < instances.size(); ++i) {
+        for (size_t field = 0; field < instances[i].fields.size() && field < built.instances[i]->field_values.size(); ++field) {
+            built.instances[i]->field_values[field] = materializeNode(instances[i].fields[field], built);
+        }
+    }
+    for (size_t i = 0; i < maps.size(); ++i) {
+        const MapEntry& entry = maps[i];
+        NyxHashTable& table = entry.is_set ? std::get<SetPtr>(built.maps[i].data)->table : std::get<MapPtr>(built.maps[i].data)->table;
+        for (size_t key = 0; key < entry.keys.size(); ++key) {
+            bool inserted = false;
+            size_t position = table.insert(materializeNode(entry.keys[key], built), inserted);
+            if (!entry.is_set) {
+                table.valueAt(position) = materializeNode(entry.values[key], built);
+            }
+        }
+    }
+
+    std::vector<NyxValue> result;
+    result.reserve(roots.size());
+    for (const Node& root : roots) {
+        result.push_back(materializeNode(root, built));
+    }
+    return result;
+}
+
+NyxValue ValueSnapshot::materializeNode(const Node& node, const BuiltObjects& built) const {
+    switch (node.kind) {
+        case Kind::NUL: return NyxValue(std::monostate{});
+        case Kind::BOOLEAN: return NyxValue(node.boolean);
+        case Kind::NUMBER: return NyxValue(node.number);
+        case Kind::STRING: return NyxValue(node.text);
+        case Kind::LIST: {
+            NyxList list;
+            list.reserve(node.elements.size());
+            for (const Node& element : node.elements) {
+                list.push_back(materializeNode(element, built));
+            }
+            return NyxValue(std::move(list));
+        }
+        case Kind::FUNCTION: return built.functions[node.index];
+        case Kind::MODULE: return built.modules[node.index];
+        case Kind::STRUCT_INSTANCE: return NyxValue(built.instances[node.index]);
+        case Kind::ARRAY: return NyxValue(built.arrays[node.index]);
+        case Kind::MAP: return built.maps[node.index];
+        case Kind::SHARED: return node.shared;
+        case Kind::BYTES: return NyxValue(NyxBytes::adopt(node.text));
+    }
+    return NyxValue(std::monostate{});
+}
+
+}
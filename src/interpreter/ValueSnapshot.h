@@ -0,0 +1,122 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "../common/Value.h"
+#include "../common/NumericArray.h"
+
+namespace Nyx {
+
+class NativeModuleTable;
+struct FunctionDeclarationStatement;
+
+// A deep copy of some values taken out of one isolate so that another can
+// rebuild them. The snapshot itself holds no interpreter objects (only plain
+// data, ASTs and thread-neutral values such as frozen values, struct
+// definitions, native functions, tasks and channels, which are shared rather
+// than copied), so it may be handed between threads freely.
+//
+// Functions are copied together with the parts of their closures their code
+// can reach: the scopes on the closure chain keep only bindings whose names
+// appear in one of the copied functions. Sharing and cycles among scopes,
+// functions, struct instances, numeric arrays, maps and sets are preserved. Copied functions keep pointing
+// at the original AST, which the sending interpreter must keep alive until the
+// copies are gone.
+class ValueSnapshot {
+public:
+    ValueSnapshot() = default;
+    // Throws NyxRuntimeException for values that cannot leave their isolate.
+    explicit ValueSnapshot(const std::vector<NyxValue>& values);
+
+    // Builds fresh copies owned by the calling thread.
+    std::vector<NyxValue> materialize() const;
+
+private:
+    enum class Kind {
+        NUL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        LIST,
+        FUNCTION,
+        MODULE,
+        STRUCT_INSTANCE,
+        ARRAY,
+        MAP,
+        SHARED,
+        BYTES,
+    };
+
+    struct Node {
+        Kind kind = Kind::NUL;
+        bool boolean = false;
+        double number = 0.0;
+        std::string text;  // also the contents of BYTES
+        std::vector<Node> elements;
+        size_t index = 0;  // into functions, modules, instances, arrays or maps
+        NyxValue shared;   // thread-neutral values, see isThreadNeutral()
+    };
+
+    struct EnvironmentEntry {
+        long enclosing = -1;
+        std::vector<std::pair<std::string, Node>> bindings;
+    };
+
+    struct FunctionEntry {
+        const FunctionDeclarationStatement* declaration = nullptr;
+        long closure = -1;
+    };
+
+    struct ModuleEntry {
+        std::string path;
+        const NativeModuleTable* native_table = nullptr;
+        long environment = -1;
+        bool failed = false;
+        std::string load_error;
+    };
+
+    struct InstanceEntry {
+        StructDefinitionPtr definition;
+        std::vector<Node> fields;
+    };
+
+    // Numeric array elements are copied as raw bytes.
+    struct ArrayEntry {
+        NyxNumericArray::ElementType type = NyxNumericArray::ElementType::FLOAT64;
+        size_t length = 0;
+        std::string bytes;
+    };
+
+    // Maps and sets, entries in insertion order (`values` is empty for a set).
+    struct MapEntry {
+        bool is_set = false;
+        std::vector<Node> keys;
+        std::vector<Node> values;
+    };
+
+    // The objects materialize() has created so far, by entry index.
+    struct BuiltObjects {
+        std::vector<std::shared_ptr<Environment>> environments;
+        std::vector<NyxValue> functions;
+        std::vector<NyxValue> modules;
+        std::vector<StructInstancePtr> instances;
+        std::vector<NumericArrayPtr> arrays;
+        std::vector<NyxValue> maps;
+    };
+
+    class Builder;
+
+    std::vector<Node> roots;
+    std::vector<EnvironmentEntry> environments;
+    std::vector<FunctionEntry> functions;
+    std::vector<ModuleEntry> modules;
+    std::vector<InstanceEntry> instances;
+    std::vector<ArrayEntry> arrays;
+    std::vector<MapEntry> maps;
+
+    NyxValue materializeNode(const Node& node, const BuiltObjects& built) const;
+};
+
+}
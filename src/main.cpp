@@ -1,12 +1,14 @@
 #include "./Nyx.h"
+#include "./common/Version.h"
+#include "./common/HeapAccounting.h"
 #include <iostream>
 #include <string>
 #include <vector>
 
-const std::string NIX_VERSION = "0.0.1";
+const std::string NIX_VERSION = Nyx::NYX_VERSION;
 
 void print_help() {
-    std::cout << "Usage: nyx [option] <file.nyx>" << std::endl;
+    std::cout << "Usage: nyx [option] [--max-heap <size>] [--isolates <n>] <file.nyx>" << std::endl;
     std::cout << std::endl;
     std::cout << "Description:" << std::endl;
     std::cout << "  Executes a Nyx script file (<file.nyx>) or displays information using options." << std::endl;
@@ -16,9 +18,23 @@ void print_help() {
     std::cout << "  --help, -h      Show this help message and exit." << std::endl;
     std::cout << "  --version, -v   Show version information and exit." << std::endl;
     std::cout << "  --about         Show information about the Nyx language and exit." << std::endl;
+    std::cout << "  --max-heap <size>" << std::endl;
+    std::cout << "                  Stop the script with a runtime error once it holds more than" << std::endl;
+    std::cout << "                  <size> of strings, lists, structs, scopes and syntax trees." << std::endl;
+    std::cout << "                  Accepts K, M and G suffixes (e.g. 512M). Unlimited by default." << std::endl;
+    std::cout << "  --isolates <n>  Run <n> copies of the script in parallel, each in its own" << std::endl;
+    std::cout << "                  interpreter on its own thread, and print the total wall time." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Environment:" << std::endl;
+    std::cout << "  NYX_CACHE_DIR   Directory for compiled module cache files (.nyxc)." << std::endl;
+    std::cout << "  NYX_NO_CACHE    Disable the compiled module cache when set." << std::endl;
+    std::cout << "  NYX_GC_STATS    Print garbage collector statistics to stderr on exit." << std::endl;
+    std::cout << "  NYX_TASK_WORKERS Number of std:task worker threads (default: one per core)." << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  nyx script.nyx" << std::endl;
+    std::cout << "  nyx --max-heap 256M script.nyx" << std::endl;
+    std::cout << "  nyx --isolates 8 script.nyx" << std::endl;
     std::cout << "  nyx --help" << std::endl;
     std::cout << "  nyx --version" << std::endl;
 }
@@ -50,7 +66,50 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    std::string arg1 = argv[1];
+    int arg_index = 1;
+    std::string arg1 = argv[arg_index];
+
+    unsigned isolate_count = 0;
+    while (arg1 == "--max-heap" || arg1.rfind("--max-heap=", 0) == 0 ||
+           arg1 == "--isolates" || arg1.rfind("--isolates=", 0) == 0) {
+        bool is_max_heap = arg1.rfind("--max-heap", 0) == 0;
+        std::string option_name = is_max_heap ? "--max-heap" : "--isolates";
+        std::string option_value;
+        if (arg1 == option_name) {
+            if (arg_index + 1 >= argc) {
+                std::cerr << "Error: '" << option_name << "' expects " << (is_max_heap ? "a size (e.g. 512M)." : "a number of copies to run.") << std::endl;
+                return 1;
+            }
+            option_value = argv[++arg_index];
+        } else {
+            option_value = arg1.substr(option_name.length() + 1);
+        }
+
+        if (is_max_heap) {
+            size_t limit_bytes = 0;
+            if (!Nyx::HeapAccounting::parseSize(option_value, limit_bytes) || limit_bytes == 0) {
+                std::cerr << "Error: Invalid heap size '" << option_value << "'. Use a number with an optional K, M or G suffix." << std::endl;
+                return 1;
+            }
+            Nyx::HeapAccounting::setLimit(limit_bytes);
+        } else {
+            bool is_number = !option_value.empty() && option_value.size() <= 4 &&
+                             option_value.find_first_not_of("0123456789") == std::string::npos;
+            unsigned long count = is_number ? std::stoul(option_value) : 0;
+            if (count == 0 || count > 4096) {
+                std::cerr << "Error: Invalid isolate count '" << option_value << "'. Use a number from 1 to 4096." << std::endl;
+                return 1;
+            }
+            isolate_count = static_cast<unsigned>(count);
+        }
+
+        if (++arg_index >= argc) {
+            std::cerr << "Usage: nyx <file.nyx> [script_args...] or nyx [option]" << std::endl;
+            std::cerr << "Try 'nyx --help' for more information." << std::endl;
+            return 1;
+        }
+        arg1 = argv[arg_index];
+    }
 
     if (arg1 == "--help" || arg1 == "-h") {
         print_help();
@@ -63,10 +122,8 @@ int main(int argc, char *argv[]) {
         return 0;
     } else {
         std::vector<std::string> script_args;
-        if (argc > 2) {
-            for (int i = 2; i < argc; ++i) {
-                script_args.push_back(argv[i]);
-            }
+        for (int i = arg_index + 1; i < argc; ++i) {
+            script_args.push_back(argv[i]);
         }
         
         if (arg1.rfind("--", 0) == 0 || (arg1.rfind("-", 0) == 0 && arg1.length() > 1 && arg1 != "-")) {
@@ -75,6 +132,9 @@ int main(int argc, char *argv[]) {
              return 1;
         }
 
+        if (isolate_count > 0) {
+            return Nyx::runNyxScriptIsolates(arg1, script_args, isolate_count);
+        }
         return Nyx::runNyxScript(arg1, script_args);
     }
     return 0;
@@ -12,11 +12,22 @@ namespace Nyx {
 class ExpressionVisitor;
 class StatementVisitor;
 
+// Nodes are counted as HeapKind::AST by their exact allocated size; the
+// virtual destructors make the sized delete see the same size.
 struct Expression {
     virtual ~Expression() = default;
     Token token;
     explicit Expression(Token t) : token(std::move(t)) {}
     virtual NyxValue accept(ExpressionVisitor& visitor) const = 0;
+
+    static void* operator new(std::size_t size) {
+        HeapAccounting::allocate(HeapKind::AST, size);
+        return ::operator new(size);
+    }
+    static void operator delete(void* pointer, std::size_t size) {
+        HeapAccounting::release(HeapKind::AST, size);
+        ::operator delete(pointer);
+    }
 };
 
 struct LiteralExpression : public Expression {
@@ -74,6 +85,17 @@ struct ListLiteralExpression : public Expression {
     NyxValue accept(ExpressionVisitor& visitor) const override;
 };
 
+// `{k: v, ...}` builds a map and `{a, b, ...}` a set; `{}` is an empty map.
+struct MapLiteralExpression : public Expression {
+    std::vector<std::unique_ptr<Expression>> keys;
+    std::vector<std::unique_ptr<Expression>> values; // empty for a set
+    bool is_set;
+    MapLiteralExpression(Token brace, std::vector<std::unique_ptr<Expression>> key_exprs,
+                         std::vector<std::unique_ptr<Expression>> value_exprs, bool set_literal)
+        : Expression(std::move(brace)), keys(std::move(key_exprs)), values(std::move(value_exprs)), is_set(set_literal) {}
+    NyxValue accept(ExpressionVisitor& visitor) const override;
+};
+
 struct LenExpression : public Expression {
     std::unique_ptr<Expression> argument;
     LenExpression(Token keyword_len, std::unique_ptr<Expression> arg)
@@ -127,6 +149,15 @@ struct StructInitializerExpression : public Expression {
 struct Statement {
     virtual ~Statement() = default;
     virtual void accept(StatementVisitor& visitor) const = 0;
+
+    static void* operator new(std::size_t size) {
+        HeapAccounting::allocate(HeapKind::AST, size);
+        return ::operator new(size);
+    }
+    static void operator delete(void* pointer, std::size_t size) {
+        HeapAccounting::release(HeapKind::AST, size);
+        ::operator delete(pointer);
+    }
 };
 
 struct ExpressionStatement : public Statement {
@@ -172,6 +203,7 @@ struct FunctionDeclarationStatement : public Statement {
     Token name;
     std::vector<Token> params; 
     std::unique_ptr<BlockStatement> body;
+    bool is_generator = false; // the body contains 'yield'
     FunctionDeclarationStatement(Token func_name, std::vector<Token> parameters, std::unique_ptr<BlockStatement> func_body)
         : name(std::move(func_name)), params(std::move(parameters)), body(std::move(func_body)) {}
     void accept(StatementVisitor& visitor) const override;
@@ -185,11 +217,21 @@ struct ReturnStatement : public Statement {
     void accept(StatementVisitor& visitor) const override;
 };
 
+// Only found in generator function bodies.
+struct YieldStatement : public Statement {
+    Token keyword;
+    std::unique_ptr<Expression> value;
+    YieldStatement(Token yield_keyword, std::unique_ptr<Expression> val_expr)
+        : keyword(std::move(yield_keyword)), value(std::move(val_expr)) {}
+    void accept(StatementVisitor& visitor) const override;
+};
+
 struct ImportStatement : public Statement {
     Token path_literal;
     Token alias_name;
-    ImportStatement(Token path, Token alias)
-        : path_literal(std::move(path)), alias_name(std::move(alias)) {}
+    bool is_lazy;
+    ImportStatement(Token path, Token alias, bool lazy = false)
+        : path_literal(std::move(path)), alias_name(std::move(alias)), is_lazy(lazy) {}
     void accept(StatementVisitor& visitor) const override;
 };
 
@@ -298,6 +340,7 @@ public:
     virtual NyxValue visitBinaryExpression(const BinaryExpression& expr) = 0;
     virtual NyxValue visitPostfixUpdateExpression(const PostfixUpdateExpression& expr) = 0;
     virtual NyxValue visitListLiteralExpression(const ListLiteralExpression& expr) = 0;
+    virtual NyxValue visitMapLiteralExpression(const MapLiteralExpression& expr) = 0;
     virtual NyxValue visitLenExpression(const LenExpression& expr) = 0;
     virtual NyxValue visitSubscriptExpression(const SubscriptExpression& expr) = 0;
     virtual NyxValue visitInterpolatedStringExpression(const InterpolatedStringExpression& expr) = 0;
@@ -316,6 +359,7 @@ public:
     virtual void visitPutStatement(const PutStatement& stmt) = 0;
     virtual void visitFunctionDeclarationStatement(const FunctionDeclarationStatement& stmt) = 0;
     virtual void visitReturnStatement(const ReturnStatement& stmt) = 0;
+    virtual void visitYieldStatement(const YieldStatement& stmt) = 0;
     virtual void visitImportStatement(const ImportStatement& stmt) = 0;
     virtual void visitTypedefStatement(const TypedefStatement& stmt) = 0;
     virtual void visitIfStatement(const IfStatement& stmt) = 0;
@@ -334,6 +378,7 @@ inline NyxValue UnaryExpression::accept(ExpressionVisitor& visitor) const { retu
 inline NyxValue PostfixUpdateExpression::accept(ExpressionVisitor& visitor) const { return visitor.visitPostfixUpdateExpression(*this); }
 inline NyxValue BinaryExpression::accept(ExpressionVisitor& visitor) const { return visitor.visitBinaryExpression(*this); }
 inline NyxValue ListLiteralExpression::accept(ExpressionVisitor& visitor) const { return visitor.visitListLiteralExpression(*this); }
+inline NyxValue MapLiteralExpression::accept(ExpressionVisitor& visitor) const { return visitor.visitMapLiteralExpression(*this); }
 inline NyxValue LenExpression::accept(ExpressionVisitor& visitor) const { return visitor.visitLenExpression(*this); }
 inline NyxValue SubscriptExpression::accept(ExpressionVisitor& visitor) const { return visitor.visitSubscriptExpression(*this); }
 inline NyxValue InterpolatedStringExpression::accept(ExpressionVisitor& visitor) const { return visitor.visitInterpolatedStringExpression(*this); }
@@ -348,6 +393,7 @@ inline void OutputStatement::accept(StatementVisitor& visitor) const { visitor.v
 inline void PutStatement::accept(StatementVisitor& visitor) const { visitor.visitPutStatement(*this); }
 inline void FunctionDeclarationStatement::accept(StatementVisitor& visitor) const { visitor.visitFunctionDeclarationStatement(*this); }
 inline void ReturnStatement::accept(StatementVisitor& visitor) const { visitor.visitReturnStatement(*this); }
+inline void YieldStatement::accept(StatementVisitor& visitor) const { visitor.visitYieldStatement(*this); }
 inline void ImportStatement::accept(StatementVisitor& visitor) const { visitor.visitImportStatement(*this); }
 inline void TypedefStatement::accept(StatementVisitor& visitor) const { visitor.visitTypedefStatement(*this); }
 inline void IfStatement::accept(StatementVisitor& visitor) const { visitor.visitIfStatement(*this); }
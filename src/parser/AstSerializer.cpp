@@ -0,0 +1,735 @@
+#include "./AstSerializer.h"
+#include <cstring>
+
+namespace Nyx {
+
+namespace {
+    enum NodeTag : std::uint8_t {
+        TAG_NULL = 0,
+
+        TAG_LITERAL,
+        TAG_IDENTIFIER,
+        TAG_ASSIGNMENT,
+        TAG_UNARY,
+        TAG_BINARY,
+        TAG_POSTFIX_UPDATE,
+        TAG_LIST_LITERAL,
+        TAG_LEN,
+        TAG_SUBSCRIPT,
+        TAG_INTERPOLATED_STRING,
+        TAG_CALL,
+        TAG_MEMBER_ACCESS,
+        TAG_STRUCT_INITIALIZER,
+        TAG_MAP_LITERAL,
+        TAG_SET_LITERAL,
+
+        TAG_EXPRESSION_STMT = 64,
+        TAG_BLOCK,
+        TAG_VARIABLE_DECLARATION,
+        TAG_OUTPUT,
+        TAG_PUT,
+        TAG_FUNCTION_DECLARATION,
+        TAG_RETURN,
+        TAG_IMPORT,
+        TAG_TYPEDEF,
+        TAG_IF,
+        TAG_FOR,
+        TAG_FOREACH,
+        TAG_SWITCH,
+        TAG_STRUCT_DECLARATION,
+        TAG_BREAK,
+        TAG_CONTINUE,
+        TAG_YIELD,
+    };
+
+    enum LiteralTag : std::uint8_t {
+        LITERAL_NULL = 0,
+        LITERAL_BOOL,
+        LITERAL_NUMBER,
+        LITERAL_STRING,
+    };
+
+    enum SegmentTag : std::uint8_t {
+        SEGMENT_TEXT = 0,
+        SEGMENT_EXPRESSION,
+    };
+}
+
+void AstWriter::writeProgram(const std::vector<std::unique_ptr<Statement>>& program) {
+    writeStatements(program);
+}
+
+void AstWriter::writeU8(std::uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+void AstWriter::writeU32(std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+void AstWriter::writeU64(std::uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+void AstWriter::writeI32(std::int32_t value) {
+    writeU32(static_cast<std::uint32_t>(value));
+}
+
+void AstWriter::writeString(const std::string& value) {
+    writeU32(static_cast<std::uint32_t>(value.size()));
+    out.append(value);
+}
+
+void AstWriter::writeToken(const Token& token) {
+    writeU8(static_cast<std::uint8_t>(token.type));
+    writeString(token.lexeme);
+    writeI32(token.line);
+}
+
+void AstWriter::writeTokens(const std::vector<Token>& tokens) {
+    writeU32(static_cast<std::uint32_t>(tokens.size()));
+    for (const Token& token : tokens) {
+        writeToken(token);
+    }
+}
+
+void AstWriter::writeStatement(const Statement* stmt) {
+    if (!stmt) {
+        writeU8(TAG_NULL);
+        return;
+    }
+    stmt->accept(*this);
+}
+
+void AstWriter::writeStatements(const std::vector<std::unique_ptr<Statement>>& stmts) {
+    writeU32(static_cast<std::uint32_t>(stmts.size()));
+    for (const auto& stmt : stmts) {
+        writeStatement(stmt.get());
+    }
+}
+
+void AstWriter::writeExpression(const Expression* expr) {
+    if (!expr) {
+        writeU8(TAG_NULL);
+        return;
+    }
+    expr->accept(*this);
+}
+
+void AstWriter::writeExpressions(const std::vector<std::unique_ptr<Expression>>& exprs) {
+    writeU32(static_cast<std::uint32_t>(exprs.size()));
+    for (const auto& expr : exprs) {
+        writeExpression(expr.get());
+    }
+}
+
+NyxValue AstWriter::visitLiteralExpression(const LiteralExpression& expr) {
+    writeU8(TAG_LITERAL);
+    writeToken(expr.token);
+    const auto& value = expr.value.data;
+    if (std::holds_alternative<bool>(value)) {
+        writeU8(LITERAL_BOOL);
+        writeU8(std::get<bool>(value) ? 1 : 0);
+    } else if (std::holds_alternative<double>(value)) {
+        writeU8(LITERAL_NUMBER);
+        std::uint64_t bits;
+        double number = std::get<double>(value);
+        std::memcpy(&bits, &number, sizeof(bits));
+        writeU64(bits);
+    } else if (std::holds_alternative<std::string>(value)) {
+        writeU8(LITERAL_STRING);
+        writeString(std::get<std::string>(value));
+    } else {
+        writeU8(LITERAL_NULL);
+    }
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitIdentifierExpression(const IdentifierExpression& expr) {
+    writeU8(TAG_IDENTIFIER);
+    writeToken(expr.token);
+    writeString(expr.name);
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitAssignmentExpression(const AssignmentExpression& expr) {
+    writeU8(TAG_ASSIGNMENT);
+    writeExpression(expr.target.get());
+    writeToken(expr.equals_token);
+    writeExpression(expr.value.get());
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitUnaryExpression(const UnaryExpression& expr) {
+    writeU8(TAG_UNARY);
+    writeToken(expr.operator_token);
+    writeExpression(expr.right.get());
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitBinaryExpression(const BinaryExpression& expr) {
+    writeU8(TAG_BINARY);
+    writeExpression(expr.left.get());
+    writeToken(expr.operator_token);
+    writeExpression(expr.right.get());
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitPostfixUpdateExpression(const PostfixUpdateExpression& expr) {
+    writeU8(TAG_POSTFIX_UPDATE);
+    writeExpression(expr.operand.get());
+    writeToken(expr.operator_token);
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitListLiteralExpression(const ListLiteralExpression& expr) {
+    writeU8(TAG_LIST_LITERAL);
+    writeToken(expr.token);
+    writeExpressions(expr.elements);
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitMapLiteralExpression(const MapLiteralExpression& expr) {
+    writeU8(expr.is_set ? TAG_SET_LITERAL : TAG_MAP_LITERAL);
+    writeToken(expr.token);
+    writeExpressions(expr.keys);
+    if (!expr.is_set) {
+        writeExpressions(expr.values);
+    }
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitLenExpression(const LenExpression& expr) {
+    writeU8(TAG_LEN);
+    writeToken(expr.token);
+    writeExpression(expr.argument.get());
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitSubscriptExpression(const SubscriptExpression& expr) {
+    writeU8(TAG_SUBSCRIPT);
+    writeToken(expr.token);
+    writeExpression(expr.object.get());
+    writeExpression(expr.index.get());
+    writeToken(expr.closing_bracket);
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitInterpolatedStringExpression(const InterpolatedStringExpression& expr) {
+    writeU8(TAG_INTERPOLATED_STRING);
+    writeToken(expr.token);
+    writeU32(static_cast<std::uint32_t>(expr.segments.size()));
+    for (const auto& segment : expr.segments) {
+        if (std::holds_alternative<std::string>(segment)) {
+            writeU8(SEGMENT_TEXT);
+            writeString(std::get<std::string>(segment));
+        } else {
+            writeU8(SEGMENT_EXPRESSION);
+            writeExpression(std::get<std::unique_ptr<Expression>>(segment).get());
+        }
+    }
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitCallExpression(const CallExpression& expr) {
+    writeU8(TAG_CALL);
+    writeExpression(expr.callee.get());
+    writeToken(expr.paren);
+    writeExpressions(expr.arguments);
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitMemberAccessExpression(const MemberAccessExpression& expr) {
+    writeU8(TAG_MEMBER_ACCESS);
+    writeExpression(expr.object.get());
+    writeToken(expr.name);
+    return NyxValue();
+}
+
+NyxValue AstWriter::visitStructInitializerExpression(const StructInitializerExpression& expr) {
+    writeU8(TAG_STRUCT_INITIALIZER);
+    writeToken(expr.name_token);
+    writeU32(static_cast<std::uint32_t>(expr.initializers.size()));
+    for (const auto& initializer : expr.initializers) {
+        writeToken(initializer.first);
+        writeExpression(initializer.second.get());
+    }
+    return NyxValue();
+}
+
+void AstWriter::visitExpressionStatement(const ExpressionStatement& stmt) {
+    writeU8(TAG_EXPRESSION_STMT);
+    writeExpression(stmt.expression.get());
+}
+
+void AstWriter::visitBlockStatement(const BlockStatement& stmt) {
+    writeU8(TAG_BLOCK);
+    writeStatements(stmt.statements);
+}
+
+void AstWriter::visitVariableDeclarationStatement(const VariableDeclarationStatement& stmt) {
+    writeU8(TAG_VARIABLE_DECLARATION);
+    writeToken(stmt.keyword_auto);
+    writeToken(stmt.identifier);
+    writeExpression(stmt.initializer.get());
+}
+
+void AstWriter::visitOutputStatement(const OutputStatement& stmt) {
+    writeU8(TAG_OUTPUT);
+    writeToken(stmt.keyword_output);
+    writeExpression(stmt.argument.get());
+}
+
+void AstWriter::visitPutStatement(const PutStatement& stmt) {
+    writeU8(TAG_PUT);
+    writeToken(stmt.keyword_put);
+    writeExpression(stmt.argument.get());
+}
+
+void AstWriter::visitFunctionDeclarationStatement(const FunctionDeclarationStatement& stmt) {
+    writeU8(TAG_FUNCTION_DECLARATION);
+    writeToken(stmt.name);
+    writeTokens(stmt.params);
+    writeStatement(stmt.body.get());
+    writeU8(stmt.is_generator ? 1 : 0);
+}
+
+void AstWriter::visitReturnStatement(const ReturnStatement& stmt) {
+    writeU8(TAG_RETURN);
+    writeToken(stmt.keyword);
+    writeExpression(stmt.value.get());
+}
+
+void AstWriter::visitYieldStatement(const YieldStatement& stmt) {
+    writeU8(TAG_YIELD);
+    writeToken(stmt.keyword);
+    writeExpression(stmt.value.get());
+}
+
+void AstWriter::visitImportStatement(const ImportStatement& stmt) {
+    writeU8(TAG_IMPORT);
+    writeToken(stmt.path_literal);
+    writeToken(stmt.alias_name);
+    writeU8(stmt.is_lazy ? 1 : 0);
+}
+
+void AstWriter::visitTypedefStatement(const TypedefStatement& stmt) {
+    writeU8(TAG_TYPEDEF);
+    writeToken(stmt.keyword_at_typedef);
+    writeExpression(stmt.expression_to_check.get());
+}
+
+void AstWriter::visitIfStatement(const IfStatement& stmt) {
+    writeU8(TAG_IF);
+    writeExpression(stmt.condition.get());
+    writeStatement(stmt.then_branch.get());
+    writeStatement(stmt.else_branch.get());
+}
+
+void AstWriter::visitForStatement(const ForStatement& stmt) {
+    writeU8(TAG_FOR);
+    writeStatement(stmt.initializer.get());
+    writeExpression(stmt.condition.get());
+    writeStatement(stmt.increment.get());
+    writeStatement(stmt.body.get());
+}
+
+void AstWriter::visitForeachStatement(const ForeachStatement& stmt) {
+    writeU8(TAG_FOREACH);
+    writeToken(stmt.foreach_token);
+    writeToken(stmt.loop_variable_token);
+    writeExpression(stmt.iterable_expression.get());
+    writeStatement(stmt.body_statement.get());
+}
+
+void AstWriter::visitSwitchStatement(const SwitchStatement& stmt) {
+    writeU8(TAG_SWITCH);
+    writeToken(stmt.switch_token);
+    writeExpression(stmt.condition.get());
+    writeU32(static_cast<std::uint32_t>(stmt.cases.size()));
+    for (const CaseBlock& case_block : stmt.cases) {
+        writeToken(case_block.case_or_default_token);
+        writeExpression(case_block.value_expression.get());
+        writeStatements(case_block.statements);
+        writeU8(case_block.is_default ? 1 : 0);
+    }
+    writeToken(stmt.closing_brace_token);
+}
+
+void AstWriter::visitStructDeclarationStatement(const StructDeclarationStatement& stmt) {
+    writeU8(TAG_STRUCT_DECLARATION);
+    writeToken(stmt.struct_keyword_token);
+    writeToken(stmt.name_token);
+    writeTokens(stmt.field_name_tokens);
+}
+
+void AstWriter::visitBreakStatement(const BreakStatement& stmt) {
+    writeU8(TAG_BREAK);
+    writeToken(stmt.keyword_break);
+}
+
+void AstWriter::visitContinueStatement(const ContinueStatement& stmt) {
+    writeU8(TAG_CONTINUE);
+    writeToken(stmt.keyword_continue);
+}
+
+std::vector<std::unique_ptr<Statement>> AstReader::readProgram() {
+    return readStatements();
+}
+
+void AstReader::require(size_t count) {
+    if (static_cast<size_t>(end - cursor) < count) {
+        throw AstFormatError("Unexpected end of serialized AST.");
+    }
+}
+
+std::uint8_t AstReader::readU8() {
+    require(1);
+    return static_cast<std::uint8_t>(*cursor++);
+}
+
+std::uint32_t AstReader::readU32() {
+    require(4);
+    std::uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(*cursor++)) << shift;
+    }
+    return value;
+}
+
+std::uint64_t AstReader::readU64() {
+    require(8);
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 8) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(*cursor++)) << shift;
+    }
+    return value;
+}
+
+std::int32_t AstReader::readI32() {
+    return static_cast<std::int32_t>(readU32());
+}
+
+std::string AstReader::readString() {
+    std::uint32_t length = readU32();
+    require(length);
+    std::string value(cursor, length);
+    cursor += length;
+    return value;
+}
+
+size_t AstReader::readCount() {
+    std::uint32_t count = readU32();
+    // Every element occupies at least one byte, so a larger count can only
+    // come from a damaged file; reject it before reserving anything.
+    require(count);
+    return count;
+}
+
+Token AstReader::readToken() {
+    std::uint8_t type = readU8();
+    if (type > static_cast<std::uint8_t>(TokenType::UNKNOWN)) {
+        throw AstFormatError("Invalid token type in serialized AST.");
+    }
+    std::string lexeme = readString();
+    int line = readI32();
+    return Token(static_cast<TokenType>(type), std::move(lexeme), line);
+}
+
+std::vector<Token> AstReader::readTokens() {
+    size_t count = readCount();
+    std::vector<Token> tokens;
+    tokens.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        tokens.push_back(readToken());
+    }
+    return tokens;
+}
+
+std::vector<std::unique_ptr<Statement>> AstReader::readStatements() {
+    size_t count = readCount();
+    std::vector<std::unique_ptr<Statement>> stmts;
+    stmts.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        stmts.push_back(readStatement());
+    }
+    return stmts;
+}
+
+std::unique_ptr<BlockStatement> AstReader::readBlock() {
+    if (readU8() != TAG_BLOCK) {
+        throw AstFormatError("Expected block statement in serialized AST.");
+    }
+    return std::make_unique<BlockStatement>(readStatements());
+}
+
+std::vector<std::unique_ptr<Expression>> AstReader::readExpressions() {
+    size_t count = readCount();
+    std::vector<std::unique_ptr<Expression>> exprs;
+    exprs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        exprs.push_back(requireExpression());
+    }
+    return exprs;
+}
+
+std::unique_ptr<Expression> AstReader::requireExpression() {
+    std::unique_ptr<Expression> expr = readExpression();
+    if (!expr) {
+        throw AstFormatError("Missing required expression in serialized AST.");
+    }
+    return expr;
+}
+
+std::unique_ptr<Expression> AstReader::readExpression() {
+    std::uint8_t tag = readU8();
+    switch (tag) {
+        case TAG_NULL:
+            return nullptr;
+        case TAG_LITERAL: {
+            Token token = readToken();
+            NyxValue value;
+            switch (readU8()) {
+                case LITERAL_NULL:
+                    break;
+                case LITERAL_BOOL:
+                    value = NyxValue(readU8() != 0);
+                    break;
+                case LITERAL_NUMBER: {
+                    std::uint64_t bits = readU64();
+                    double number;
+                    std::memcpy(&number, &bits, sizeof(number));
+                    value = NyxValue(number);
+                    break;
+                }
+                case LITERAL_STRING:
+                    value = NyxValue(readString());
+                    break;
+                default:
+                    throw AstFormatError("Invalid literal kind in serialized AST.");
+            }
+            return std::make_unique<LiteralExpression>(std::move(token), std::move(value));
+        }
+        case TAG_IDENTIFIER: {
+            Token token = readToken();
+            std::string name = readString();
+            return std::make_unique<IdentifierExpression>(std::move(token), std::move(name));
+        }
+        case TAG_ASSIGNMENT: {
+            auto target = requireExpression();
+            Token equals_token = readToken();
+            auto value = requireExpression();
+            return std::make_unique<AssignmentExpression>(std::move(target), std::move(equals_token), std::move(value));
+        }
+        case TAG_UNARY: {
+            Token op = readToken();
+            auto right = requireExpression();
+            return std::make_unique<UnaryExpression>(std::move(op), std::move(right));
+        }
+        case TAG_BINARY: {
+            auto left = requireExpression();
+            Token op = readToken();
+            auto right = requireExpression();
+            return std::make_unique<BinaryExpression>(std::move(left), std::move(op), std::move(right));
+        }
+        case TAG_POSTFIX_UPDATE: {
+            auto operand = requireExpression();
+            Token op = readToken();
+            return std::make_unique<PostfixUpdateExpression>(std::move(operand), std::move(op));
+        }
+        case TAG_LIST_LITERAL: {
+            Token bracket = readToken();
+            auto elements = readExpressions();
+            return std::make_unique<ListLiteralExpression>(std::move(bracket), std::move(elements));
+        }
+        case TAG_MAP_LITERAL:
+        case TAG_SET_LITERAL: {
+            Token brace = readToken();
+            auto keys = readExpressions();
+            std::vector<std::unique_ptr<Expression>> values;
+            if (tag == TAG_MAP_LITERAL) {
+                values = readExpressions();
+                if (values.size() != keys.size()) {
+                    throw AstFormatError("Map literal with mismatched keys and values in serialized AST.");
+                }
+            }
+            return std::make_unique<MapLiteralExpression>(std::move(brace), std::move(keys), std::move(values), tag == TAG_SET_LITERAL);
+        }
+        case TAG_LEN: {
+            Token keyword = readToken();
+            auto argument = requireExpression();
+            return std::make_unique<LenExpression>(std::move(keyword), std::move(argument));
+        }
+        case TAG_SUBSCRIPT: {
+            Token bracket = readToken();
+            auto object = requireExpression();
+            auto index = requireExpression();
+            Token closing_bracket = readToken();
+            return std::make_unique<SubscriptExpression>(std::move(bracket), std::move(object), std::move(index), std::move(closing_bracket));
+        }
+        case TAG_INTERPOLATED_STRING: {
+            Token token = readToken();
+            size_t count = readCount();
+            std::vector<std::variant<std::string, std::unique_ptr<Expression>>> segments;
+            segments.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                std::uint8_t segment_tag = readU8();
+                if (segment_tag == SEGMENT_TEXT) {
+                    segments.emplace_back(readString());
+                } else if (segment_tag == SEGMENT_EXPRESSION) {
+                    segments.emplace_back(requireExpression());
+                } else {
+                    throw AstFormatError("Invalid interpolation segment in serialized AST.");
+                }
+            }
+            return std::make_unique<InterpolatedStringExpression>(std::move(token), std::move(segments));
+        }
+        case TAG_CALL: {
+            auto callee = requireExpression();
+            Token paren = readToken();
+            auto arguments = readExpressions();
+            return std::make_unique<CallExpression>(std::move(callee), std::move(paren), std::move(arguments));
+        }
+        case TAG_MEMBER_ACCESS: {
+            auto object = requireExpression();
+            Token name = readToken();
+            return std::make_unique<MemberAccessExpression>(std::move(object), std::move(name));
+        }
+        case TAG_STRUCT_INITIALIZER: {
+            Token name_token = readToken();
+            size_t count = readCount();
+            std::vector<std::pair<Token, std::unique_ptr<Expression>>> initializers;
+            initializers.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                Token field = readToken();
+                initializers.emplace_back(std::move(field), requireExpression());
+            }
+            return std::make_unique<StructInitializerExpression>(std::move(name_token), std::move(initializers));
+        }
+        default:
+            throw AstFormatError("Invalid expression tag " + std::to_string(tag) + " in serialized AST.");
+    }
+}
+
+std::unique_ptr<Statement> AstReader::readStatement() {
+    std::uint8_t tag = readU8();
+    switch (tag) {
+        case TAG_NULL:
+            return nullptr;
+        case TAG_EXPRESSION_STMT:
+            return std::make_unique<ExpressionStatement>(requireExpression());
+        case TAG_BLOCK:
+            return std::make_unique<BlockStatement>(readStatements());
+        case TAG_VARIABLE_DECLARATION: {
+            Token keyword = readToken();
+            Token identifier = readToken();
+            auto initializer = readExpression();
+            return std::make_unique<VariableDeclarationStatement>(std::move(keyword), std::move(identifier), std::move(initializer));
+        }
+        case TAG_OUTPUT: {
+            Token keyword = readToken();
+            auto argument = requireExpression();
+            return std::make_unique<OutputStatement>(std::move(keyword), std::move(argument));
+        }
+        case TAG_PUT: {
+            Token keyword = readToken();
+            auto argument = requireExpression();
+            return std::make_unique<PutStatement>(std::move(keyword), std::move(argument));
+        }
+        case TAG_FUNCTION_DECLARATION: {
+            Token name = readToken();
+            std::vector<Token> params = readTokens();
+            auto body = readBlock();
+            auto declaration = std::make_unique<FunctionDeclarationStatement>(std::move(name), std::move(params), std::move(body));
+            declaration->is_generator = readU8() != 0;
+            return declaration;
+        }
+        case TAG_RETURN: {
+            Token keyword = readToken();
+            auto value = readExpression();
+            return std::make_unique<ReturnStatement>(std::move(keyword), std::move(value));
+        }
+        case TAG_YIELD: {
+            Token keyword = readToken();
+            auto value = requireExpression();
+            return std::make_unique<YieldStatement>(std::move(keyword), std::move(value));
+        }
+        case TAG_IMPORT: {
+            Token path = readToken();
+            Token alias = readToken();
+            bool is_lazy = readU8() != 0;
+            return std::make_unique<ImportStatement>(std::move(path), std::move(alias), is_lazy);
+        }
+        case TAG_TYPEDEF: {
+            Token keyword = readToken();
+            auto expression = requireExpression();
+            return std::make_unique<TypedefStatement>(std::move(keyword), std::move(expression));
+        }
+        case TAG_IF: {
+            auto condition = requireExpression();
+            auto then_branch = readStatement();
+            if (!then_branch) {
+                throw AstFormatError("Missing 'if' branch in serialized AST.");
+            }
+            auto else_branch = readStatement();
+            return std::make_unique<IfStatement>(std::move(condition), std::move(then_branch), std::move(else_branch));
+        }
+        case TAG_FOR: {
+            auto initializer = readStatement();
+            auto condition = readExpression();
+            auto increment = readStatement();
+            auto body = readStatement();
+            if (!body) {
+                throw AstFormatError("Missing 'for' body in serialized AST.");
+            }
+            return std::make_unique<ForStatement>(std::move(initializer), std::move(condition), std::move(increment), std::move(body));
+        }
+        case TAG_FOREACH: {
+            Token foreach_token = readToken();
+            Token loop_variable = readToken();
+            auto iterable = requireExpression();
+            auto body = readStatement();
+            if (!body) {
+                throw AstFormatError("Missing 'foreach' body in serialized AST.");
+            }
+            return std::make_unique<ForeachStatement>(std::move(foreach_token), std::move(loop_variable), std::move(iterable), std::move(body));
+        }
+        case TAG_SWITCH: {
+            Token switch_token = readToken();
+            auto condition = requireExpression();
+            size_t count = readCount();
+            std::vector<CaseBlock> cases;
+            cases.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                Token case_token = readToken();
+                auto value = readExpression();
+                auto stmts = readStatements();
+                bool is_default = readU8() != 0;
+                if (!is_default && !value) {
+                    throw AstFormatError("Missing 'case' value in serialized AST.");
+                }
+                cases.emplace_back(std::move(case_token), std::move(value), std::move(stmts), is_default);
+            }
+            Token closing_brace = readToken();
+            return std::make_unique<SwitchStatement>(std::move(switch_token), std::move(condition), std::move(cases), std::move(closing_brace));
+        }
+        case TAG_STRUCT_DECLARATION: {
+            Token keyword = readToken();
+            Token name = readToken();
+            std::vector<Token> fields = readTokens();
+            return std::make_unique<StructDeclarationStatement>(std::move(keyword), std::move(name), std::move(fields));
+        }
+        case TAG_BREAK:
+            return std::make_unique<BreakStatement>(readToken());
+        case TAG_CONTINUE:
+            return std::make_unique<ContinueStatement>(readToken());
+        default:
+            throw AstFormatError("Invalid statement tag " + std::to_string(tag) + " in serialized AST.");
+    }
+}
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+#include "../parser/AstNodes.h"
+
+namespace Nyx {
+
+// Bump whenever a node's layout or the set of node kinds changes, so that
+// stale .nyxc files are rejected instead of misread.
+constexpr std::uint32_t AST_FORMAT_VERSION = 4;
+
+class AstFormatError : public std::runtime_error {
+public:
+    explicit AstFormatError(const std::string& message) : std::runtime_error(message) {}
+};
+
+class AstWriter : public StatementVisitor, public ExpressionVisitor {
+public:
+    explicit AstWriter(std::string& output) : out(output) {}
+
+    void writeProgram(const std::vector<std::unique_ptr<Statement>>& program);
+
+    void writeU8(std::uint8_t value);
+    void writeU32(std::uint32_t value);
+    void writeU64(std::uint64_t value);
+    void writeString(const std::string& value);
+
+    void visitExpressionStatement(const ExpressionStatement& stmt) override;
+    void visitBlockStatement(const BlockStatement& stmt) override;
+    void visitVariableDeclarationStatement(const VariableDeclarationStatement& stmt) override;
+    void visitOutputStatement(const OutputStatement& stmt) override;
+    void visitPutStatement(const PutStatement& stmt) override;
+    void visitFunctionDeclarationStatement(const FunctionDeclarationStatement& stmt) override;
+    void visitReturnStatement(const ReturnStatement& stmt) override;
+    void visitYieldStatement(const YieldStatement& stmt) override;
+    void visitImportStatement(const ImportStatement& stmt) override;
+    void visitTypedefStatement(const TypedefStatement& stmt) override;
+    void visitIfStatement(const IfStatement& stmt) override;
+    void visitForStatement(const ForStatement& stmt) override;
+    void visitForeachStatement(const ForeachStatement& stmt) override;
+    void visitSwitchStatement(const SwitchStatement& stmt) override;
+    void visitStructDeclarationStatement(const StructDeclarationStatement& stmt) override;
+    void visitBreakStatement(const BreakStatement& stmt) override;
+    void visitContinueStatement(const ContinueStatement& stmt) override;
+
+    NyxValue visitLiteralExpression(const LiteralExpression& expr) override;
+    NyxValue visitIdentifierExpression(const IdentifierExpression& expr) override;
+    NyxValue visitAssignmentExpression(const AssignmentExpression& expr) override;
+    NyxValue visitUnaryExpression(const UnaryExpression& expr) override;
+    NyxValue visitBinaryExpression(const BinaryExpression& expr) override;
+    NyxValue visitPostfixUpdateExpression(const PostfixUpdateExpression& expr) override;
+    NyxValue visitListLiteralExpression(const ListLiteralExpression& expr) override;
+    NyxValue visitMapLiteralExpression(const MapLiteralExpression& expr) override;
+    NyxValue visitLenExpression(const LenExpression& expr) override;
+    NyxValue visitSubscriptExpression(const SubscriptExpression& expr) override;
+    NyxValue visitInterpolatedStringExpression(const InterpolatedStringExpression& expr) override;
+    NyxValue visitCallExpression(const CallExpression& expr) override;
+    NyxValue visitMemberAccessExpression(const MemberAccessExpression& expr) override;
+    NyxValue visitStructInitializerExpression(const StructInitializerExpression& expr) override;
+
+private:
+    std::string& out;
+
+    void writeI32(std::int32_t value);
+    void writeToken(const Token& token);
+    void writeTokens(const std::vector<Token>& tokens);
+    void writeStatement(const Statement* stmt);
+    void writeStatements(const std::vector<std::unique_ptr<Statement>>& stmts);
+    void writeExpression(const Expression* expr);
+    void writeExpressions(const std::vector<std::unique_ptr<Expression>>& exprs);
+};
+
+// Reads a program written by AstWriter. Every read is bounds-checked and every
+// tag validated; malformed input raises AstFormatError rather than crashing.
+class AstReader {
+public:
+    AstReader(const char* data, size_t size) : cursor(data), end(data + size) {}
+
+    std::vector<std::unique_ptr<Statement>> readProgram();
+
+    std::uint8_t readU8();
+    std::uint32_t readU32();
+    std::uint64_t readU64();
+    std::string readString();
+    bool atEnd() const { return cursor == end; }
+    size_t remaining() const { return static_cast<size_t>(end - cursor); }
+
+private:
+    const char* cursor;
+    const char* end;
+
+    void require(size_t count);
+    std::int32_t readI32();
+    size_t readCount();
+    Token readToken();
+    std::vector<Token> readTokens();
+    std::unique_ptr<Statement> readStatement();
+    std::vector<std::unique_ptr<Statement>> readStatements();
+    std::unique_ptr<BlockStatement> readBlock();
+    std::unique_ptr<Expression> readExpression();
+    std::unique_ptr<Expression> requireExpression();
+    std::vector<std::unique_ptr<Expression>> readExpressions();
+};
+
+}
@@ -1,5 +1,4 @@
 #include "../parser/Parser.h"
-#include "../tokenizer/Tokenizer.h" 
 #include <stdexcept>
 #include <iostream>
 #include <string>
@@ -9,13 +8,14 @@
 
 namespace Nyx {
 
-Parser::Parser(std::vector<Token> tokens_list) : tokens(std::move(tokens_list)), current(0), current_line_for_sub_parsing(0) {}
+Parser::Parser(std::vector<Token> tokens_list, std::ostream& diagnostics_stream)
+    : tokens(std::move(tokens_list)), diagnostics(diagnostics_stream), current(0) {}
 
 bool Parser::isAtEnd() const {
     return peek().type == TokenType::END_OF_FILE;
 }
 
-Token Parser::peek() const {
+const Token& Parser::peek() const {
     if (current < tokens.size()) {
         return tokens[current];
     }
@@ -26,7 +26,7 @@ Token Parser::peek() const {
     return dummy_eof_token_static;
 }
 
-Token Parser::previous() const {
+const Token& Parser::previous() const {
      if (current > 0 && current <= tokens.size()) {
         return tokens[current - 1];
     }
@@ -42,7 +42,7 @@ bool Parser::checkNext(TokenType type) const {
     return tokens[current + 1].type == type;
 }
 
-Token Parser::advance() {
+const Token& Parser::advance() {
     if (!isAtEnd()) current++;
     return previous();
 }
@@ -52,24 +52,14 @@ bool Parser::check(TokenType type) const {
     return peek().type == type;
 }
 
-bool Parser::match(const std::vector<TokenType>& types) {
-    for (TokenType type : types) {
-        if (check(type)) {
-            advance();
-            return true;
-        }
-    }
-    return false;
-}
-
-Token Parser::consume(TokenType type, const std::string& message) {
+const Token& Parser::consume(TokenType type, const std::string& message) {
     if (check(type)) return advance();
     
-    int error_line = current_line_for_sub_parsing > 0 ? current_line_for_sub_parsing : peek().line;
+    int error_line = peek().line;
     if (peek().type == TokenType::END_OF_FILE && !tokens.empty() && current > 0) {
          error_line = tokens[current-1].line;
     } else if (tokens.empty() || peek().type == TokenType::END_OF_FILE) {
-        error_line = current_line_for_sub_parsing > 0 ? current_line_for_sub_parsing : 1;
+        error_line = 1;
     }
 
     throw Common::NyxParserException(message, error_line);
@@ -102,6 +92,7 @@ std::unique_ptr<Statement> Parser::statement() {
     if (check(TokenType::KEYWORD_BREAK)) return breakStatement();
     if (check(TokenType::KEYWORD_CONTINUE)) return continueStatement();
     if (check(TokenType::KEYWORD_RETURN)) return returnStatement();
+    if (check(TokenType::KEYWORD_YIELD)) return yieldStatement();
     if (check(TokenType::LEFT_BRACE)) return blockStatement();
     if (check(TokenType::KEYWORD_OUTPUT)) return outputStatement();
     if (check(TokenType::KEYWORD_PUT)) return putStatement();
@@ -111,8 +102,8 @@ std::unique_ptr<Statement> Parser::statement() {
 }
 
 std::unique_ptr<Statement> Parser::structDeclarationStatement() {
-    Token struct_token = consume(TokenType::KEYWORD_STRUCT, "Expected 'struct' keyword.");
-    Token name_token = consume(TokenType::IDENTIFIER, "Expected struct name.");
+    const Token& struct_token = consume(TokenType::KEYWORD_STRUCT, "Expected 'struct' keyword.");
+    const Token& name_token = consume(TokenType::IDENTIFIER, "Expected struct name.");
     consume(TokenType::LEFT_BRACE, "Expected '{' after struct name.");
 
     std::vector<Token> field_name_tokens;
@@ -126,7 +117,7 @@ std::unique_ptr<Statement> Parser::structDeclarationStatement() {
 }
 
 std::unique_ptr<FunctionDeclarationStatement> Parser::functionDeclarationStatement() {
-    Token name = consume(TokenType::IDENTIFIER, "Expected function name.");
+    const Token& name = consume(TokenType::IDENTIFIER, "Expected function name.");
     consume(TokenType::LEFT_PAREN, "Expected '(' after function name.");
     std::vector<Token> parameters;
     if (!check(TokenType::RIGHT_PAREN)) {
@@ -135,7 +126,7 @@ std::unique_ptr<FunctionDeclarationStatement> Parser::functionDeclarationStateme
                 throw Common::NyxParserException("Cannot have more than 255 parameters.", peek().line);
             }
             parameters.push_back(consume(TokenType::IDENTIFIER, "Expected parameter name."));
-        } while (match({TokenType::COMMA}));
+        } while (match(TokenType::COMMA));
     }
     consume(TokenType::RIGHT_PAREN, "Expected ')' after parameters.");
     
@@ -144,35 +135,70 @@ std::unique_ptr<FunctionDeclarationStatement> Parser::functionDeclarationStateme
     if (!check(TokenType::LEFT_BRACE)) {
         throw Common::NyxParserException("Expected function body (e.g. '{ ... }').", peek().line);
     }
-    std::unique_ptr<Statement> body_stmt = blockStatement();
+    FunctionContext context;
+    FunctionContext* enclosing_context = function_context;
+    function_context = &context;
+    std::unique_ptr<Statement> body_stmt;
+    try {
+        body_stmt = blockStatement();
+    } catch (...) {
+        function_context = enclosing_context;
+        throw;
+    }
+    function_context = enclosing_context;
     auto block_body = std::unique_ptr<BlockStatement>(static_cast<BlockStatement*>(body_stmt.release()));
 
+    if (context.yields && context.value_return_line != 0) {
+        throw Common::NyxParserException("A generator cannot return a value (use 'yield').", context.value_return_line);
+    }
 
-    return std::make_unique<FunctionDeclarationStatement>(name, parameters, std::move(block_body));
+    auto declaration = std::make_unique<FunctionDeclarationStatement>(name, parameters, std::move(block_body));
+    declaration->is_generator = context.yields;
+    return declaration;
 }
 
 std::unique_ptr<ImportStatement> Parser::importStatement() {
     consume(TokenType::KEYWORD_IMPORT, "Expected 'import'.");
-    Token path_literal = consume(TokenType::STRING_LITERAL, "Expected file path string after 'import'.");
+    // 'lazy' is contextual so it stays usable as an ordinary identifier.
+    bool is_lazy = false;
+    if (check(TokenType::IDENTIFIER) && peek().lexeme == "lazy" && checkNext(TokenType::STRING_LITERAL)) {
+        advance();
+        is_lazy = true;
+    }
+    const Token& path_literal = consume(TokenType::STRING_LITERAL, "Expected file path string after 'import'.");
     consume(TokenType::KEYWORD_AS, "Expected 'as' after file path in import statement.");
-    Token alias_name = consume(TokenType::IDENTIFIER, "Expected module alias name after 'as'.");
+    const Token& alias_name = consume(TokenType::IDENTIFIER, "Expected module alias name after 'as'.");
     consume(TokenType::SEMICOLON, "Expected ';' after import statement.");
-    return std::make_unique<ImportStatement>(path_literal, alias_name);
+    return std::make_unique<ImportStatement>(path_literal, alias_name, is_lazy);
 }
 
 std::unique_ptr<Statement> Parser::returnStatement() {
-    Token keyword = consume(TokenType::KEYWORD_RETURN, "Expected 'return'.");
+    const Token& keyword = consume(TokenType::KEYWORD_RETURN, "Expected 'return'.");
     std::unique_ptr<Expression> value = nullptr;
     if (!check(TokenType::SEMICOLON)) {
         value = expression();
     }
     consume(TokenType::SEMICOLON, "Expected ';' after return value.");
+    if (value && function_context && function_context->value_return_line == 0) {
+        function_context->value_return_line = keyword.line;
+    }
     return std::make_unique<ReturnStatement>(keyword, std::move(value));
 }
 
+std::unique_ptr<Statement> Parser::yieldStatement() {
+    const Token& keyword = consume(TokenType::KEYWORD_YIELD, "Expected 'yield'.");
+    if (!function_context) {
+        throw Common::NyxParserException("'yield' can only be used inside a function.", keyword.line);
+    }
+    function_context->yields = true;
+    std::unique_ptr<Expression> value = expression();
+    consume(TokenType::SEMICOLON, "Expected ';' after yielded value.");
+    return std::make_unique<YieldStatement>(keyword, std::move(value));
+}
+
 std::unique_ptr<VariableDeclarationStatement> Parser::parseVariableDeclaration(bool consume_trailing_semicolon) {
-    Token auto_kw = consume(TokenType::KEYWORD_AUTO, "Expected 'auto'.");
-    Token name = consume(TokenType::IDENTIFIER, "Expected variable name after 'auto'.");
+    const Token& auto_kw = consume(TokenType::KEYWORD_AUTO, "Expected 'auto'.");
+    const Token& name = consume(TokenType::IDENTIFIER, "Expected variable name after 'auto'.");
     consume(TokenType::EQUALS, "Expected '=' after variable name.");
     std::unique_ptr<Expression> initializer_expr = expression();
     if (consume_trailing_semicolon) {
@@ -188,7 +214,7 @@ std::unique_ptr<Statement> Parser::expressionStatement() {
 }
 
 std::unique_ptr<Statement> Parser::outputStatement() {
-    Token output_kw = consume(TokenType::KEYWORD_OUTPUT, "Expected 'output'.");
+    const Token& output_kw = consume(TokenType::KEYWORD_OUTPUT, "Expected 'output'.");
     consume(TokenType::LEFT_PAREN, "Expected '(' after 'output'.");
     std::unique_ptr<Expression> arg = expression();
     consume(TokenType::RIGHT_PAREN, "Expected ')' after output argument.");
@@ -197,7 +223,7 @@ std::unique_ptr<Statement> Parser::outputStatement() {
 }
 
 std::unique_ptr<Statement> Parser::putStatement() {
-    Token put_kw = consume(TokenType::KEYWORD_PUT, "Expected 'put'.");
+    const Token& put_kw = consume(TokenType::KEYWORD_PUT, "Expected 'put'.");
     consume(TokenType::LEFT_PAREN, "Expected '(' after 'put'.");
     std::unique_ptr<Expression> arg = expression();
     consume(TokenType::RIGHT_PAREN, "Expected ')' after put argument.");
@@ -206,7 +232,7 @@ std::unique_ptr<Statement> Parser::putStatement() {
 }
 
 std::unique_ptr<Statement> Parser::typedefStatement() {
-    Token typedef_kw = consume(TokenType::KEYWORD_AT_TYPEDEF, "Expected '@Typedef'.");
+    const Token& typedef_kw = consume(TokenType::KEYWORD_AT_TYPEDEF, "Expected '@Typedef'.");
     consume(TokenType::LEFT_PAREN, "Expected '(' after '@Typedef'.");
     std::unique_ptr<Expression> expr_to_check = expression();
     consume(TokenType::RIGHT_PAREN, "Expected ')' after expression in '@Typedef'.");
@@ -215,7 +241,7 @@ std::unique_ptr<Statement> Parser::typedefStatement() {
 }
 
 std::unique_ptr<Statement> Parser::ifStatement() {
-    Token if_keyword_token = consume(TokenType::KEYWORD_IF, "Expected 'if'.");
+    consume(TokenType::KEYWORD_IF, "Expected 'if'.");
     consume(TokenType::LEFT_PAREN, "Expected '(' after 'if'.");
     std::unique_ptr<Expression> condition = expression();
     consume(TokenType::RIGHT_PAREN, "Expected ')' after if condition.");
@@ -226,7 +252,7 @@ std::unique_ptr<Statement> Parser::ifStatement() {
     }
 
     std::unique_ptr<Statement> else_branch = nullptr;
-    if (match({TokenType::KEYWORD_ELSE})) {
+    if (match(TokenType::KEYWORD_ELSE)) {
         else_branch = statement();
          if (!else_branch) {
             throw Common::NyxParserException("Expected statement or block after 'else'.", peek().line);
@@ -237,7 +263,7 @@ std::unique_ptr<Statement> Parser::ifStatement() {
 }
 
 std::unique_ptr<Statement> Parser::forStatement() {
-    Token for_keyword_token = consume(TokenType::KEYWORD_FOR, "Expected 'for'.");
+    consume(TokenType::KEYWORD_FOR, "Expected 'for'.");
     consume(TokenType::LEFT_PAREN, "Expected '(' after 'for'.");
 
     std::unique_ptr<Statement> initializer = nullptr;
@@ -269,10 +295,10 @@ std::unique_ptr<Statement> Parser::forStatement() {
 }
 
 std::unique_ptr<Statement> Parser::foreachStatement() {
-    Token foreach_keyword_token = consume(TokenType::KEYWORD_FOREACH, "Expected 'foreach'.");
+    const Token& foreach_keyword_token = consume(TokenType::KEYWORD_FOREACH, "Expected 'foreach'.");
     consume(TokenType::LEFT_PAREN, "Expected '(' after 'foreach' keyword.");
     consume(TokenType::KEYWORD_AUTO, "Expected 'auto' for loop variable declaration in foreach.");
-    Token loop_variable = consume(TokenType::IDENTIFIER, "Expected variable name after 'auto' in foreach.");
+    const Token& loop_variable = consume(TokenType::IDENTIFIER, "Expected variable name after 'auto' in foreach.");
     consume(TokenType::COLON, "Expected ':' after loop variable in foreach.");
     std::unique_ptr<Expression> iterable = expression();
     consume(TokenType::RIGHT_PAREN, "Expected ')' after foreach iterable expression.");
@@ -282,7 +308,7 @@ std::unique_ptr<Statement> Parser::foreachStatement() {
 }
 
 std::unique_ptr<Statement> Parser::switchStatement() {
-    Token switch_tok = consume(TokenType::KEYWORD_SWITCH, "Expected 'switch'.");
+    const Token& switch_tok = consume(TokenType::KEYWORD_SWITCH, "Expected 'switch'.");
     consume(TokenType::LEFT_PAREN, "Expected '(' after 'switch'.");
     std::unique_ptr<Expression> condition = expression();
     consume(TokenType::RIGHT_PAREN, "Expected ')' after switch condition.");
@@ -296,11 +322,11 @@ std::unique_ptr<Statement> Parser::switchStatement() {
         std::unique_ptr<Expression> case_expr = nullptr;
         bool is_default_case = false;
 
-        if (match({TokenType::KEYWORD_CASE})) {
+        if (match(TokenType::KEYWORD_CASE)) {
             case_or_default_tok = previous();
             case_expr = expression();
             consume(TokenType::COLON, "Expected ':' after case value.");
-        } else if (match({TokenType::KEYWORD_DEFAULT})) {
+        } else if (match(TokenType::KEYWORD_DEFAULT)) {
             if (default_found) {
                 throw Common::NyxParserException("Multiple default cases in switch statement.", previous().line);
             }
@@ -320,18 +346,18 @@ std::unique_ptr<Statement> Parser::switchStatement() {
         case_blocks.emplace_back(case_or_default_tok, std::move(case_expr), std::move(statements_in_case), is_default_case);
     }
 
-    Token right_brace_tok = consume(TokenType::RIGHT_BRACE, "Expected '}' to close switch block.");
+    const Token& right_brace_tok = consume(TokenType::RIGHT_BRACE, "Expected '}' to close switch block.");
     return std::make_unique<SwitchStatement>(switch_tok, std::move(condition), std::move(case_blocks), right_brace_tok);
 }
 
 std::unique_ptr<Statement> Parser::breakStatement() {
-    Token keyword = consume(TokenType::KEYWORD_BREAK, "Expected 'break'.");
+    const Token& keyword = consume(TokenType::KEYWORD_BREAK, "Expected 'break'.");
     consume(TokenType::SEMICOLON, "Expected ';' after 'break'.");
     return std::make_unique<BreakStatement>(keyword);
 }
 
 std::unique_ptr<Statement> Parser::continueStatement() {
-    Token keyword = consume(TokenType::KEYWORD_CONTINUE, "Expected 'continue'.");
+    const Token& keyword = consume(TokenType::KEYWORD_CONTINUE, "Expected 'continue'.");
     consume(TokenType::SEMICOLON, "Expected ';' after 'continue'.");
     return std::make_unique<ContinueStatement>(keyword);
 }
@@ -353,8 +379,8 @@ std::unique_ptr<Expression> Parser::expression() {
 std::unique_ptr<Expression> Parser::assignment() {
     std::unique_ptr<Expression> expr = logical_or();
 
-    if (match({TokenType::EQUALS})) {
-        Token equals_token = previous();
+    if (match(TokenType::EQUALS)) {
+        const Token& equals_token = previous();
         std::unique_ptr<Expression> value = assignment();
 
         if (dynamic_cast<IdentifierExpression*>(expr.get()) || dynamic_cast<SubscriptExpression*>(expr.get()) || dynamic_cast<MemberAccessExpression*>(expr.get())) {
@@ -367,8 +393,8 @@ std::unique_ptr<Expression> Parser::assignment() {
 
 std::unique_ptr<Expression> Parser::logical_or() {
     std::unique_ptr<Expression> expr = logical_and();
-    while (match({TokenType::KEYWORD_OR})) {
-        Token operator_token = previous();
+    while (match(TokenType::KEYWORD_OR)) {
+        const Token& operator_token = previous();
         std::unique_ptr<Expression> right = logical_and();
         expr = std::make_unique<BinaryExpression>(std::move(expr), operator_token, std::move(right));
     }
@@ -377,8 +403,8 @@ std::unique_ptr<Expression> Parser::logical_or() {
 
 std::unique_ptr<Expression> Parser::logical_and() {
     std::unique_ptr<Expression> expr = equality();
-    while (match({TokenType::KEYWORD_AND})) {
-        Token operator_token = previous();
+    while (match(TokenType::KEYWORD_AND)) {
+        const Token& operator_token = previous();
         std::unique_ptr<Expression> right = equality();
         expr = std::make_unique<BinaryExpression>(std::move(expr), operator_token, std::move(right));
     }
@@ -387,8 +413,8 @@ std::unique_ptr<Expression> Parser::logical_and() {
 
 std::unique_ptr<Expression> Parser::equality() {
     std::unique_ptr<Expression> expr = comparison();
-    while (match({TokenType::BANG_EQUAL, TokenType::EQUAL_EQUAL})) {
-        Token operator_token = previous();
+    while (match(TokenType::BANG_EQUAL, TokenType::EQUAL_EQUAL)) {
+        const Token& operator_token = previous();
         std::unique_ptr<Expression> right = comparison();
         expr = std::make_unique<BinaryExpression>(std::move(expr), operator_token, std::move(right));
     }
@@ -397,8 +423,8 @@ std::unique_ptr<Expression> Parser::equality() {
 
 std::unique_ptr<Expression> Parser::comparison() {
     std::unique_ptr<Expression> expr = term();
-    while (match({TokenType::GREATER, TokenType::GREATER_EQUAL, TokenType::LESS, TokenType::LESS_EQUAL})) {
-        Token operator_token = previous();
+    while (match(TokenType::GREATER, TokenType::GREATER_EQUAL, TokenType::LESS, TokenType::LESS_EQUAL)) {
+        const Token& operator_token = previous();
         std::unique_ptr<Expression> right = term();
         expr = std::make_unique<BinaryExpression>(std::move(expr), operator_token, std::move(right));
     }
@@ -407,8 +433,8 @@ std::unique_ptr<Expression> Parser::comparison() {
 
 std::unique_ptr<Expression> Parser::term() {
     std::unique_ptr<Expression> expr = factor();
-    while (match({TokenType::PLUS, TokenType::MINUS})) {
-        Token operator_token = previous();
+    while (match(TokenType::PLUS, TokenType::MINUS)) {
+        const Token& operator_token = previous();
         std::unique_ptr<Expression> right = factor();
         expr = std::make_unique<BinaryExpression>(std::move(expr), operator_token, std::move(right));
     }
@@ -417,8 +443,8 @@ std::unique_ptr<Expression> Parser::term() {
 
 std::unique_ptr<Expression> Parser::factor() {
     std::unique_ptr<Expression> expr = unary();
-    while (match({TokenType::STAR, TokenType::SLASH, TokenType::PERCENT})) {
-        Token operator_token = previous();
+    while (match(TokenType::STAR, TokenType::SLASH, TokenType::PERCENT)) {
+        const Token& operator_token = previous();
         std::unique_ptr<Expression> right = unary();
         expr = std::make_unique<BinaryExpression>(std::move(expr), operator_token, std::move(right));
     }
@@ -426,8 +452,8 @@ std::unique_ptr<Expression> Parser::factor() {
 }
 
 std::unique_ptr<Expression> Parser::unary() {
-    if (match({TokenType::MINUS, TokenType::KEYWORD_NOT, TokenType::BANG})) {
-        Token operator_token = previous();
+    if (match(TokenType::MINUS, TokenType::KEYWORD_NOT, TokenType::BANG)) {
+        const Token& operator_token = previous();
         std::unique_ptr<Expression> right = unary();
         return std::make_unique<UnaryExpression>(operator_token, std::move(right));
     }
@@ -436,14 +462,14 @@ std::unique_ptr<Expression> Parser::unary() {
 
 std::unique_ptr<Expression> Parser::finishCall(std::unique_ptr<Expression> callee) {
     std::vector<std::unique_ptr<Expression>> arguments;
-    Token paren = previous(); 
+    const Token& paren = previous(); 
     if (!check(TokenType::RIGHT_PAREN)) {
         do {
             if (arguments.size() >= 255) {
                  throw Common::NyxParserException("Cannot have more than 255 arguments.", peek().line);
             }
             arguments.push_back(expression());
-        } while (match({TokenType::COMMA}));
+        } while (match(TokenType::COMMA));
     }
     consume(TokenType::RIGHT_PAREN, "Expected ')' after arguments.");
     return std::make_unique<CallExpression>(std::move(callee), paren, std::move(arguments));
@@ -453,7 +479,7 @@ std::unique_ptr<Expression> Parser::postfix_operators() {
     std::unique_ptr<Expression> expr = primary();
 
     while (true) {
-        if (match({TokenType::LEFT_PAREN})) {
+        if (match(TokenType::LEFT_PAREN)) {
             expr = finishCall(std::move(expr));
         } else if (check(TokenType::LEFT_BRACE)) {
             if (auto id_expr = dynamic_cast<IdentifierExpression*>(expr.get())) {
@@ -464,27 +490,27 @@ std::unique_ptr<Expression> Parser::postfix_operators() {
                 if (!check(TokenType::RIGHT_BRACE)) {
                     do {
                         if (peek().type == TokenType::RIGHT_BRACE) break; 
-                        Token field_name = consume(TokenType::IDENTIFIER, "Expected field name in struct initializer.");
+                        const Token& field_name = consume(TokenType::IDENTIFIER, "Expected field name in struct initializer.");
                         consume(TokenType::COLON, "Expected ':' after field name in struct initializer.");
                         std::unique_ptr<Expression> field_value = expression();
                         initializers.emplace_back(std::move(field_name), std::move(field_value));
-                    } while (match({TokenType::COMMA}));
+                    } while (match(TokenType::COMMA));
                 }
                 consume(TokenType::RIGHT_BRACE, "Expected '}' to close struct initializer.");
                 expr = std::make_unique<StructInitializerExpression>(struct_name_token, std::move(initializers));
             } else {
                 break; 
             }
-        } else if (match({TokenType::PLUS_PLUS, TokenType::MINUS_MINUS})) {
-            Token operator_token = previous();
+        } else if (match(TokenType::PLUS_PLUS, TokenType::MINUS_MINUS)) {
+            const Token& operator_token = previous();
             expr = std::make_unique<PostfixUpdateExpression>(std::move(expr), operator_token);
-        } else if (match({TokenType::LEFT_BRACKET})) {
-            Token open_bracket_token = previous();
+        } else if (match(TokenType::LEFT_BRACKET)) {
+            const Token& open_bracket_token = previous();
             std::unique_ptr<Expression> index = expression();
-            Token close_bracket_token = consume(TokenType::RIGHT_BRACKET, "Expected ']' after subscript index.");
+            const Token& close_bracket_token = consume(TokenType::RIGHT_BRACKET, "Expected ']' after subscript index.");
             expr = std::make_unique<SubscriptExpression>(open_bracket_token, std::move(expr), std::move(index), close_bracket_token);
-        } else if (match({TokenType::DOT})) {
-            Token name = consume(TokenType::IDENTIFIER, "Expected member name after '.'.");
+        } else if (match(TokenType::DOT)) {
+            const Token& name = consume(TokenType::IDENTIFIER, "Expected member name after '.'.");
             expr = std::make_unique<MemberAccessExpression>(std::move(expr), name);
         }
         else {
@@ -494,111 +520,71 @@ std::unique_ptr<Expression> Parser::postfix_operators() {
     return expr;
 }
 
-std::vector<std::variant<std::string, std::unique_ptr<Expression>>> Parser::parseInterpolationSegments(const std::string& raw_string_content, int base_line_number) {
+std::unique_ptr<Expression> Parser::interpolatedString() {
+    const Token& string_token = previous();
     std::vector<std::variant<std::string, std::unique_ptr<Expression>>> segments;
-    size_t current_pos = 0;
-    size_t length = raw_string_content.length();
-    current_line_for_sub_parsing = base_line_number;
-
-    while(current_pos < length) {
-        size_t interp_start = raw_string_content.find("#{", current_pos);
-        if (interp_start == std::string::npos) {
-            if (current_pos < length) {
-                segments.emplace_back(raw_string_content.substr(current_pos));
-            }
-            break;
-        }
-
-        if (interp_start > current_pos) {
-            segments.emplace_back(raw_string_content.substr(current_pos, interp_start - current_pos));
-        }
-        
-        current_pos = interp_start + 2; 
-        size_t interp_end = raw_string_content.find('}', current_pos);
-        if (interp_end == std::string::npos) {
-            throw Common::NyxParserException("Unterminated interpolation expression in string literal. Expected '}'.", base_line_number);
-        }
 
-        std::string expr_str = raw_string_content.substr(current_pos, interp_end - current_pos);
-        if (expr_str.empty()) {
-             throw Common::NyxParserException("Empty interpolation expression '#{}'.", base_line_number);
-        }
-
-        try {
-            Tokenizer expr_tokenizer(expr_str);
-            std::vector<Token> expr_tokens = expr_tokenizer.tokenize();
-            
-            std::vector<Token> filtered_tokens;
-            for(const auto& t : expr_tokens) {
-                if(t.type != TokenType::END_OF_FILE) {
-                    Token adjusted_token = t;
-                    adjusted_token.line = base_line_number; 
-                    for(size_t i = 0; i < expr_str.substr(0, t.lexeme.empty() ? 0 : expr_str.find(t.lexeme)).length(); ++i) {
-                        if(expr_str[i] == '\n') adjusted_token.line++;
-                    }
-                     current_line_for_sub_parsing = adjusted_token.line;
-                    filtered_tokens.push_back(adjusted_token);
-                }
+    while (!match(TokenType::STRING_INTERPOLATION_END)) {
+        if (match(TokenType::STRING_SEGMENT)) {
+            segments.emplace_back(previous().lexeme);
+        } else if (match(TokenType::INTERPOLATION_OPEN)) {
+            const Token& open_token = previous();
+            if (check(TokenType::INTERPOLATION_CLOSE)) {
+                throw Common::NyxParserException("Empty interpolation expression '#{}'.", open_token.line);
             }
-             if (filtered_tokens.empty() && !expr_str.empty()) {
-                 throw Common::NyxParserException("Failed to tokenize interpolated expression.", base_line_number);
-             }
-             if (!filtered_tokens.empty()) {
-                filtered_tokens.emplace_back(TokenType::END_OF_FILE, "", filtered_tokens.back().line);
-             } else {
-                 filtered_tokens.emplace_back(TokenType::END_OF_FILE, "", base_line_number);
-             }
-
-
-            Parser expr_parser(filtered_tokens);
-            expr_parser.current_line_for_sub_parsing = this->current_line_for_sub_parsing;
-            std::unique_ptr<Expression> parsed_expr = expr_parser.expression();
-            
-            if (!expr_parser.isAtEnd() && expr_parser.peek().type != TokenType::END_OF_FILE) {
-                 Token problem_token = expr_parser.peek();
-                 throw Common::NyxParserException("Unexpected token '" + problem_token.lexeme + "' after interpolated expression.", problem_token.line);
+            segments.emplace_back(expression());
+            if (!match(TokenType::INTERPOLATION_CLOSE)) {
+                if (check(TokenType::STRING_INTERPOLATION_END) || isAtEnd()) {
+                    throw Common::NyxParserException("Unterminated interpolation expression in string literal. Expected '}'.", open_token.line);
+                }
+                throw Common::NyxParserException("Unexpected token '" + peek().lexeme + "' after interpolated expression.", peek().line);
             }
-
-            segments.emplace_back(std::move(parsed_expr));
-        } catch (const Common::NyxException& e) {
-             throw Common::NyxParserException("Error parsing interpolated expression '" + expr_str + "': " + e.what(), base_line_number);
-        } catch (const std::exception& e) {
-             throw Common::NyxParserException("Unexpected system error parsing interpolated expression '" + expr_str + "': " + e.what(), base_line_number);
+        } else {
+            throw Common::NyxParserException("Malformed interpolated string literal.", peek().line);
         }
+    }
+    return std::make_unique<InterpolatedStringExpression>(string_token, std::move(segments));
+}
 
-        current_pos = interp_end + 1;
+// The first entry decides: `key: value` makes a map, a lone value a set.
+std::unique_ptr<Expression> Parser::mapLiteral() {
+    const Token& brace_token = previous();
+    std::vector<std::unique_ptr<Expression>> keys;
+    std::vector<std::unique_ptr<Expression>> values;
+    bool is_set = false;
+    if (!check(TokenType::RIGHT_BRACE)) {
+        do {
+            if (isAtEnd() || check(TokenType::RIGHT_BRACE)) {
+                throw Common::NyxParserException(is_set ? "Expression expected for set element." : "Expression expected for map key.", peek().line);
+            }
+            keys.push_back(expression());
+            if (keys.size() == 1) {
+                is_set = !check(TokenType::COLON);
+            }
+            if (!is_set) {
+                consume(TokenType::COLON, "Expected ':' after map key.");
+                values.push_back(expression());
+            }
+        } while (match(TokenType::COMMA));
     }
-    current_line_for_sub_parsing = 0;
-    return segments;
+    consume(TokenType::RIGHT_BRACE, is_set ? "Expected '}' after set elements." : "Expected '}' after map entries.");
+    return std::make_unique<MapLiteralExpression>(brace_token, std::move(keys), std::move(values), is_set);
 }
 
 std::unique_ptr<Expression> Parser::primary() {
-    if (match({TokenType::KEYWORD_FALSE})) {
+    if (match(TokenType::KEYWORD_FALSE)) {
         return std::make_unique<LiteralExpression>(previous(), NyxValue(false));
     }
-    if (match({TokenType::KEYWORD_TRUE})) {
+    if (match(TokenType::KEYWORD_TRUE)) {
         return std::make_unique<LiteralExpression>(previous(), NyxValue(true));
     }
-    if (match({TokenType::STRING_LITERAL})) {
-        Token string_token = previous();
-        const std::string& lexeme = string_token.lexeme;
-        
-        size_t interpolation_pos = lexeme.find("#{");
-        if (interpolation_pos != std::string::npos) {
-            if (lexeme.find('}', interpolation_pos + 2) != std::string::npos) {
-                 try {
-                    auto segments = parseInterpolationSegments(lexeme, string_token.line);
-                    return std::make_unique<InterpolatedStringExpression>(string_token, std::move(segments));
-                 } catch (const Common::NyxParserException& e) {
-                    throw; 
-                 } catch (const std::exception& e) {
-                    throw Common::NyxParserException(std::string("Failed to parse interpolated string: ") + e.what(), string_token.line);
-                 }
-            }
-        }
-        return std::make_unique<LiteralExpression>(string_token, NyxValue(lexeme));
+    if (match(TokenType::STRING_LITERAL)) {
+        return std::make_unique<LiteralExpression>(previous(), NyxValue(previous().lexeme));
     }
-    if (match({TokenType::NUMBER_LITERAL})) {
+    if (match(TokenType::STRING_INTERPOLATION_START)) {
+        return interpolatedString();
+    }
+    if (match(TokenType::NUMBER_LITERAL)) {
         try {
             double num_val = std::stod(previous().lexeme);
             return std::make_unique<LiteralExpression>(previous(), NyxValue(num_val));
@@ -608,24 +594,23 @@ std::unique_ptr<Expression> Parser::primary() {
             throw Common::NyxParserException("Number out of range: " + previous().lexeme, previous().line);
         }
     }
-    if (match({TokenType::IDENTIFIER})) {
+    if (match(TokenType::IDENTIFIER)) {
         return std::make_unique<IdentifierExpression>(previous(), previous().lexeme);
     }
-    if (match({TokenType::LEFT_PAREN})) {
-        Token paren_token = previous();
+    if (match(TokenType::LEFT_PAREN)) {
         std::unique_ptr<Expression> expr_in_paren = expression();
         consume(TokenType::RIGHT_PAREN, "Expected ')' after expression in parentheses.");
         return expr_in_paren; 
     }
-    if (match({TokenType::KEYWORD_LEN})) {
-        Token len_token = previous();
+    if (match(TokenType::KEYWORD_LEN)) {
+        const Token& len_token = previous();
         consume(TokenType::LEFT_PAREN, "Expected '(' after 'len'.");
         std::unique_ptr<Expression> argument = expression();
         consume(TokenType::RIGHT_PAREN, "Expected ')' after 'len' argument.");
         return std::make_unique<LenExpression>(len_token, std::move(argument));
     }
-    if (match({TokenType::LEFT_BRACKET})) {
-        Token bracket_token = previous();
+    if (match(TokenType::LEFT_BRACKET)) {
+        const Token& bracket_token = previous();
         std::vector<std::unique_ptr<Expression>> elements;
         if (!check(TokenType::RIGHT_BRACKET)) {
             do {
@@ -633,11 +618,14 @@ std::unique_ptr<Expression> Parser::primary() {
                      throw Common::NyxParserException("Expression expected for list element.", peek().line);
                 }
                 elements.push_back(expression());
-            } while (match({TokenType::COMMA}));
+            } while (match(TokenType::COMMA));
         }
         consume(TokenType::RIGHT_BRACKET, "Expected ']' after list elements.");
         return std::make_unique<ListLiteralExpression>(bracket_token, std::move(elements));
     }
+    if (match(TokenType::LEFT_BRACE)) {
+        return mapLiteral();
+    }
 
     throw Common::NyxParserException("Primary expression expected.", peek().line);
 }
@@ -657,6 +645,7 @@ void Parser::synchronize() {
             case TokenType::KEYWORD_IF:
             case TokenType::KEYWORD_FOR:
             case TokenType::KEYWORD_RETURN:
+            case TokenType::KEYWORD_YIELD:
             case TokenType::KEYWORD_BREAK:
             case TokenType::KEYWORD_CONTINUE:
             case TokenType::KEYWORD_STRUCT:
@@ -675,7 +664,8 @@ std::vector<std::unique_ptr<Statement>> Parser::parse() {
         try {
             statements_list.push_back(declaration());
         } catch (const Common::NyxParserException& e) {
-             std::cerr << e.what() << std::endl;
+             diagnostics << e.what() << std::endl;
+             had_error = true;
              synchronize(); 
         }
     }
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 #include <variant>
+#include <iostream>
 #include "../tokenizer/Token.h"
 #include "../parser/AstNodes.h"
 #include "../common/Utils.h"
@@ -11,22 +12,39 @@ namespace Nyx {
 
 class Parser {
 public:
-    Parser(std::vector<Token> tokens_list);
+    Parser(std::vector<Token> tokens_list, std::ostream& diagnostics = std::cerr);
     std::vector<std::unique_ptr<Statement>> parse();
+    bool hadError() const { return had_error; }
 
 private:
     std::vector<Token> tokens;
+    std::ostream& diagnostics;
     size_t current = 0;
-    int current_line_for_sub_parsing = 0; 
+    bool had_error = false;
+
+    // What the function body being parsed contains, to tell generators apart.
+    struct FunctionContext {
+        bool yields = false;
+        int value_return_line = 0; // line of the first 'return' with a value
+    };
+    FunctionContext* function_context = nullptr;
 
     bool isAtEnd() const;
-    Token peek() const;
-    Token previous() const;
-    Token advance();
+    const Token& peek() const;
+    const Token& previous() const;
+    const Token& advance();
     bool check(TokenType type) const;
     bool checkNext(TokenType type) const;
-    bool match(const std::vector<TokenType>& types);
-    Token consume(TokenType type, const std::string& message);
+    const Token& consume(TokenType type, const std::string& message);
+
+    template<typename... Types>
+    bool match(Types... types) {
+        if ((check(types) || ...)) {
+            advance();
+            return true;
+        }
+        return false;
+    }
 
     std::unique_ptr<Statement> declaration();
     std::unique_ptr<Statement> statement();
@@ -37,6 +55,7 @@ private:
     std::unique_ptr<Statement> outputStatement();
     std::unique_ptr<Statement> putStatement();
     std::unique_ptr<Statement> returnStatement();
+    std::unique_ptr<Statement> yieldStatement();
     std::unique_ptr<Statement> typedefStatement();
     std::unique_ptr<Statement> ifStatement();
     std::unique_ptr<Statement> forStatement();
@@ -58,9 +77,10 @@ private:
     std::unique_ptr<Expression> unary();
     std::unique_ptr<Expression> postfix_operators();
     std::unique_ptr<Expression> finishCall(std::unique_ptr<Expression> callee);
+    std::unique_ptr<Expression> mapLiteral();
     std::unique_ptr<Expression> primary();
 
-    std::vector<std::variant<std::string, std::unique_ptr<Expression>>> parseInterpolationSegments(const std::string& raw_string_content, int base_line_number);
+    std::unique_ptr<Expression> interpolatedString();
     
     void synchronize();
 };
@@ -0,0 +1,555 @@
+#include "./array_kernels.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NYX_ARRAY_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC accepts AVX intrinsics in any function.
+#define NYX_TARGET_AVX
+#define NYX_TARGET_AVX2
+#else
+#define NYX_TARGET_AVX __attribute__((target("avx")))
+#define NYX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define NYX_ARRAY_X86 0
+#endif
+
+namespace Nyx {
+namespace ArrayKernels {
+
+namespace {
+    SimdLevel detectSimdLevel() {
+#if NYX_ARRAY_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        bool os_saves_avx = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+        bool has_avx = os_saves_avx && (info[2] & (1 << 28));
+        __cpuidex(info, 7, 0);
+        bool has_avx2 = has_avx && (info[1] & (1 << 5));
+#else
+        // Also checks that the OS saves the AVX registers.
+        __builtin_cpu_init();
+        bool has_avx = __builtin_cpu_supports("avx");
+        bool has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (has_avx2) return SimdLevel::AVX2;
+        if (has_avx) return SimdLevel::AVX;
+        return SimdLevel::SSE2; // part of x86-64
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }
+
+    SimdLevel chooseSimdLevel() {
+        SimdLevel detected = detectSimdLevel();
+        const char* requested = std::getenv("NYX_SIMD");
+        if (!requested) {
+            return detected;
+        }
+        for (SimdLevel candidate : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX, SimdLevel::AVX2}) {
+            // Only ever lower the level: raising it would crash on older CPUs.
+            if (std::string(requested) == simdLevelName(candidate) && candidate < detected) {
+                return candidate;
+            }
+        }
+        return detected;
+    }
+
+    template<typename Body>
+    void withBinaryOp(BinaryOp op, Body body) {
+        switch (op) {
+            case BinaryOp::ADD: body(std::integral_constant<BinaryOp, BinaryOp::ADD>()); break;
+            case BinaryOp::SUB: body(std::integral_constant<BinaryOp, BinaryOp::SUB>()); break;
+            case BinaryOp::MUL: body(std::integral_constant<BinaryOp, BinaryOp::MUL>()); break;
+            case BinaryOp::DIV: body(std::integral_constant<BinaryOp, BinaryOp::DIV>()); break;
+        }
+    }
+
+    template<typename Body>
+    void withCompareOp(CompareOp op, Body body) {
+        switch (op) {
+            case CompareOp::LT: body(std::integral_constant<CompareOp, CompareOp::LT>()); break;
+            case CompareOp::LE: body(std::integral_constant<CompareOp, CompareOp::LE>()); break;
+            case CompareOp::GT: body(std::integral_constant<CompareOp, CompareOp::GT>()); break;
+            case CompareOp::GE: body(std::integral_constant<CompareOp, CompareOp::GE>()); break;
+            case CompareOp::EQ: body(std::integral_constant<CompareOp, CompareOp::EQ>()); break;
+            case CompareOp::NE: body(std::integral_constant<CompareOp, CompareOp::NE>()); break;
+        }
+    }
+
+    // Scalar versions, also used for the tails of the vector loops.
+
+    inline double elementAt(const Float64Operand& operand, size_t index) {
+        return operand.broadcast ? operand.data[0] : operand.data[index];
+    }
+
+    template<BinaryOp OP>
+    inline double applyScalar(double left, double right) {
+        if constexpr (OP == BinaryOp::ADD) return left + right;
+        else if constexpr (OP == BinaryOp::SUB) return left - right;
+        else if constexpr (OP == BinaryOp::MUL) return left * right;
+        else return left / right;
+    }
+
+    template<CompareOp OP>
+    inline bool compareScalar(double left, double right) {
+        if constexpr (OP == CompareOp::LT) return left < right;
+        else if constexpr (OP == CompareOp::LE) return left <= right;
+        else if constexpr (OP == CompareOp::GT) return left > right;
+        else if constexpr (OP == CompareOp::GE) return left >= right;
+        else if constexpr (OP == CompareOp::EQ) return left == right;
+        else return left != right;
+    }
+
+    template<BinaryOp OP>
+    void binaryScalar(Float64Operand left, Float64Operand right, double* out, size_t from, size_t n) {
+        for (size_t i = from; i < n; ++i) {
+            out[i] = applyScalar<OP>(elementAt(left, i), elementAt(right, i));
+        }
+    }
+
+    template<CompareOp OP>
+    void compareScalarLoop(Float64Operand left, Float64Operand right, std::uint8_t* out, size_t from, size_t n) {
+        for (size_t i = from; i < n; ++i) {
+            out[i] = compareScalar<OP>(elementAt(left, i), elementAt(right, i)) ? 1 : 0;
+        }
+    }
+
+    // Sums keep four running totals, element i going to total i % 4, and
+    // combine them as (t0 + t1) + (t2 + t3) before adding the tail. The vector
+    // versions hold the same four totals in their lanes.
+    double finishSum(const double lanes[4], const double* tail_values, const double* tail_factors, size_t from, size_t n) {
+        double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        for (size_t i = from; i < n; ++i) {
+            total += tail_factors ? tail_values[i] * tail_factors[i] : tail_values[i];
+        }
+        return total;
+    }
+
+    double sumScalar(const double* values, size_t n) {
+        double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            for (size_t lane = 0; lane < 4; ++lane) lanes[lane] += values[i + lane];
+        }
+        return finishSum(lanes, values, nullptr, i, n);
+    }
+
+    double dotScalar(const double* left, const double* right, size_t n) {
+        double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            for (size_t lane = 0; lane < 4; ++lane) lanes[lane] += left[i + lane] * right[i + lane];
+        }
+        return finishSum(lanes, left, right, i, n);
+    }
+
+    template<bool MAXIMUM>
+    double extremeScalar(const double* values, size_t from, size_t n, double best, bool saw_nan) {
+        for (size_t i = from; i < n; ++i) {
+            saw_nan |= values[i] != values[i];
+            if (MAXIMUM ? values[i] > best : values[i] < best) best = values[i];
+        }
+        return saw_nan ? std::numeric_limits<double>::quiet_NaN() : best;
+    }
+
+    size_t countNonZeroScalar(const std::uint8_t* values, size_t from, size_t n) {
+        size_t count = 0;
+        for (size_t i = from; i < n; ++i) {
+            count += values[i] != 0;
+        }
+        return count;
+    }
+
+    void saturatingAddScalar(const std::uint8_t* left, const std::uint8_t* right, std::uint8_t* out, size_t from, size_t n) {
+        for (size_t i = from; i < n; ++i) {
+            unsigned total = static_cast<unsigned>(left[i]) + right[i];
+            out[i] = static_cast<std::uint8_t>(total > 255 ? 255 : total);
+        }
+    }
+
+    void saturatingSubScalar(const std::uint8_t* left, const std::uint8_t* right, std::uint8_t* out, size_t from, size_t n) {
+        for (size_t i = from; i < n; ++i) {
+            out[i] = static_cast<std::uint8_t>(left[i] > right[i] ? left[i] - right[i] : 0);
+        }
+    }
+
+#if NYX_ARRAY_X86
+    // SSE2: two doubles per operation.
+
+    inline __m128d loadSse2(const Float64Operand& operand, size_t index) {
+        return operand.broadcast ? _mm_set1_pd(operand.data[0]) : _mm_loadu_pd(operand.data + index);
+    }
+
+    template<BinaryOp OP>
+    inline __m128d applySse2(__m128d left, __m128d right) {
+        if constexpr (OP == BinaryOp::ADD) return _mm_add_pd(left, right);
+        else if constexpr (OP == BinaryOp::SUB) return _mm_sub_pd(left, right);
+        else if constexpr (OP == BinaryOp::MUL) return _mm_mul_pd(left, right);
+        else return _mm_div_pd(left, right);
+    }
+
+    template<CompareOp OP>
+    inline __m128d compareSse2(__m128d left, __m128d right) {
+        if constexpr (OP == CompareOp::LT) return _mm_cmplt_pd(left, right);
+        else if constexpr (OP == CompareOp::LE) return _mm_cmple_pd(left, right);
+        else if constexpr (OP == CompareOp::GT) return _mm_cmpgt_pd(left, right);
+        else if constexpr (OP == CompareOp::GE) return _mm_cmpge_pd(left, right);
+        else if constexpr (OP == CompareOp::EQ) return _mm_cmpeq_pd(left, right);
+        else return _mm_cmpneq_pd(left, right);
+    }
+
+    template<BinaryOp OP>
+    void binarySse2(Float64Operand left, Float64Operand right, double* out, size_t n) {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            _mm_storeu_pd(out + i, applySse2<OP>(loadSse2(left, i), loadSse2(right, i)));
+        }
+        binaryScalar<OP>(left, right, out, i, n);
+    }
+
+    template<CompareOp OP>
+    void compareSse2Loop(Float64Operand left, Float64Operand right, std::uint8_t* out, size_t n) {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            int bits = _mm_movemask_pd(compareSse2<OP>(loadSse2(left, i), loadSse2(right, i)));
+            out[i] = bits & 1;
+            out[i + 1] = (bits >> 1) & 1;
+        }
+        compareScalarLoop<OP>(left, right, out, i, n);
+    }
+
+    void absSse2(const double* values, double* out, size_t n) {
+        const __m128d sign = _mm_set1_pd(-0.0);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            _mm_storeu_pd(out + i, _mm_andnot_pd(sign, _mm_loadu_pd(values + i)));
+        }
+        for (; i < n; ++i) out[i] = std::fabs(values[i]);
+    }
+
+    void sqrtSse2(const double* values, double* out, size_t n) {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            _mm_storeu_pd(out + i, _mm_sqrt_pd(_mm_loadu_pd(values + i)));
+        }
+        for (; i < n; ++i) out[i] = std::sqrt(values[i]);
+    }
+
+    double sumSse2(const double* values, const double* factors, size_t n) {
+        __m128d low = _mm_setzero_pd();
+        __m128d high = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128d first = _mm_loadu_pd(values + i);
+            __m128d second = _mm_loadu_pd(values + i + 2);
+            if (factors) {
+                first = _mm_mul_pd(first, _mm_loadu_pd(factors + i));
+                second = _mm_mul_pd(second, _mm_loadu_pd(factors + i + 2));
+            }
+            low = _mm_add_pd(low, first);
+            high = _mm_add_pd(high, second);
+        }
+        double lanes[4];
+        _mm_storeu_pd(lanes, low);
+        _mm_storeu_pd(lanes + 2, high);
+        return finishSum(lanes, values, factors, i, n);
+    }
+
+    template<bool MAXIMUM>
+    double extremeSse2(const double* values, size_t n) {
+        if (n < 2) return extremeScalar<MAXIMUM>(values, 1, n, values[0], values[0] != values[0]);
+        __m128d best = _mm_loadu_pd(values);
+        __m128d nans = _mm_cmpunord_pd(best, best);
+        size_t i = 2;
+        for (; i + 2 <= n; i += 2) {
+            __m128d chunk = _mm_loadu_pd(values + i);
+            nans = _mm_or_pd(nans, _mm_cmpunord_pd(chunk, chunk));
+            best = MAXIMUM ? _mm_max_pd(best, chunk) : _mm_min_pd(best, chunk);
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, best);
+        double result = MAXIMUM ? (lanes[1] > lanes[0] ? lanes[1] : lanes[0]) : (lanes[1] < lanes[0] ? lanes[1] : lanes[0]);
+        return extremeScalar<MAXIMUM>(values, i, n, result, _mm_movemask_pd(nans) != 0);
+    }
+
+    size_t countNonZeroSse2(const std::uint8_t* values, size_t n) {
+        // Counts the zero bytes: compare with zero, keep one bit per match and
+        // let the sum-of-absolute-differences instruction add them up.
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi8(1);
+        __m128i zeros = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i is_zero = _mm_and_si128(_mm_cmpeq_epi8(bytes, zero), one);
+            zeros = _mm_add_epi64(zeros, _mm_sad_epu8(is_zero, zero));
+        }
+        std::uint64_t lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), zeros);
+        return (i - static_cast<size_t>(lanes[0] + lanes[1])) + countNonZeroScalar(values, i, n);
+    }
+
+    template<bool ADD>
+    void saturatingSse2(const std::uint8_t* left, const std::uint8_t* right, std::uint8_t* out, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), ADD ? _mm_adds_epu8(a, b) : _mm_subs_epu8(a, b));
+        }
+        if (ADD) {
+            saturatingAddScalar(left, right, out, i, n);
+        } else {
+            saturatingSubScalar(left, right, out, i, n);
+        }
+    }
+
+    // AVX: four doubles per operation.
+
+    NYX_TARGET_AVX inline __m256d loadAvx(const Float64Operand& operand, size_t index) {
+        return operand.broadcast ? _mm256_set1_pd(operand.data[0]) : _mm256_loadu_pd(operand.data + index);
+    }
+
+    template<BinaryOp OP>
+    NYX_TARGET_AVX inline __m256d applyAvx(__m256d left, __m256d right) {
+        if constexpr (OP == BinaryOp::ADD) return _mm256_add_pd(left, right);
+        else if constexpr (OP == BinaryOp::SUB) return _mm256_sub_pd(left, right);
+        else if constexpr (OP == BinaryOp::MUL) return _mm256_mul_pd(left, right);
+        else return _mm256_div_pd(left, right);
+    }
+
+    // Ordered predicates are false for NaN; NE is unordered, as in C++.
+    template<CompareOp OP>
+    NYX_TARGET_AVX inline __m256d compareAvx(__m256d left, __m256d right) {
+        if constexpr (OP == CompareOp::LT) return _mm256_cmp_pd(left, right, _CMP_LT_OQ);
+        else if constexpr (OP == CompareOp::LE) return _mm256_cmp_pd(left, right, _CMP_LE_OQ);
+        else if constexpr (OP == CompareOp::GT) return _mm256_cmp_pd(left, right, _CMP_GT_OQ);
+        else if constexpr (OP == CompareOp::GE) return _mm256_cmp_pd(left, right, _CMP_GE_OQ);
+        else if constexpr (OP == CompareOp::EQ) return _mm256_cmp_pd(left, right, _CMP_EQ_OQ);
+        else return _mm256_cmp_pd(left, right, _CMP_NEQ_UQ);
+    }
+
+    template<BinaryOp OP>
+    NYX_TARGET_AVX void binaryAvx(Float64Operand left, Float64Operand right, double* out, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            _mm256_storeu_pd(out + i, applyAvx<OP>(loadAvx(left, i), loadAvx(right, i)));
+        }
+        binaryScalar<OP>(left, right, out, i, n);
+    }
+
+    template<CompareOp OP>
+    NYX_TARGET_AVX void compareAvxLoop(Float64Operand left, Float64Operand right, std::uint8_t* out, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            int bits = _mm256_movemask_pd(compareAvx<OP>(loadAvx(left, i), loadAvx(right, i)));
+            for (size_t lane = 0; lane < 4; ++lane) {
+                out[i + lane] = (bits >> lane) & 1;
+            }
+        }
+        compareScalarLoop<OP>(left, right, out, i, n);
+    }
+
+    NYX_TARGET_AVX void absAvx(const double* values, double* out, size_t n) {
+        const __m256d sign = _mm256_set1_pd(-0.0);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            _mm256_storeu_pd(out + i, _mm256_andnot_pd(sign, _mm256_loadu_pd(values + i)));
+        }
+        for (; i < n; ++i) out[i] = std::fabs(values[i]);
+    }
+
+    NYX_TARGET_AVX void sqrtAvx(const double* values, double* out, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            _mm256_storeu_pd(out + i, _mm256_sqrt_pd(_mm256_loadu_pd(values + i)));
+        }
+        for (; i < n; ++i) out[i] = std::sqrt(values[i]);
+    }
+
+    NYX_TARGET_AVX double sumAvx(const double* values, const double* factors, size_t n) {
+        __m256d totals = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d chunk = _mm256_loadu_pd(values + i);
+            if (factors) {
+                chunk = _mm256_mul_pd(chunk, _mm256_loadu_pd(factors + i));
+            }
+            totals = _mm256_add_pd(totals, chunk);
+        }
+        double lanes[4];
+        _mm256_storeu_pd(lanes, totals);
+        return finishSum(lanes, values, factors, i, n);
+    }
+
+    template<bool MAXIMUM>
+    NYX_TARGET_AVX double extremeAvx(const double* values, size_t n) {
+        if (n < 4) return extremeSse2<MAXIMUM>(values, n);
+        __m256d best = _mm256_loadu_pd(values);
+        __m256d nans = _mm256_cmp_pd(best, best, _CMP_UNORD_Q);
+        size_t i = 4;
+        for (; i + 4 <= n; i += 4) {
+            __m256d chunk = _mm256_loadu_pd(values + i);
+            nans = _mm256_or_pd(nans, _mm256_cmp_pd(chunk, chunk, _CMP_UNORD_Q));
+            best = MAXIMUM ? _mm256_max_pd(best, chunk) : _mm256_min_pd(best, chunk);
+        }
+        double lanes[4];
+        _mm256_storeu_pd(lanes, best);
+        double result = extremeScalar<MAXIMUM>(lanes, 1, 4, lanes[0], false);
+        return extremeScalar<MAXIMUM>(values, i, n, result, _mm256_movemask_pd(nans) != 0);
+    }
+
+    template<bool ADD>
+    NYX_TARGET_AVX2 void saturatingAvx2(const std::uint8_t* left, const std::uint8_t* right, std::uint8_t* out, size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), ADD ? _mm256_adds_epu8(a, b) : _mm256_subs_epu8(a, b));
+        }
+        saturatingSse2<ADD>(left + i, right + i, out + i, n - i);
+    }
+
+    NYX_TARGET_AVX2 void gatherAvx2(const double* source, const std::int32_t* indices, double* out, size_t n) {
+        // The masked form with a zero pass-through: the plain one leaves its
+        // pass-through operand undefined, which GCC warns about.
+        const __m256d all_lanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i));
+            _mm256_storeu_pd(out + i, _mm256_mask_i32gather_pd(_mm256_setzero_pd(), source, chunk, all_lanes, sizeof(double)));
+        }
+        for (; i < n; ++i) out[i] = source[indices[i]];
+    }
+#endif
+}
+
+SimdLevel simdLevel() {
+    static const SimdLevel level = chooseSimdLevel();
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return "scalar";
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX: return "avx";
+        case SimdLevel::AVX2: return "avx2";
+    }
+    return "scalar";
+}
+
+void binary(BinaryOp op, Float64Operand left, Float64Operand right, double* out, size_t n) {
+    SimdLevel level = simdLevel();
+    withBinaryOp(op, [&](auto tag) {
+        constexpr BinaryOp OP = decltype(tag)::value;
+#if NYX_ARRAY_X86
+        if (level >= SimdLevel::AVX) return binaryAvx<OP>(left, right, out, n);
+        if (level >= SimdLevel::SSE2) return binarySse2<OP>(left, right, out, n);
+#endif
+        binaryScalar<OP>(left, right, out, 0, n);
+    });
+}
+
+void compare(CompareOp op, Float64Operand left, Float64Operand right, std::uint8_t* out, size_t n) {
+    SimdLevel level = simdLevel();
+    withCompareOp(op, [&](auto tag) {
+        constexpr CompareOp OP = decltype(tag)::value;
+#if NYX_ARRAY_X86
+        if (level >= SimdLevel::AVX) return compareAvxLoop<OP>(left, right, out, n);
+        if (level >= SimdLevel::SSE2) return compareSse2Loop<OP>(left, right, out, n);
+#endif
+        compareScalarLoop<OP>(left, right, out, 0, n);
+    });
+}
+
+void abs(const double* values, double* out, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::AVX) return absAvx(values, out, n);
+    if (simdLevel() >= SimdLevel::SSE2) return absSse2(values, out, n);
+#endif
+    for (size_t i = 0; i < n; ++i) out[i] = std::fabs(values[i]);
+}
+
+void sqrt(const double* values, double* out, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::AVX) return sqrtAvx(values, out, n);
+    if (simdLevel() >= SimdLevel::SSE2) return sqrtSse2(values, out, n);
+#endif
+    for (size_t i = 0; i < n; ++i) out[i] = std::sqrt(values[i]);
+}
+
+double sum(const double* values, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::AVX) return sumAvx(values, nullptr, n);
+    if (simdLevel() >= SimdLevel::SSE2) return sumSse2(values, nullptr, n);
+#endif
+    return sumScalar(values, n);
+}
+
+double dot(const double* left, const double* right, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::AVX) return sumAvx(left, right, n);
+    if (simdLevel() >= SimdLevel::SSE2) return sumSse2(left, right, n);
+#endif
+    return dotScalar(left, right, n);
+}
+
+double min(const double* values, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::AVX) return extremeAvx<false>(values, n);
+    if (simdLevel() >= SimdLevel::SSE2) return extremeSse2<false>(values, n);
+#endif
+    return extremeScalar<false>(values, 1, n, values[0], values[0] != values[0]);
+}
+
+double max(const double* values, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::AVX) return extremeAvx<true>(values, n);
+    if (simdLevel() >= SimdLevel::SSE2) return extremeSse2<true>(values, n);
+#endif
+    return extremeScalar<true>(values, 1, n, values[0], values[0] != values[0]);
+}
+
+size_t countNonZero(const std::uint8_t* values, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::SSE2) return countNonZeroSse2(values, n);
+#endif
+    return countNonZeroScalar(values, 0, n);
+}
+
+void saturatingAdd(const std::uint8_t* left, const std::uint8_t* right, std::uint8_t* out, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::AVX2) return saturatingAvx2<true>(left, right, out, n);
+    if (simdLevel() >= SimdLevel::SSE2) return saturatingSse2<true>(left, right, out, n);
+#endif
+    saturatingAddScalar(left, right, out, 0, n);
+}
+
+void saturatingSub(const std::uint8_t* left, const std::uint8_t* right, std::uint8_t* out, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::AVX2) return saturatingAvx2<false>(left, right, out, n);
+    if (simdLevel() >= SimdLevel::SSE2) return saturatingSse2<false>(left, right, out, n);
+#endif
+    saturatingSubScalar(left, right, out, 0, n);
+}
+
+void gather(const double* source, const std::int32_t* indices, double* out, size_t n) {
+#if NYX_ARRAY_X86
+    if (simdLevel() >= SimdLevel::AVX2) return gatherAvx2(source, indices, out, n);
+#endif
+    for (size_t i = 0; i < n; ++i) out[i] = source[indices[i]];
+}
+
+}
+}
@@ -0,0 +1,61 @@
+#ifndef NYX_STDLIB_ARRAY_KERNELS_H
+#define NYX_STDLIB_ARRAY_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nyx {
+
+// Loops behind std:array. Each kernel has a scalar version and, on x86-64,
+// SSE2 and AVX versions (AVX2 for gathers and byte arithmetic) chosen at run
+// time from what the CPU supports, so one binary runs everywhere. Setting
+// NYX_SIMD to scalar, sse2, avx or avx2 lowers the level, for benchmarks and
+// for checking the versions against each other.
+//
+// Every level gives bit-identical results: element-wise operations are exact
+// IEEE operations, and sums always add in the same four-lane order.
+namespace ArrayKernels {
+
+enum class SimdLevel { SCALAR, SSE2, AVX, AVX2 };
+
+SimdLevel simdLevel();
+// "scalar", "sse2", "avx" or "avx2".
+const char* simdLevelName(SimdLevel level);
+
+enum class BinaryOp { ADD, SUB, MUL, DIV };
+enum class CompareOp { LT, LE, GT, GE, EQ, NE };
+
+// An operand of n elements, or one value used for every element.
+struct Float64Operand {
+    const double* data;
+    bool broadcast;
+};
+
+void binary(BinaryOp op, Float64Operand left, Float64Operand right, double* out, size_t n);
+// Writes 1 where the comparison holds and 0 elsewhere (including NaNs,
+// except for NE).
+void compare(CompareOp op, Float64Operand left, Float64Operand right, std::uint8_t* out, size_t n);
+
+void abs(const double* values, double* out, size_t n);
+void sqrt(const double* values, double* out, size_t n);
+
+double sum(const double* values, size_t n);
+double dot(const double* left, const double* right, size_t n);
+// NaN if any element is NaN. n must be at least 1.
+double min(const double* values, size_t n);
+double max(const double* values, size_t n);
+
+size_t countNonZero(const std::uint8_t* values, size_t n);
+
+// Byte arithmetic clamped to 0..255.
+void saturatingAdd(const std::uint8_t* left, const std::uint8_t* right, std::uint8_t* out, size_t n);
+void saturatingSub(const std::uint8_t* left, const std::uint8_t* right, std::uint8_t* out, size_t n);
+
+// out[i] = source[indices[i]]; the caller checks the indices.
+void gather(const double* source, const std::int32_t* indices, double* out, size_t n);
+
+}
+
+}
+
+#endif
@@ -0,0 +1,529 @@
+#include "./array_module.h"
+#include "./array_kernels.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../common/NumericArray.h"
+#include "../common/HeapAccounting.h"
+#include "../common/Utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Nyx {
+
+namespace {
+    using ElementType = NyxNumericArray::ElementType;
+
+    const NumericArrayPtr& expectArray(const NyxValue& value, const std::string& function_name) {
+        const auto* array = std::get_if<NumericArrayPtr>(&value.data);
+        if (!array || !*array) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects an array, got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        return *array;
+    }
+
+    NumericArrayPtr makeArray(ElementType type, size_t length) {
+        HeapAccounting::checkAllocation(length * NyxNumericArray::elementSize(type), 0);
+        return std::make_shared<NyxNumericArray>(type, length);
+    }
+
+    // Wider types can hold every value of narrower ones: uint8 < int32 < float64.
+    int typeRank(ElementType type) {
+        switch (type) {
+            case ElementType::UINT8: return 0;
+            case ElementType::INT32: return 1;
+            case ElementType::FLOAT64: return 2;
+        }
+        return 2;
+    }
+
+    ElementType widerType(ElementType a, ElementType b) {
+        return typeRank(a) >= typeRank(b) ? a : b;
+    }
+
+    // The elements as doubles: float64 arrays directly, others converted into
+    // `scratch`.
+    const double* float64Elements(const NyxNumericArray& array, std::vector<double>& scratch) {
+        if (array.type() == ElementType::FLOAT64) {
+            return array.float64Data();
+        }
+        scratch.resize(array.size());
+        if (array.type() == ElementType::INT32) {
+            std::copy(array.int32Data(), array.int32Data() + array.size(), scratch.begin());
+        } else {
+            std::copy(array.uint8Data(), array.uint8Data() + array.size(), scratch.begin());
+        }
+        return scratch.data();
+    }
+
+    // Converts with the saturating rules of NyxNumericArray::set().
+    void storeFloat64(NyxNumericArray& target, const double* values) {
+        size_t length = target.size();
+        switch (target.type()) {
+            case ElementType::FLOAT64:
+                if (length > 0) std::memcpy(target.float64Data(), values, length * sizeof(double));
+                break;
+            case ElementType::INT32:
+                for (size_t i = 0; i < length; ++i) target.int32Data()[i] = NyxNumericArray::toInt32(values[i]);
+                break;
+            case ElementType::UINT8:
+                for (size_t i = 0; i < length; ++i) target.uint8Data()[i] = NyxNumericArray::toUInt8(values[i]);
+                break;
+        }
+    }
+
+    size_t expectIndex(const NyxValue& value, const std::string& function_name, const std::string& what) {
+        if (!std::holds_alternative<double>(value.data)) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects a number for " + what + ", got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        double number = std::get<double>(value.data);
+        if (number < 0 || std::trunc(number) != number || number > static_cast<double>(std::numeric_limits<std::int32_t>::max())) {
+            throw Common::NyxRuntimeException("'" + function_name + "' " + what + " must be a non-negative integer below 2^31.", 0);
+        }
+        return static_cast<size_t>(number);
+    }
+
+    NyxValue constructArray(ElementType type, const std::vector<NyxValue>& args, const std::string& function_name) {
+        const NyxValue& source = args[0];
+        if (std::holds_alternative<double>(source.data)) {
+            return NyxValue(makeArray(type, expectIndex(source, function_name, "the length")));
+        }
+        if (const auto* list = std::get_if<NyxList>(&source.data)) {
+            NumericArrayPtr array = makeArray(type, list->size());
+            for (size_t i = 0; i < list->size(); ++i) {
+                const double* number = std::get_if<double>(&(*list)[i].data);
+                if (!number) {
+                    throw Common::NyxRuntimeException("'" + function_name + "' expects a list of numbers, but element " + std::to_string(i) +
+                                                     " is " + nyxValueTypeToString((*list)[i]) + ".", 0);
+                }
+                array->set(i, *number);
+            }
+            return NyxValue(array);
+        }
+        if (const auto* other = std::get_if<NumericArrayPtr>(&source.data); other && *other) {
+            NumericArrayPtr array = makeArray(type, (*other)->size());
+            std::vector<double> scratch;
+            storeFloat64(*array, float64Elements(**other, scratch));
+            return NyxValue(array);
+        }
+        throw Common::NyxRuntimeException("'" + function_name + "' expects a length, a list of numbers or an array, got " + nyxValueTypeToString(source) + ".", 0);
+    }
+
+    // One side of an element-wise operation: an array or a single number used
+    // for every element.
+    struct Operand {
+        const NyxNumericArray* array = nullptr;
+        double number = 0.0;
+        std::vector<double> scratch;
+
+        ArrayKernels::Float64Operand float64() {
+            if (!array) return {&number, true};
+            return {float64Elements(*array, scratch), false};
+        }
+        double at(size_t index) const { return array ? array->get(index) : number; }
+    };
+
+    // Reads the two operands of add, lt, ... and returns their common length.
+    size_t readOperands(const std::vector<NyxValue>& args, Operand& left, Operand& right, const std::string& function_name) {
+        Operand* operands[2] = {&left, &right};
+        for (size_t i = 0; i < 2; ++i) {
+            if (const auto* array = std::get_if<NumericArrayPtr>(&args[i].data); array && *array) {
+                operands[i]->array = array->get();
+            } else if (const double* number = std::get_if<double>(&args[i].data)) {
+                operands[i]->number = *number;
+            } else {
+                throw Common::NyxRuntimeException("'" + function_name + "' expects arrays or numbers, got " + nyxValueTypeToString(args[i]) + ".", 0);
+            }
+        }
+        if (!left.array && !right.array) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects at least one array.", 0);
+        }
+        if (left.array && right.array && left.array->size() != right.array->size()) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects arrays of the same length (" + std::to_string(left.array->size()) +
+                                             " and " + std::to_string(right.array->size()) + ").", 0);
+        }
+        return left.array ? left.array->size() : right.array->size();
+    }
+
+    // Arrays keep their type when combined with each other or with integers;
+    // a fractional number makes the result float64.
+    ElementType resultType(const Operand& left, const Operand& right) {
+        ElementType type = ElementType::UINT8;
+        for (const Operand* operand : {&left, &right}) {
+            if (operand->array) {
+                type = widerType(type, operand->array->type());
+            } else if (std::trunc(operand->number) != operand->number) {
+                type = ElementType::FLOAT64;
+            }
+        }
+        return type;
+    }
+
+    NyxValue arithmetic(ArrayKernels::BinaryOp op, const std::vector<NyxValue>& args, const std::string& function_name) {
+        Operand left, right;
+        size_t length = readOperands(args, left, right, function_name);
+        ElementType type = op == ArrayKernels::BinaryOp::DIV ? ElementType::FLOAT64 : resultType(left, right);
+        NumericArrayPtr result = makeArray(type, length);
+
+        bool both_bytes = left.array && right.array && left.array->type() == ElementType::UINT8 && right.array->type() == ElementType::UINT8;
+        if (both_bytes && op == ArrayKernels::BinaryOp::ADD) {
+            ArrayKernels::saturatingAdd(left.array->uint8Data(), right.array->uint8Data(), result->uint8Data(), length);
+        } else if (both_bytes && op == ArrayKernels::BinaryOp::SUB) {
+            ArrayKernels::saturatingSub(left.array->uint8Data(), right.array->uint8Data(), result->uint8Data(), length);
+        } else if (type == ElementType::FLOAT64) {
+            ArrayKernels::binary(op, left.float64(), right.float64(), result->float64Data(), length);
+        } else {
+            std::vector<double> values(length);
+            ArrayKernels::binary(op, left.float64(), right.float64(), values.data(), length);
+            storeFloat64(*result, values.data());
+        }
+        return NyxValue(result);
+    }
+
+    NyxValue comparison(ArrayKernels::CompareOp op, const std::vector<NyxValue>& args, const std::string& function_name) {
+        Operand left, right;
+        size_t length = readOperands(args, left, right, function_name);
+        NumericArrayPtr mask = makeArray(ElementType::UINT8, length);
+        ArrayKernels::compare(op, left.float64(), right.float64(), mask->uint8Data(), length);
+        return NyxValue(mask);
+    }
+
+    const NyxNumericArray& expectNonEmpty(const NyxValue& value, const std::string& function_name) {
+        const NyxNumericArray& array = *expectArray(value, function_name);
+        if (array.size() == 0) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects a non-empty array.", 0);
+        }
+        return array;
+    }
+
+    long long clampSliceIndex(const NyxValue& value, long long length, const std::string& function_name) {
+        if (!std::holds_alternative<double>(value.data) || std::trunc(std::get<double>(value.data)) != std::get<double>(value.data)) {
+            throw Common::NyxRuntimeException("'" + function_name + "' indices must be integers.", 0);
+        }
+        long long index = static_cast<long long>(std::get<double>(value.data));
+        if (index < 0) index += length;
+        return std::max(0LL, std::min(index, length));
+    }
+}
+
+NyxValue native_array_float64(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return constructArray(ElementType::FLOAT64, args, "array.float64");
+}
+
+NyxValue native_array_int32(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return constructArray(ElementType::INT32, args, "array.int32");
+}
+
+NyxValue native_array_uint8(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return constructArray(ElementType::UINT8, args, "array.uint8");
+}
+
+NyxValue native_array_range(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'array.range' expects 2 or 3 arguments (start, stop, [step]).", 0);
+    }
+    double bounds[3] = {0.0, 0.0, 1.0};
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (!std::holds_alternative<double>(args[i].data)) {
+            throw Common::NyxRuntimeException("'array.range' expects number arguments, got " + nyxValueTypeToString(args[i]) + ".", 0);
+        }
+        bounds[i] = std::get<double>(args[i].data);
+    }
+    double start = bounds[0], stop = bounds[1], step = bounds[2];
+    if (step == 0 || !std::isfinite(start) || !std::isfinite(stop) || !std::isfinite(step)) {
+        throw Common::NyxRuntimeException("'array.range' expects finite bounds and a non-zero step.", 0);
+    }
+    double count = std::ceil((stop - start) / step);
+    if (count > static_cast<double>(std::numeric_limits<std::int32_t>::max())) {
+        throw Common::NyxRuntimeException("'array.range' would make more than 2^31 elements.", 0);
+    }
+    size_t length = count > 0 ? static_cast<size_t>(count) : 0;
+    NumericArrayPtr array = makeArray(ElementType::FLOAT64, length);
+    double* elements = array->float64Data();
+    for (size_t i = 0; i < length; ++i) {
+        elements[i] = start + static_cast<double>(i) * step;
+    }
+    return NyxValue(array);
+}
+
+NyxValue native_array_fill(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& array = expectArray(args[0], "array.fill");
+    if (!std::holds_alternative<double>(args[1].data)) {
+        throw Common::NyxRuntimeException("'array.fill' expects a number to fill with, got " + nyxValueTypeToString(args[1]) + ".", 0);
+    }
+    double value = std::get<double>(args[1].data);
+    switch (array->type()) {
+        case ElementType::FLOAT64: std::fill_n(array->float64Data(), array->size(), value); break;
+        case ElementType::INT32: std::fill_n(array->int32Data(), array->size(), NyxNumericArray::toInt32(value)); break;
+        case ElementType::UINT8: std::fill_n(array->uint8Data(), array->size(), NyxNumericArray::toUInt8(value)); break;
+    }
+    return args[0];
+}
+
+NyxValue native_array_copy(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& array = expectArray(args[0], "array.copy");
+    NumericArrayPtr copy = makeArray(array->type(), array->size());
+    if (array->byteSize() > 0) {
+        std::memcpy(copy->rawData(), array->rawData(), array->byteSize());
+    }
+    return NyxValue(copy);
+}
+
+NyxValue native_array_slice(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'array.slice' expects 2 or 3 arguments (array, start_index, [end_index]).", 0);
+    }
+    const NumericArrayPtr& array = expectArray(args[0], "array.slice");
+    long long length = static_cast<long long>(array->size());
+    long long start = clampSliceIndex(args[1], length, "array.slice");
+    long long end = args.size() == 3 ? clampSliceIndex(args[2], length, "array.slice") : length;
+    size_t count = end > start ? static_cast<size_t>(end - start) : 0;
+    NumericArrayPtr slice = makeArray(array->type(), count);
+    if (count > 0) {
+        size_t element_size = NyxNumericArray::elementSize(array->type());
+        std::memcpy(slice->rawData(), static_cast<const char*>(array->rawData()) + start * element_size, count * element_size);
+    }
+    return NyxValue(slice);
+}
+
+NyxValue native_array_toList(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& array = expectArray(args[0], "array.toList");
+    HeapAccounting::checkAllocation(array->size() * sizeof(NyxValue), 0);
+    NyxList list;
+    list.reserve(array->size());
+    for (size_t i = 0; i < array->size(); ++i) {
+        list.push_back(NyxValue(array->get(i)));
+    }
+    return NyxValue(std::move(list));
+}
+
+NyxValue native_array_type(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(std::string(NyxNumericArray::typeName(expectArray(args[0], "array.type")->type())));
+}
+
+NyxValue native_array_add(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return arithmetic(ArrayKernels::BinaryOp::ADD, args, "array.add");
+}
+
+NyxValue native_array_sub(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return arithmetic(ArrayKernels::BinaryOp::SUB, args, "array.sub");
+}
+
+NyxValue native_array_mul(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return arithmetic(ArrayKernels::BinaryOp::MUL, args, "array.mul");
+}
+
+NyxValue native_array_div(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return arithmetic(ArrayKernels::BinaryOp::DIV, args, "array.div");
+}
+
+NyxValue native_array_abs(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& array = expectArray(args[0], "array.abs");
+    NumericArrayPtr result = makeArray(array->type(), array->size());
+    switch (array->type()) {
+        case ElementType::FLOAT64:
+            ArrayKernels::abs(array->float64Data(), result->float64Data(), array->size());
+            break;
+        case ElementType::INT32:
+            for (size_t i = 0; i < array->size(); ++i) result->set(i, std::fabs(array->get(i)));
+            break;
+        case ElementType::UINT8:
+            if (array->size() > 0) std::memcpy(result->uint8Data(), array->uint8Data(), array->size());
+            break;
+    }
+    return NyxValue(result);
+}
+
+NyxValue native_array_sqrt(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& array = expectArray(args[0], "array.sqrt");
+    NumericArrayPtr result = makeArray(ElementType::FLOAT64, array->size());
+    std::vector<double> scratch;
+    ArrayKernels::sqrt(float64Elements(*array, scratch), result->float64Data(), array->size());
+    return NyxValue(result);
+}
+
+NyxValue native_array_sum(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& array = expectArray(args[0], "array.sum");
+    std::vector<double> scratch;
+    return NyxValue(ArrayKernels::sum(float64Elements(*array, scratch), array->size()));
+}
+
+NyxValue native_array_mean(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxNumericArray& array = expectNonEmpty(args[0], "array.mean");
+    std::vector<double> scratch;
+    return NyxValue(ArrayKernels::sum(float64Elements(array, scratch), array.size()) / static_cast<double>(array.size()));
+}
+
+NyxValue native_array_min(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxNumericArray& array = expectNonEmpty(args[0], "array.min");
+    std::vector<double> scratch;
+    return NyxValue(ArrayKernels::min(float64Elements(array, scratch), array.size()));
+}
+
+NyxValue native_array_max(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxNumericArray& array = expectNonEmpty(args[0], "array.max");
+    std::vector<double> scratch;
+    return NyxValue(ArrayKernels::max(float64Elements(array, scratch), array.size()));
+}
+
+NyxValue native_array_dot(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& left = expectArray(args[0], "array.dot");
+    const NumericArrayPtr& right = expectArray(args[1], "array.dot");
+    if (left->size() != right->size()) {
+        throw Common::NyxRuntimeException("'array.dot' expects arrays of the same length (" + std::to_string(left->size()) +
+                                         " and " + std::to_string(right->size()) + ").", 0);
+    }
+    std::vector<double> left_scratch, right_scratch;
+    return NyxValue(ArrayKernels::dot(float64Elements(*left, left_scratch), float64Elements(*right, right_scratch), left->size()));
+}
+
+NyxValue native_array_lt(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return comparison(ArrayKernels::CompareOp::LT, args, "array.lt");
+}
+
+NyxValue native_array_le(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return comparison(ArrayKernels::CompareOp::LE, args, "array.le");
+}
+
+NyxValue native_array_gt(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return comparison(ArrayKernels::CompareOp::GT, args, "array.gt");
+}
+
+NyxValue native_array_ge(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return comparison(ArrayKernels::CompareOp::GE, args, "array.ge");
+}
+
+NyxValue native_array_eq(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return comparison(ArrayKernels::CompareOp::EQ, args, "array.eq");
+}
+
+NyxValue native_array_ne(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return comparison(ArrayKernels::CompareOp::NE, args, "array.ne");
+}
+
+NyxValue native_array_where(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& mask = expectArray(args[0], "array.where");
+    Operand chosen, otherwise;
+    std::vector<NyxValue> choices = {args[1], args[2]};
+    size_t length = readOperands(choices, chosen, otherwise, "array.where");
+    if (mask->size() != length) {
+        throw Common::NyxRuntimeException("'array.where' expects arrays of the same length (" + std::to_string(mask->size()) +
+                                         " and " + std::to_string(length) + ").", 0);
+    }
+    NumericArrayPtr result = makeArray(resultType(chosen, otherwise), length);
+    for (size_t i = 0; i < length; ++i) {
+        result->set(i, mask->get(i) != 0 ? chosen.at(i) : otherwise.at(i));
+    }
+    return NyxValue(result);
+}
+
+NyxValue native_array_select(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& array = expectArray(args[0], "array.select");
+    const NumericArrayPtr& mask = expectArray(args[1], "array.select");
+    if (array->size() != mask->size()) {
+        throw Common::NyxRuntimeException("'array.select' expects arrays of the same length (" + std::to_string(array->size()) +
+                                         " and " + std::to_string(mask->size()) + ").", 0);
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < mask->size(); ++i) {
+        kept += mask->get(i) != 0;
+    }
+    NumericArrayPtr result = makeArray(array->type(), kept);
+    size_t next = 0;
+    for (size_t i = 0; i < array->size(); ++i) {
+        if (mask->get(i) != 0) result->set(next++, array->get(i));
+    }
+    return NyxValue(result);
+}
+
+NyxValue native_array_count(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& mask = expectArray(args[0], "array.count");
+    if (mask->type() == ElementType::UINT8) {
+        return NyxValue(static_cast<double>(ArrayKernels::countNonZero(mask->uint8Data(), mask->size())));
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < mask->size(); ++i) {
+        count += mask->get(i) != 0;
+    }
+    return NyxValue(static_cast<double>(count));
+}
+
+NyxValue native_array_gather(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NumericArrayPtr& source = expectArray(args[0], "array.gather");
+    const NumericArrayPtr& indices = expectArray(args[1], "array.gather");
+    long long source_size = static_cast<long long>(source->size());
+    std::vector<std::int32_t> positions(indices->size());
+    for (size_t i = 0; i < indices->size(); ++i) {
+        double index = indices->get(i);
+        long long position = static_cast<long long>(index);
+        if (position < 0) position += source_size;
+        if (std::trunc(index) != index || position < 0 || position >= source_size) {
+            throw Common::NyxRuntimeException("'array.gather' index " + nyxValueToString(NyxValue(index)) + " is out of bounds for an array of " +
+                                             std::to_string(source_size) + " elements.", 0);
+        }
+        positions[i] = static_cast<std::int32_t>(position);
+    }
+    NumericArrayPtr result = makeArray(source->type(), positions.size());
+    if (source->type() == ElementType::FLOAT64) {
+        ArrayKernels::gather(source->float64Data(), positions.data(), result->float64Data(), positions.size());
+    } else {
+        for (size_t i = 0; i < positions.size(); ++i) {
+            result->set(i, source->get(static_cast<size_t>(positions[i])));
+        }
+    }
+    return NyxValue(result);
+}
+
+NyxValue native_array_simd(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'array.simd' function takes no arguments.", 0);
+    }
+    return NyxValue(std::string(ArrayKernels::simdLevelName(ArrayKernels::simdLevel())));
+}
+
+
+namespace {
+    constexpr NativeModuleMember ARRAY_MODULE_MEMBERS[] = {
+        nativeFunction("float64", native_array_float64, 1),
+        nativeFunction("int32", native_array_int32, 1),
+        nativeFunction("uint8", native_array_uint8, 1),
+        nativeFunction("range", native_array_range, -1),
+        nativeFunction("fill", native_array_fill, 2),
+        nativeFunction("copy", native_array_copy, 1),
+        nativeFunction("slice", native_array_slice, -1),
+        nativeFunction("toList", native_array_toList, 1),
+        nativeFunction("type", native_array_type, 1),
+        nativeFunction("add", native_array_add, 2),
+        nativeFunction("sub", native_array_sub, 2),
+        nativeFunction("mul", native_array_mul, 2),
+        nativeFunction("div", native_array_div, 2),
+        nativeFunction("abs", native_array_abs, 1),
+        nativeFunction("sqrt", native_array_sqrt, 1),
+        nativeFunction("sum", native_array_sum, 1),
+        nativeFunction("mean", native_array_mean, 1),
+        nativeFunction("min", native_array_min, 1),
+        nativeFunction("max", native_array_max, 1),
+        nativeFunction("dot", native_array_dot, 2),
+        nativeFunction("lt", native_array_lt, 2),
+        nativeFunction("le", native_array_le, 2),
+        nativeFunction("gt", native_array_gt, 2),
+        nativeFunction("ge", native_array_ge, 2),
+        nativeFunction("eq", native_array_eq, 2),
+        nativeFunction("ne", native_array_ne, 2),
+        nativeFunction("where", native_array_where, 3),
+        nativeFunction("select", native_array_select, 2),
+        nativeFunction("count", native_array_count, 1),
+        nativeFunction("gather", native_array_gather, 2),
+        nativeFunction("simd", native_array_simd, 0),
+    };
+
+    const NativeModuleTable ARRAY_MODULE(ARRAY_MODULE_MEMBERS);
+}
+
+void registerStdArrayModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:array", ARRAY_MODULE);
+}
+
+}
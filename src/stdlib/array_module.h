@@ -0,0 +1,47 @@
+#ifndef NYX_STDLIB_ARRAY_H
+#define NYX_STDLIB_ARRAY_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_array_float64(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_int32(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_uint8(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_range(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_fill(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_copy(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_slice(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_toList(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_type(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_add(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_sub(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_mul(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_div(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_abs(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_sqrt(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_sum(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_mean(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_min(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_max(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_dot(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_lt(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_le(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_gt(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_ge(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_eq(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_ne(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_where(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_select(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_count(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_gather(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_array_simd(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdArrayModule(Interpreter& interpreter);
+
+}
+
+#endif
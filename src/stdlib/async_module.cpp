@@ -0,0 +1,158 @@
+#include "./async_module.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../interpreter/EventLoop.h"
+#include "../common/FileHandle.h"
+#include "../common/HashTable.h"
+#include "../common/HeapAccounting.h"
+#include "../common/Utils.h"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace Nyx {
+
+namespace {
+    const GreenThreadPtr& expectThread(const NyxValue& value, const std::string& function_name) {
+        const auto* thread = std::get_if<GreenThreadPtr>(&value.data);
+        if (!thread || !*thread) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects a green thread returned by 'async.spawn', got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        return *thread;
+    }
+
+    NyxValue awaitThread(const GreenThreadPtr& thread) {
+        EventLoop::current().await(*thread);
+        return thread->outcome();
+    }
+
+    const std::string& expectString(const NyxValue& value, const std::string& what) {
+        const auto* text = std::get_if<std::string>(&value.data);
+        if (!text) {
+            throw Common::NyxRuntimeException(what + " must be a string, got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        return *text;
+    }
+}
+
+NyxValue native_async_spawn(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty()) {
+        throw Common::NyxRuntimeException("'async.spawn' expects a function followed by its arguments.", 0);
+    }
+    const auto& callee = args[0].data;
+    if (const auto* function = std::get_if<UserDefinedFunctionPtr>(&callee)) {
+        if (*function && (*function)->arity() != args.size() - 1) {
+            throw Common::NyxRuntimeException("'async.spawn': function '" + (*function)->name() + "' expects " +
+                                              std::to_string((*function)->arity()) + " arguments but got " +
+                                              std::to_string(args.size() - 1) + ".", 0);
+        }
+    } else if (!std::holds_alternative<NativeFunctionPtr>(callee)) {
+        throw Common::NyxRuntimeException("'async.spawn' expects a function as its first argument.", 0);
+    }
+    std::vector<NyxValue> arguments(args.begin() + 1, args.end());
+    return NyxValue(EventLoop::current().spawn(interpreter, args[0], std::move(arguments)));
+}
+
+NyxValue native_async_await(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return awaitThread(expectThread(args[0], "async.await"));
+}
+
+NyxValue native_async_all(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const auto* list = std::get_if<NyxList>(&args[0].data);
+    if (!list) {
+        throw Common::NyxRuntimeException("'async.all' expects one list of green threads.", 0);
+    }
+    std::vector<GreenThreadPtr> threads;
+    threads.reserve(list->size());
+    for (const NyxValue& element : *list) {
+        threads.push_back(expectThread(element, "async.all"));
+    }
+    NyxList results;
+    results.reserve(threads.size());
+    for (const GreenThreadPtr& thread : threads) {
+        results.push_back(awaitThread(thread));
+    }
+    return NyxValue(std::move(results));
+}
+
+NyxValue native_async_done(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(expectThread(args[0], "async.done")->finished());
+}
+
+NyxValue native_async_run(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    EventLoop::current().runAll();
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_async_sleep(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const double* seconds = std::get_if<double>(&args[0].data);
+    if (!seconds || !(*seconds >= 0)) {
+        throw Common::NyxRuntimeException("'async.sleep' expects a non-negative number of seconds.", 0);
+    }
+    EventLoop::current().sleepFor(*seconds);
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_async_readFile(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    std::string filepath = expectString(args[0], "'async.readFile' path");
+    std::error_code size_error;
+    auto file_size = std::filesystem::file_size(filepath, size_error);
+    if (!size_error) {
+        HeapAccounting::checkAllocation(static_cast<size_t>(file_size), 0);
+    }
+    auto content = std::make_shared<std::string>();
+    EventLoop::current().runElsewhere([filepath, content]() {
+        *content = readWholeFile(filepath);
+    });
+    return NyxValue(std::move(*content));
+}
+
+NyxValue native_async_writeFile(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    std::string filepath = expectString(args[0], "'async.writeFile' path");
+    auto content = std::make_shared<std::string>(Common::process_escapes(expectString(args[1], "'async.writeFile' content")));
+    EventLoop::current().runElsewhere([filepath, content]() {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw Common::NyxRuntimeException("Could not open file '" + filepath + "' for writing.", 0);
+        }
+        file.write(content->data(), static_cast<std::streamsize>(content->size()));
+    });
+    return NyxValue(true);
+}
+
+NyxValue native_async_exec(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const std::string& command = expectString(args[0], "'async.exec' command");
+    std::string output;
+    int status = 0;
+    EventLoop::current().runCommand(command, output, status);
+
+    auto result = std::make_shared<NyxMap>();
+    bool inserted = false;
+    result->table.valueAt(result->table.insert(NyxValue(std::string("status")), inserted)) = NyxValue(static_cast<double>(status));
+    result->table.valueAt(result->table.insert(NyxValue(std::string("output")), inserted)) = NyxValue(std::move(output));
+    return NyxValue(result);
+}
+
+
+namespace {
+    constexpr NativeModuleMember ASYNC_MODULE_MEMBERS[] = {
+        nativeFunction("spawn", native_async_spawn, -1),
+        nativeFunction("await", native_async_await, 1),
+        nativeFunction("all", native_async_all, 1),
+        nativeFunction("done", native_async_done, 1),
+        nativeFunction("run", native_async_run, 0),
+        nativeFunction("sleep", native_async_sleep, 1),
+        nativeFunction("readFile", native_async_readFile, 1),
+        nativeFunction("writeFile", native_async_writeFile, 2),
+        nativeFunction("exec", native_async_exec, 1),
+    };
+
+    const NativeModuleTable ASYNC_MODULE(ASYNC_MODULE_MEMBERS);
+}
+
+void registerStdAsyncModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:async", ASYNC_MODULE);
+}
+
+}
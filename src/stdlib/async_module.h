@@ -0,0 +1,25 @@
+#ifndef NYX_STDLIB_ASYNC_H
+#define NYX_STDLIB_ASYNC_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_async_spawn(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_async_await(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_async_all(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_async_done(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_async_run(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_async_sleep(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_async_readFile(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_async_writeFile(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_async_exec(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdAsyncModule(Interpreter& interpreter);
+
+}
+
+#endif
@@ -0,0 +1,320 @@
+#include "./bytes_kernels.h"
+#include "./array_kernels.h"
+
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NYX_BYTES_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define NYX_TARGET_SSSE3
+#else
+#define NYX_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#else
+#define NYX_BYTES_X86 0
+#endif
+
+namespace Nyx {
+namespace BytesKernels {
+
+namespace {
+    using ArrayKernels::SimdLevel;
+
+    constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    constexpr char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    // -1 for bytes outside the alphabet.
+    constexpr std::array<std::int8_t, 256> makeDecodeTable(bool hex) {
+        std::array<std::int8_t, 256> table{};
+        for (auto& entry : table) entry = -1;
+        if (hex) {
+            for (int i = 0; i < 10; ++i) table['0' + i] = static_cast<std::int8_t>(i);
+            for (int i = 0; i < 6; ++i) {
+                table['a' + i] = static_cast<std::int8_t>(10 + i);
+                table['A' + i] = static_cast<std::int8_t>(10 + i);
+            }
+        } else {
+            for (int i = 0; i < 64; ++i) table[static_cast<unsigned char>(BASE64_ALPHABET[i])] = static_cast<std::int8_t>(i);
+        }
+        return table;
+    }
+
+    constexpr std::array<std::int8_t, 256> HEX_VALUES = makeDecodeTable(true);
+    constexpr std::array<std::int8_t, 256> BASE64_VALUES = makeDecodeTable(false);
+
+    inline std::uint32_t readLE32(const std::uint8_t* p) {
+        return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8 |
+               static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+    }
+
+    inline std::uint64_t readLE64(const std::uint8_t* p) {
+        return static_cast<std::uint64_t>(readLE32(p)) | static_cast<std::uint64_t>(readLE32(p + 4)) << 32;
+    }
+
+    inline std::uint32_t rotl32(std::uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+    inline std::uint64_t rotl64(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    void hexEncodeScalar(const std::uint8_t* in, size_t from, size_t n, char* out) {
+        for (size_t i = from; i < n; ++i) {
+            out[2 * i] = HEX_DIGITS[in[i] >> 4];
+            out[2 * i + 1] = HEX_DIGITS[in[i] & 0x0f];
+        }
+    }
+
+    void base64EncodeScalar(const std::uint8_t* in, size_t from, size_t n, char* out) {
+        size_t i = from;
+        char* o = out + from / 3 * 4;
+        for (; i + 3 <= n; i += 3) {
+            std::uint32_t triple = static_cast<std::uint32_t>(in[i]) << 16 | static_cast<std::uint32_t>(in[i + 1]) << 8 | in[i + 2];
+            *o++ = BASE64_ALPHABET[(triple >> 18) & 63];
+            *o++ = BASE64_ALPHABET[(triple >> 12) & 63];
+            *o++ = BASE64_ALPHABET[(triple >> 6) & 63];
+            *o++ = BASE64_ALPHABET[triple & 63];
+        }
+        if (i < n) {
+            std::uint32_t triple = static_cast<std::uint32_t>(in[i]) << 16 | (i + 1 < n ? static_cast<std::uint32_t>(in[i + 1]) << 8 : 0);
+            *o++ = BASE64_ALPHABET[(triple >> 18) & 63];
+            *o++ = BASE64_ALPHABET[(triple >> 12) & 63];
+            *o++ = i + 1 < n ? BASE64_ALPHABET[(triple >> 6) & 63] : '=';
+            *o++ = '=';
+        }
+    }
+
+#if NYX_BYTES_X86
+    // Sixteen bytes become 32 digits: split each byte into nibbles, turn the
+    // nibbles into digits with a compare, then interleave high and low.
+    size_t hexEncodeSse2(const std::uint8_t* in, size_t n, char* out) {
+        const __m128i low_mask = _mm_set1_epi8(0x0f);
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i zero_digit = _mm_set1_epi8('0');
+        const __m128i letter_gap = _mm_set1_epi8('a' - '0' - 10);
+        auto digits = [&](__m128i nibbles) {
+            __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), letter_gap);
+            return _mm_add_epi8(_mm_add_epi8(nibbles, zero_digit), letters);
+        };
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            __m128i high = digits(_mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask));
+            __m128i low = digits(_mm_and_si128(bytes, low_mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(high, low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+        }
+        return i;
+    }
+
+    // Twelve bytes become sixteen digits per step (W. Muła's method): a
+    // shuffle and two multiplies spread each 6-bit group into its own byte,
+    // then a second shuffle looks up how far each group is from its digit.
+    // Loads sixteen bytes, so stops while at least sixteen remain.
+    NYX_TARGET_SSSE3 size_t base64EncodeSsse3(const std::uint8_t* in, size_t n, char* out) {
+        const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+        const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        size_t i = 0;
+        char* o = out;
+        for (; i + 16 <= n; i += 12, o += 16) {
+            __m128i bytes = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), spread);
+            __m128i t0 = _mm_and_si128(bytes, _mm_set1_epi32(0x0fc0fc00));
+            __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+            __m128i t2 = _mm_and_si128(bytes, _mm_set1_epi32(0x003f03f0));
+            __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+            __m128i indices = _mm_or_si128(t1, t3);
+
+            // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+            __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+            __m128i below_26 = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+            range = _mm_or_si128(range, _mm_and_si128(below_26, _mm_set1_epi8(13)));
+            __m128i encoded = _mm_add_epi8(_mm_shuffle_epi8(shift_lut, range), indices);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(o), encoded);
+        }
+        return i;
+    }
+#endif
+
+    std::array<std::array<std::uint32_t, 256>, 8> makeCrcTables() {
+        std::array<std::array<std::uint32_t, 256>, 8> tables{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            tables[0][i] = crc;
+        }
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            for (size_t t = 1; t < 8; ++t) {
+                tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+            }
+        }
+        return tables;
+    }
+
+    const std::array<std::array<std::uint32_t, 256>, 8>& crcTables() {
+        static const auto tables = makeCrcTables();
+        return tables;
+    }
+}
+
+void hexEncode(const std::uint8_t* in, size_t n, char* out) {
+    size_t done = 0;
+#if NYX_BYTES_X86
+    if (ArrayKernels::simdLevel() >= SimdLevel::SSE2) {
+        done = hexEncodeSse2(in, n, out);
+    }
+#endif
+    hexEncodeScalar(in, done, n, out);
+}
+
+bool hexDecode(const char* in, size_t n, std::uint8_t* out) {
+    for (size_t i = 0; i < n; ++i) {
+        std::int8_t high = HEX_VALUES[static_cast<unsigned char>(in[2 * i])];
+        std::int8_t low = HEX_VALUES[static_cast<unsigned char>(in[2 * i + 1])];
+        if ((high | low) < 0) return false;
+        out[i] = static_cast<std::uint8_t>(high << 4 | low);
+    }
+    return true;
+}
+
+size_t base64EncodedSize(size_t n) {
+    return (n + 2) / 3 * 4;
+}
+
+void base64Encode(const std::uint8_t* in, size_t n, char* out) {
+    size_t done = 0;
+#if NYX_BYTES_X86
+    // SSSE3 comes with every CPU at the AVX2 level.
+    if (ArrayKernels::simdLevel() >= SimdLevel::AVX2) {
+        done = base64EncodeSsse3(in, n, out);
+    }
+#endif
+    base64EncodeScalar(in, done, n, out);
+}
+
+size_t base64Decode(const char* in, size_t n, std::uint8_t* out) {
+    size_t padding = 0;
+    while (n > 0 && padding < 2 && in[n - 1] == '=') {
+        --n;
+        ++padding;
+    }
+    if (n % 4 == 1 || (padding > 0 && (n + padding) % 4 != 0)) return SIZE_MAX;
+    std::uint8_t* o = out;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        std::int32_t a = BASE64_VALUES[static_cast<unsigned char>(in[i])];
+        std::int32_t b = BASE64_VALUES[static_cast<unsigned char>(in[i + 1])];
+        std::int32_t c = BASE64_VALUES[static_cast<unsigned char>(in[i + 2])];
+        std::int32_t d = BASE64_VALUES[static_cast<unsigned char>(in[i + 3])];
+        if ((a | b | c | d) < 0) return SIZE_MAX;
+        std::uint32_t triple = static_cast<std::uint32_t>(a << 18 | b << 12 | c << 6 | d);
+        *o++ = static_cast<std::uint8_t>(triple >> 16);
+        *o++ = static_cast<std::uint8_t>(triple >> 8);
+        *o++ = static_cast<std::uint8_t>(triple);
+    }
+    size_t rest = n - i;
+    if (rest > 0) {
+        std::int32_t a = BASE64_VALUES[static_cast<unsigned char>(in[i])];
+        std::int32_t b = BASE64_VALUES[static_cast<unsigned char>(in[i + 1])];
+        std::int32_t c = rest == 3 ? BASE64_VALUES[static_cast<unsigned char>(in[i + 2])] : 0;
+        if ((a | b | c) < 0) return SIZE_MAX;
+        std::uint32_t triple = static_cast<std::uint32_t>(a << 18 | b << 12 | c << 6);
+        *o++ = static_cast<std::uint8_t>(triple >> 16);
+        if (rest == 3) *o++ = static_cast<std::uint8_t>(triple >> 8);
+    }
+    return static_cast<size_t>(o - out);
+}
+
+// Slicing by 8: eight table lookups fold in eight bytes per step.
+std::uint32_t crc32(const std::uint8_t* data, size_t n, std::uint32_t previous) {
+    const auto& tables = crcTables();
+    std::uint32_t crc = ~previous;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        std::uint32_t low = readLE32(data + i) ^ crc;
+        std::uint32_t high = readLE32(data + i + 4);
+        crc = tables[7][low & 0xff] ^ tables[6][(low >> 8) & 0xff] ^ tables[5][(low >> 16) & 0xff] ^ tables[4][low >> 24] ^
+              tables[3][high & 0xff] ^ tables[2][(high >> 8) & 0xff] ^ tables[1][(high >> 16) & 0xff] ^ tables[0][high >> 24];
+    }
+    for (; i < n; ++i) {
+        crc = (crc >> 8) ^ tables[0][(crc ^ data[i]) & 0xff];
+    }
+    return ~crc;
+}
+
+std::uint32_t xxhash32(const std::uint8_t* data, size_t n, std::uint32_t seed) {
+    constexpr std::uint32_t P1 = 0x9E3779B1u, P2 = 0x85EBCA77u, P3 = 0xC2B2AE3Du, P4 = 0x27D4EB2Fu, P5 = 0x165667B1u;
+    auto round = [](std::uint32_t acc, std::uint32_t input) { return rotl32(acc + input * P2, 13) * P1; };
+    size_t i = 0;
+    std::uint32_t hash;
+    if (n >= 16) {
+        std::uint32_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+        for (; i + 16 <= n; i += 16) {
+            v1 = round(v1, readLE32(data + i));
+            v2 = round(v2, readLE32(data + i + 4));
+            v3 = round(v3, readLE32(data + i + 8));
+            v4 = round(v4, readLE32(data + i + 12));
+        }
+        hash = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+    } else {
+        hash = seed + P5;
+    }
+    hash += static_cast<std::uint32_t>(n);
+    for (; i + 4 <= n; i += 4) {
+        hash = rotl32(hash + readLE32(data + i) * P3, 17) * P4;
+    }
+    for (; i < n; ++i) {
+        hash = rotl32(hash + data[i] * P5, 11) * P1;
+    }
+    hash ^= hash >> 15;
+    hash *= P2;
+    hash ^= hash >> 13;
+    hash *= P3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+std::uint64_t xxhash64(const std::uint8_t* data, size_t n, std::uint64_t seed) {
+    constexpr std::uint64_t P1 = 0x9E3779B185EBCA87ull, P2 = 0xC2B2AE3D27D4EB4Full, P3 = 0x165667B19E3779F9ull,
+                            P4 = 0x85EBCA77C2B2AE63ull, P5 = 0x27D4EB2F165667C5ull;
+    auto round = [](std::uint64_t acc, std::uint64_t input) { return rotl64(acc + input * P2, 31) * P1; };
+    auto merge = [&](std::uint64_t acc, std::uint64_t value) { return (acc ^ round(0, value)) * P1 + P4; };
+    size_t i = 0;
+    std::uint64_t hash;
+    if (n >= 32) {
+        std::uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+        for (; i + 32 <= n; i += 32) {
+            v1 = round(v1, readLE64(data + i));
+            v2 = round(v2, readLE64(data + i + 8));
+            v3 = round(v3, readLE64(data + i + 16));
+            v4 = round(v4, readLE64(data + i + 24));
+        }
+        hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        hash = merge(hash, v1);
+        hash = merge(hash, v2);
+        hash = merge(hash, v3);
+        hash = merge(hash, v4);
+    } else {
+        hash = seed + P5;
+    }
+    hash += static_cast<std::uint64_t>(n);
+    for (; i + 8 <= n; i += 8) {
+        hash = rotl64(hash ^ round(0, readLE64(data + i)), 27) * P1 + P4;
+    }
+    if (i + 4 <= n) {
+        hash = rotl64(hash ^ (static_cast<std::uint64_t>(readLE32(data + i)) * P1), 23) * P2 + P3;
+        i += 4;
+    }
+    for (; i < n; ++i) {
+        hash = rotl64(hash ^ (data[i] * P5), 11) * P1;
+    }
+    hash ^= hash >> 33;
+    hash *= P2;
+    hash ^= hash >> 29;
+    hash *= P3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+}
+}
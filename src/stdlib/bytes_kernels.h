@@ -0,0 +1,36 @@
+#ifndef NYX_STDLIB_BYTES_KERNELS_H
+#define NYX_STDLIB_BYTES_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nyx {
+
+// Encoders and hashes behind std:bytes. The encoders pick a vector version
+// at run time by the same SIMD level as std:array (see array_kernels.h):
+// SSE2 for hex, and SSSE3 shuffles for base64 on CPUs at the AVX2 level.
+// Every level gives identical output.
+namespace BytesKernels {
+
+// Writes 2 * n lowercase hex digits.
+void hexEncode(const std::uint8_t* in, size_t n, char* out);
+// Reads 2 * n hex digits of either case. Returns false on any other byte.
+bool hexDecode(const char* in, size_t n, std::uint8_t* out);
+
+size_t base64EncodedSize(size_t n);
+// Standard alphabet with '=' padding; writes base64EncodedSize(n) bytes.
+void base64Encode(const std::uint8_t* in, size_t n, char* out);
+// Accepts input with or without padding. Returns the number of bytes
+// written (at most 3 * n / 4), or SIZE_MAX if the input is not base64.
+size_t base64Decode(const char* in, size_t n, std::uint8_t* out);
+
+// CRC-32 as used by zip, gzip and PNG.
+std::uint32_t crc32(const std::uint8_t* data, size_t n, std::uint32_t previous = 0);
+std::uint32_t xxhash32(const std::uint8_t* data, size_t n, std::uint32_t seed);
+std::uint64_t xxhash64(const std::uint8_t* data, size_t n, std::uint64_t seed);
+
+}
+
+}
+
+#endif
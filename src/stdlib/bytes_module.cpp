@@ -0,0 +1,514 @@
+#include "./bytes_module.h"
+#include "./bytes_kernels.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../common/Bytes.h"
+#include "../common/NumericArray.h"
+#include "../common/HeapAccounting.h"
+#include "../common/Utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Nyx {
+
+namespace {
+    const BytesPtr& expectBytes(const NyxValue& value, const std::string& function_name) {
+        const auto* bytes = std::get_if<BytesPtr>(&value.data);
+        if (!bytes || !*bytes) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects bytes, got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        return *bytes;
+    }
+
+    // Read-only input of the encoders, hashes and find: bytes, or the raw
+    // bytes of a string.
+    struct ByteView {
+        const std::uint8_t* data;
+        size_t size;
+    };
+
+    ByteView expectByteView(const NyxValue& value, const std::string& function_name) {
+        if (const auto* bytes = std::get_if<BytesPtr>(&value.data); bytes && *bytes) {
+            return {(*bytes)->data(), (*bytes)->size()};
+        }
+        if (const auto* text = std::get_if<std::string>(&value.data)) {
+            return {reinterpret_cast<const std::uint8_t*>(text->data()), text->size()};
+        }
+        throw Common::NyxRuntimeException("'" + function_name + "' expects bytes or a string, got " + nyxValueTypeToString(value) + ".", 0);
+    }
+
+    BytesPtr makeBytes(size_t length) {
+        HeapAccounting::checkAllocation(length, 0);
+        return std::make_shared<NyxBytes>(length);
+    }
+
+    size_t expectCount(const NyxValue& value, const std::string& function_name, const std::string& what) {
+        const double* number = std::get_if<double>(&value.data);
+        if (!number || !(*number >= 0) || std::trunc(*number) != *number || *number > 9007199254740992.0) {
+            throw Common::NyxRuntimeException("'" + function_name + "' " + what + " must be a non-negative integer, got " +
+                                             nyxValueToString(value) + ".", 0);
+        }
+        return static_cast<size_t>(*number);
+    }
+
+    long long clampSliceIndex(const NyxValue& value, long long length, const std::string& function_name) {
+        if (!std::holds_alternative<double>(value.data) || std::trunc(std::get<double>(value.data)) != std::get<double>(value.data)) {
+            throw Common::NyxRuntimeException("'" + function_name + "' indices must be integers.", 0);
+        }
+        long long index = static_cast<long long>(std::get<double>(value.data));
+        if (index < 0) index += length;
+        return std::max(0LL, std::min(index, length));
+    }
+
+    // The arguments shared by the get* and set* functions: the buffer, an
+    // offset, a width in bytes and an optional byte order (`endian_index`).
+    struct Field {
+        std::uint8_t* at;
+        size_t width;
+        bool big_endian;
+    };
+
+    Field expectField(const std::vector<NyxValue>& args, size_t endian_index, bool is_float, const std::string& function_name) {
+        const BytesPtr& bytes = expectBytes(args[0], function_name);
+        size_t offset = expectCount(args[1], function_name, "offset");
+        size_t width = expectCount(args[2], function_name, "width");
+        bool width_ok = is_float ? (width == 4 || width == 8) : (width == 1 || width == 2 || width == 4 || width == 8);
+        if (!width_ok) {
+            throw Common::NyxRuntimeException("'" + function_name + "' width must be " + (is_float ? "4 or 8" : "1, 2, 4 or 8") +
+                                             " bytes, got " + std::to_string(width) + ".", 0);
+        }
+        bool big_endian = false;
+        if (args.size() > endian_index) {
+            const auto* order = std::get_if<std::string>(&args[endian_index].data);
+            if (!order || (*order != "little" && *order != "big")) {
+                throw Common::NyxRuntimeException("'" + function_name + "' byte order must be \"little\" or \"big\".", 0);
+            }
+            big_endian = *order == "big";
+        }
+        if (offset > bytes->size() || width > bytes->size() - offset) {
+            throw Common::NyxRuntimeException("'" + function_name + "' of " + std::to_string(width) + " bytes at offset " + std::to_string(offset) +
+                                             " is past the end of " + std::to_string(bytes->size()) + " bytes.", 0);
+        }
+        return {bytes->data() + offset, width, big_endian};
+    }
+
+    void expectFieldArgCount(const std::vector<NyxValue>& args, size_t required, const std::string& function_name, const std::string& usage) {
+        if (args.size() < required || args.size() > required + 1) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects " + std::to_string(required) + " or " + std::to_string(required + 1) +
+                                             " arguments (" + usage + ").", 0);
+        }
+    }
+
+    std::uint64_t loadField(const Field& field) {
+        std::uint64_t bits = 0;
+        for (size_t i = 0; i < field.width; ++i) {
+            size_t source = field.big_endian ? i : field.width - 1 - i;
+            bits = (bits << 8) | field.at[source];
+        }
+        return bits;
+    }
+
+    void storeField(const Field& field, std::uint64_t bits) {
+        for (size_t i = 0; i < field.width; ++i) {
+            size_t target = field.big_endian ? field.width - 1 - i : i;
+            field.at[target] = static_cast<std::uint8_t>(bits >> (8 * i));
+        }
+    }
+
+    // Converts the raw bits of a field to a number by its kind.
+    enum class FieldKind { UINT, INT, FLOAT };
+
+    double fieldValue(std::uint64_t bits, size_t width, FieldKind kind) {
+        switch (kind) {
+            case FieldKind::UINT:
+                return static_cast<double>(bits);
+            case FieldKind::INT: {
+                // Sign-extend from the field's top bit.
+                unsigned shift = static_cast<unsigned>(64 - 8 * width);
+                return static_cast<double>(static_cast<std::int64_t>(bits << shift) >> shift);
+            }
+            case FieldKind::FLOAT:
+                if (width == 4) {
+                    std::uint32_t narrow = static_cast<std::uint32_t>(bits);
+                    float value;
+                    std::memcpy(&value, &narrow, sizeof(value));
+                    return value;
+                } else {
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return value;
+                }
+        }
+        return 0.0;
+    }
+
+    double expectInteger(const NyxValue& value, double low, double high, const std::string& function_name, size_t width) {
+        const double* number = std::get_if<double>(&value.data);
+        if (!number || std::trunc(*number) != *number || *number < low || *number >= high) {
+            throw Common::NyxRuntimeException("'" + function_name + "' value " + nyxValueToString(value) + " does not fit in " +
+                                             std::to_string(width) + (width == 1 ? " byte." : " bytes."), 0);
+        }
+        return *number;
+    }
+
+    std::string toHexString(std::uint64_t value, int digits) {
+        std::string text(static_cast<size_t>(digits), '0');
+        for (int i = digits - 1; i >= 0; --i, value >>= 4) {
+            text[static_cast<size_t>(i)] = "0123456789abcdef"[value & 0x0f];
+        }
+        return text;
+    }
+}
+
+NyxValue native_bytes_make(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxValue& source = args[0];
+    if (std::holds_alternative<double>(source.data)) {
+        return NyxValue(makeBytes(expectCount(source, "bytes.make", "length")));
+    }
+    if (const auto* text = std::get_if<std::string>(&source.data)) {
+        HeapAccounting::checkAllocation(text->size(), 0);
+        return NyxValue(NyxBytes::adopt(*text));
+    }
+    if (const auto* list = std::get_if<NyxList>(&source.data)) {
+        BytesPtr bytes = makeBytes(list->size());
+        for (size_t i = 0; i < list->size(); ++i) {
+            const double* number = std::get_if<double>(&(*list)[i].data);
+            if (!number) {
+                throw Common::NyxRuntimeException("'bytes.make' expects a list of numbers, but element " + std::to_string(i) +
+                                                 " is " + nyxValueTypeToString((*list)[i]) + ".", 0);
+            }
+            bytes->set(i, NyxNumericArray::toUInt8(*number));
+        }
+        return NyxValue(bytes);
+    }
+    if (const auto* array = std::get_if<NumericArrayPtr>(&source.data); array && *array) {
+        BytesPtr bytes = makeBytes((*array)->size());
+        if ((*array)->type() == NyxNumericArray::ElementType::UINT8) {
+            if (bytes->size() > 0) std::memcpy(bytes->data(), (*array)->uint8Data(), bytes->size());
+        } else {
+            for (size_t i = 0; i < bytes->size(); ++i) bytes->set(i, NyxNumericArray::toUInt8((*array)->get(i)));
+        }
+        return NyxValue(bytes);
+    }
+    if (const auto* other = std::get_if<BytesPtr>(&source.data); other && *other) {
+        HeapAccounting::checkAllocation((*other)->size(), 0);
+        return NyxValue(std::make_shared<NyxBytes>((*other)->data(), (*other)->size()));
+    }
+    throw Common::NyxRuntimeException("'bytes.make' expects a length, a string, a list of numbers, an array or bytes, got " +
+                                     nyxValueTypeToString(source) + ".", 0);
+}
+
+NyxValue native_bytes_slice(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'bytes.slice' expects 2 or 3 arguments (bytes, start_index, [end_index]).", 0);
+    }
+    const BytesPtr& bytes = expectBytes(args[0], "bytes.slice");
+    long long length = static_cast<long long>(bytes->size());
+    long long start = clampSliceIndex(args[1], length, "bytes.slice");
+    long long end = args.size() == 3 ? clampSliceIndex(args[2], length, "bytes.slice") : length;
+    return NyxValue(bytes->slice(static_cast<size_t>(start), static_cast<size_t>(std::max(start, end))));
+}
+
+NyxValue native_bytes_copy(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const BytesPtr& bytes = expectBytes(args[0], "bytes.copy");
+    HeapAccounting::checkAllocation(bytes->size(), 0);
+    return NyxValue(std::make_shared<NyxBytes>(bytes->data(), bytes->size()));
+}
+
+NyxValue native_bytes_concat(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const auto* parts = std::get_if<NyxList>(&args[0].data);
+    if (!parts) {
+        throw Common::NyxRuntimeException("'bytes.concat' expects a list of bytes, got " + nyxValueTypeToString(args[0]) + ".", 0);
+    }
+    size_t total = 0;
+    for (const NyxValue& part : *parts) {
+        total += expectBytes(part, "bytes.concat")->size();
+    }
+    BytesPtr result = makeBytes(total);
+    size_t written = 0;
+    for (const NyxValue& part : *parts) {
+        const NyxBytes& bytes = *std::get<BytesPtr>(part.data);
+        if (bytes.size() > 0) std::memcpy(result->data() + written, bytes.data(), bytes.size());
+        written += bytes.size();
+    }
+    return NyxValue(result);
+}
+
+NyxValue native_bytes_fill(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const BytesPtr& bytes = expectBytes(args[0], "bytes.fill");
+    if (!std::holds_alternative<double>(args[1].data)) {
+        throw Common::NyxRuntimeException("'bytes.fill' expects a number to fill with, got " + nyxValueTypeToString(args[1]) + ".", 0);
+    }
+    if (bytes->size() > 0) std::memset(bytes->data(), NyxNumericArray::toUInt8(std::get<double>(args[1].data)), bytes->size());
+    return args[0];
+}
+
+NyxValue native_bytes_toString(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(expectBytes(args[0], "bytes.toString")->toString());
+}
+
+NyxValue native_bytes_toList(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const BytesPtr& bytes = expectBytes(args[0], "bytes.toList");
+    HeapAccounting::checkAllocation(bytes->size() * sizeof(NyxValue), 0);
+    NyxList list;
+    list.reserve(bytes->size());
+    for (size_t i = 0; i < bytes->size(); ++i) {
+        list.push_back(NyxValue(static_cast<double>(bytes->get(i))));
+    }
+    return NyxValue(std::move(list));
+}
+
+NyxValue native_bytes_equals(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxBytes& a = *expectBytes(args[0], "bytes.equals");
+    const NyxBytes& b = *expectBytes(args[1], "bytes.equals");
+    return NyxValue(a.size() == b.size() && (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size()) == 0));
+}
+
+NyxValue native_bytes_find(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'bytes.find' expects 2 or 3 arguments (bytes, needle, [start_index]).", 0);
+    }
+    const BytesPtr& bytes = expectBytes(args[0], "bytes.find");
+    ByteView needle = expectByteView(args[1], "bytes.find");
+    size_t start = args.size() == 3 ? static_cast<size_t>(clampSliceIndex(args[2], static_cast<long long>(bytes->size()), "bytes.find")) : 0;
+    const std::uint8_t* data = bytes->data();
+    size_t size = bytes->size();
+    if (needle.size == 0) return NyxValue(static_cast<double>(start));
+    // memchr for the first byte, then compare the rest.
+    size_t last_start = size >= needle.size ? size - needle.size : 0;
+    for (size_t at = start; size >= needle.size && at <= last_start;) {
+        const void* hit = std::memchr(data + at, needle.data[0], last_start - at + 1);
+        if (!hit) break;
+        at = static_cast<size_t>(static_cast<const std::uint8_t*>(hit) - data);
+        if (std::memcmp(data + at + 1, needle.data + 1, needle.size - 1) == 0) {
+            return NyxValue(static_cast<double>(at));
+        }
+        ++at;
+    }
+    return NyxValue(-1.0);
+}
+
+NyxValue native_bytes_getUint(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFieldArgCount(args, 3, "bytes.getUint", "bytes, offset, width, [byte_order]");
+    Field field = expectField(args, 3, false, "bytes.getUint");
+    return NyxValue(fieldValue(loadField(field), field.width, FieldKind::UINT));
+}
+
+NyxValue native_bytes_getInt(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFieldArgCount(args, 3, "bytes.getInt", "bytes, offset, width, [byte_order]");
+    Field field = expectField(args, 3, false, "bytes.getInt");
+    return NyxValue(fieldValue(loadField(field), field.width, FieldKind::INT));
+}
+
+NyxValue native_bytes_getFloat(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFieldArgCount(args, 3, "bytes.getFloat", "bytes, offset, width, [byte_order]");
+    Field field = expectField(args, 3, true, "bytes.getFloat");
+    return NyxValue(fieldValue(loadField(field), field.width, FieldKind::FLOAT));
+}
+
+NyxValue native_bytes_setUint(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFieldArgCount(args, 4, "bytes.setUint", "bytes, offset, width, value, [byte_order]");
+    Field field = expectField(args, 4, false, "bytes.setUint");
+    double limit = std::ldexp(1.0, static_cast<int>(8 * field.width));
+    double value = expectInteger(args[3], 0.0, limit, "bytes.setUint", field.width);
+    storeField(field, static_cast<std::uint64_t>(value));
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_bytes_setInt(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFieldArgCount(args, 4, "bytes.setInt", "bytes, offset, width, value, [byte_order]");
+    Field field = expectField(args, 4, false, "bytes.setInt");
+    double limit = std::ldexp(1.0, static_cast<int>(8 * field.width) - 1);
+    double value = expectInteger(args[3], -limit, limit, "bytes.setInt", field.width);
+    storeField(field, static_cast<std::uint64_t>(static_cast<std::int64_t>(value)));
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_bytes_setFloat(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFieldArgCount(args, 4, "bytes.setFloat", "bytes, offset, width, value, [byte_order]");
+    Field field = expectField(args, 4, true, "bytes.setFloat");
+    const double* number = std::get_if<double>(&args[3].data);
+    if (!number) {
+        throw Common::NyxRuntimeException("'bytes.setFloat' expects a number to store, got " + nyxValueTypeToString(args[3]) + ".", 0);
+    }
+    if (field.width == 4) {
+        float narrow = static_cast<float>(*number);
+        std::uint32_t bits;
+        std::memcpy(&bits, &narrow, sizeof(bits));
+        storeField(field, bits);
+    } else {
+        std::uint64_t bits;
+        std::memcpy(&bits, number, sizeof(bits));
+        storeField(field, bits);
+    }
+    return NyxValue(std::monostate{});
+}
+
+// bytes.column(b, type, offset, stride, [byte_order]): the field of `type`
+// ("u8" ... "u64", "i8" ... "i64", "f32", "f64") at `offset` in every
+// `stride`-byte record, as a float64 array. One call instead of a get* per
+// record.
+NyxValue native_bytes_column(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFieldArgCount(args, 4, "bytes.column", "bytes, type, offset, stride, [byte_order]");
+    const BytesPtr& bytes = expectBytes(args[0], "bytes.column");
+    const auto* type = std::get_if<std::string>(&args[1].data);
+    FieldKind kind = FieldKind::UINT;
+    size_t width = 0;
+    if (type && type->size() >= 2) {
+        char prefix = (*type)[0];
+        std::string bits = type->substr(1);
+        width = bits == "8" ? 1 : bits == "16" ? 2 : bits == "32" ? 4 : bits == "64" ? 8 : 0;
+        kind = prefix == 'i' ? FieldKind::INT : prefix == 'f' ? FieldKind::FLOAT : FieldKind::UINT;
+        if ((prefix != 'u' && prefix != 'i' && prefix != 'f') || (kind == FieldKind::FLOAT && width < 4)) width = 0;
+    }
+    if (width == 0) {
+        throw Common::NyxRuntimeException("'bytes.column' type must be one of u8, u16, u32, u64, i8, i16, i32, i64, f32 or f64.", 0);
+    }
+    size_t offset = expectCount(args[2], "bytes.column", "offset");
+    size_t stride = expectCount(args[3], "bytes.column", "stride");
+    if (stride < width) {
+        throw Common::NyxRuntimeException("'bytes.column' stride must be at least the field width (" + std::to_string(width) + ").", 0);
+    }
+    bool big_endian = false;
+    if (args.size() == 5) {
+        const auto* order = std::get_if<std::string>(&args[4].data);
+        if (!order || (*order != "little" && *order != "big")) {
+            throw Common::NyxRuntimeException("'bytes.column' byte order must be \"little\" or \"big\".", 0);
+        }
+        big_endian = *order == "big";
+    }
+    // Records whose field lies wholly inside the buffer.
+    size_t count = offset + width <= bytes->size() ? (bytes->size() - offset - width) / stride + 1 : 0;
+    HeapAccounting::checkAllocation(count * sizeof(double), 0);
+    NumericArrayPtr column = std::make_shared<NyxNumericArray>(NyxNumericArray::ElementType::FLOAT64, count);
+    double* values = column->float64Data();
+    Field field{bytes->data() + offset, width, big_endian};
+    for (size_t i = 0; i < count; ++i, field.at += stride) {
+        values[i] = fieldValue(loadField(field), width, kind);
+    }
+    return NyxValue(column);
+}
+
+NyxValue native_bytes_toHex(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    ByteView input = expectByteView(args[0], "bytes.toHex");
+    HeapAccounting::checkAllocation(2 * input.size, 0);
+    std::string text(2 * input.size, '\0');
+    BytesKernels::hexEncode(input.data, input.size, text.data());
+    return NyxValue(std::move(text));
+}
+
+NyxValue native_bytes_fromHex(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const auto* text = std::get_if<std::string>(&args[0].data);
+    if (!text) {
+        throw Common::NyxRuntimeException("'bytes.fromHex' expects a string, got " + nyxValueTypeToString(args[0]) + ".", 0);
+    }
+    if (text->size() % 2 != 0) {
+        throw Common::NyxRuntimeException("'bytes.fromHex' expects an even number of hex digits.", 0);
+    }
+    BytesPtr bytes = makeBytes(text->size() / 2);
+    if (!BytesKernels::hexDecode(text->data(), bytes->size(), bytes->data())) {
+        throw Common::NyxRuntimeException("'bytes.fromHex' found a character that is not a hex digit.", 0);
+    }
+    return NyxValue(bytes);
+}
+
+NyxValue native_bytes_toBase64(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    ByteView input = expectByteView(args[0], "bytes.toBase64");
+    size_t encoded_size = BytesKernels::base64EncodedSize(input.size);
+    HeapAccounting::checkAllocation(encoded_size, 0);
+    std::string text(encoded_size, '\0');
+    BytesKernels::base64Encode(input.data, input.size, text.data());
+    return NyxValue(std::move(text));
+}
+
+NyxValue native_bytes_fromBase64(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const auto* text = std::get_if<std::string>(&args[0].data);
+    if (!text) {
+        throw Common::NyxRuntimeException("'bytes.fromBase64' expects a string, got " + nyxValueTypeToString(args[0]) + ".", 0);
+    }
+    HeapAccounting::checkAllocation(text->size() / 4 * 3 + 3, 0);
+    std::string decoded(text->size() / 4 * 3 + 3, '\0');
+    size_t written = BytesKernels::base64Decode(text->data(), text->size(), reinterpret_cast<std::uint8_t*>(decoded.data()));
+    if (written == std::numeric_limits<size_t>::max()) {
+        throw Common::NyxRuntimeException("'bytes.fromBase64' expects base64 text.", 0);
+    }
+    decoded.resize(written);
+    return NyxValue(NyxBytes::adopt(std::move(decoded)));
+}
+
+NyxValue native_bytes_crc32(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2) {
+        throw Common::NyxRuntimeException("'bytes.crc32' expects 1 or 2 arguments (bytes, [previous_crc]).", 0);
+    }
+    ByteView input = expectByteView(args[0], "bytes.crc32");
+    std::uint32_t previous = 0;
+    if (args.size() == 2) {
+        previous = static_cast<std::uint32_t>(expectInteger(args[1], 0.0, 4294967296.0, "bytes.crc32", 4));
+    }
+    return NyxValue(static_cast<double>(BytesKernels::crc32(input.data, input.size, previous)));
+}
+
+NyxValue native_bytes_xxhash32(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2) {
+        throw Common::NyxRuntimeException("'bytes.xxhash32' expects 1 or 2 arguments (bytes, [seed]).", 0);
+    }
+    ByteView input = expectByteView(args[0], "bytes.xxhash32");
+    std::uint32_t seed = 0;
+    if (args.size() == 2) {
+        seed = static_cast<std::uint32_t>(expectInteger(args[1], 0.0, 4294967296.0, "bytes.xxhash32", 4));
+    }
+    return NyxValue(static_cast<double>(BytesKernels::xxhash32(input.data, input.size, seed)));
+}
+
+NyxValue native_bytes_xxhash64(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2) {
+        throw Common::NyxRuntimeException("'bytes.xxhash64' expects 1 or 2 arguments (bytes, [seed]).", 0);
+    }
+    ByteView input = expectByteView(args[0], "bytes.xxhash64");
+    std::uint64_t seed = 0;
+    if (args.size() == 2) {
+        seed = static_cast<std::uint64_t>(expectInteger(args[1], 0.0, 9007199254740992.0, "bytes.xxhash64", 8));
+    }
+    // 64 bits do not fit in a number, so the hash comes back as hex.
+    return NyxValue(toHexString(BytesKernels::xxhash64(input.data, input.size, seed), 16));
+}
+
+
+namespace {
+    constexpr NativeModuleMember BYTES_MODULE_MEMBERS[] = {
+        nativeFunction("make", native_bytes_make, 1),
+        nativeFunction("slice", native_bytes_slice, -1),
+        nativeFunction("copy", native_bytes_copy, 1),
+        nativeFunction("concat", native_bytes_concat, 1),
+        nativeFunction("fill", native_bytes_fill, 2),
+        nativeFunction("toString", native_bytes_toString, 1),
+        nativeFunction("toList", native_bytes_toList, 1),
+        nativeFunction("equals", native_bytes_equals, 2),
+        nativeFunction("find", native_bytes_find, -1),
+        nativeFunction("getUint", native_bytes_getUint, -1),
+        nativeFunction("getInt", native_bytes_getInt, -1),
+        nativeFunction("getFloat", native_bytes_getFloat, -1),
+        nativeFunction("setUint", native_bytes_setUint, -1),
+        nativeFunction("setInt", native_bytes_setInt, -1),
+        nativeFunction("setFloat", native_bytes_setFloat, -1),
+        nativeFunction("column", native_bytes_column, -1),
+        nativeFunction("toHex", native_bytes_toHex, 1),
+        nativeFunction("fromHex", native_bytes_fromHex, 1),
+        nativeFunction("toBase64", native_bytes_toBase64, 1),
+        nativeFunction("fromBase64", native_bytes_fromBase64, 1),
+        nativeFunction("crc32", native_bytes_crc32, -1),
+        nativeFunction("xxhash32", native_bytes_xxhash32, -1),
+        nativeFunction("xxhash64", native_bytes_xxhash64, -1),
+    };
+
+    const NativeModuleTable BYTES_MODULE(BYTES_MODULE_MEMBERS);
+}
+
+void registerStdBytesModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:bytes", BYTES_MODULE);
+}
+
+}
@@ -0,0 +1,39 @@
+#ifndef NYX_STDLIB_BYTES_H
+#define NYX_STDLIB_BYTES_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_bytes_make(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_slice(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_copy(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_concat(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_fill(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_toString(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_toList(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_equals(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_find(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_getUint(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_getInt(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_getFloat(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_setUint(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_setInt(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_setFloat(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_column(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_toHex(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_fromHex(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_toBase64(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_fromBase64(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_crc32(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_xxhash32(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_bytes_xxhash64(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdBytesModule(Interpreter& interpreter);
+
+}
+
+#endif
@@ -0,0 +1,164 @@
+#include "./chan_module.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../interpreter/Channel.h"
+#include "../common/Utils.h"
+
+#include <chrono>
+
+namespace Nyx {
+
+namespace {
+    constexpr double MAX_CHANNEL_CAPACITY = 1 << 24;
+
+    const ChannelPtr& expectChannel(const NyxValue& value, const std::string& function_name) {
+        const auto* channel = std::get_if<ChannelPtr>(&value.data);
+        if (!channel || !*channel) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects a channel made by 'chan.make', got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        return *channel;
+    }
+
+    NyxChannel::Deadline deadlineAfter(const NyxValue& seconds_value, const std::string& function_name) {
+        if (!std::holds_alternative<double>(seconds_value.data) || std::get<double>(seconds_value.data) < 0) {
+            throw Common::NyxRuntimeException("'" + function_name + "' timeout must be a non-negative number of seconds.", 0);
+        }
+        auto timeout = std::chrono::duration<double>(std::get<double>(seconds_value.data));
+        return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+    }
+}
+
+NyxValue native_chan_make(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() != 1 || !std::holds_alternative<double>(args[0].data)) {
+        throw Common::NyxRuntimeException("'chan.make' expects one number argument (capacity).", 0);
+    }
+    double capacity = std::get<double>(args[0].data);
+    if (capacity < 1 || capacity > MAX_CHANNEL_CAPACITY || capacity != static_cast<double>(static_cast<size_t>(capacity))) {
+        throw Common::NyxRuntimeException("'chan.make' capacity must be an integer between 1 and " +
+                                          std::to_string(static_cast<size_t>(MAX_CHANNEL_CAPACITY)) + ".", 0);
+    }
+    return NyxValue(std::make_shared<NyxChannel>(static_cast<size_t>(capacity)));
+}
+
+NyxValue native_chan_send(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const ChannelPtr& channel = expectChannel(args[0], "chan.send");
+    channel->send(ChannelMessage(args[1]));
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_chan_trySend(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const ChannelPtr& channel = expectChannel(args[0], "chan.trySend");
+    ChannelMessage message(args[1]);
+    return NyxValue(channel->trySend(message));
+}
+
+NyxValue native_chan_recv(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2) {
+        throw Common::NyxRuntimeException("'chan.recv' expects 1 or 2 arguments: (channel, [timeout_seconds]).", 0);
+    }
+    const ChannelPtr& channel = expectChannel(args[0], "chan.recv");
+    NyxChannel::Deadline deadline;
+    if (args.size() == 2) {
+        deadline = deadlineAfter(args[1], "chan.recv");
+    }
+    ChannelMessage message;
+    if (channel->recv(message, deadline) != NyxChannel::RecvStatus::RECEIVED) {
+        return NyxValue(std::monostate{});
+    }
+    return message.take();
+}
+
+NyxValue native_chan_tryRecv(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const ChannelPtr& channel = expectChannel(args[0], "chan.tryRecv");
+    ChannelMessage message;
+    NyxList result;
+    if (channel->tryRecv(message) == NyxChannel::RecvStatus::RECEIVED) {
+        result.push_back(NyxValue(true));
+        result.push_back(message.take());
+    } else {
+        result.push_back(NyxValue(false));
+        result.push_back(NyxValue(std::monostate{}));
+    }
+    return NyxValue(std::move(result));
+}
+
+NyxValue native_chan_select(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2 || !std::holds_alternative<NyxList>(args[0].data)) {
+        throw Common::NyxRuntimeException("'chan.select' expects 1 or 2 arguments: (list_of_channels, [timeout_seconds]).", 0);
+    }
+    std::vector<ChannelPtr> channels;
+    for (const NyxValue& element : std::get<NyxList>(args[0].data)) {
+        channels.push_back(expectChannel(element, "chan.select"));
+    }
+    if (channels.empty()) {
+        throw Common::NyxRuntimeException("'chan.select' expects at least one channel.", 0);
+    }
+    NyxChannel::Deadline deadline;
+    if (args.size() == 2) {
+        deadline = deadlineAfter(args[1], "chan.select");
+    }
+    ChannelMessage message;
+    NyxChannel::RecvStatus status = NyxChannel::RecvStatus::EMPTY;
+    long index = NyxChannel::select(channels, message, status, deadline);
+
+    NyxList result;
+    result.push_back(NyxValue(static_cast<double>(index)));
+    result.push_back(status == NyxChannel::RecvStatus::RECEIVED ? message.take() : NyxValue(std::monostate{}));
+    return NyxValue(std::move(result));
+}
+
+NyxValue native_chan_close(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectChannel(args[0], "chan.close")->close();
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_chan_isClosed(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(expectChannel(args[0], "chan.isClosed")->isClosed());
+}
+
+NyxValue native_chan_size(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(static_cast<double>(expectChannel(args[0], "chan.size")->size()));
+}
+
+NyxValue native_chan_capacity(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(static_cast<double>(expectChannel(args[0], "chan.capacity")->capacity()));
+}
+
+NyxValue native_chan_freeze(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return freezeValue(args[0]);
+}
+
+NyxValue native_chan_thaw(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return thawValue(args[0]);
+}
+
+NyxValue native_chan_isFrozen(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(std::holds_alternative<FrozenValuePtr>(args[0].data));
+}
+
+
+namespace {
+    constexpr NativeModuleMember CHAN_MODULE_MEMBERS[] = {
+        nativeFunction("make", native_chan_make, 1),
+        nativeFunction("send", native_chan_send, 2),
+        nativeFunction("trySend", native_chan_trySend, 2),
+        nativeFunction("recv", native_chan_recv, -1),
+        nativeFunction("tryRecv", native_chan_tryRecv, 1),
+        nativeFunction("select", native_chan_select, -1),
+        nativeFunction("close", native_chan_close, 1),
+        nativeFunction("isClosed", native_chan_isClosed, 1),
+        nativeFunction("size", native_chan_size, 1),
+        nativeFunction("capacity", native_chan_capacity, 1),
+        nativeFunction("freeze", native_chan_freeze, 1),
+        nativeFunction("thaw", native_chan_thaw, 1),
+        nativeFunction("isFrozen", native_chan_isFrozen, 1),
+    };
+
+    const NativeModuleTable CHAN_MODULE(CHAN_MODULE_MEMBERS);
+}
+
+void registerStdChanModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:chan", CHAN_MODULE);
+}
+
+}
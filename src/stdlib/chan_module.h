@@ -0,0 +1,29 @@
+#ifndef NYX_STDLIB_CHAN_H
+#define NYX_STDLIB_CHAN_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_chan_make(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_send(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_trySend(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_recv(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_tryRecv(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_select(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_close(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_isClosed(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_size(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_capacity(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_freeze(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_thaw(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_chan_isFrozen(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdChanModule(Interpreter& interpreter);
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+#include "./csv_kernels.h"
+#include "./array_kernels.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NYX_CSV_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define NYX_CSV_X86 0
+#endif
+
+namespace Nyx {
+namespace CsvKernels {
+
+namespace {
+    using ArrayKernels::SimdLevel;
+
+    size_t fieldEndScalar(const char* data, size_t from, size_t n, char delimiter) {
+        size_t i = from;
+        while (i < n && data[i] != delimiter && data[i] != '\n' && data[i] != '\r') ++i;
+        return i;
+    }
+
+#if NYX_CSV_X86
+    unsigned lowestBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    // Fields are mostly short, so one 16-byte compare usually finds the end.
+    size_t fieldEndSse2(const char* data, size_t n, char delimiter) {
+        const __m128i separator = _mm_set1_epi8(delimiter);
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i carriage_return = _mm_set1_epi8('\r');
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, separator), _mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, carriage_return)));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+            if (mask != 0) return i + lowestBit(mask);
+        }
+        return fieldEndScalar(data, i, n, delimiter);
+    }
+#endif
+}
+
+size_t fieldEnd(const char* data, size_t n, char delimiter) {
+#if NYX_CSV_X86
+    static const SimdLevel level = ArrayKernels::simdLevel();
+    if (level >= SimdLevel::SSE2) return fieldEndSse2(data, n, delimiter);
+#endif
+    return fieldEndScalar(data, 0, n, delimiter);
+}
+
+size_t nextQuote(const char* data, size_t n) {
+    const void* quote = std::memchr(data, '"', n);
+    return quote ? static_cast<size_t>(static_cast<const char*>(quote) - data) : n;
+}
+
+}
+}
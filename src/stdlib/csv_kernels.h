@@ -0,0 +1,24 @@
+#ifndef NYX_STDLIB_CSV_KERNELS_H
+#define NYX_STDLIB_CSV_KERNELS_H
+
+#include <cstddef>
+
+namespace Nyx {
+
+// The byte scans behind std:csv, with an SSE2 version chosen by the same
+// SIMD level as std:array (see array_kernels.h). Every level gives the same
+// results.
+namespace CsvKernels {
+
+// The index of the first `delimiter`, '\n' or '\r' in data[0, n), or n:
+// where an unquoted field ends.
+size_t fieldEnd(const char* data, size_t n, char delimiter);
+
+// The index of the first '"' in data[0, n), or n.
+size_t nextQuote(const char* data, size_t n);
+
+}
+
+}
+
+#endif
@@ -0,0 +1,786 @@
+#include "./csv_module.h"
+#include "./csv_kernels.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../common/Bytes.h"
+#include "../common/FileHandle.h"
+#include "../common/HashTable.h"
+#include "../common/HeapAccounting.h"
+#include "../common/Iterator.h"
+#include "../common/NumericArray.h"
+#include "../common/Utils.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace Nyx {
+
+namespace {
+    // The options map the functions take as their last argument.
+    struct CsvOptions {
+        char delimiter = ',';
+        bool header = false;                  // reading: the first row names the fields
+        bool numbers = false;                 // reading: unquoted numbers become numbers
+        const NyxValue* header_names = nullptr; // writing: names to write first
+        std::string line_ending = "\n";       // writing
+    };
+
+    CsvOptions expectOptions(const std::vector<NyxValue>& args, size_t index, const std::string& function_name, bool writing) {
+        CsvOptions options;
+        if (args.size() <= index) return options;
+        const auto* map = std::get_if<MapPtr>(&args[index].data);
+        if (!map || !*map) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects an options map, got " + nyxValueTypeToString(args[index]) + ".", 0);
+        }
+        const char* allowed = writing ? "delimiter, header and lineEnding" : "delimiter, header and numbers";
+        const NyxHashTable& table = (*map)->table;
+        for (size_t entry = 0; entry < table.entryLimit(); ++entry) {
+            if (!table.isLive(entry)) continue;
+            const std::string* name = std::get_if<std::string>(&table.keyAt(entry).data);
+            const NyxValue& value = table.valueAt(entry);
+            auto invalid = [&](const std::string& expected) {
+                return Common::NyxRuntimeException("'" + function_name + "' option '" + *name + "' must be " + expected + ", got " +
+                                                  nyxValueTypeToString(value) + ".", 0);
+            };
+            const std::string* text = std::get_if<std::string>(&value.data);
+            // Escapes are processed, so "\t" is a tab.
+            std::string processed = text ? Common::process_escapes(*text) : std::string();
+            if (name && *name == "delimiter") {
+                if (!text || processed.size() != 1 || processed[0] == '"' || processed[0] == '\n' || processed[0] == '\r') {
+                    throw invalid("a single character other than a quote or a line break");
+                }
+                options.delimiter = processed[0];
+            } else if (name && *name == "header" && !writing) {
+                const bool* flag = std::get_if<bool>(&value.data);
+                if (!flag) throw invalid("true or false");
+                options.header = *flag;
+            } else if (name && *name == "header" && writing) {
+                if (!std::holds_alternative<NyxList>(value.data)) throw invalid("a list of field names");
+                options.header_names = &value;
+            } else if (name && *name == "numbers" && !writing) {
+                const bool* flag = std::get_if<bool>(&value.data);
+                if (!flag) throw invalid("true or false");
+                options.numbers = *flag;
+            } else if (name && *name == "lineEnding" && writing) {
+                if (text && (processed == "\n" || processed == "\r\n")) {
+                    options.line_ending = processed;
+                } else {
+                    throw invalid("\"\\n\" or \"\\r\\n\"");
+                }
+            } else {
+                throw Common::NyxRuntimeException("'" + function_name + "' options are " + allowed + ", got " +
+                                                 (name ? "'" + *name + "'" : nyxValueToString(table.keyAt(entry))) + ".", 0);
+            }
+        }
+        return options;
+    }
+
+    // A field's text as a number, for fields that are numbers and nothing
+    // else: digits with an optional sign, decimal point and exponent.
+    bool parseNumber(const char* text, size_t length, double& out) {
+        if (length == 0) return false;
+        size_t i = 0;
+        bool negative = text[0] == '-';
+        if (text[0] == '-' || text[0] == '+') i = 1;
+        // Up to 15 digits with an optional decimal point: the digits are
+        // exact as a double, and so is a power of ten up to 10^22, so one
+        // division rounds correctly.
+        if (length - i <= 16 && length > i) {
+            static const double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+            std::int64_t digits = 0;
+            size_t point = length;
+            size_t d = i;
+            for (; d < length; ++d) {
+                char c = text[d];
+                if (c >= '0' && c <= '9') {
+                    digits = digits * 10 + (c - '0');
+                } else if (c == '.' && point == length) {
+                    point = d;
+                } else {
+                    break;
+                }
+            }
+            size_t digit_count = length - i - (point < length ? 1 : 0);
+            if (d == length && digit_count > 0 && digit_count <= 15) {
+                double value = static_cast<double>(digits);
+                if (point < length) value /= POWERS_OF_TEN[length - point - 1];
+                out = negative ? -value : value;
+                return true;
+            }
+        }
+        // Rules out "inf", "nan" and a second sign, which from_chars would take.
+        if (i == length || !((text[i] >= '0' && text[i] <= '9') || text[i] == '.')) return false;
+        auto parsed = std::from_chars(text + i, text + length, out);
+        if (parsed.ptr != text + length) return false;
+        if (parsed.ec == std::errc::result_out_of_range) {
+            out = std::strtod(std::string(text + i, length - i).c_str(), nullptr);
+        } else if (parsed.ec != std::errc()) {
+            return false;
+        }
+        if (negative) out = -out;
+        return true;
+    }
+
+    // Reads rows of CSV text as defined by RFC 4180: fields separated by the
+    // delimiter, rows ended by "\r\n" or "\n", and fields in double quotes
+    // holding delimiters, line breaks and doubled quotes ("") as text.
+    // Blank lines are skipped. A row is parsed where it lies: in the string
+    // or bytes given, or in the file's mapping or read buffer (see
+    // NyxFile::peek), and only a row that runs past the end of what the file
+    // has ready is copied. A field is copied out only when its value is
+    // taken, and not at all when it becomes a number.
+    class CsvReader {
+    public:
+        // Reads `text`, which must outlive the reader.
+        CsvReader(const char* text, size_t size, char delimiter)
+            : memory(text), memory_size(size), delimiter(delimiter) {}
+        // Reads a file opened with io.open.
+        CsvReader(FilePtr source, char delimiter) : file(std::move(source)), delimiter(delimiter) {}
+
+        // Moves to the next row and returns true, or returns false at the
+        // end of the input. Throws NyxRuntimeException on malformed input.
+        bool nextRow();
+
+        size_t fieldCount() const { return fields.size(); }
+        // These read fields of the current row.
+        std::string text(size_t index) const;
+        bool number(size_t index, double& out) const {
+            const Field& field = fields[index];
+            return !field.quoted && parseNumber(row_data + field.start, field.length, out);
+        }
+        bool isEmpty(size_t index) const { return fields[index].length == 0; }
+        // A number (with `numbers`, for unquoted numbers) or a string.
+        NyxValue value(size_t index, bool numbers) const {
+            double parsed;
+            if (numbers && number(index, parsed)) return NyxValue(parsed);
+            return NyxValue(text(index));
+        }
+
+        [[noreturn]] void failRow(const std::string& message) const { fail(row_line, message); }
+
+    private:
+        struct Field {
+            size_t start;        // offset from row_data
+            size_t length;
+            bool quoted;
+            bool doubled_quotes; // holds "" to be read as "
+        };
+        static constexpr size_t NEED_MORE = static_cast<size_t>(-1);
+        static constexpr size_t VIEW_SIZE = 1 << 20;
+
+        size_t parseRow(const char* data, size_t size, bool at_end);
+        [[noreturn]] void fail(size_t at_line, const std::string& message) const {
+            throw Common::NyxRuntimeException("Invalid CSV at line " + std::to_string(at_line) + ": " + message + ".", 0);
+        }
+
+        FilePtr file;
+        const char* memory = nullptr;
+        size_t memory_size = 0;
+        size_t memory_position = 0;
+        char delimiter;
+
+        std::string carry;        // a row that ran past the end of a peek
+        bool carry_used = false;  // the current row lies in `carry`
+        size_t pending_skip = 0;  // file bytes of the current row, skipped on the next call
+        const char* row_data = nullptr;
+        std::vector<Field> fields;
+        bool row_found = false;
+        size_t line = 1;          // where the next row starts
+        size_t row_line = 1;      // where the current row starts
+    };
+
+    bool CsvReader::nextRow() {
+        if (!file) {
+            while (memory_position < memory_size) {
+                row_data = memory + memory_position;
+                memory_position += parseRow(row_data, memory_size - memory_position, true);
+                if (row_found) return true;
+            }
+            return false;
+        }
+        file->skip(pending_skip);
+        pending_skip = 0;
+        if (carry_used) {
+            carry.clear();
+            carry_used = false;
+        }
+        size_t step = 4096;
+        for (;;) {
+            const char* view = nullptr;
+            if (carry.empty()) {
+                size_t size = file->peek(VIEW_SIZE, view);
+                if (size == 0) return false;
+                size_t used = parseRow(view, size, false);
+                if (used == NEED_MORE) {
+                    carry.assign(view, size);
+                    file->skip(size);
+                    continue;
+                }
+                if (!row_found) {
+                    file->skip(used);
+                    continue;
+                }
+                // The view stays valid until the bytes are skipped.
+                row_data = view;
+                pending_skip = used;
+                return true;
+            }
+            // Add to the row a piece at a time, so only the row is copied.
+            size_t size = file->peek(step, view);
+            size_t kept = carry.size();
+            carry.append(view, size);
+            size_t used = parseRow(carry.data(), carry.size(), size == 0);
+            if (used == NEED_MORE) {
+                file->skip(size);
+                step = std::min(step * 2, VIEW_SIZE);
+                continue;
+            }
+            file->skip(used > kept ? used - kept : 0);
+            if (!row_found) {
+                carry.clear();
+                continue;
+            }
+            row_data = carry.data();
+            carry_used = true;
+            return true;
+        }
+    }
+
+    // Parses the row at the start of data[0, size). Returns the bytes it
+    // takes up, with its line break and any blank lines before it, or
+    // NEED_MORE if it may go on past `size` and `at_end` is false. Sets
+    // `row_found` (false if there were only blank lines).
+    size_t CsvReader::parseRow(const char* data, size_t size, bool at_end) {
+        fields.clear();
+        row_found = false;
+        size_t i = 0;
+        size_t newlines = 0;
+        while (i < size && (data[i] == '\n' || data[i] == '\r')) {
+            if (data[i] == '\n') ++newlines;
+            ++i;
+        }
+        if (i == size) {
+            line += newlines;
+            return i;
+        }
+        size_t blank_lines = newlines;
+        for (;;) {
+            if (data[i] == '"') {
+                size_t start = i + 1;
+                size_t end = start;
+                bool doubled_quotes = false;
+                for (;;) {
+                    end += CsvKernels::nextQuote(data + end, size - end);
+                    if (end >= size) {
+                        if (!at_end) return NEED_MORE;
+                        fail(line + newlines, "a quoted field has no closing quote");
+                    }
+                    if (end + 1 < size && data[end + 1] == '"') {
+                        doubled_quotes = true;
+                        end += 2;
+                        continue;
+                    }
+                    if (end + 1 == size && !at_end) return NEED_MORE;
+                    break;
+                }
+                newlines += static_cast<size_t>(std::count(data + start, data + end, '\n'));
+                fields.push_back(Field{start, end - start, true, doubled_quotes});
+                i = end + 1;
+                if (i < size && data[i] != delimiter && data[i] != '\n' && data[i] != '\r') {
+                    fail(line + newlines, std::string("'") + data[i] + "' after a closing quote (quotes inside a quoted field are doubled: \"\")");
+                }
+            } else {
+                size_t end = i + CsvKernels::fieldEnd(data + i, size - i, delimiter);
+                fields.push_back(Field{i, end - i, false, false});
+                i = end;
+            }
+            if (i == size) {
+                if (!at_end) return NEED_MORE;
+                break;
+            }
+            char c = data[i];
+            if (c == delimiter) {
+                // A delimiter at the very end still starts an empty field.
+                if (++i == size) {
+                    if (!at_end) return NEED_MORE;
+                    fields.push_back(Field{i, 0, false, false});
+                    break;
+                }
+                continue;
+            }
+            if (c == '\r') {
+                if (i + 1 == size && !at_end) return NEED_MORE;
+                bool crlf = i + 1 < size && data[i + 1] == '\n';
+                i += crlf ? 2 : 1;
+                if (crlf) ++newlines;
+                break;
+            }
+            ++i;
+            ++newlines;
+            break;
+        }
+        row_found = true;
+        row_line = line + blank_lines;
+        line += newlines;
+        return i;
+    }
+
+    std::string CsvReader::text(size_t index) const {
+        const Field& field = fields[index];
+        const char* start = row_data + field.start;
+        if (!field.doubled_quotes) return std::string(start, field.length);
+        std::string result;
+        result.reserve(field.length);
+        for (size_t i = 0; i < field.length; ++i) {
+            result += start[i];
+            if (start[i] == '"') ++i;
+        }
+        return result;
+    }
+
+    // What a reader reads: CSV text in a string or bytes, or a file opened
+    // for reading. A copy of a string is kept for iterators, which outlive
+    // the call that made them.
+    class ReaderSource {
+    public:
+        ReaderSource(const NyxValue& source, const std::string& function_name, bool copy_text, char delimiter) {
+            if (const std::string* text = std::get_if<std::string>(&source.data)) {
+                const std::string* read = text;
+                if (copy_text) {
+                    held_text = *text;
+                    read = &held_text;
+                }
+                reader = std::make_unique<CsvReader>(read->data(), read->size(), delimiter);
+            } else if (const auto* bytes = std::get_if<BytesPtr>(&source.data); bytes && *bytes) {
+                held_bytes = *bytes;
+                reader = std::make_unique<CsvReader>(reinterpret_cast<const char*>(held_bytes->data()), held_bytes->size(), delimiter);
+            } else if (const auto* file = std::get_if<FilePtr>(&source.data); file && *file) {
+                reader = std::make_unique<CsvReader>(*file, delimiter);
+            } else {
+                throw Common::NyxRuntimeException("'" + function_name + "' expects CSV text (a string or bytes) or a file opened with 'io.open', got " +
+                                                 nyxValueTypeToString(source) + ".", 0);
+            }
+        }
+
+        CsvReader& get() { return *reader; }
+
+    private:
+        std::string held_text;
+        BytesPtr held_bytes;
+        std::unique_ptr<CsvReader> reader;
+    };
+
+    // Reads the header row, if the options ask for one, into `names`.
+    void readHeader(CsvReader& reader, const CsvOptions& options, std::vector<NyxValue>& names) {
+        if (!options.header || !reader.nextRow()) return;
+        names.reserve(reader.fieldCount());
+        for (size_t i = 0; i < reader.fieldCount(); ++i) names.emplace_back(reader.text(i));
+    }
+
+    // `first` names the row that set the width: the header or the first row.
+    void expectWidth(const CsvReader& reader, size_t width, const char* first) {
+        if (reader.fieldCount() != width) {
+            reader.failRow("the row has " + std::to_string(reader.fieldCount()) + " fields but " + first + " has " + std::to_string(width));
+        }
+    }
+
+    // The current row as a list, or as a map from the header's names.
+    NyxValue buildRow(const CsvReader& reader, const CsvOptions& options, const std::vector<NyxValue>& names) {
+        if (!options.header) {
+            NyxList row;
+            row.reserve(reader.fieldCount());
+            for (size_t i = 0; i < reader.fieldCount(); ++i) row.push_back(reader.value(i, options.numbers));
+            return NyxValue(std::move(row));
+        }
+        expectWidth(reader, names.size(), "the header");
+        auto row = std::make_shared<NyxMap>();
+        row->table.reserve(names.size());
+        for (size_t i = 0; i < names.size(); ++i) {
+            bool inserted = false;
+            row->table.valueAt(row->table.insert(names[i], inserted)) = reader.value(i, options.numbers);
+        }
+        return NyxValue(std::move(row));
+    }
+
+    // csv.rows: one row at a time.
+    class RowsIterator : public NyxIterator {
+    public:
+        RowsIterator(const NyxValue& source, const CsvOptions& options)
+            : source(source, "csv.rows", true, options.delimiter), options(options) {}
+
+        bool next(Interpreter&, NyxValue& item) override {
+            CsvReader& reader = source.get();
+            if (!started) {
+                started = true;
+                readHeader(reader, options, names);
+            }
+            if (!reader.nextRow()) return false;
+            item = buildRow(reader, options, names);
+            return true;
+        }
+
+        std::string describe() const override { return "<csv rows>"; }
+
+    private:
+        ReaderSource source;
+        CsvOptions options;
+        std::vector<NyxValue> names;
+        bool started = false;
+    };
+
+    // The fields of a row given as a list or frozen list.
+    const NyxList* listFields(const NyxValue& row) {
+        if (const auto* list = std::get_if<NyxList>(&row.data)) return list;
+        if (const auto* frozen = std::get_if<FrozenValuePtr>(&row.data); frozen && *frozen && (*frozen)->kind == NyxFrozenValue::Kind::LIST) {
+            return &(*frozen)->elements;
+        }
+        return nullptr;
+    }
+
+    // Writes rows as CSV text into `out`. With a file, `out` is passed on to
+    // it whenever it fills up.
+    class CsvWriter {
+    public:
+        static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+        CsvWriter(std::string& out, const CsvOptions& options, NyxFile* file, const std::string& function_name)
+            : out(out), options(options), file(file), function_name(function_name) {}
+
+        // A list or frozen list of fields, or a map written in the order
+        // of `keys` (or its own order if there are none).
+        void writeRow(const NyxValue& row, const std::vector<NyxValue>* keys) {
+            if (const NyxList* fields = listFields(row)) {
+                writeFields(*fields);
+            } else if (const auto* map = std::get_if<MapPtr>(&row.data); map && *map) {
+                const NyxHashTable& table = (*map)->table;
+                size_t row_start = out.size();
+                bool first = true;
+                if (keys) {
+                    for (const NyxValue& key : *keys) {
+                        if (!first) out += options.delimiter;
+                        first = false;
+                        size_t entry = table.find(key);
+                        if (entry != NyxHashTable::NOT_FOUND) writeField(table.valueAt(entry));
+                    }
+                } else {
+                    for (size_t entry = 0; entry < table.entryLimit(); ++entry) {
+                        if (!table.isLive(entry)) continue;
+                        if (!first) out += options.delimiter;
+                        first = false;
+                        writeField(table.valueAt(entry));
+                    }
+                }
+                endRow(row_start, keys ? keys->size() : table.size());
+            } else {
+                throw Common::NyxRuntimeException("'" + function_name + "' expects each row to be a list or a map, got " + nyxValueTypeToString(row) + ".", 0);
+            }
+            if (file && out.size() >= FLUSH_SIZE) finish();
+        }
+
+        void writeFields(const NyxList& fields) {
+            size_t row_start = out.size();
+            for (size_t i = 0; i < fields.size(); ++i) {
+                if (i > 0) out += options.delimiter;
+                writeField(fields[i]);
+            }
+            endRow(row_start, fields.size());
+        }
+
+        void finish() {
+            if (file) {
+                file->write(out.data(), out.size());
+                out.clear();
+            }
+        }
+
+    private:
+        // A row written as nothing would be a blank line, which readers
+        // skip, so a single empty field is written as "" (as Python's csv
+        // module does), and a row with no fields cannot be written at all.
+        void endRow(size_t row_start, size_t field_count) {
+            if (out.size() == row_start) {
+                if (field_count == 0) {
+                    throw Common::NyxRuntimeException("'" + function_name + "' cannot write a row with no fields.", 0);
+                }
+                out += "\"\"";
+            }
+            out += options.line_ending;
+        }
+        void writeField(const NyxValue& value);
+        void writeText(const std::string& text);
+
+        std::string& out;
+        const CsvOptions& options;
+        NyxFile* file;
+        const std::string& function_name;
+    };
+
+    void CsvWriter::writeField(const NyxValue& value) {
+        if (const std::string* text = std::get_if<std::string>(&value.data)) {
+            writeText(*text);
+        } else if (const double* number = std::get_if<double>(&value.data)) {
+            // NaN is written as an empty field, which csv.columns reads back
+            // as NaN. Infinity has no form that reads back, as in std:json.
+            if (std::isnan(*number)) return;
+            if (std::isinf(*number)) {
+                throw Common::NyxRuntimeException("'" + function_name + "' cannot write infinity.", 0);
+            }
+            char digits[32];
+            std::to_chars_result written;
+            if (std::trunc(*number) == *number && std::fabs(*number) < 9007199254740992.0) {
+                written = std::to_chars(digits, digits + sizeof(digits), static_cast<long long>(*number));
+            } else {
+                written = std::to_chars(digits, digits + sizeof(digits), *number);
+            }
+            out.append(digits, written.ptr);
+        } else if (const bool* flag = std::get_if<bool>(&value.data)) {
+            out += *flag ? "true" : "false";
+        } else if (std::holds_alternative<std::monostate>(value.data)) {
+            // An empty field.
+        } else if (const auto* frozen = std::get_if<FrozenValuePtr>(&value.data);
+                   frozen && *frozen && (*frozen)->kind == NyxFrozenValue::Kind::STRING) {
+            writeText((*frozen)->text);
+        } else {
+            throw Common::NyxRuntimeException("'" + function_name + "' cannot write a field of type " + nyxValueTypeToString(value) +
+                                             " (fields are strings, numbers, booleans or nyx_null).", 0);
+        }
+    }
+
+    // Quotes text holding the delimiter, a quote or a line break.
+    void CsvWriter::writeText(const std::string& text) {
+        size_t plain = CsvKernels::fieldEnd(text.data(), text.size(), options.delimiter);
+        if (plain == text.size() && CsvKernels::nextQuote(text.data(), text.size()) == text.size()) {
+            out += text;
+            return;
+        }
+        out += '"';
+        size_t start = 0;
+        for (;;) {
+            size_t quote = start + CsvKernels::nextQuote(text.data() + start, text.size() - start);
+            out.append(text, start, quote - start);
+            if (quote == text.size()) break;
+            out += "\"\"";
+            start = quote + 1;
+        }
+        out += '"';
+    }
+
+    // Reused by csv.writeRow, which is called once per row.
+    std::string& rowBuffer() {
+        thread_local std::string buffer;
+        return buffer;
+    }
+
+    FilePtr expectTarget(const NyxValue& target, const std::string& function_name, bool allow_path, bool& close_after) {
+        close_after = false;
+        if (const auto* file = std::get_if<FilePtr>(&target.data); file && *file) return *file;
+        if (const std::string* filepath = std::get_if<std::string>(&target.data); filepath && allow_path) {
+            close_after = true;
+            return NyxFile::openForWriting(*filepath, NyxFile::Mode::WRITE, NyxFile::DEFAULT_WRITE_BUFFER_SIZE);
+        }
+        throw Common::NyxRuntimeException("'" + function_name + "' expects a file returned by 'io.open'" + (allow_path ? " or a filepath" : "") +
+                                         ", got " + nyxValueTypeToString(target) + ".", 0);
+    }
+
+    // How often readers that collect rows check the heap limit.
+    constexpr size_t HEAP_CHECK_ROWS = 4096;
+}
+
+NyxValue native_csv_rows(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2) {
+        throw Common::NyxRuntimeException("'csv.rows' expects 1 or 2 arguments (source, [options]).", 0);
+    }
+    CsvOptions options = expectOptions(args, 1, "csv.rows", false);
+    return NyxValue(IteratorPtr(std::make_shared<RowsIterator>(args[0], options)));
+}
+
+NyxValue native_csv_read(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2) {
+        throw Common::NyxRuntimeException("'csv.read' expects 1 or 2 arguments (source, [options]).", 0);
+    }
+    CsvOptions options = expectOptions(args, 1, "csv.read", false);
+    ReaderSource source(args[0], "csv.read", false, options.delimiter);
+    CsvReader& reader = source.get();
+    std::vector<NyxValue> names;
+    readHeader(reader, options, names);
+    NyxList rows;
+    while (reader.nextRow()) {
+        rows.push_back(buildRow(reader, options, names));
+        if (rows.size() % HEAP_CHECK_ROWS == 0 && HeapAccounting::overLimit()) HeapAccounting::enforceLimit(0);
+    }
+    return NyxValue(std::move(rows));
+}
+
+// csv.columns(source, [options]): every column at once. A column of numbers
+// (and empty fields, read as NaN) becomes a float64 array, built without a
+// value per field; any other column becomes a list.
+NyxValue native_csv_columns(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2) {
+        throw Common::NyxRuntimeException("'csv.columns' expects 1 or 2 arguments (source, [options]).", 0);
+    }
+    CsvOptions options = expectOptions(args, 1, "csv.columns", false);
+    ReaderSource source(args[0], "csv.columns", false, options.delimiter);
+    CsvReader& reader = source.get();
+    std::vector<NyxValue> names;
+    readHeader(reader, options, names);
+
+    struct Column {
+        bool numeric = true;
+        std::vector<double> numbers;
+        NyxList values;
+
+        // From here on, a list: numbers stay numbers, NaN (an empty field)
+        // becomes "".
+        void makeList() {
+            numeric = false;
+            values.reserve(numbers.size() * 2);
+            for (double number : numbers) values.push_back(std::isnan(number) ? NyxValue(std::string()) : NyxValue(number));
+            std::vector<double>().swap(numbers);
+        }
+    };
+    std::vector<Column> columns;
+    size_t width = names.size();
+    size_t rows = 0;
+    while (reader.nextRow()) {
+        if (rows == 0 && !options.header) {
+            width = reader.fieldCount();
+        }
+        expectWidth(reader, width, options.header ? "the header" : "the first row");
+        if (columns.size() < width) columns.resize(width);
+        for (size_t i = 0; i < width; ++i) {
+            Column& column = columns[i];
+            double number;
+            if (column.numeric) {
+                if (reader.isEmpty(i)) {
+                    column.numbers.push_back(std::nan(""));
+                    continue;
+                }
+                if (reader.number(i, number)) {
+                    column.numbers.push_back(number);
+                    continue;
+                }
+                column.makeList();
+            }
+            column.values.push_back(reader.value(i, true));
+        }
+        if (++rows % HEAP_CHECK_ROWS == 0) {
+            size_t pending = 0;
+            for (const Column& column : columns) pending += column.numbers.capacity() * sizeof(double);
+            HeapAccounting::checkAllocation(pending, 0);
+        }
+    }
+    if (columns.size() < width) columns.resize(width);
+
+    NyxList built;
+    built.reserve(width);
+    for (Column& column : columns) {
+        if (!column.numeric) {
+            built.emplace_back(std::move(column.values));
+            continue;
+        }
+        HeapAccounting::checkAllocation(column.numbers.size() * sizeof(double), 0);
+        auto array = std::make_shared<NyxNumericArray>(NyxNumericArray::ElementType::FLOAT64, column.numbers.size());
+        std::copy(column.numbers.begin(), column.numbers.end(), array->float64Data());
+        std::vector<double>().swap(column.numbers);
+        built.emplace_back(NumericArrayPtr(std::move(array)));
+    }
+    if (!options.header) return NyxValue(std::move(built));
+    auto result = std::make_shared<NyxMap>();
+    result->table.reserve(width);
+    for (size_t i = 0; i < width; ++i) {
+        bool inserted = false;
+        result->table.valueAt(result->table.insert(names[i], inserted)) = std::move(built[i]);
+    }
+    return NyxValue(std::move(result));
+}
+
+// csv.write(target, rows, [options]): writes a list or iterator of rows to
+// a file opened with "w" or "a", or replaces the file at a path. Rows that
+// are maps get a header row from the first one's keys.
+NyxValue native_csv_write(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'csv.write' expects 2 or 3 arguments (file or filepath, rows, [options]).", 0);
+    }
+    CsvOptions options = expectOptions(args, 2, "csv.write", true);
+    if (!ItemCursor::accepts(args[1])) {
+        throw Common::NyxRuntimeException("'csv.write' expects a list or iterator of rows, got " + nyxValueTypeToString(args[1]) + ".", 0);
+    }
+    bool close_after = false;
+    FilePtr file = expectTarget(args[0], "csv.write", true, close_after);
+    std::string buffer;
+    buffer.reserve(CsvWriter::FLUSH_SIZE + 4096);
+    CsvWriter writer(buffer, options, file.get(), "csv.write");
+
+    std::vector<NyxValue> keys;
+    bool have_keys = false;
+    if (options.header_names) {
+        const NyxList& header = std::get<NyxList>(options.header_names->data);
+        writer.writeFields(header);
+        keys = header;
+        have_keys = true;
+    }
+    auto write = [&](const NyxValue& row) {
+        if (!have_keys) {
+            if (const auto* map = std::get_if<MapPtr>(&row.data); map && *map) {
+                const NyxHashTable& table = (*map)->table;
+                for (size_t entry = 0; entry < table.entryLimit(); ++entry) {
+                    if (table.isLive(entry)) keys.push_back(table.keyAt(entry));
+                }
+                writer.writeFields(keys);
+            }
+            have_keys = true;
+        }
+        writer.writeRow(row, keys.empty() ? nullptr : &keys);
+    };
+    // A list's rows are written where they are; ItemCursor would copy each.
+    if (const NyxList* rows = std::get_if<NyxList>(&args[1].data)) {
+        for (const NyxValue& row : *rows) write(row);
+    } else {
+        ItemCursor cursor(args[1]);
+        NyxValue row;
+        while (cursor.next(interpreter, row)) write(row);
+    }
+    writer.finish();
+    if (close_after) file->close();
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_csv_writeRow(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'csv.writeRow' expects 2 or 3 arguments (file, row, [options]).", 0);
+    }
+    CsvOptions options = expectOptions(args, 2, "csv.writeRow", true);
+    if (options.header_names) {
+        throw Common::NyxRuntimeException("'csv.writeRow' does not take a header option; write the header as a row.", 0);
+    }
+    bool close_after = false;
+    FilePtr file = expectTarget(args[0], "csv.writeRow", false, close_after);
+    std::string& buffer = rowBuffer();
+    buffer.clear();
+    CsvWriter writer(buffer, options, file.get(), "csv.writeRow");
+    writer.writeRow(args[1], nullptr);
+    writer.finish();
+    return NyxValue(std::monostate{});
+}
+
+
+namespace {
+    constexpr NativeModuleMember CSV_MODULE_MEMBERS[] = {
+        nativeFunction("rows", native_csv_rows, -1),
+        nativeFunction("read", native_csv_read, -1),
+        nativeFunction("columns", native_csv_columns, -1),
+        nativeFunction("write", native_csv_write, -1),
+        nativeFunction("writeRow", native_csv_writeRow, -1),
+    };
+
+    const NativeModuleTable CSV_MODULE(CSV_MODULE_MEMBERS);
+}
+
+void registerStdCsvModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:csv", CSV_MODULE);
+}
+
+}
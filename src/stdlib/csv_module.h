@@ -0,0 +1,21 @@
+#ifndef NYX_STDLIB_CSV_H
+#define NYX_STDLIB_CSV_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_csv_rows(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_csv_read(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_csv_columns(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_csv_write(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_csv_writeRow(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdCsvModule(Interpreter& interpreter);
+
+}
+
+#endif
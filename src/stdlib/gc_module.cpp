@@ -0,0 +1,134 @@
+#include "./gc_module.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../common/GarbageCollector.h"
+#include "../common/HeapAccounting.h"
+#include "../common/Utils.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace Nyx {
+
+NyxValue native_gc_collect(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.collect' function takes no arguments.", 0);
+    }
+    return NyxValue(static_cast<double>(GarbageCollector::current().collect()));
+}
+
+NyxValue native_gc_objects(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.objects' function takes no arguments.", 0);
+    }
+    return NyxValue(static_cast<double>(GarbageCollector::current().stats().tracked_objects));
+}
+
+NyxValue native_gc_collections(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.collections' function takes no arguments.", 0);
+    }
+    GcStats stats = GarbageCollector::current().stats();
+    size_t total = 0;
+    for (size_t count : stats.collections) {
+        total += count;
+    }
+    return NyxValue(static_cast<double>(total));
+}
+
+NyxValue native_gc_freed(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.freed' function takes no arguments.", 0);
+    }
+    return NyxValue(static_cast<double>(GarbageCollector::current().stats().objects_freed));
+}
+
+NyxValue native_gc_lastPauseMs(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.lastPauseMs' function takes no arguments.", 0);
+    }
+    return NyxValue(GarbageCollector::current().stats().last_pause_ms);
+}
+
+NyxValue native_gc_maxPauseMs(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.maxPauseMs' function takes no arguments.", 0);
+    }
+    return NyxValue(GarbageCollector::current().stats().max_pause_ms);
+}
+
+NyxValue native_gc_totalPauseMs(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.totalPauseMs' function takes no arguments.", 0);
+    }
+    return NyxValue(GarbageCollector::current().stats().total_pause_ms);
+}
+
+NyxValue native_gc_heapBytes(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.heapBytes' function takes no arguments.", 0);
+    }
+    return NyxValue(static_cast<double>(HeapAccounting::liveBytes()));
+}
+
+NyxValue native_gc_heapLimit(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.heapLimit' function takes no arguments.", 0);
+    }
+    return NyxValue(static_cast<double>(HeapAccounting::limit()));
+}
+
+NyxValue native_gc_peakRss(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.peakRss' function takes no arguments.", 0);
+    }
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return NyxValue(0.0);
+    return NyxValue(static_cast<double>(counters.PeakWorkingSetSize));
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return NyxValue(0.0);
+#if defined(__APPLE__)
+    return NyxValue(static_cast<double>(usage.ru_maxrss));
+#else
+    return NyxValue(static_cast<double>(usage.ru_maxrss) * 1024.0);
+#endif
+#endif
+}
+
+NyxValue native_gc_report(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'gc.report' function takes no arguments.", 0);
+    }
+    return NyxValue(GarbageCollector::current().report());
+}
+
+
+namespace {
+    constexpr NativeModuleMember GC_MODULE_MEMBERS[] = {
+        nativeFunction("collect", native_gc_collect, 0),
+        nativeFunction("objects", native_gc_objects, 0),
+        nativeFunction("collections", native_gc_collections, 0),
+        nativeFunction("freed", native_gc_freed, 0),
+        nativeFunction("lastPauseMs", native_gc_lastPauseMs, 0),
+        nativeFunction("maxPauseMs", native_gc_maxPauseMs, 0),
+        nativeFunction("totalPauseMs", native_gc_totalPauseMs, 0),
+        nativeFunction("heapBytes", native_gc_heapBytes, 0),
+        nativeFunction("heapLimit", native_gc_heapLimit, 0),
+        nativeFunction("peakRss", native_gc_peakRss, 0),
+        nativeFunction("report", native_gc_report, 0),
+    };
+
+    const NativeModuleTable GC_MODULE(GC_MODULE_MEMBERS);
+}
+
+void registerStdGcModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:gc", GC_MODULE);
+}
+
+}
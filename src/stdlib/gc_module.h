@@ -0,0 +1,27 @@
+#ifndef NYX_STDLIB_GC_H
+#define NYX_STDLIB_GC_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_gc_collect(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_objects(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_collections(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_freed(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_lastPauseMs(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_maxPauseMs(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_totalPauseMs(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_heapBytes(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_heapLimit(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_peakRss(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_gc_report(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdGcModule(Interpreter& interpreter);
+
+}
+
+#endif
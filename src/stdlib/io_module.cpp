@@ -1,7 +1,11 @@
 #include "./io_module.h"
+#include "./native_module_table.h"
 #include "../interpreter/Interpreter.h" 
 #include "../interpreter/Environment.h" 
 #include "../common/Utils.h"         
+#include "../common/FileHandle.h"
+#include "../common/Bytes.h"
+#include "../common/Iterator.h"
 #include <iostream> 
 #include <string>
 #include <sstream> 
@@ -10,6 +14,65 @@
 
 namespace Nyx {
 
+namespace {
+    const FilePtr& expectFile(const NyxValue& value, const std::string& function_name) {
+        const auto* file = std::get_if<FilePtr>(&value.data);
+        if (!file || !*file) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects a file returned by 'io.open', got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        return *file;
+    }
+
+    // Writes `text` with its escapes processed as Common::process_escapes
+    // does, a run of plain bytes at a time, without a processed copy.
+    void writeProcessed(NyxFile& file, const std::string& text) {
+        size_t start = 0;
+        for (;;) {
+            size_t slash = text.find('\\', start);
+            if (slash == std::string::npos || slash + 1 >= text.size()) {
+                file.write(text.data() + start, text.size() - start);
+                return;
+            }
+            file.write(text.data() + start, slash - start);
+            char replacement;
+            switch (text[slash + 1]) {
+                case 'n': replacement = '\n'; break;
+                case 'r': replacement = '\r'; break;
+                case 't': replacement = '\t'; break;
+                case 'e': replacement = '\033'; break;
+                case '\\': replacement = '\\'; break;
+                case '"': replacement = '"'; break;
+                default:
+                    file.write(text.data() + slash, 2);
+                    start = slash + 2;
+                    continue;
+            }
+            file.write(&replacement, 1);
+            start = slash + 2;
+        }
+    }
+
+    // io.lines: reads the next line as each item is asked for.
+    class LineIterator : public NyxIterator {
+    public:
+        explicit LineIterator(FilePtr file) : file(std::move(file)) {}
+
+        bool next(Interpreter&, NyxValue& item) override {
+            std::string line;
+            if (!file->readLine(line)) return false;
+            item = NyxValue(std::move(line));
+            return true;
+        }
+
+        std::string describe() const override {
+            return "<lines of " + file->path() + ">";
+        }
+
+    private:
+        FilePtr file;
+    };
+}
+
 NyxValue native_io_input(Interpreter& interpreter, const std::vector<NyxValue>& args) {
     if (args.size() > 1) {
         throw Common::NyxRuntimeException("'io.input' function takes 0 or 1 argument (prompt).", 0); 
@@ -48,13 +111,12 @@ NyxValue native_io_readFile(Interpreter& interpreter, const std::vector<NyxValue
         throw Common::NyxRuntimeException("'io.readFile' expects one string argument (filepath).", 0);
     }
     std::string filepath = std::get<std::string>(args[0].data);
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        throw Common::NyxRuntimeException("Could not open file '" + filepath + "' for reading.", 0);
+    std::error_code size_error;
+    auto file_size = std::filesystem::file_size(filepath, size_error);
+    if (!size_error) {
+        HeapAccounting::checkAllocation(static_cast<size_t>(file_size), 0);
     }
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
-    return NyxValue(content);
+    return NyxValue(readWholeFile(filepath));
 }
 
 NyxValue native_io_writeFile(Interpreter& interpreter, const std::vector<NyxValue>& args) {
@@ -116,22 +178,153 @@ NyxValue native_io_deleteFile(Interpreter& interpreter, const std::vector<NyxVal
     }
 }
 
+NyxValue native_io_open(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 3 || !std::holds_alternative<std::string>(args[0].data)) {
+        throw Common::NyxRuntimeException("'io.open' expects a filepath, an optional mode and an optional buffer size.", 0);
+    }
+    const std::string& filepath = std::get<std::string>(args[0].data);
+    std::string mode = "r";
+    if (args.size() >= 2) {
+        const auto* mode_string = std::get_if<std::string>(&args[1].data);
+        if (!mode_string || (*mode_string != "r" && *mode_string != "w" && *mode_string != "a")) {
+            throw Common::NyxRuntimeException("'io.open' mode must be \"r\", \"w\" or \"a\".", 0);
+        }
+        mode = *mode_string;
+    }
+    size_t buffer_size = NyxFile::DEFAULT_WRITE_BUFFER_SIZE;
+    if (args.size() == 3) {
+        const double* size = std::get_if<double>(&args[2].data);
+        if (mode == "r" || !size || !(*size >= 0) || *size != static_cast<double>(static_cast<size_t>(*size))) {
+            throw Common::NyxRuntimeException("'io.open' buffer size must be a whole number of bytes, for mode \"w\" or \"a\".", 0);
+        }
+        buffer_size = static_cast<size_t>(*size);
+        HeapAccounting::checkAllocation(buffer_size, 0);
+    }
+    if (mode == "r") {
+        return NyxValue(NyxFile::openForReading(filepath));
+    }
+    return NyxValue(NyxFile::openForWriting(filepath, mode == "w" ? NyxFile::Mode::WRITE : NyxFile::Mode::APPEND, buffer_size));
+}
+
+NyxValue native_io_readLine(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    std::string line;
+    if (!expectFile(args[0], "io.readLine")->readLine(line)) {
+        return NyxValue(std::monostate{});
+    }
+    return NyxValue(std::move(line));
+}
 
-void registerStdIoModule(Interpreter& interpreter) {
-    Interpreter::NativeModuleBuilder builder = [&]() {
-        auto module_env = std::make_shared<Environment>(interpreter.globals); 
-        
-        module_env->define("input", NyxValue(std::make_shared<NyxNativeFunction>("input", native_io_input, -1)));
-        module_env->define("print", NyxValue(std::make_shared<NyxNativeFunction>("print", native_io_print, -1)));
-        module_env->define("readFile", NyxValue(std::make_shared<NyxNativeFunction>("readFile", native_io_readFile, 1)));
-        module_env->define("writeFile", NyxValue(std::make_shared<NyxNativeFunction>("writeFile", native_io_writeFile, 2)));
-        module_env->define("appendFile", NyxValue(std::make_shared<NyxNativeFunction>("appendFile", native_io_appendFile, 2)));
-        module_env->define("fileExists", NyxValue(std::make_shared<NyxNativeFunction>("fileExists", native_io_fileExists, 1)));
-        module_env->define("deleteFile", NyxValue(std::make_shared<NyxNativeFunction>("deleteFile", native_io_deleteFile, 1)));
-        
-        return module_env;
+NyxValue native_io_readChunk(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const FilePtr& file = expectFile(args[0], "io.readChunk");
+    const double* size = std::get_if<double>(&args[1].data);
+    if (!size || !(*size >= 1) || *size != static_cast<double>(static_cast<size_t>(*size))) {
+        throw Common::NyxRuntimeException("'io.readChunk' expects a positive whole number of bytes.", 0);
+    }
+    HeapAccounting::checkAllocation(static_cast<size_t>(*size), 0);
+    std::string chunk;
+    if (!file->readChunk(static_cast<size_t>(*size), chunk)) {
+        return NyxValue(std::monostate{});
+    }
+    return NyxValue(std::move(chunk));
+}
+
+NyxValue native_io_lines(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(IteratorPtr(std::make_shared<LineIterator>(expectFile(args[0], "io.lines"))));
+}
+
+NyxValue native_io_write(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const FilePtr& file = expectFile(args[0], "io.write");
+    const auto* text = std::get_if<std::string>(&args[1].data);
+    if (!text) {
+        throw Common::NyxRuntimeException("'io.write' expects a string to write, got " + nyxValueTypeToString(args[1]) + ".", 0);
+    }
+    writeProcessed(*file, *text);
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_io_flush(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFile(args[0], "io.flush")->flush();
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_io_sync(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFile(args[0], "io.sync")->sync();
+    return NyxValue(std::monostate{});
+}
+
+// io.readBytes(path) reads a whole file; io.readBytes(file, n) reads up to
+// n bytes from an open handle and returns null at the end.
+NyxValue native_io_readBytes(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() == 1 && std::holds_alternative<std::string>(args[0].data)) {
+        return NyxValue(NyxBytes::adopt(readWholeFile(std::get<std::string>(args[0].data))));
+    }
+    if (args.size() != 2) {
+        throw Common::NyxRuntimeException("'io.readBytes' expects a filepath, or a file and a number of bytes.", 0);
+    }
+    const FilePtr& file = expectFile(args[0], "io.readBytes");
+    const double* size = std::get_if<double>(&args[1].data);
+    if (!size || !(*size >= 1) || *size != static_cast<double>(static_cast<size_t>(*size))) {
+        throw Common::NyxRuntimeException("'io.readBytes' expects a positive whole number of bytes.", 0);
+    }
+    HeapAccounting::checkAllocation(static_cast<size_t>(*size), 0);
+    std::string chunk;
+    if (!file->readChunk(static_cast<size_t>(*size), chunk)) {
+        return NyxValue(std::monostate{});
+    }
+    return NyxValue(NyxBytes::adopt(std::move(chunk)));
+}
+
+// io.writeBytes(path, bytes) replaces a file; io.writeBytes(file, bytes)
+// writes through an open handle. Bytes are written as they are, with no
+// escape processing.
+NyxValue native_io_writeBytes(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const auto* bytes = std::get_if<BytesPtr>(&args[1].data);
+    if (!bytes || !*bytes) {
+        throw Common::NyxRuntimeException("'io.writeBytes' expects bytes to write, got " + nyxValueTypeToString(args[1]) + ".", 0);
+    }
+    const char* data = reinterpret_cast<const char*>((*bytes)->data());
+    if (const auto* filepath = std::get_if<std::string>(&args[0].data)) {
+        FilePtr file = NyxFile::openForWriting(*filepath, NyxFile::Mode::WRITE, 0);
+        file->write(data, (*bytes)->size());
+        file->close();
+    } else {
+        expectFile(args[0], "io.writeBytes")->write(data, (*bytes)->size());
+    }
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_io_close(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectFile(args[0], "io.close")->close();
+    return NyxValue(std::monostate{});
+}
+
+
+namespace {
+    constexpr NativeModuleMember IO_MODULE_MEMBERS[] = {
+        nativeFunction("input", native_io_input, -1),
+        nativeFunction("print", native_io_print, -1),
+        nativeFunction("readFile", native_io_readFile, 1),
+        nativeFunction("writeFile", native_io_writeFile, 2),
+        nativeFunction("appendFile", native_io_appendFile, 2),
+        nativeFunction("fileExists", native_io_fileExists, 1),
+        nativeFunction("deleteFile", native_io_deleteFile, 1),
+        nativeFunction("open", native_io_open, -1),
+        nativeFunction("readLine", native_io_readLine, 1),
+        nativeFunction("readChunk", native_io_readChunk, 2),
+        nativeFunction("lines", native_io_lines, 1),
+        nativeFunction("write", native_io_write, 2),
+        nativeFunction("flush", native_io_flush, 1),
+        nativeFunction("sync", native_io_sync, 1),
+        nativeFunction("readBytes", native_io_readBytes, -1),
+        nativeFunction("writeBytes", native_io_writeBytes, 2),
+        nativeFunction("close", native_io_close, 1),
     };
-    interpreter.registerNativeModule("std:io", builder);
+
+    const NativeModuleTable IO_MODULE(IO_MODULE_MEMBERS);
+}
+
+void registerStdIoModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:io", IO_MODULE);
 }
 
 }
\ No newline at end of file
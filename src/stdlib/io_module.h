@@ -15,6 +15,16 @@ NyxValue native_io_writeFile(Interpreter& interpreter, const std::vector<NyxValu
 NyxValue native_io_appendFile(Interpreter& interpreter, const std::vector<NyxValue>& args);
 NyxValue native_io_fileExists(Interpreter& interpreter, const std::vector<NyxValue>& args);
 NyxValue native_io_deleteFile(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_open(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_readLine(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_readChunk(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_lines(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_write(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_flush(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_sync(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_readBytes(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_writeBytes(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_io_close(Interpreter& interpreter, const std::vector<NyxValue>& args);
 
 
 void registerStdIoModule(Interpreter& interpreter);
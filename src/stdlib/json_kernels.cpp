@@ -0,0 +1,198 @@
+#include "./json_kernels.h"
+#include "./array_kernels.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NYX_JSON_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define NYX_TARGET_AVX2
+#else
+#define NYX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define NYX_JSON_X86 0
+#endif
+
+namespace Nyx {
+namespace JsonKernels {
+
+namespace {
+    using ArrayKernels::SimdLevel;
+
+    // Per-byte classes of a block, before strings are taken into account.
+    struct RawMasks {
+        std::uint64_t quote = 0;
+        std::uint64_t backslash = 0;
+        std::uint64_t op = 0;          // { } [ ] : ,
+        std::uint64_t whitespace = 0;
+        std::uint64_t control = 0;     // below 0x20
+    };
+
+    RawMasks classifyScalar(const char* data) {
+        RawMasks masks;
+        for (int i = 0; i < 64; ++i) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            std::uint64_t bit = std::uint64_t{1} << i;
+            if (c == '"') masks.quote |= bit;
+            if (c == '\\') masks.backslash |= bit;
+            if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') masks.op |= bit;
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') masks.whitespace |= bit;
+            if (c < 0x20) masks.control |= bit;
+        }
+        return masks;
+    }
+
+#if NYX_JSON_X86
+    std::uint64_t maskBitsSse2(__m128i m) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(m)));
+    }
+
+    // '[' and ']' are '{' and '}' without bit 5, so or-ing it in folds the
+    // brackets onto the braces. Bytes below 0x20 are those below 0xa0 once
+    // the top bit is flipped, as a signed compare sees them.
+    RawMasks classifySse2(const char* data) {
+        const __m128i case_bit = _mm_set1_epi8(0x20);
+        const __m128i top_bit = _mm_set1_epi8(static_cast<char>(0x80));
+        const __m128i control_limit = _mm_set1_epi8(static_cast<char>(0xa0));
+        RawMasks masks;
+        for (int lane = 0; lane < 4; ++lane) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * lane));
+            __m128i folded = _mm_or_si128(v, case_bit);
+            int shift = 16 * lane;
+            masks.quote |= maskBitsSse2(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << shift;
+            masks.backslash |= maskBitsSse2(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << shift;
+            __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+                                      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+            masks.op |= maskBitsSse2(op) << shift;
+            __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                                         _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+            masks.whitespace |= maskBitsSse2(space) << shift;
+            masks.control |= maskBitsSse2(_mm_cmplt_epi8(_mm_xor_si128(v, top_bit), control_limit)) << shift;
+        }
+        return masks;
+    }
+
+    NYX_TARGET_AVX2 inline std::uint64_t maskBitsAvx2(__m256i m) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(m)));
+    }
+
+    NYX_TARGET_AVX2 RawMasks classifyAvx2(const char* data) {
+        const __m256i case_bit = _mm256_set1_epi8(0x20);
+        const __m256i top_bit = _mm256_set1_epi8(static_cast<char>(0x80));
+        const __m256i control_limit = _mm256_set1_epi8(static_cast<char>(0xa0));
+        RawMasks masks;
+        for (int lane = 0; lane < 2; ++lane) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32 * lane));
+            __m256i folded = _mm256_or_si256(v, case_bit);
+            int shift = 32 * lane;
+            masks.quote |= maskBitsAvx2(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))) << shift;
+            masks.backslash |= maskBitsAvx2(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))) << shift;
+            __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+                                         _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+            masks.op |= maskBitsAvx2(op) << shift;
+            __m256i space = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                                            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+            masks.whitespace |= maskBitsAvx2(space) << shift;
+            masks.control |= maskBitsAvx2(_mm256_cmpgt_epi8(control_limit, _mm256_xor_si256(v, top_bit))) << shift;
+        }
+        return masks;
+    }
+
+    size_t plainStringPrefixSse2(const char* data, size_t n) {
+        const __m128i top_bit = _mm_set1_epi8(static_cast<char>(0x80));
+        const __m128i control_limit = _mm_set1_epi8(static_cast<char>(0xa0));
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+                                           _mm_cmplt_epi8(_mm_xor_si128(v, top_bit), control_limit));
+            int mask = _mm_movemask_epi8(special);
+            if (mask != 0) return i + lowestBit(static_cast<std::uint64_t>(mask));
+        }
+        return i;
+    }
+#endif
+
+    RawMasks classify(const char* data) {
+#if NYX_JSON_X86
+        static const SimdLevel level = ArrayKernels::simdLevel();
+        if (level >= SimdLevel::AVX2) return classifyAvx2(data);
+        if (level >= SimdLevel::SSE2) return classifySse2(data);
+#endif
+        return classifyScalar(data);
+    }
+
+    // Bits of the bytes that follow an odd run of backslashes. `carry` says
+    // whether the first byte is escaped by the end of the previous block.
+    std::uint64_t escapedBytes(std::uint64_t backslash, std::uint64_t& carry) {
+        constexpr std::uint64_t EVEN_BITS = 0x5555555555555555ULL;
+        backslash &= ~carry;
+        std::uint64_t follows_escape = (backslash << 1) | carry;
+        // Runs starting on odd bits carry into the byte after the run
+        // exactly when the run is odd-length; even-start runs the same way
+        // after flipping which bits count as even.
+        std::uint64_t odd_starts = backslash & ~EVEN_BITS & ~follows_escape;
+        std::uint64_t sum = odd_starts + backslash;
+        carry = sum < odd_starts ? 1 : 0;
+        std::uint64_t invert = sum << 1;
+        return (EVEN_BITS ^ invert) & follows_escape;
+    }
+
+    // Bit i is the xor of bits 0..i: 1 from an opening quote up to (not
+    // including) its closing quote.
+    std::uint64_t prefixXor(std::uint64_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    size_t plainStringPrefixScalar(const char* data, size_t from, size_t n) {
+        size_t i = from;
+        while (i < n) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            if (c == '"' || c == '\\' || c < 0x20) break;
+            ++i;
+        }
+        return i;
+    }
+}
+
+Block scanBlock(const char* data, ScanState& state) {
+    RawMasks raw = classify(data);
+    std::uint64_t escaped = escapedBytes(raw.backslash, state.escaped);
+    std::uint64_t quotes = raw.quote & ~escaped;
+    std::uint64_t in_string = prefixXor(quotes) ^ state.in_string;
+    state.in_string = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+    std::uint64_t ops = raw.op & ~in_string;
+    std::uint64_t scalar = ~(raw.op | raw.whitespace | quotes | in_string);
+    std::uint64_t scalar_starts = scalar & ~((scalar << 1) | state.scalar);
+    state.scalar = scalar >> 63;
+
+    Block block;
+    block.token_starts = ops | (quotes & in_string) | scalar_starts;
+    block.quotes = quotes;
+    block.string_controls = raw.control & in_string;
+    return block;
+}
+
+size_t plainStringPrefix(const char* data, size_t n) {
+    size_t i = 0;
+#if NYX_JSON_X86
+    static const SimdLevel level = ArrayKernels::simdLevel();
+    if (level >= SimdLevel::SSE2) {
+        i = plainStringPrefixSse2(data, n);
+        if (i < n && (data[i] == '"' || data[i] == '\\' || static_cast<unsigned char>(data[i]) < 0x20)) return i;
+    }
+#endif
+    return plainStringPrefixScalar(data, i, n);
+}
+
+}
+}
@@ -0,0 +1,59 @@
+#ifndef NYX_STDLIB_JSON_KERNELS_H
+#define NYX_STDLIB_JSON_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Nyx {
+
+// The byte scans behind std:json, with SSE2 and AVX2 versions chosen by the
+// same SIMD level as std:array (see array_kernels.h). Every level gives the
+// same results.
+namespace JsonKernels {
+
+// Where things are in one 64-byte block of JSON text; bit i stands for
+// byte i. Found with vector compares and bit arithmetic rather than a
+// byte-by-byte state machine, after simdjson's first stage.
+struct Block {
+    // '{', '}', '[', ']', ':' and ',' outside strings, opening quotes, and
+    // the first byte of every number or literal: where each token starts.
+    std::uint64_t token_starts;
+    // Unescaped quotes, opening and closing.
+    std::uint64_t quotes;
+    // Bytes below 0x20 inside strings, which JSON does not allow.
+    std::uint64_t string_controls;
+};
+
+// Carried from each block to the next.
+struct ScanState {
+    std::uint64_t in_string = 0;  // all ones while a string is open
+    std::uint64_t escaped = 0;    // 1 if the next block starts escaped
+    std::uint64_t scalar = 0;     // 1 if the last byte was in a number or literal
+};
+
+// Classifies data[0, 64). Pad the last block of the input with spaces.
+Block scanBlock(const char* data, ScanState& state);
+
+// The index of the lowest set bit of a non-zero mask.
+inline unsigned lowestBit(std::uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+// The number of leading bytes of data[0, n) that a JSON string can hold
+// as they are: all but '"', '\\' and bytes below 0x20.
+size_t plainStringPrefix(const char* data, size_t n);
+
+}
+
+}
+
+#endif
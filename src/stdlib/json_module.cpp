@@ -0,0 +1,872 @@
+#include "./json_module.h"
+#include "./json_kernels.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../common/Bytes.h"
+#include "../common/FileHandle.h"
+#include "../common/HashTable.h"
+#include "../common/HeapAccounting.h"
+#include "../common/Iterator.h"
+#include "../common/NumericArray.h"
+#include "../common/Utils.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace Nyx {
+
+namespace {
+    // Deeper input is rejected, and deeper values (or values that contain
+    // themselves) cannot be written.
+    constexpr size_t MAX_DEPTH = 1024;
+
+    // Reads JSON text as a sequence of events: the start and end of each
+    // object and array, each key, and each string, number, boolean or null.
+    // Text is classified 64 bytes at a time by JsonKernels::scanBlock, which
+    // marks where every token starts and where every string ends, so the
+    // reader jumps from token to token instead of looking at every byte.
+    // A reader over a file holds only the part of it not yet read.
+    class JsonReader {
+    public:
+        enum class Event { START_OBJECT, END_OBJECT, START_ARRAY, END_ARRAY, KEY, VALUE, END };
+
+        // Reads `text`, which must outlive the reader. With
+        // `many_documents`, any number of values may follow one another
+        // (as in JSON Lines); otherwise the text holds exactly one.
+        JsonReader(const char* text, size_t text_size, bool many_documents)
+            : data(text), size(text_size), at_end(true), many_documents(many_documents) {}
+        // Reads a file opened with io.open, a megabyte at a time.
+        JsonReader(FilePtr source, bool many_documents)
+            : file(std::move(source)), many_documents(many_documents) {}
+
+        // Throws NyxRuntimeException on malformed input. Returns END (and
+        // keeps returning it) once the input is over.
+        Event next();
+        size_t depth() const { return containers.size(); }
+
+        std::string key;  // of a KEY event
+        NyxValue value;   // of a VALUE event
+
+    private:
+        enum class Expect { VALUE, FIRST_VALUE_OR_END, FIRST_KEY_OR_END, KEY, COMMA_OR_END, DOCUMENT_END };
+        static constexpr size_t NO_TOKEN = static_cast<size_t>(-1);
+        static constexpr size_t READ_SIZE = 1 << 20;
+
+        size_t nextToken();
+        bool nextBlock();
+        bool readMore();
+        size_t inputEnd() const { return window_start + size; }
+        const char* pointerAt(size_t position) const { return data + (position - window_start); }
+        char byteAt(size_t position) const { return *pointerAt(position); }
+
+        Event startValue(size_t position);
+        Event endContainer();
+        void finishValue() { expect = containers.empty() ? Expect::DOCUMENT_END : Expect::COMMA_OR_END; }
+        std::string readString(size_t position);
+        std::string unescape(const char* text, size_t length, size_t plain, size_t position) const;
+        unsigned readHex4(const char* text, size_t length, size_t at, size_t position) const;
+        NyxValue readScalar(size_t position);
+        double readNumber(const char* text, size_t length, size_t position) const;
+        [[noreturn]] void fail(size_t position, const std::string& message) const;
+
+        FilePtr file;
+        std::string window;          // input read from `file` and still needed
+        const char* data = nullptr;  // the input in memory
+        size_t size = 0;
+        size_t window_start = 0;     // input offset of data[0]
+        bool at_end = false;         // nothing more to read
+        bool many_documents;
+
+        JsonKernels::ScanState scan_state;
+        JsonKernels::Block block{};
+        size_t block_start = 0;      // input offset of the current block
+        bool have_block = false;
+        std::uint64_t pending = 0;   // token starts in the block not yet read
+        size_t keep_from = 0;        // input before this offset may be dropped
+
+        std::vector<char> containers;  // '{' or '[' for each open container
+        Expect expect = Expect::VALUE;
+    };
+
+    bool isScalarByte(char c) {
+        switch (c) {
+            case '{': case '}': case '[': case ']': case ':': case ',': case '"':
+            case ' ': case '\t': case '\n': case '\r':
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    void appendUtf8(std::string& out, unsigned code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xc0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xe0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        } else {
+            out += static_cast<char>(0xf0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+
+    JsonReader::Event JsonReader::next() {
+        for (;;) {
+            size_t position = nextToken();
+            if (position == NO_TOKEN) {
+                if (containers.empty() && (expect == Expect::DOCUMENT_END || (many_documents && expect == Expect::VALUE))) {
+                    return Event::END;
+                }
+                fail(inputEnd(), containers.empty() && expect == Expect::VALUE ? "no value" : "unexpected end of input");
+            }
+            char c = byteAt(position);
+            switch (expect) {
+                case Expect::DOCUMENT_END:
+                    if (!many_documents) fail(position, "unexpected data after the value");
+                    return startValue(position);
+                case Expect::VALUE:
+                    return startValue(position);
+                case Expect::FIRST_VALUE_OR_END:
+                    if (c == ']') return endContainer();
+                    return startValue(position);
+                case Expect::FIRST_KEY_OR_END:
+                    if (c == '}') return endContainer();
+                    [[fallthrough]];
+                case Expect::KEY: {
+                    if (c != '"') fail(position, "expected a string key");
+                    key = readString(position);
+                    size_t colon = nextToken();
+                    if (colon == NO_TOKEN || byteAt(colon) != ':') {
+                        fail(colon == NO_TOKEN ? inputEnd() : colon, "expected ':' after a key");
+                    }
+                    expect = Expect::VALUE;
+                    return Event::KEY;
+                }
+                case Expect::COMMA_OR_END: {
+                    bool in_object = containers.back() == '{';
+                    char close = in_object ? '}' : ']';
+                    if (c == close) return endContainer();
+                    if (c != ',') fail(position, std::string("expected ',' or '") + close + "'");
+                    expect = in_object ? Expect::KEY : Expect::VALUE;
+                    break;
+                }
+            }
+        }
+    }
+
+    JsonReader::Event JsonReader::startValue(size_t position) {
+        char c = byteAt(position);
+        if (c == '{' || c == '[') {
+            if (containers.size() >= MAX_DEPTH) {
+                fail(position, "nested more than " + std::to_string(MAX_DEPTH) + " levels deep");
+            }
+            containers.push_back(c);
+            expect = c == '{' ? Expect::FIRST_KEY_OR_END : Expect::FIRST_VALUE_OR_END;
+            return c == '{' ? Event::START_OBJECT : Event::START_ARRAY;
+        }
+        if (c == '"') {
+            value = NyxValue(readString(position));
+        } else if (c == '}' || c == ']' || c == ':' || c == ',') {
+            fail(position, std::string("unexpected '") + c + "'");
+        } else {
+            value = readScalar(position);
+        }
+        finishValue();
+        return Event::VALUE;
+    }
+
+    JsonReader::Event JsonReader::endContainer() {
+        char open = containers.back();
+        containers.pop_back();
+        finishValue();
+        return open == '{' ? Event::END_OBJECT : Event::END_ARRAY;
+    }
+
+    size_t JsonReader::nextToken() {
+        while (pending == 0) {
+            keep_from = have_block ? block_start + 64 : 0;
+            if (!nextBlock()) return NO_TOKEN;
+        }
+        size_t position = block_start + JsonKernels::lowestBit(pending);
+        pending &= pending - 1;
+        return position;
+    }
+
+    // Moves on to the next 64 bytes, reading more of the file if needed.
+    bool JsonReader::nextBlock() {
+        size_t start = have_block ? block_start + 64 : 0;
+        while (start + 64 > inputEnd() && readMore()) {}
+        if (start >= inputEnd()) return false;
+        if (start + 64 <= inputEnd()) {
+            block = JsonKernels::scanBlock(pointerAt(start), scan_state);
+        } else {
+            char padded[64];
+            std::memset(padded, ' ', sizeof(padded));
+            std::memcpy(padded, pointerAt(start), inputEnd() - start);
+            block = JsonKernels::scanBlock(padded, scan_state);
+        }
+        block_start = start;
+        have_block = true;
+        pending = block.token_starts;
+        if (block.string_controls != 0) {
+            fail(start + JsonKernels::lowestBit(block.string_controls), "control character in a string (it must be escaped)");
+        }
+        return true;
+    }
+
+    // Drops the input before `keep_from` and appends the next part of the
+    // file. Returns false once the file is used up.
+    bool JsonReader::readMore() {
+        if (at_end) return false;
+        size_t drop = std::min(keep_from > window_start ? keep_from - window_start : 0, window.size());
+        window.erase(0, drop);
+        window_start += drop;
+        std::string chunk;
+        if (file->readChunk(READ_SIZE, chunk)) {
+            window += chunk;
+        } else {
+            at_end = true;
+        }
+        data = window.data();
+        size = window.size();
+        return !at_end;
+    }
+
+    std::string JsonReader::readString(size_t position) {
+        keep_from = position;
+        // The string ends at the first quote after the opening one.
+        std::uint64_t closing = block.quotes & ~((std::uint64_t{2} << (position - block_start)) - 1);
+        while (closing == 0) {
+            if (!nextBlock()) fail(position, "unterminated string");
+            closing = block.quotes;
+        }
+        size_t end = block_start + JsonKernels::lowestBit(closing);
+        const char* text = pointerAt(position + 1);
+        size_t length = end - position - 1;
+        size_t plain = JsonKernels::plainStringPrefix(text, length);
+        if (plain == length) return std::string(text, length);
+        return unescape(text, length, plain, position + 1);
+    }
+
+    std::string JsonReader::unescape(const char* text, size_t length, size_t plain, size_t position) const {
+        std::string result;
+        result.reserve(length);
+        result.append(text, plain);
+        size_t i = plain;
+        while (i < length) {
+            if (text[i] != '\\') {
+                size_t run = std::max<size_t>(1, JsonKernels::plainStringPrefix(text + i, length - i));
+                result.append(text + i, run);
+                i += run;
+                continue;
+            }
+            char escape = i + 1 < length ? text[i + 1] : '\0';
+            switch (escape) {
+                case '"': result += '"'; break;
+                case '\\': result += '\\'; break;
+                case '/': result += '/'; break;
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'n': result += '\n'; break;
+                case 'r': result += '\r'; break;
+                case 't': result += '\t'; break;
+                case 'u': {
+                    unsigned code = readHex4(text, length, i + 2, position);
+                    i += 6;
+                    // A surrogate pair spells one character above U+FFFF;
+                    // a lone surrogate becomes U+FFFD.
+                    if (code >= 0xd800 && code < 0xdc00 && i + 1 < length && text[i] == '\\' && text[i + 1] == 'u') {
+                        unsigned low = readHex4(text, length, i + 2, position);
+                        if (low >= 0xdc00 && low < 0xe000) {
+                            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                            i += 6;
+                        }
+                    }
+                    appendUtf8(result, code >= 0xd800 && code < 0xe000 ? 0xfffd : code);
+                    continue;
+                }
+                default:
+                    fail(position + i, "invalid escape in a string");
+            }
+            i += 2;
+        }
+        return result;
+    }
+
+    unsigned JsonReader::readHex4(const char* text, size_t length, size_t at, size_t position) const {
+        if (at + 4 > length) fail(position + at - 2, "invalid \\u escape");
+        unsigned code = 0;
+        for (size_t i = at; i < at + 4; ++i) {
+            char c = text[i];
+            unsigned digit;
+            if (c >= '0' && c <= '9') digit = static_cast<unsigned>(c - '0');
+            else if (c >= 'a' && c <= 'f') digit = static_cast<unsigned>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') digit = static_cast<unsigned>(c - 'A' + 10);
+            else fail(position + at - 2, "invalid \\u escape");
+            code = code << 4 | digit;
+        }
+        return code;
+    }
+
+    NyxValue JsonReader::readScalar(size_t position) {
+        keep_from = position;
+        size_t end = position;
+        for (;;) {
+            while (end < inputEnd() && isScalarByte(byteAt(end))) ++end;
+            if (end < inputEnd() || !readMore()) break;
+        }
+        const char* text = pointerAt(position);
+        size_t length = end - position;
+        if (length == 4 && std::memcmp(text, "true", 4) == 0) return NyxValue(true);
+        if (length == 5 && std::memcmp(text, "false", 5) == 0) return NyxValue(false);
+        if (length == 4 && std::memcmp(text, "null", 4) == 0) return NyxValue(std::monostate{});
+        return NyxValue(readNumber(text, length, position));
+    }
+
+    double JsonReader::readNumber(const char* text, size_t length, size_t position) const {
+        auto digit = [&](size_t i) { return i < length && text[i] >= '0' && text[i] <= '9'; };
+        size_t i = 0;
+        bool negative = length > 0 && text[0] == '-';
+        if (negative) ++i;
+        bool valid = digit(i);
+        if (valid && text[i] == '0') {
+            ++i;
+        } else {
+            while (digit(i)) ++i;
+        }
+        size_t integer_digits = i - (negative ? 1 : 0);
+        bool is_integer = true;
+        if (valid && i < length && text[i] == '.') {
+            is_integer = false;
+            valid = digit(++i);
+            while (digit(i)) ++i;
+        }
+        if (valid && i < length && (text[i] == 'e' || text[i] == 'E')) {
+            is_integer = false;
+            ++i;
+            if (i < length && (text[i] == '+' || text[i] == '-')) ++i;
+            valid = digit(i);
+            while (digit(i)) ++i;
+        }
+        if (!valid || i != length) {
+            std::string shown(text, std::min<size_t>(length, 32));
+            fail(position, "invalid value '" + shown + (length > 32 ? "...'" : "'"));
+        }
+        // Integers of up to 15 digits are exact as doubles.
+        if (is_integer && integer_digits <= 15) {
+            std::int64_t whole = 0;
+            for (size_t d = negative ? 1 : 0; d < length; ++d) whole = whole * 10 + (text[d] - '0');
+            double result = static_cast<double>(whole);
+            return negative ? -result : result;
+        }
+        double result = 0.0;
+        auto parsed = std::from_chars(text, text + length, result);
+        if (parsed.ec == std::errc::result_out_of_range) {
+            // Too large or too small for a double: strtod gives infinity or 0.
+            result = std::strtod(std::string(text, length).c_str(), nullptr);
+        }
+        return result;
+    }
+
+    void JsonReader::fail(size_t position, const std::string& message) const {
+        std::string where = "byte " + std::to_string(position);
+        if (!file) {
+            size_t line = 1;
+            size_t column = 1;
+            for (size_t i = 0; i < position && i < size; ++i) {
+                if (data[i] == '\n') {
+                    ++line;
+                    column = 1;
+                } else {
+                    ++column;
+                }
+            }
+            where = "line " + std::to_string(line) + ", column " + std::to_string(column);
+        }
+        throw Common::NyxRuntimeException("Invalid JSON at " + where + ": " + message + ".", 0);
+    }
+
+    // Builds the value that starts with `first`, reading the rest of it.
+    // Objects become maps (keys in the order they appear; the last of
+    // repeated keys wins), arrays become lists. An object's keys and values
+    // are gathered first, so its map is allocated once at its final size;
+    // the buffers for each depth are kept from one object to the next.
+    NyxValue buildValue(JsonReader& reader, JsonReader::Event first) {
+        using Event = JsonReader::Event;
+        if (first == Event::VALUE) return std::move(reader.value);
+        struct Frame {
+            bool is_object = false;
+            NyxList items;  // array elements, or keys and values in turn
+        };
+        thread_local std::vector<Frame> frames;
+        size_t depth = 0;
+        auto open = [&](Event event) {
+            if (depth == frames.size()) frames.emplace_back();
+            frames[depth].is_object = event == Event::START_OBJECT;
+            frames[depth].items.clear();
+            ++depth;
+        };
+        auto close = [&]() {
+            Frame& done = frames[depth - 1];
+            if (!done.is_object) return NyxValue(std::move(done.items));
+            auto map = std::make_shared<NyxMap>();
+            map->table.reserve(done.items.size() / 2);
+            for (size_t i = 0; i < done.items.size(); i += 2) {
+                bool inserted = false;
+                size_t entry = map->table.insert(std::move(done.items[i]), inserted);
+                map->table.valueAt(entry) = std::move(done.items[i + 1]);
+            }
+            done.items.clear();
+            return NyxValue(std::move(map));
+        };
+        // Leaves no values behind (after an error too), nor very large
+        // buffers.
+        struct Release {
+            ~Release() {
+                for (Frame& frame : frames) {
+                    frame.items.clear();
+                    if (frame.items.capacity() > 4096) NyxList().swap(frame.items);
+                }
+            }
+        } release;
+        open(first);
+        for (;;) {
+            Event event = reader.next();
+            switch (event) {
+                case Event::START_OBJECT:
+                case Event::START_ARRAY:
+                    open(event);
+                    break;
+                case Event::KEY:
+                    frames[depth - 1].items.emplace_back(std::move(reader.key));
+                    break;
+                case Event::VALUE:
+                    frames[depth - 1].items.push_back(std::move(reader.value));
+                    break;
+                case Event::END_OBJECT:
+                case Event::END_ARRAY: {
+                    NyxValue built = close();
+                    --depth;
+                    if (HeapAccounting::overLimit()) HeapAccounting::enforceLimit(0);
+                    if (depth == 0) return built;
+                    frames[depth - 1].items.push_back(std::move(built));
+                    break;
+                }
+                case Event::END:
+                    // next() reports unfinished containers itself.
+                    return NyxValue(std::monostate{});
+            }
+        }
+    }
+
+    // Writes values as JSON text into `out`. With a file, `out` is passed on
+    // to it whenever it fills up, so output of any size takes little memory.
+    class JsonWriter {
+    public:
+        static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+        JsonWriter(std::string& out, size_t indent, NyxFile* file) : out(out), indent(indent), file(file) {}
+
+        void write(const NyxValue& value, size_t depth);
+        void finish() {
+            if (file) {
+                file->write(out.data(), out.size());
+                out.clear();
+            }
+        }
+
+    private:
+        void writeString(const std::string& text);
+        void writeNumber(double number);
+        void writeKey(const NyxValue& key);
+        void writeFields(const std::vector<std::string>& names, const std::vector<NyxValue>& values, size_t depth);
+        template <typename Each>
+        void writeArray(size_t count, size_t depth, Each each);
+        void newline(size_t depth) {
+            if (indent == 0) return;
+            out += '\n';
+            out.append(depth * indent, ' ');
+        }
+        void maybeFlush() {
+            if (file && out.size() >= FLUSH_SIZE) finish();
+        }
+
+        std::string& out;
+        size_t indent;
+        NyxFile* file;
+    };
+
+    void JsonWriter::write(const NyxValue& value, size_t depth) {
+        if (depth > MAX_DEPTH) {
+            throw Common::NyxRuntimeException("'json' cannot write values nested more than " + std::to_string(MAX_DEPTH) +
+                                             " levels deep (does the value contain itself?).", 0);
+        }
+        maybeFlush();
+        const auto& data = value.data;
+        if (std::holds_alternative<std::monostate>(data)) {
+            out += "null";
+        } else if (const bool* flag = std::get_if<bool>(&data)) {
+            out += *flag ? "true" : "false";
+        } else if (const double* number = std::get_if<double>(&data)) {
+            writeNumber(*number);
+        } else if (const std::string* text = std::get_if<std::string>(&data)) {
+            writeString(*text);
+        } else if (const NyxList* list = std::get_if<NyxList>(&data)) {
+            writeArray(list->size(), depth, [&](size_t i) { write((*list)[i], depth + 1); });
+        } else if (const auto* array = std::get_if<NumericArrayPtr>(&data); array && *array) {
+            writeArray((*array)->size(), depth, [&](size_t i) { writeNumber((*array)->get(i)); });
+        } else if (const auto* map = std::get_if<MapPtr>(&data); map && *map) {
+            const NyxHashTable& table = (*map)->table;
+            bool first = true;
+            out += '{';
+            for (size_t entry = 0; entry < table.entryLimit(); ++entry) {
+                if (!table.isLive(entry)) continue;
+                if (!first) out += ',';
+                first = false;
+                newline(depth + 1);
+                writeKey(table.keyAt(entry));
+                write(table.valueAt(entry), depth + 1);
+            }
+            if (!first) newline(depth);
+            out += '}';
+        } else if (const auto* set = std::get_if<SetPtr>(&data); set && *set) {
+            const NyxHashTable& table = (*set)->table;
+            std::vector<const NyxValue*> elements;
+            elements.reserve(table.size());
+            for (size_t entry = 0; entry < table.entryLimit(); ++entry) {
+                if (table.isLive(entry)) elements.push_back(&table.keyAt(entry));
+            }
+            writeArray(elements.size(), depth, [&](size_t i) { write(*elements[i], depth + 1); });
+        } else if (const auto* instance = std::get_if<StructInstancePtr>(&data); instance && *instance) {
+            writeFields((*instance)->definition->field_names_in_order, (*instance)->field_values, depth);
+        } else if (const auto* frozen = std::get_if<FrozenValuePtr>(&data); frozen && *frozen) {
+            const NyxFrozenValue& contents = **frozen;
+            switch (contents.kind) {
+                case NyxFrozenValue::Kind::STRING:
+                    writeString(contents.text);
+                    break;
+                case NyxFrozenValue::Kind::LIST:
+                    writeArray(contents.elements.size(), depth, [&](size_t i) { write(contents.elements[i], depth + 1); });
+                    break;
+                case NyxFrozenValue::Kind::STRUCT_INSTANCE:
+                    writeFields(contents.definition->field_names_in_order, contents.elements, depth);
+                    break;
+            }
+        } else {
+            std::string hint = std::holds_alternative<BytesPtr>(data) ? " (use bytes.toBase64 or bytes.toHex)" : "";
+            throw Common::NyxRuntimeException("'json' cannot write values of type " + nyxValueTypeToString(value) + hint + ".", 0);
+        }
+    }
+
+    template <typename Each>
+    void JsonWriter::writeArray(size_t count, size_t depth, Each each) {
+        out += '[';
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0) out += ',';
+            newline(depth + 1);
+            each(i);
+            maybeFlush();
+        }
+        if (count > 0) newline(depth);
+        out += ']';
+    }
+
+    void JsonWriter::writeFields(const std::vector<std::string>& names, const std::vector<NyxValue>& values, size_t depth) {
+        out += '{';
+        for (size_t i = 0; i < names.size() && i < values.size(); ++i) {
+            if (i > 0) out += ',';
+            newline(depth + 1);
+            writeString(names[i]);
+            out += indent > 0 ? ": " : ":";
+            write(values[i], depth + 1);
+        }
+        if (!names.empty()) newline(depth);
+        out += '}';
+    }
+
+    void JsonWriter::writeKey(const NyxValue& key) {
+        if (const std::string* text = std::get_if<std::string>(&key.data)) {
+            writeString(*text);
+        } else if (const double* number = std::get_if<double>(&key.data)) {
+            out += '"';
+            writeNumber(*number);
+            out += '"';
+        } else if (const bool* flag = std::get_if<bool>(&key.data)) {
+            out += *flag ? "\"true\"" : "\"false\"";
+        } else if (const auto* frozen = std::get_if<FrozenValuePtr>(&key.data);
+                   frozen && *frozen && (*frozen)->kind == NyxFrozenValue::Kind::STRING) {
+            writeString((*frozen)->text);
+        } else {
+            throw Common::NyxRuntimeException("'json' object keys must be strings, numbers or booleans, got " + nyxValueTypeToString(key) + ".", 0);
+        }
+        out += indent > 0 ? ": " : ":";
+    }
+
+    void JsonWriter::writeNumber(double number) {
+        if (!std::isfinite(number)) {
+            throw Common::NyxRuntimeException("'json' cannot write " + std::string(std::isnan(number) ? "NaN" : "infinity") + ".", 0);
+        }
+        // The shortest text that reads back as the same double.
+        char digits[32];
+        auto written = std::to_chars(digits, digits + sizeof(digits), number);
+        out.append(digits, written.ptr);
+    }
+
+    void JsonWriter::writeString(const std::string& text) {
+        static const char HEX[] = "0123456789abcdef";
+        out += '"';
+        const char* data = text.data();
+        size_t length = text.size();
+        size_t i = 0;
+        while (i < length) {
+            size_t plain = JsonKernels::plainStringPrefix(data + i, length - i);
+            out.append(data + i, plain);
+            i += plain;
+            if (i == length) break;
+            unsigned char c = static_cast<unsigned char>(data[i++]);
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    out += "\\u00";
+                    out += HEX[c >> 4];
+                    out += HEX[c & 0x0f];
+            }
+        }
+        out += '"';
+    }
+
+    // Reused by json.stringify, so building one string after another does
+    // not grow a fresh buffer each time.
+    std::string& outputBuffer() {
+        thread_local std::string buffer;
+        return buffer;
+    }
+
+    size_t expectIndent(const std::vector<NyxValue>& args, size_t index, const std::string& function_name) {
+        if (args.size() <= index) return 0;
+        const double* indent = std::get_if<double>(&args[index].data);
+        if (!indent || !(*indent >= 0 && *indent <= 16) || std::trunc(*indent) != *indent) {
+            throw Common::NyxRuntimeException("'" + function_name + "' indent must be a whole number of spaces from 0 to 16.", 0);
+        }
+        return static_cast<size_t>(*indent);
+    }
+
+    // What a reader reads: JSON text in a string or bytes, or a file
+    // opened for reading. A copy of a string is kept for iterators, which
+    // outlive the call that made them.
+    class ReaderSource {
+    public:
+        ReaderSource(const NyxValue& source, const std::string& function_name, bool copy_text, bool many_documents) {
+            if (const std::string* text = std::get_if<std::string>(&source.data)) {
+                const std::string* read = text;
+                if (copy_text) {
+                    held_text = *text;
+                    read = &held_text;
+                }
+                reader = std::make_unique<JsonReader>(read->data(), read->size(), many_documents);
+            } else if (const auto* bytes = std::get_if<BytesPtr>(&source.data); bytes && *bytes) {
+                held_bytes = *bytes;
+                reader = std::make_unique<JsonReader>(reinterpret_cast<const char*>(held_bytes->data()), held_bytes->size(), many_documents);
+            } else if (const auto* file = std::get_if<FilePtr>(&source.data); file && *file) {
+                reader = std::make_unique<JsonReader>(*file, many_documents);
+            } else {
+                throw Common::NyxRuntimeException("'" + function_name + "' expects JSON text (a string or bytes) or a file opened with 'io.open', got " +
+                                                 nyxValueTypeToString(source) + ".", 0);
+            }
+        }
+
+        JsonReader& get() { return *reader; }
+
+    private:
+        std::string held_text;
+        BytesPtr held_bytes;
+        std::unique_ptr<JsonReader> reader;
+    };
+
+    // json.items: the elements of a top-level array, parsed one at a time.
+    class ItemsIterator : public NyxIterator {
+    public:
+        explicit ItemsIterator(const NyxValue& source) : source(source, "json.items", true, false) {}
+
+        bool next(Interpreter&, NyxValue& item) override {
+            if (finished) return false;
+            JsonReader& reader = source.get();
+            using Event = JsonReader::Event;
+            if (!started) {
+                started = true;
+                if (reader.next() != Event::START_ARRAY) {
+                    finished = true;
+                    throw Common::NyxRuntimeException("'json.items' expects the JSON text to be an array.", 0);
+                }
+            }
+            Event event = reader.next();
+            if (event == Event::END_ARRAY) {
+                finished = true;
+                reader.next();  // rejects anything after the array
+                return false;
+            }
+            item = buildValue(reader, event);
+            return true;
+        }
+
+        std::string describe() const override { return "<json items>"; }
+
+    private:
+        ReaderSource source;
+        bool started = false;
+        bool finished = false;
+    };
+
+    // json.documents: each of a run of values (JSON Lines and the like).
+    class DocumentsIterator : public NyxIterator {
+    public:
+        explicit DocumentsIterator(const NyxValue& source) : source(source, "json.documents", true, true) {}
+
+        bool next(Interpreter&, NyxValue& item) override {
+            JsonReader& reader = source.get();
+            JsonReader::Event event = reader.next();
+            if (event == JsonReader::Event::END) return false;
+            item = buildValue(reader, event);
+            return true;
+        }
+
+        std::string describe() const override { return "<json documents>"; }
+
+    private:
+        ReaderSource source;
+    };
+
+    // json.events: every event of the reader as a [name, value] list.
+    class EventsIterator : public NyxIterator {
+    public:
+        explicit EventsIterator(const NyxValue& source) : source(source, "json.events", true, true) {}
+
+        bool next(Interpreter&, NyxValue& item) override {
+            JsonReader& reader = source.get();
+            using Event = JsonReader::Event;
+            Event event = reader.next();
+            NyxList pair(2);
+            switch (event) {
+                case Event::START_OBJECT: pair[0] = NyxValue("startObject"); break;
+                case Event::END_OBJECT: pair[0] = NyxValue("endObject"); break;
+                case Event::START_ARRAY: pair[0] = NyxValue("startArray"); break;
+                case Event::END_ARRAY: pair[0] = NyxValue("endArray"); break;
+                case Event::KEY:
+                    pair[0] = NyxValue("key");
+                    pair[1] = NyxValue(std::move(reader.key));
+                    break;
+                case Event::VALUE:
+                    pair[0] = NyxValue("value");
+                    pair[1] = std::move(reader.value);
+                    break;
+                case Event::END:
+                    return false;
+            }
+            item = NyxValue(std::move(pair));
+            return true;
+        }
+
+        std::string describe() const override { return "<json events>"; }
+
+    private:
+        ReaderSource source;
+    };
+}
+
+NyxValue native_json_parse(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    ReaderSource source(args[0], "json.parse", false, false);
+    JsonReader& reader = source.get();
+    NyxValue result = buildValue(reader, reader.next());
+    reader.next();  // rejects anything after the value
+    return result;
+}
+
+NyxValue native_json_stringify(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2) {
+        throw Common::NyxRuntimeException("'json.stringify' expects 1 or 2 arguments (value, [indent]).", 0);
+    }
+    std::string& buffer = outputBuffer();
+    buffer.clear();
+    JsonWriter writer(buffer, expectIndent(args, 1, "json.stringify"), nullptr);
+    writer.write(args[0], 0);
+    HeapAccounting::checkAllocation(buffer.size(), 0);
+    std::string result(buffer);
+    // Keep a moderate buffer for next time, but not a huge one.
+    if (buffer.capacity() > 16 * JsonWriter::FLUSH_SIZE) {
+        std::string().swap(buffer);
+    }
+    return NyxValue(std::move(result));
+}
+
+// json.write(target, value, [indent]): writes to a file opened with "w" or
+// "a", or replaces the file at a path, without building the whole text.
+NyxValue native_json_write(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'json.write' expects 2 or 3 arguments (file or filepath, value, [indent]).", 0);
+    }
+    size_t indent = expectIndent(args, 2, "json.write");
+    FilePtr file;
+    bool close_after = false;
+    if (const std::string* filepath = std::get_if<std::string>(&args[0].data)) {
+        file = NyxFile::openForWriting(*filepath, NyxFile::Mode::WRITE, 0);
+        close_after = true;
+    } else if (const auto* handle = std::get_if<FilePtr>(&args[0].data); handle && *handle) {
+        file = *handle;
+    } else {
+        throw Common::NyxRuntimeException("'json.write' expects a file returned by 'io.open' or a filepath, got " + nyxValueTypeToString(args[0]) + ".", 0);
+    }
+    std::string buffer;
+    buffer.reserve(JsonWriter::FLUSH_SIZE + 4096);
+    JsonWriter writer(buffer, indent, file.get());
+    writer.write(args[1], 0);
+    writer.finish();
+    if (close_after) file->close();
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_json_items(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(IteratorPtr(std::make_shared<ItemsIterator>(args[0])));
+}
+
+NyxValue native_json_documents(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(IteratorPtr(std::make_shared<DocumentsIterator>(args[0])));
+}
+
+NyxValue native_json_events(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(IteratorPtr(std::make_shared<EventsIterator>(args[0])));
+}
+
+
+namespace {
+    constexpr NativeModuleMember JSON_MODULE_MEMBERS[] = {
+        nativeFunction("parse", native_json_parse, 1),
+        nativeFunction("stringify", native_json_stringify, -1),
+        nativeFunction("write", native_json_write, -1),
+        nativeFunction("items", native_json_items, 1),
+        nativeFunction("documents", native_json_documents, 1),
+        nativeFunction("events", native_json_events, 1),
+    };
+
+    const NativeModuleTable JSON_MODULE(JSON_MODULE_MEMBERS);
+}
+
+void registerStdJsonModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:json", JSON_MODULE);
+}
+
+}
@@ -0,0 +1,22 @@
+#ifndef NYX_STDLIB_JSON_H
+#define NYX_STDLIB_JSON_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_json_parse(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_json_stringify(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_json_write(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_json_items(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_json_documents(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_json_events(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdJsonModule(Interpreter& interpreter);
+
+}
+
+#endif
@@ -1,7 +1,15 @@
 #include "./list_module.h"
+#include "./native_module_table.h"
 #include "../interpreter/Interpreter.h" 
 #include "../interpreter/Environment.h" 
+#include "../interpreter/CallbackFrame.h"
+#include "../common/Iterator.h"
 #include "../common/Utils.h"         
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <sstream>
 
@@ -18,7 +26,14 @@ NyxValue native_list_append(Interpreter& interpreter, const std::vector<NyxValue
     const NyxValue& item_to_append = args[1];
     
     original_list.push_back(item_to_append);
-    return NyxValue(original_list);
+    return NyxValue(std::move(original_list));
+}
+
+void native_list_append_in_place(Interpreter& interpreter, NyxValue& target, const std::vector<NyxValue>& rest) {
+    if (!std::holds_alternative<NyxList>(target.data)) {
+        throw Common::NyxRuntimeException("First argument to 'list.append' must be a list.", 0);
+    }
+    editListInPlace(target, [&](NyxList& list) { list.push_back(rest[0]); });
 }
 
 NyxValue native_list_prepend(Interpreter& interpreter, const std::vector<NyxValue>& args) {
@@ -36,7 +51,14 @@ NyxValue native_list_prepend(Interpreter& interpreter, const std::vector<NyxValu
     new_list.push_back(item_to_prepend);
     new_list.insert(new_list.end(), original_list.begin(), original_list.end());
     
-    return NyxValue(new_list);
+    return NyxValue(std::move(new_list));
+}
+
+void native_list_prepend_in_place(Interpreter& interpreter, NyxValue& target, const std::vector<NyxValue>& rest) {
+    if (!std::holds_alternative<NyxList>(target.data)) {
+        throw Common::NyxRuntimeException("First argument to 'list.prepend' must be a list.", 0);
+    }
+    editListInPlace(target, [&](NyxList& list) { list.insert(list.begin(), rest[0]); });
 }
 
 NyxValue native_list_is_empty(Interpreter& interpreter, const std::vector<NyxValue>& args) {
@@ -130,58 +152,636 @@ NyxValue native_list_join(Interpreter& interpreter, const std::vector<NyxValue>&
     return NyxValue(ss.str());
 }
 
+namespace {
+    const NyxList& expectList(const NyxValue& value, const std::string& function_name) {
+        const auto* list = std::get_if<NyxList>(&value.data);
+        if (!list) {
+            throw Common::NyxRuntimeException("First argument to '" + function_name + "' must be a list.", 0);
+        }
+        return *list;
+    }
+
+    const IteratorPtr* asIterator(const NyxValue& value) {
+        const auto* iterator = std::get_if<IteratorPtr>(&value.data);
+        return iterator && *iterator ? iterator : nullptr;
+    }
+
+    // Calls `visit` with each item of a list or iterator until it returns
+    // false. Lists are read in place; iterators are read only as far as needed.
+    template <typename Visit>
+    void visitItems(Interpreter& interpreter, const NyxValue& iterable, const std::string& function_name, Visit&& visit) {
+        if (const IteratorPtr* iterator = asIterator(iterable)) {
+            IteratorPtr source = *iterator;
+            NyxValue item;
+            while (source->next(interpreter, item)) {
+                if (!visit(item)) return;
+            }
+            return;
+        }
+        const auto* list = std::get_if<NyxList>(&iterable.data);
+        if (!list) {
+            throw Common::NyxRuntimeException("First argument to '" + function_name + "' must be a list or iterator.", 0);
+        }
+        for (const NyxValue& element : *list) {
+            if (!visit(element)) return;
+        }
+    }
+}
+
 NyxValue native_list_each(Interpreter& interpreter, const std::vector<NyxValue>& args) {
     if (args.size() != 2) {
         throw Common::NyxRuntimeException("'list.each' expects two arguments (list, callback_function).", 0);
     }
-    if (!std::holds_alternative<NyxList>(args[0].data)) {
-        throw Common::NyxRuntimeException("First argument to 'list.each' must be a list.", 0);
+    CallbackFrame callback(interpreter, args[1], 1, "list.each");
+    visitItems(interpreter, args[0], "list.each", [&](const NyxValue& element) {
+        callback.call(element);
+        return true;
+    });
+    return NyxValue(std::monostate{}); 
+}
+
+namespace {
+    // Numbers sort ascending with NaN last, which keeps the order strict
+    // even for lists that contain NaN.
+    bool numberLess(double a, double b) {
+        return std::isnan(b) ? !std::isnan(a) : a < b;
     }
-    const NyxValue& callback_value = args[1];
-    if (!std::holds_alternative<UserDefinedFunctionPtr>(callback_value.data) && 
-        !std::holds_alternative<NativeFunctionPtr>(callback_value.data)) {
-        throw Common::NyxRuntimeException("Second argument to 'list.each' must be a function.", 0);
+
+    // Positions of `keys` in ascending order; equal keys keep their original
+    // order. Keys must all be numbers or all be strings, and are compared
+    // natively without calling back into the script. Breaking ties by
+    // position makes the order total, so an unstable introsort (std::sort)
+    // gives the stable result.
+    std::vector<size_t> naturalOrder(const NyxList& keys, const std::string& function_name) {
+        std::vector<size_t> order(keys.size());
+        if (keys.empty()) return order;
+
+        if (std::holds_alternative<double>(keys[0].data)) {
+            std::vector<std::pair<double, size_t>> numbers;
+            numbers.reserve(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                const double* number = std::get_if<double>(&keys[i].data);
+                if (!number) {
+                    throw Common::NyxRuntimeException("'" + function_name + "' cannot compare a number with a " + nyxValueTypeToString(keys[i]) +
+                                                      " (use list.sortWith for mixed elements).", 0);
+                }
+                numbers.emplace_back(*number, i);
+            }
+            std::sort(numbers.begin(), numbers.end(), [](const auto& a, const auto& b) {
+                if (numberLess(a.first, b.first)) return true;
+                if (numberLess(b.first, a.first)) return false;
+                return a.second < b.second;
+            });
+            for (size_t i = 0; i < numbers.size(); ++i) order[i] = numbers[i].second;
+            return order;
+        }
+
+        if (std::holds_alternative<std::string>(keys[0].data)) {
+            std::vector<std::pair<const std::string*, size_t>> strings;
+            strings.reserve(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                const std::string* text = std::get_if<std::string>(&keys[i].data);
+                if (!text) {
+                    throw Common::NyxRuntimeException("'" + function_name + "' cannot compare a string with a " + nyxValueTypeToString(keys[i]) +
+                                                      " (use list.sortWith for mixed elements).", 0);
+                }
+                strings.emplace_back(text, i);
+            }
+            std::sort(strings.begin(), strings.end(), [](const auto& a, const auto& b) {
+                int difference = a.first->compare(*b.first);
+                return difference != 0 ? difference < 0 : a.second < b.second;
+            });
+            for (size_t i = 0; i < strings.size(); ++i) order[i] = strings[i].second;
+            return order;
+        }
+
+        throw Common::NyxRuntimeException("'" + function_name + "' can only compare numbers or strings, got " + nyxValueTypeToString(keys[0]) +
+                                          " (use list.sortWith for other elements).", 0);
     }
 
-    const auto& list = std::get<NyxList>(args[0].data);
-    std::vector<NyxValue> callback_args(1); 
-
-    for (const auto& element : list) {
-        callback_args[0] = element;
-        if (std::holds_alternative<UserDefinedFunctionPtr>(callback_value.data)) {
-            auto func_ptr = std::get<UserDefinedFunctionPtr>(callback_value.data);
-            if (!func_ptr) throw Common::NyxRuntimeException("Callback function is null.", 0);
-            if (func_ptr->arity() != 1) {
-                 throw Common::NyxRuntimeException("Callback function for 'list.each' must accept 1 argument (element).", 0);
+    NyxList keysOf(const NyxList& list, CallbackFrame& key_function) {
+        NyxList keys;
+        keys.reserve(list.size());
+        for (const NyxValue& element : list) {
+            keys.push_back(key_function.call(element));
+        }
+        return keys;
+    }
+
+    NyxList inOrder(const NyxList& list, const std::vector<size_t>& order) {
+        NyxList sorted;
+        sorted.reserve(order.size());
+        for (size_t position : order) {
+            sorted.push_back(list[position]);
+        }
+        return sorted;
+    }
+
+    // Stable bottom-up merge sort of positions. The comparator calls into the
+    // script, so unlike std::sort this stays in bounds even when it is
+    // inconsistent, and it makes close to the minimum number of calls.
+    template <typename Less>
+    std::vector<size_t> mergeSortedOrder(size_t count, Less less) {
+        std::vector<size_t> order(count), buffer(count);
+        for (size_t i = 0; i < count; ++i) order[i] = i;
+        for (size_t width = 1; width < count; width *= 2) {
+            for (size_t start = 0; start < count; start += 2 * width) {
+                size_t middle = std::min(start + width, count);
+                size_t end = std::min(start + 2 * width, count);
+                size_t left = start, right = middle, out = start;
+                while (left < middle && right < end) {
+                    // Take from the right only when strictly smaller, for stability.
+                    buffer[out++] = less(order[right], order[left]) ? order[right++] : order[left++];
+                }
+                while (left < middle) buffer[out++] = order[left++];
+                while (right < end) buffer[out++] = order[right++];
+            }
+            order.swap(buffer);
+        }
+        return order;
+    }
+
+    size_t expectCount(const NyxValue& value, const std::string& function_name) {
+        const double* number = std::get_if<double>(&value.data);
+        if (!number || *number < 0 || std::trunc(*number) != *number) {
+            throw Common::NyxRuntimeException("'" + function_name + "' count must be a non-negative integer.", 0);
+        }
+        return static_cast<size_t>(std::min(*number, 1e18));
+    }
+}
+
+NyxValue native_list_sort(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxList& list = expectList(args[0], "list.sort");
+    return NyxValue(inOrder(list, naturalOrder(list, "list.sort")));
+}
+
+NyxValue native_list_sortBy(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxList& list = expectList(args[0], "list.sortBy");
+    CallbackFrame key_function(interpreter, args[1], 1, "list.sortBy");
+    // Each key is computed once, then sorted natively.
+    NyxList keys = keysOf(list, key_function);
+    return NyxValue(inOrder(list, naturalOrder(keys, "list.sortBy")));
+}
+
+NyxValue native_list_sortWith(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxList& list = expectList(args[0], "list.sortWith");
+    CallbackFrame comparator(interpreter, args[1], 2, "list.sortWith");
+    auto less = [&](size_t a, size_t b) {
+        NyxValue result = comparator.call(list[a], list[b]);
+        const double* difference = std::get_if<double>(&result.data);
+        if (!difference) {
+            throw Common::NyxRuntimeException("'list.sortWith' comparator must return a number, got " + nyxValueTypeToString(result) + ".", 0);
+        }
+        return *difference < 0;
+    };
+    return NyxValue(inOrder(list, mergeSortedOrder(list.size(), less)));
+}
+
+NyxValue native_list_binarySearch(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxList& list = expectList(args[0], "list.binarySearch");
+    const NyxValue& wanted = args[1];
+    const double* wanted_number = std::get_if<double>(&wanted.data);
+    const std::string* wanted_text = std::get_if<std::string>(&wanted.data);
+    if (!wanted_number && !wanted_text) {
+        throw Common::NyxRuntimeException("'list.binarySearch' looks for a number or a string, got " + nyxValueTypeToString(wanted) + ".", 0);
+    }
+    auto elementLess = [&](const NyxValue& element, bool element_first) {
+        if (wanted_number) {
+            const double* number = std::get_if<double>(&element.data);
+            if (!number) {
+                throw Common::NyxRuntimeException("'list.binarySearch' found a " + nyxValueTypeToString(element) + " in a list searched for a number.", 0);
             }
-            interpreter.executeFunctionBody(*func_ptr, callback_args);
-        } else if (std::holds_alternative<NativeFunctionPtr>(callback_value.data)) {
-            auto native_func_ptr = std::get<NativeFunctionPtr>(callback_value.data);
-            if (!native_func_ptr) throw Common::NyxRuntimeException("Native callback function is null.", 0);
-            if (native_func_ptr->arity != 1 && native_func_ptr->arity != -1) {
-                 throw Common::NyxRuntimeException("Native callback function for 'list.each' must accept 1 argument (element) or be variadic.", 0);
+            return element_first ? numberLess(*number, *wanted_number) : numberLess(*wanted_number, *number);
+        }
+        const std::string* text = std::get_if<std::string>(&element.data);
+        if (!text) {
+            throw Common::NyxRuntimeException("'list.binarySearch' found a " + nyxValueTypeToString(element) + " in a list searched for a string.", 0);
+        }
+        return element_first ? *text < *wanted_text : *wanted_text < *text;
+    };
+
+    // Lower bound: the first position whose element is not less than `wanted`.
+    size_t low = 0, high = list.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (elementLess(list[middle], true)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low < list.size() && !elementLess(list[low], false)) {
+        return NyxValue(static_cast<double>(low));
+    }
+    return NyxValue(-static_cast<double>(low) - 1.0);
+}
+
+NyxValue native_list_partition(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxList& list = expectList(args[0], "list.partition");
+    CallbackFrame predicate(interpreter, args[1], 1, "list.partition");
+    NyxList matching, rest;
+    for (const NyxValue& element : list) {
+        if (interpreter.isTruthy(predicate.call(element))) {
+            matching.push_back(element);
+        } else {
+            rest.push_back(element);
+        }
+    }
+    NyxList result;
+    result.push_back(NyxValue(std::move(matching)));
+    result.push_back(NyxValue(std::move(rest)));
+    return NyxValue(std::move(result));
+}
+
+NyxValue native_list_topK(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'list.topK' expects 2 or 3 arguments (list, count, [key_function]).", 0);
+    }
+    const NyxList& list = expectList(args[0], "list.topK");
+    size_t count = std::min(expectCount(args[1], "list.topK"), list.size());
+    NyxList keys;
+    if (args.size() == 3) {
+        CallbackFrame key_function(interpreter, args[2], 1, "list.topK");
+        keys = keysOf(list, key_function);
+    }
+    const NyxList& compared = args.size() == 3 ? keys : list;
+
+    // Largest first; equal keys keep their original order. Only the first
+    // `count` positions are fully sorted.
+    std::vector<size_t> order(list.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    if (!compared.empty()) {
+        if (std::holds_alternative<double>(compared[0].data)) {
+            std::vector<double> numbers(compared.size());
+            for (size_t i = 0; i < compared.size(); ++i) {
+                const double* number = std::get_if<double>(&compared[i].data);
+                if (!number) {
+                    throw Common::NyxRuntimeException("'list.topK' cannot compare a number with a " + nyxValueTypeToString(compared[i]) + ".", 0);
+                }
+                numbers[i] = *number;
             }
-            native_func_ptr->callback(interpreter, callback_args);
+            std::partial_sort(order.begin(), order.begin() + count, order.end(), [&](size_t a, size_t b) {
+                if (numberLess(numbers[b], numbers[a])) return true;
+                if (numberLess(numbers[a], numbers[b])) return false;
+                return a < b;
+            });
+        } else if (std::holds_alternative<std::string>(compared[0].data)) {
+            for (const NyxValue& key : compared) {
+                if (!std::holds_alternative<std::string>(key.data)) {
+                    throw Common::NyxRuntimeException("'list.topK' cannot compare a string with a " + nyxValueTypeToString(key) + ".", 0);
+                }
+            }
+            std::partial_sort(order.begin(), order.begin() + count, order.end(), [&](size_t a, size_t b) {
+                int difference = std::get<std::string>(compared[a].data).compare(std::get<std::string>(compared[b].data));
+                return difference != 0 ? difference > 0 : a < b;
+            });
+        } else {
+            throw Common::NyxRuntimeException("'list.topK' can only compare numbers or strings, got " + nyxValueTypeToString(compared[0]) + ".", 0);
         }
     }
-    return NyxValue(std::monostate{}); 
+    order.resize(count);
+    return NyxValue(inOrder(list, order));
 }
 
 
-void registerStdListModule(Interpreter& interpreter) {
-    Interpreter::NativeModuleBuilder builder = [&]() {
-        auto module_env = std::make_shared<Environment>(interpreter.globals); 
-        
-        module_env->define("append", NyxValue(std::make_shared<NyxNativeFunction>("append", native_list_append, 2)));
-        module_env->define("prepend", NyxValue(std::make_shared<NyxNativeFunction>("prepend", native_list_prepend, 2)));
-        module_env->define("is_empty", NyxValue(std::make_shared<NyxNativeFunction>("is_empty", native_list_is_empty, 1)));
-        module_env->define("slice", NyxValue(std::make_shared<NyxNativeFunction>("slice", native_list_slice, -1)));
-        module_env->define("join", NyxValue(std::make_shared<NyxNativeFunction>("join", native_list_join, -1)));
-        module_env->define("each", NyxValue(std::make_shared<NyxNativeFunction>("each", native_list_each, 2)));
-        
-        return module_env;
+namespace {
+    // Reads another list or iterator; the lazy steps of a pipeline build on it.
+    class SourceIterator : public NyxIterator {
+    public:
+        explicit SourceIterator(const NyxValue& iterable) : source(iterable), cursor(source) {}
+
+        void gcTraverse(GcVisitor& visitor) const override {
+            gcTraverseValue(source, visitor);
+        }
+
+        void gcClear() override {
+            source = NyxValue();
+            cursor = ItemCursor(source);
+        }
+
+    protected:
+        NyxValue source;
+        ItemCursor cursor;
+    };
+
+    // Lazy map and filter: the callback runs as items are read.
+    class CallbackIterator : public SourceIterator {
+    public:
+        enum class Kind { MAP, FILTER };
+
+        CallbackIterator(Kind kind, Interpreter& interpreter, const NyxValue& iterable, const NyxValue& callback_value, const char* name)
+            : SourceIterator(iterable), kind(kind), function_name(name), callback_value(callback_value),
+              frame(std::make_unique<CallbackFrame>(interpreter, callback_value, 1, name)) {}
+
+        bool next(Interpreter& interpreter, NyxValue& item) override {
+            if (running) {
+                throw Common::NyxRuntimeException("'" + std::string(function_name) + "' callback read its own iterator.", 0);
+            }
+            if (!frame) return false;
+            // The frame is bound to an interpreter; a pipeline built in one
+            // module may be read from another.
+            if (&frame->owner() != &interpreter) {
+                frame = std::make_unique<CallbackFrame>(interpreter, callback_value, 1, function_name);
+            }
+            running = true;
+            try {
+                bool found = false;
+                while (!found && cursor.next(interpreter, item)) {
+                    if (kind == Kind::MAP) {
+                        item = frame->call(item);
+                        found = true;
+                    } else {
+                        found = interpreter.isTruthy(frame->call(item));
+                    }
+                }
+                running = false;
+                return found;
+            } catch (...) {
+                running = false;
+                throw;
+            }
+        }
+
+        void gcTraverse(GcVisitor& visitor) const override {
+            SourceIterator::gcTraverse(visitor);
+            gcTraverseValue(callback_value, visitor);
+            if (frame) frame->gcTraverse(visitor);
+        }
+
+        void gcClear() override {
+            SourceIterator::gcClear();
+            callback_value = NyxValue();
+            frame.reset();
+        }
+
+    private:
+        Kind kind;
+        const char* function_name;
+        NyxValue callback_value;
+        std::unique_ptr<CallbackFrame> frame;
+        bool running = false;
+    };
+
+    class EnumerateIterator : public SourceIterator {
+    public:
+        using SourceIterator::SourceIterator;
+
+        bool next(Interpreter& interpreter, NyxValue& item) override {
+            NyxValue element;
+            if (!cursor.next(interpreter, element)) return false;
+            item = NyxValue(NyxList{NyxValue(static_cast<double>(index++)), std::move(element)});
+            return true;
+        }
+
+    private:
+        size_t index = 0;
+    };
+
+    class TakeIterator : public SourceIterator {
+    public:
+        TakeIterator(const NyxValue& iterable, size_t count) : SourceIterator(iterable), remaining(count) {}
+
+        bool next(Interpreter& interpreter, NyxValue& item) override {
+            if (remaining == 0 || !cursor.next(interpreter, item)) return false;
+            --remaining;
+            return true;
+        }
+
+    private:
+        size_t remaining;
+    };
+
+    class RangeIterator : public NyxIterator {
+    public:
+        RangeIterator(double start, double end, double step) : current(start), end(end), step(step) {}
+
+        bool next(Interpreter&, NyxValue& item) override {
+            if (step > 0 ? current >= end : current <= end) return false;
+            item = NyxValue(current);
+            current += step;
+            return true;
+        }
+
+        std::string describe() const override { return "<range>"; }
+
+    private:
+        double current;
+        double end;
+        double step;
+    };
+
+    double expectNumber(const NyxValue& value, const std::string& what) {
+        const double* number = std::get_if<double>(&value.data);
+        if (!number || !std::isfinite(*number)) {
+            throw Common::NyxRuntimeException(what + " must be a finite number, got " + nyxValueToString(value) + ".", 0);
+        }
+        return *number;
+    }
+}
+
+NyxValue native_list_map(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (asIterator(args[0])) {
+        return NyxValue(IteratorPtr(std::make_shared<CallbackIterator>(CallbackIterator::Kind::MAP, interpreter, args[0], args[1], "list.map")));
+    }
+    const NyxList& list = expectList(args[0], "list.map");
+    CallbackFrame callback(interpreter, args[1], 1, "list.map");
+    NyxList mapped;
+    mapped.reserve(list.size());
+    for (const NyxValue& element : list) {
+        mapped.push_back(callback.call(element));
+    }
+    return NyxValue(std::move(mapped));
+}
+
+NyxValue native_list_filter(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (asIterator(args[0])) {
+        return NyxValue(IteratorPtr(std::make_shared<CallbackIterator>(CallbackIterator::Kind::FILTER, interpreter, args[0], args[1], "list.filter")));
+    }
+    const NyxList& list = expectList(args[0], "list.filter");
+    CallbackFrame predicate(interpreter, args[1], 1, "list.filter");
+    NyxList kept;
+    kept.reserve(list.size());
+    for (const NyxValue& element : list) {
+        if (interpreter.isTruthy(predicate.call(element))) {
+            kept.push_back(element);
+        }
+    }
+    kept.shrink_to_fit();
+    return NyxValue(std::move(kept));
+}
+
+NyxValue native_list_reduce(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'list.reduce' expects 2 or 3 arguments (list, function, [initial]).", 0);
+    }
+    CallbackFrame callback(interpreter, args[1], 2, "list.reduce");
+    bool have_accumulator = args.size() == 3;
+    NyxValue accumulator = have_accumulator ? args[2] : NyxValue();
+    visitItems(interpreter, args[0], "list.reduce", [&](const NyxValue& element) {
+        if (have_accumulator) {
+            accumulator = callback.call(accumulator, element);
+        } else {
+            accumulator = element;
+            have_accumulator = true;
+        }
+        return true;
+    });
+    if (!have_accumulator) {
+        throw Common::NyxRuntimeException("'list.reduce' of an empty list needs an initial value.", 0);
+    }
+    return accumulator;
+}
+
+NyxValue native_list_any(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    CallbackFrame predicate(interpreter, args[1], 1, "list.any");
+    bool found = false;
+    visitItems(interpreter, args[0], "list.any", [&](const NyxValue& element) {
+        found = interpreter.isTruthy(predicate.call(element));
+        return !found;
+    });
+    return NyxValue(found);
+}
+
+NyxValue native_list_all(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    CallbackFrame predicate(interpreter, args[1], 1, "list.all");
+    bool all = true;
+    visitItems(interpreter, args[0], "list.all", [&](const NyxValue& element) {
+        all = interpreter.isTruthy(predicate.call(element));
+        return all;
+    });
+    return NyxValue(all);
+}
+
+NyxValue native_list_find(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    CallbackFrame predicate(interpreter, args[1], 1, "list.find");
+    NyxValue found;
+    visitItems(interpreter, args[0], "list.find", [&](const NyxValue& element) {
+        if (!interpreter.isTruthy(predicate.call(element))) return true;
+        found = element;
+        return false;
+    });
+    return found;
+}
+
+NyxValue native_list_flatMap(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxList& list = expectList(args[0], "list.flatMap");
+    CallbackFrame callback(interpreter, args[1], 1, "list.flatMap");
+    NyxList flattened;
+    flattened.reserve(list.size());
+    for (const NyxValue& element : list) {
+        NyxValue result = callback.call(element);
+        auto* part = std::get_if<NyxList>(&result.data);
+        if (!part) {
+            throw Common::NyxRuntimeException("'list.flatMap' function must return a list, got " + nyxValueTypeToString(result) + ".", 0);
+        }
+        flattened.insert(flattened.end(), std::make_move_iterator(part->begin()), std::make_move_iterator(part->end()));
+    }
+    return NyxValue(std::move(flattened));
+}
+
+NyxValue native_list_zip(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2) {
+        throw Common::NyxRuntimeException("'list.zip' expects at least two lists.", 0);
+    }
+    size_t length = SIZE_MAX;
+    for (const NyxValue& arg : args) {
+        const auto* list = std::get_if<NyxList>(&arg.data);
+        if (!list) {
+            throw Common::NyxRuntimeException("'list.zip' expects lists, got " + nyxValueTypeToString(arg) + ".", 0);
+        }
+        length = std::min(length, list->size());
+    }
+    NyxList zipped;
+    zipped.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        NyxList tuple;
+        tuple.reserve(args.size());
+        for (const NyxValue& arg : args) {
+            tuple.push_back(std::get<NyxList>(arg.data)[i]);
+        }
+        zipped.push_back(NyxValue(std::move(tuple)));
+    }
+    return NyxValue(std::move(zipped));
+}
+
+NyxValue native_list_range(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 3) {
+        throw Common::NyxRuntimeException("'list.range' expects 1 to 3 arguments ([start], end, [step]).", 0);
+    }
+    double start = args.size() == 1 ? 0.0 : expectNumber(args[0], "'list.range' start");
+    double end = expectNumber(args[args.size() == 1 ? 0 : 1], "'list.range' end");
+    double step = args.size() == 3 ? expectNumber(args[2], "'list.range' step") : 1.0;
+    if (step == 0.0) {
+        throw Common::NyxRuntimeException("'list.range' step must not be zero.", 0);
+    }
+    return NyxValue(IteratorPtr(std::make_shared<RangeIterator>(start, end, step)));
+}
+
+NyxValue native_list_enumerate(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!ItemCursor::accepts(args[0])) {
+        throw Common::NyxRuntimeException("'list.enumerate' expects a list, array or iterator, got " + nyxValueTypeToString(args[0]) + ".", 0);
+    }
+    return NyxValue(IteratorPtr(std::make_shared<EnumerateIterator>(args[0])));
+}
+
+NyxValue native_list_take(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    double count = expectNumber(args[1], "'list.take' count");
+    if (count < 0 || std::trunc(count) != count) {
+        throw Common::NyxRuntimeException("'list.take' count must be a non-negative integer.", 0);
+    }
+    if (asIterator(args[0])) {
+        return NyxValue(IteratorPtr(std::make_shared<TakeIterator>(args[0], static_cast<size_t>(count))));
+    }
+    const NyxList& list = expectList(args[0], "list.take");
+    return NyxValue(NyxList(list.begin(), list.begin() + static_cast<std::ptrdiff_t>(std::min(list.size(), static_cast<size_t>(count)))));
+}
+
+NyxValue native_list_collect(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!ItemCursor::accepts(args[0])) {
+        throw Common::NyxRuntimeException("'list.collect' expects a list, array or iterator, got " + nyxValueTypeToString(args[0]) + ".", 0);
+    }
+    NyxList items;
+    ItemCursor cursor(args[0]);
+    NyxValue item;
+    while (cursor.next(interpreter, item)) {
+        items.push_back(std::move(item));
+    }
+    return NyxValue(std::move(items));
+}
+
+namespace {
+    constexpr NativeModuleMember LIST_MODULE_MEMBERS[] = {
+        nativeUpdatingFunction("append", native_list_append, native_list_append_in_place, 2),
+        nativeUpdatingFunction("prepend", native_list_prepend, native_list_prepend_in_place, 2),
+        nativeFunction("is_empty", native_list_is_empty, 1),
+        nativeFunction("slice", native_list_slice, -1),
+        nativeFunction("join", native_list_join, -1),
+        nativeFunction("each", native_list_each, 2),
+        nativeFunction("sort", native_list_sort, 1),
+        nativeFunction("sortBy", native_list_sortBy, 2),
+        nativeFunction("sortWith", native_list_sortWith, 2),
+        nativeFunction("binarySearch", native_list_binarySearch, 2),
+        nativeFunction("partition", native_list_partition, 2),
+        nativeFunction("topK", native_list_topK, -1),
+        nativeFunction("map", native_list_map, 2),
+        nativeFunction("filter", native_list_filter, 2),
+        nativeFunction("reduce", native_list_reduce, -1),
+        nativeFunction("any", native_list_any, 2),
+        nativeFunction("all", native_list_all, 2),
+        nativeFunction("find", native_list_find, 2),
+        nativeFunction("flatMap", native_list_flatMap, 2),
+        nativeFunction("zip", native_list_zip, -1),
+        nativeFunction("range", native_list_range, -1),
+        nativeFunction("enumerate", native_list_enumerate, 1),
+        nativeFunction("take", native_list_take, 2),
+        nativeFunction("collect", native_list_collect, 1),
     };
-    interpreter.registerNativeModule("std:list", builder);
+
+    const NativeModuleTable LIST_MODULE(LIST_MODULE_MEMBERS);
+}
+
+void registerStdListModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:list", LIST_MODULE);
 }
 
 }
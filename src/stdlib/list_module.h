@@ -10,10 +10,30 @@ class Interpreter;
 
 NyxValue native_list_append(Interpreter& interpreter, const std::vector<NyxValue>& args);
 NyxValue native_list_prepend(Interpreter& interpreter, const std::vector<NyxValue>& args);
+void native_list_append_in_place(Interpreter& interpreter, NyxValue& target, const std::vector<NyxValue>& rest);
+void native_list_prepend_in_place(Interpreter& interpreter, NyxValue& target, const std::vector<NyxValue>& rest);
 NyxValue native_list_is_empty(Interpreter& interpreter, const std::vector<NyxValue>& args);
 NyxValue native_list_slice(Interpreter& interpreter, const std::vector<NyxValue>& args);
 NyxValue native_list_join(Interpreter& interpreter, const std::vector<NyxValue>& args);
 NyxValue native_list_each(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_sort(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_sortBy(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_sortWith(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_binarySearch(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_partition(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_topK(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_map(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_filter(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_reduce(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_any(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_all(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_find(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_flatMap(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_zip(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_range(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_enumerate(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_take(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_list_collect(Interpreter& interpreter, const std::vector<NyxValue>& args);
 
 void registerStdListModule(Interpreter& interpreter);
 
@@ -0,0 +1,132 @@
+#include "./map_module.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../common/HashTable.h"
+#include "../common/Utils.h"
+
+namespace Nyx {
+
+namespace {
+    // The table behind a map or a set.
+    NyxHashTable& expectTable(const NyxValue& value, const std::string& function_name) {
+        if (const auto* map = std::get_if<MapPtr>(&value.data); map && *map) return (*map)->table;
+        if (const auto* set = std::get_if<SetPtr>(&value.data); set && *set) return (*set)->table;
+        throw Common::NyxRuntimeException("'" + function_name + "' expects a map or a set, got " + nyxValueTypeToString(value) + ".", 0);
+    }
+
+    NyxMap& expectMap(const NyxValue& value, const std::string& function_name) {
+        const auto* map = std::get_if<MapPtr>(&value.data);
+        if (!map || !*map) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects a map, got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        return **map;
+    }
+
+    NyxSet& expectSet(const NyxValue& value, const std::string& function_name) {
+        const auto* set = std::get_if<SetPtr>(&value.data);
+        if (!set || !*set) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects a set, got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        return **set;
+    }
+}
+
+NyxValue native_map_has(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(expectTable(args[0], "map.has").find(args[1]) != NyxHashTable::NOT_FOUND);
+}
+
+NyxValue native_map_get(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'map.get' expects 2 or 3 arguments: (map, key, [default]).", 0);
+    }
+    const NyxMap& map = expectMap(args[0], "map.get");
+    size_t entry = map.table.find(args[1]);
+    if (entry == NyxHashTable::NOT_FOUND) {
+        return args.size() == 3 ? args[2] : NyxValue(std::monostate{});
+    }
+    return map.table.valueAt(entry);
+}
+
+NyxValue native_map_remove(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    return NyxValue(expectTable(args[0], "map.remove").remove(args[1]));
+}
+
+NyxValue native_map_clear(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    expectTable(args[0], "map.clear").clear();
+    return NyxValue(std::monostate{});
+}
+
+NyxValue native_map_keys(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxHashTable& table = expectTable(args[0], "map.keys");
+    NyxList keys;
+    keys.reserve(table.size());
+    for (size_t entry = 0; entry < table.entryLimit(); ++entry) {
+        if (table.isLive(entry)) keys.push_back(table.keyAt(entry));
+    }
+    return NyxValue(std::move(keys));
+}
+
+NyxValue native_map_values(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    const NyxHashTable& table = expectMap(args[0], "map.values").table;
+    NyxList values;
+    values.reserve(table.size());
+    for (size_t entry = 0; entry < table.entryLimit(); ++entry) {
+        if (table.isLive(entry)) values.push_back(table.valueAt(entry));
+    }
+    return NyxValue(std::move(values));
+}
+
+NyxValue native_map_copy(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (const auto* set = std::get_if<SetPtr>(&args[0].data); set && *set) {
+        return NyxValue(std::make_shared<NyxSet>(**set));
+    }
+    return NyxValue(std::make_shared<NyxMap>(expectMap(args[0], "map.copy")));
+}
+
+NyxValue native_map_set(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() > 1) {
+        throw Common::NyxRuntimeException("'map.set' expects at most one argument: ([list]).", 0);
+    }
+    auto set = std::make_shared<NyxSet>();
+    if (args.empty()) {
+        return NyxValue(set);
+    }
+    const auto* list = std::get_if<NyxList>(&args[0].data);
+    if (!list) {
+        throw Common::NyxRuntimeException("'map.set' expects a list, got " + nyxValueTypeToString(args[0]) + ".", 0);
+    }
+    for (const NyxValue& element : *list) {
+        bool inserted = false;
+        set->table.insert(element, inserted);
+    }
+    return NyxValue(set);
+}
+
+NyxValue native_map_add(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    bool inserted = false;
+    expectSet(args[0], "map.add").table.insert(args[1], inserted);
+    return NyxValue(inserted);
+}
+
+
+namespace {
+    constexpr NativeModuleMember MAP_MODULE_MEMBERS[] = {
+        nativeFunction("has", native_map_has, 2),
+        nativeFunction("get", native_map_get, -1),
+        nativeFunction("remove", native_map_remove, 2),
+        nativeFunction("clear", native_map_clear, 1),
+        nativeFunction("keys", native_map_keys, 1),
+        nativeFunction("values", native_map_values, 1),
+        nativeFunction("copy", native_map_copy, 1),
+        nativeFunction("set", native_map_set, -1),
+        nativeFunction("add", native_map_add, 2),
+    };
+
+    const NativeModuleTable MAP_MODULE(MAP_MODULE_MEMBERS);
+}
+
+void registerStdMapModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:map", MAP_MODULE);
+}
+
+}
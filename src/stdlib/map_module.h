@@ -0,0 +1,25 @@
+#ifndef NYX_STDLIB_MAP_H
+#define NYX_STDLIB_MAP_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_map_has(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_map_get(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_map_remove(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_map_clear(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_map_keys(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_map_values(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_map_copy(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_map_set(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_map_add(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdMapModule(Interpreter& interpreter);
+
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "./math_module.h"
+#include "./native_module_table.h"
 #include "../interpreter/Interpreter.h"
 #include "../interpreter/Environment.h"
 #include "../common/Utils.h"
@@ -9,18 +10,19 @@
 #include <cstdlib>
 #include <ctime>
 #include <limits>
+#include <random>
 
 namespace Nyx {
 
-static bool random_seeded = false;
-void seed_random_if_needed() {
-    if (!random_seeded) {
-        std::srand(static_cast<unsigned int>(std::time(0)));
-        random_seeded = true;
-    }
+// One generator per thread, so interpreters running in parallel neither
+// contend on nor perturb each other's sequence.
+static std::mt19937_64& random_engine() {
+    thread_local std::mt19937_64 engine(std::random_device{}());
+    return engine;
 }
 
-const double PI_VALUE_FOR_CONVERSION = std::acos(-1.0);
+constexpr double PI_VALUE_FOR_CONVERSION = 3.14159265358979323846;
+constexpr double E_VALUE = 2.71828182845904523536;
 
 NyxValue native_math_abs(Interpreter& interpreter, const std::vector<NyxValue>& args) {
     if (args.size() != 1 || !std::holds_alternative<double>(args[0].data)) {
@@ -193,15 +195,13 @@ NyxValue native_math_random(Interpreter& interpreter, const std::vector<NyxValue
     if (!args.empty()) {
         throw Common::NyxRuntimeException("'math.random' function takes no arguments.", 0);
     }
-    seed_random_if_needed();
-    return NyxValue(static_cast<double>(std::rand()) / (RAND_MAX + 1.0)); // 0.0 to <1.0
+    return NyxValue(std::uniform_real_distribution<double>(0.0, 1.0)(random_engine())); // 0.0 to <1.0
 }
 
 NyxValue native_math_randomInt(Interpreter& interpreter, const std::vector<NyxValue>& args) {
     if (args.size() != 2 || !std::holds_alternative<double>(args[0].data) || !std::holds_alternative<double>(args[1].data)) {
         throw Common::NyxRuntimeException("'math.randomInt' expects two number arguments (min, max).", 0);
     }
-    seed_random_if_needed();
     double min_val_double = std::get<double>(args[0].data);
     double max_val_double = std::get<double>(args[1].data);
 
@@ -217,47 +217,47 @@ NyxValue native_math_randomInt(Interpreter& interpreter, const std::vector<NyxVa
     if (min_val == max_val) {
         return NyxValue(static_cast<double>(min_val));
     }
-    long long range = max_val - min_val + 1;
-    return NyxValue(static_cast<double>(min_val + (std::rand() % range)));
+    return NyxValue(static_cast<double>(std::uniform_int_distribution<long long>(min_val, max_val)(random_engine())));
 }
 
 
-void registerStdMathModule(Interpreter& interpreter) {
-    Interpreter::NativeModuleBuilder builder = [&]() {
-        auto module_env = std::make_shared<Environment>(interpreter.globals);
-
+namespace {
+    constexpr NativeModuleMember MATH_MODULE_MEMBERS[] = {
         // Constants
-        module_env->define("PI", NyxValue(PI_VALUE_FOR_CONVERSION));
-        module_env->define("E", NyxValue(std::exp(1.0)));
+        nativeConstant("PI", PI_VALUE_FOR_CONVERSION),
+        nativeConstant("E", E_VALUE),
 
         // Functions
-        module_env->define("abs", NyxValue(std::make_shared<NyxNativeFunction>("abs", native_math_abs, 1)));
-        module_env->define("floor", NyxValue(std::make_shared<NyxNativeFunction>("floor", native_math_floor, 1)));
-        module_env->define("ceil", NyxValue(std::make_shared<NyxNativeFunction>("ceil", native_math_ceil, 1)));
-        module_env->define("round", NyxValue(std::make_shared<NyxNativeFunction>("round", native_math_round, 1)));
-        module_env->define("trunc", NyxValue(std::make_shared<NyxNativeFunction>("trunc", native_math_trunc, 1)));
-        module_env->define("sqrt", NyxValue(std::make_shared<NyxNativeFunction>("sqrt", native_math_sqrt, 1)));
-        module_env->define("pow", NyxValue(std::make_shared<NyxNativeFunction>("pow", native_math_pow, 2)));
-        module_env->define("sin", NyxValue(std::make_shared<NyxNativeFunction>("sin", native_math_sin, 1)));
-        module_env->define("cos", NyxValue(std::make_shared<NyxNativeFunction>("cos", native_math_cos, 1)));
-        module_env->define("tan", NyxValue(std::make_shared<NyxNativeFunction>("tan", native_math_tan, 1)));
-        module_env->define("asin", NyxValue(std::make_shared<NyxNativeFunction>("asin", native_math_asin, 1)));
-        module_env->define("acos", NyxValue(std::make_shared<NyxNativeFunction>("acos", native_math_acos, 1)));
-        module_env->define("atan", NyxValue(std::make_shared<NyxNativeFunction>("atan", native_math_atan, 1)));
-        module_env->define("atan2", NyxValue(std::make_shared<NyxNativeFunction>("atan2", native_math_atan2, 2)));
-        module_env->define("degrees", NyxValue(std::make_shared<NyxNativeFunction>("degrees", native_math_degrees, 1)));
-        module_env->define("radians", NyxValue(std::make_shared<NyxNativeFunction>("radians", native_math_radians, 1)));
-        module_env->define("log", NyxValue(std::make_shared<NyxNativeFunction>("log", native_math_log, 1)));
-        module_env->define("log10", NyxValue(std::make_shared<NyxNativeFunction>("log10", native_math_log10, 1)));
-        module_env->define("exp", NyxValue(std::make_shared<NyxNativeFunction>("exp", native_math_exp, 1)));
-        module_env->define("min", NyxValue(std::make_shared<NyxNativeFunction>("min", native_math_min, 2)));
-        module_env->define("max", NyxValue(std::make_shared<NyxNativeFunction>("max", native_math_max, 2)));
-        module_env->define("random", NyxValue(std::make_shared<NyxNativeFunction>("random", native_math_random, 0)));
-        module_env->define("randomInt", NyxValue(std::make_shared<NyxNativeFunction>("randomInt", native_math_randomInt, 2)));
-        
-        return module_env;
+        nativeFunction("abs", native_math_abs, 1),
+        nativeFunction("floor", native_math_floor, 1),
+        nativeFunction("ceil", native_math_ceil, 1),
+        nativeFunction("round", native_math_round, 1),
+        nativeFunction("trunc", native_math_trunc, 1),
+        nativeFunction("sqrt", native_math_sqrt, 1),
+        nativeFunction("pow", native_math_pow, 2),
+        nativeFunction("sin", native_math_sin, 1),
+        nativeFunction("cos", native_math_cos, 1),
+        nativeFunction("tan", native_math_tan, 1),
+        nativeFunction("asin", native_math_asin, 1),
+        nativeFunction("acos", native_math_acos, 1),
+        nativeFunction("atan", native_math_atan, 1),
+        nativeFunction("atan2", native_math_atan2, 2),
+        nativeFunction("degrees", native_math_degrees, 1),
+        nativeFunction("radians", native_math_radians, 1),
+        nativeFunction("log", native_math_log, 1),
+        nativeFunction("log10", native_math_log10, 1),
+        nativeFunction("exp", native_math_exp, 1),
+        nativeFunction("min", native_math_min, 2),
+        nativeFunction("max", native_math_max, 2),
+        nativeFunction("random", native_math_random, 0),
+        nativeFunction("randomInt", native_math_randomInt, 2),
     };
-    interpreter.registerNativeModule("std:math", builder);
+
+    const NativeModuleTable MATH_MODULE(MATH_MODULE_MEMBERS);
+}
+
+void registerStdMathModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:math", MATH_MODULE);
 }
 
 }
\ No newline at end of file
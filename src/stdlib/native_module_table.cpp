@@ -0,0 +1,27 @@
+#include "./native_module_table.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Nyx {
+
+const NativeModuleMember* NativeModuleTable::find(const std::string& name) const {
+    std::call_once(index_built, [this]() {
+        sorted_index.resize(member_count);
+        for (size_t i = 0; i < member_count; ++i) {
+            sorted_index[i] = i;
+        }
+        std::sort(sorted_index.begin(), sorted_index.end(), [this](size_t a, size_t b) {
+            return std::strcmp(members[a].name, members[b].name) < 0;
+        });
+    });
+
+    auto it = std::lower_bound(sorted_index.begin(), sorted_index.end(), name, [this](size_t index, const std::string& key) {
+        return std::strcmp(members[index].name, key.c_str()) < 0;
+    });
+    if (it != sorted_index.end() && name == members[*it].name) {
+        return &members[*it];
+    }
+    return nullptr;
+}
+
+}
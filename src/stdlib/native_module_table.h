@@ -0,0 +1,60 @@
+#ifndef NYX_STDLIB_NATIVE_MODULE_TABLE_H
+#define NYX_STDLIB_NATIVE_MODULE_TABLE_H
+
+#include "../common/Value.h"
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Nyx {
+
+// One entry of a native module: either a function (callback set) or a numeric
+// constant (callback null).
+struct NativeModuleMember {
+    const char* name;
+    NativeFunctionCallback callback;
+    int arity;
+    double constant;
+    NativeInPlaceCallback in_place;
+};
+
+constexpr NativeModuleMember nativeFunction(const char* name, NativeFunctionCallback callback, int arity) {
+    return NativeModuleMember{name, callback, arity, 0.0, nullptr};
+}
+
+// A function that also knows how to update its first argument in place.
+constexpr NativeModuleMember nativeUpdatingFunction(const char* name, NativeFunctionCallback callback,
+                                                    NativeInPlaceCallback in_place, int arity) {
+    return NativeModuleMember{name, callback, arity, 0.0, in_place};
+}
+
+constexpr NativeModuleMember nativeConstant(const char* name, double value) {
+    return NativeModuleMember{name, nullptr, 0, value, nullptr};
+}
+
+// Static description of a std: module. Tables are shared by every
+// Interpreter; importing one allocates nothing per member, and function
+// objects are only created when a member is first looked up.
+class NativeModuleTable {
+public:
+    template<size_t N>
+    explicit NativeModuleTable(const NativeModuleMember (&table_members)[N])
+        : members(table_members), member_count(N) {}
+
+    NativeModuleTable(const NativeModuleTable&) = delete;
+    NativeModuleTable& operator=(const NativeModuleTable&) = delete;
+
+    const NativeModuleMember* find(const std::string& name) const;
+
+private:
+    const NativeModuleMember* members;
+    size_t member_count;
+
+    mutable std::once_flag index_built;
+    mutable std::vector<size_t> sorted_index;
+};
+
+}
+
+#endif
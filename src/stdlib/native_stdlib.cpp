@@ -8,6 +8,16 @@
 #include "./string_module.h"
 #include "./type_utils_module.h"
 #include "./math_module.h"
+#include "./gc_module.h"
+#include "./task_module.h"
+#include "./chan_module.h"
+#include "./array_module.h"
+#include "./map_module.h"
+#include "./async_module.h"
+#include "./bytes_module.h"
+#include "./json_module.h"
+#include "./csv_module.h"
+#include "./regex_module.h"
 
 namespace Nyx {
 
@@ -19,6 +29,16 @@ void registerNyxStandardLibrary(Interpreter& interpreter) {
     registerStdStringModule(interpreter);
     registerStdTypeUtilsModule(interpreter);
     registerStdMathModule(interpreter);
+    registerStdGcModule(interpreter);
+    registerStdTaskModule(interpreter);
+    registerStdChanModule(interpreter);
+    registerStdArrayModule(interpreter);
+    registerStdMapModule(interpreter);
+    registerStdAsyncModule(interpreter);
+    registerStdBytesModule(interpreter);
+    registerStdJsonModule(interpreter);
+    registerStdCsvModule(interpreter);
+    registerStdRegexModule(interpreter);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,1789 @@
+#include "./regex_engine.h"
+#include "./regex_kernels.h"
+#include "../common/Utils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
+namespace Nyx {
+
+namespace {
+    // Pattern flags. LINES is the form findLine() runs: multiline, with
+    // nothing matching "\n".
+    constexpr unsigned CASE_INSENSITIVE = 1;
+    constexpr unsigned MULTILINE = 2;
+    constexpr unsigned DOT_ALL = 4;
+    constexpr unsigned LINES = 8;
+
+    constexpr std::uint32_t MAX_CODEPOINT = 0x10FFFF;
+    constexpr int MAX_REPEAT = 1000;
+    // Parsing and compiling recurse once per level of groups, and may run on
+    // a green thread's stack.
+    constexpr int MAX_NESTING = 200;
+    constexpr size_t MAX_INSTRUCTIONS = 250000;
+    constexpr size_t NO_POSITION = NyxRegex::NO_POSITION;
+
+    unsigned parseFlags(const std::string& flags) {
+        unsigned bits = 0;
+        for (char flag : flags) {
+            if (flag == 'i') bits |= CASE_INSENSITIVE;
+            else if (flag == 'm') bits |= MULTILINE;
+            else if (flag == 's') bits |= DOT_ALL;
+            else throw Common::NyxRuntimeException(std::string("Invalid regex flag '") + flag + "' (flags are i, m and s).", 0);
+        }
+        return bits;
+    }
+
+    // ---- Assertions -------------------------------------------------------
+
+    enum class Assertion : std::uint8_t {
+        BEGIN_TEXT, END_TEXT,
+        BEGIN_LINE, END_LINE,
+        // findLine()'s '$' also matches before "\r", for "\r\n" line breaks;
+        // BEGIN_LINE_CR is the same thing read backwards.
+        BEGIN_LINE_CR, END_LINE_CR,
+        WORD_BOUNDARY, NOT_WORD_BOUNDARY,
+        // \B holds nowhere inside a character, so no empty match splits
+        // one. Read backwards, that depends on the byte before the position
+        // rather than the one after.
+        NOT_WORD_BOUNDARY_REVERSED,
+    };
+
+    // What comes before a position, as far as assertions care.
+    constexpr unsigned AT_START = 1;
+    constexpr unsigned AFTER_NEWLINE = 2;
+    constexpr unsigned AFTER_CR = 4;
+    constexpr unsigned AFTER_WORD = 8;
+    constexpr unsigned AFTER_CONTINUATION = 16;   // a UTF-8 continuation byte
+    constexpr unsigned CONTEXT_COUNT = 32;
+    // The "byte" after the last one.
+    constexpr int END_OF_TEXT = 256;
+
+    bool isContinuationByte(int c) {
+        return c >= 0x80 && c <= 0xBF;
+    }
+
+    bool isWordByte(int c) {
+        return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_';
+    }
+
+    unsigned contextAfter(unsigned char c) {
+        return (c == '\n' ? AFTER_NEWLINE : 0) | (c == '\r' ? AFTER_CR : 0) | (isWordByte(c) ? AFTER_WORD : 0) |
+               (isContinuationByte(c) ? AFTER_CONTINUATION : 0);
+    }
+
+    unsigned contextAt(const unsigned char* text, size_t position) {
+        return position == 0 ? AT_START : contextAfter(text[position - 1]);
+    }
+
+    bool assertionHolds(Assertion assertion, unsigned before, int next) {
+        switch (assertion) {
+            case Assertion::BEGIN_TEXT: return (before & AT_START) != 0;
+            case Assertion::END_TEXT: return next == END_OF_TEXT;
+            case Assertion::BEGIN_LINE: return (before & (AT_START | AFTER_NEWLINE)) != 0;
+            case Assertion::END_LINE: return next == END_OF_TEXT || next == '\n';
+            case Assertion::BEGIN_LINE_CR: return (before & (AT_START | AFTER_NEWLINE | AFTER_CR)) != 0;
+            case Assertion::END_LINE_CR: return next == END_OF_TEXT || next == '\n' || next == '\r';
+            case Assertion::WORD_BOUNDARY: return ((before & AFTER_WORD) != 0) != (next != END_OF_TEXT && isWordByte(next));
+            case Assertion::NOT_WORD_BOUNDARY:
+                return ((before & AFTER_WORD) != 0) == (next != END_OF_TEXT && isWordByte(next)) && !isContinuationByte(next);
+            case Assertion::NOT_WORD_BOUNDARY_REVERSED:
+                return ((before & AFTER_WORD) != 0) == (next != END_OF_TEXT && isWordByte(next)) && (before & AFTER_CONTINUATION) == 0;
+        }
+        return false;
+    }
+
+    // The assertion that means the same when the text is read backwards.
+    Assertion reversed(Assertion assertion) {
+        switch (assertion) {
+            case Assertion::BEGIN_TEXT: return Assertion::END_TEXT;
+            case Assertion::END_TEXT: return Assertion::BEGIN_TEXT;
+            case Assertion::BEGIN_LINE: return Assertion::END_LINE;
+            case Assertion::END_LINE: return Assertion::BEGIN_LINE;
+            case Assertion::BEGIN_LINE_CR: return Assertion::END_LINE_CR;
+            case Assertion::END_LINE_CR: return Assertion::BEGIN_LINE_CR;
+            case Assertion::NOT_WORD_BOUNDARY: return Assertion::NOT_WORD_BOUNDARY_REVERSED;
+            case Assertion::NOT_WORD_BOUNDARY_REVERSED: return Assertion::NOT_WORD_BOUNDARY;
+            default: return assertion;
+        }
+    }
+
+    // The context bits an assertion reads.
+    unsigned contextRead(Assertion assertion) {
+        switch (assertion) {
+            case Assertion::BEGIN_TEXT: return AT_START;
+            case Assertion::BEGIN_LINE: return AT_START | AFTER_NEWLINE;
+            case Assertion::BEGIN_LINE_CR: return AT_START | AFTER_NEWLINE | AFTER_CR;
+            case Assertion::WORD_BOUNDARY:
+            case Assertion::NOT_WORD_BOUNDARY: return AFTER_WORD;
+            case Assertion::NOT_WORD_BOUNDARY_REVERSED: return AFTER_WORD | AFTER_CONTINUATION;
+            default: return 0;
+        }
+    }
+
+    // ---- Character classes ------------------------------------------------
+
+    struct CodeRange {
+        std::uint32_t low;
+        std::uint32_t high;
+    };
+    using CodeRanges = std::vector<CodeRange>;
+
+    // Sorts and merges overlapping and touching ranges.
+    void normalize(CodeRanges& ranges) {
+        std::sort(ranges.begin(), ranges.end(), [](const CodeRange& a, const CodeRange& b) { return a.low < b.low; });
+        size_t kept = 0;
+        for (const CodeRange& range : ranges) {
+            if (kept > 0 && range.low <= ranges[kept - 1].high + 1) {
+                ranges[kept - 1].high = std::max(ranges[kept - 1].high, range.high);
+            } else {
+                ranges[kept++] = range;
+            }
+        }
+        ranges.resize(kept);
+    }
+
+    // Everything a normalized class leaves out.
+    CodeRanges negate(const CodeRanges& ranges) {
+        CodeRanges result;
+        std::uint32_t next = 0;
+        for (const CodeRange& range : ranges) {
+            if (range.low > next) result.push_back({next, range.low - 1});
+            next = range.high + 1;
+        }
+        if (next <= MAX_CODEPOINT) result.push_back({next, MAX_CODEPOINT});
+        return result;
+    }
+
+    // Adds the other case of every ASCII letter in the class.
+    void addOtherCase(CodeRanges& ranges) {
+        size_t count = ranges.size();
+        for (size_t i = 0; i < count; ++i) {
+            std::uint32_t low = std::max<std::uint32_t>(ranges[i].low, 'A');
+            std::uint32_t high = std::min<std::uint32_t>(ranges[i].high, 'Z');
+            if (low <= high) ranges.push_back({low + 32, high + 32});
+            low = std::max<std::uint32_t>(ranges[i].low, 'a');
+            high = std::min<std::uint32_t>(ranges[i].high, 'z');
+            if (low <= high) ranges.push_back({low - 32, high - 32});
+        }
+        normalize(ranges);
+    }
+
+    // Takes "\n" out of the class.
+    void removeNewline(CodeRanges& ranges) {
+        CodeRanges result;
+        for (const CodeRange& range : ranges) {
+            if (range.low <= '\n' && range.high >= '\n') {
+                if (range.low < '\n') result.push_back({range.low, '\n' - 1});
+                if (range.high > '\n') result.push_back({'\n' + 1, range.high});
+            } else {
+                result.push_back(range);
+            }
+        }
+        ranges = std::move(result);
+    }
+
+    // \d, \w, \s and their negations; ASCII only, like string.toUpperCase.
+    CodeRanges perlClass(char name) {
+        static const CodeRanges DIGITS = {{'0', '9'}};
+        static const CodeRanges WORD = {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}};
+        static const CodeRanges SPACE = {{'\t', '\r'}, {' ', ' '}};
+        char lower = static_cast<char>(name | 0x20);
+        const CodeRanges& ranges = lower == 'd' ? DIGITS : lower == 'w' ? WORD : SPACE;
+        return name >= 'A' && name <= 'Z' ? negate(ranges) : ranges;
+    }
+
+    // [:alpha:] and the like, inside brackets. Returns false for an unknown name.
+    bool posixClass(const std::string& name, CodeRanges& ranges) {
+        static const std::map<std::string, CodeRanges> CLASSES = {
+            {"alnum", {{'0', '9'}, {'A', 'Z'}, {'a', 'z'}}},
+            {"alpha", {{'A', 'Z'}, {'a', 'z'}}},
+            {"blank", {{'\t', '\t'}, {' ', ' '}}},
+            {"cntrl", {{0, 0x1F}, {0x7F, 0x7F}}},
+            {"digit", {{'0', '9'}}},
+            {"graph", {{'!', '~'}}},
+            {"lower", {{'a', 'z'}}},
+            {"print", {{' ', '~'}}},
+            {"punct", {{'!', '/'}, {':', '@'}, {'[', '`'}, {'{', '~'}}},
+            {"space", {{'\t', '\r'}, {' ', ' '}}},
+            {"upper", {{'A', 'Z'}}},
+            {"word", {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}}},
+            {"xdigit", {{'0', '9'}, {'A', 'F'}, {'a', 'f'}}},
+        };
+        bool negated = !name.empty() && name[0] == '^';
+        auto found = CLASSES.find(negated ? name.substr(1) : name);
+        if (found == CLASSES.end()) return false;
+        CodeRanges members = negated ? negate(found->second) : found->second;
+        ranges.insert(ranges.end(), members.begin(), members.end());
+        return true;
+    }
+
+    // ---- UTF-8 ------------------------------------------------------------
+
+    size_t encodeUtf8(std::uint32_t codepoint, unsigned char* out) {
+        if (codepoint < 0x80) {
+            out[0] = static_cast<unsigned char>(codepoint);
+            return 1;
+        }
+        if (codepoint < 0x800) {
+            out[0] = static_cast<unsigned char>(0xC0 | (codepoint >> 6));
+            out[1] = static_cast<unsigned char>(0x80 | (codepoint & 0x3F));
+            return 2;
+        }
+        if (codepoint < 0x10000) {
+            out[0] = static_cast<unsigned char>(0xE0 | (codepoint >> 12));
+            out[1] = static_cast<unsigned char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out[2] = static_cast<unsigned char>(0x80 | (codepoint & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<unsigned char>(0xF0 | (codepoint >> 18));
+        out[1] = static_cast<unsigned char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out[2] = static_cast<unsigned char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out[3] = static_cast<unsigned char>(0x80 | (codepoint & 0x3F));
+        return 4;
+    }
+
+    // The encodings of a run of characters, as a byte range per position.
+    struct Utf8Sequence {
+        unsigned char low[4];
+        unsigned char high[4];
+        size_t length;
+    };
+
+    // Splits [low, high] into runs whose encodings are each a range of
+    // bytes at every position, as in Russ Cox's utf8 package. Surrogates,
+    // which UTF-8 cannot hold, are left out.
+    void utf8Sequences(std::uint32_t low, std::uint32_t high, std::vector<Utf8Sequence>& out) {
+        if (low <= 0xDFFF && high >= 0xD800) {
+            if (low < 0xD800) utf8Sequences(low, 0xD7FF, out);
+            if (high > 0xDFFF) utf8Sequences(0xE000, high, out);
+            return;
+        }
+        // Encodings of different lengths.
+        static const std::uint32_t LENGTH_LIMITS[] = {0x7F, 0x7FF, 0xFFFF};
+        for (std::uint32_t limit : LENGTH_LIMITS) {
+            if (low <= limit && high > limit) {
+                utf8Sequences(low, limit, out);
+                utf8Sequences(limit + 1, high, out);
+                return;
+            }
+        }
+        // Runs whose continuation bytes do not each cover a whole range.
+        for (unsigned i = 1; i < 4; ++i) {
+            std::uint32_t mask = (1u << (6 * i)) - 1;
+            if ((low & ~mask) != (high & ~mask)) {
+                if ((low & mask) != 0) {
+                    utf8Sequences(low, low | mask, out);
+                    utf8Sequences((low | mask) + 1, high, out);
+                    return;
+                }
+                if ((high & mask) != mask) {
+                    utf8Sequences(low, (high & ~mask) - 1, out);
+                    utf8Sequences(high & ~mask, high, out);
+                    return;
+                }
+            }
+        }
+        Utf8Sequence sequence;
+        sequence.length = encodeUtf8(low, sequence.low);
+        encodeUtf8(high, sequence.high);
+        out.push_back(sequence);
+    }
+
+    // ---- Parsing ----------------------------------------------------------
+
+    struct Node {
+        enum class Kind { EMPTY, LITERAL, CLASS, CONCAT, ALTERNATE, REPEAT, GROUP, ASSERT };
+
+        explicit Node(Kind kind) : kind(kind) {}
+
+        Kind kind;
+        std::uint32_t codepoint = 0;                 // LITERAL
+        CodeRanges ranges;                           // CLASS: normalized
+        std::vector<std::unique_ptr<Node>> children;
+        int min = 0;                                 // REPEAT
+        int max = 0;                                 // REPEAT: -1 for no limit
+        bool greedy = true;                          // REPEAT
+        int group = 0;                               // GROUP: its number, 0 if it captures nothing
+        Assertion assertion = Assertion::BEGIN_TEXT; // ASSERT
+    };
+    using NodePtr = std::unique_ptr<Node>;
+
+    // Parses the syntax of RE2 and Go's regexp, less Unicode classes.
+    class Parser {
+    public:
+        Parser(const std::string& pattern, unsigned flags) : pattern(pattern), initial_flags(flags) {}
+
+        NodePtr parse() {
+            unsigned flags = initial_flags;
+            NodePtr root = parseAlternation(flags, 0);
+            if (position < pattern.size()) fail("unmatched ')'");
+            return root;
+        }
+
+        // The name of each group, "" for unnamed ones.
+        std::vector<std::string> names;
+
+    private:
+        [[noreturn]] void fail(const std::string& message) const {
+            throw Common::NyxRuntimeException("Invalid regex '" + pattern + "' at offset " + std::to_string(position) + ": " + message + ".", 0);
+        }
+
+        bool atEnd() const { return position >= pattern.size(); }
+        char peek() const { return pattern[position]; }
+        bool consume(char c) {
+            if (atEnd() || pattern[position] != c) return false;
+            ++position;
+            return true;
+        }
+
+        static NodePtr make(Node::Kind kind) { return std::make_unique<Node>(kind); }
+
+        NodePtr parseAlternation(unsigned& flags, int depth) {
+            if (depth > MAX_NESTING) fail("groups are nested more than " + std::to_string(MAX_NESTING) + " deep");
+            std::vector<NodePtr> branches;
+            branches.push_back(parseSequence(flags, depth));
+            while (consume('|')) branches.push_back(parseSequence(flags, depth));
+            if (branches.size() == 1) return std::move(branches[0]);
+            NodePtr node = make(Node::Kind::ALTERNATE);
+            node->children = std::move(branches);
+            return node;
+        }
+
+        NodePtr parseSequence(unsigned& flags, int depth) {
+            std::vector<NodePtr> items;
+            while (!atEnd() && peek() != '|' && peek() != ')') {
+                NodePtr atom = parseAtom(flags, depth);
+                // A group of flags alone, such as "(?i)", matches nothing.
+                if (atom) items.push_back(parseRepeat(std::move(atom)));
+            }
+            if (items.empty()) return make(Node::Kind::EMPTY);
+            if (items.size() == 1) return std::move(items[0]);
+            NodePtr node = make(Node::Kind::CONCAT);
+            node->children = std::move(items);
+            return node;
+        }
+
+        NodePtr parseRepeat(NodePtr atom) {
+            int min = 0;
+            int max = 0;
+            if (consume('*')) {
+                max = -1;
+            } else if (consume('+')) {
+                min = 1;
+                max = -1;
+            } else if (consume('?')) {
+                max = 1;
+            } else if (!parseCounts(min, max)) {
+                return atom;
+            }
+            bool greedy = !consume('?');
+            if (!atEnd() && (peek() == '*' || peek() == '+' || peek() == '?' || startsCounts())) {
+                fail("a repetition cannot be repeated without a group around it");
+            }
+            NodePtr node = make(Node::Kind::REPEAT);
+            node->min = min;
+            node->max = max;
+            node->greedy = greedy;
+            node->children.push_back(std::move(atom));
+            return node;
+        }
+
+        // "{n}", "{n,}" or "{n,m}". Anything else, like "{x}", leaves the
+        // position alone and is read as literal text.
+        bool parseCounts(int& min, int& max) {
+            if (atEnd() || peek() != '{') return false;
+            size_t start = position;
+            ++position;
+            auto number = [&](int& value) {
+                size_t first = position;
+                long long parsed = 0;
+                while (!atEnd() && peek() >= '0' && peek() <= '9') {
+                    parsed = std::min<long long>(parsed * 10 + (peek() - '0'), 1000000);
+                    ++position;
+                }
+                value = static_cast<int>(parsed);
+                return position > first;
+            };
+            if (!number(min)) {
+                position = start;
+                return false;
+            }
+            max = min;
+            if (consume(',')) {
+                if (!number(max)) max = -1;
+            }
+            if (!consume('}')) {
+                position = start;
+                return false;
+            }
+            if (min > MAX_REPEAT || max > MAX_REPEAT) fail("repetition counts go up to " + std::to_string(MAX_REPEAT));
+            if (max != -1 && max < min) fail("the repetition's maximum is below its minimum");
+            return true;
+        }
+
+        bool startsCounts() {
+            size_t start = position;
+            int min = 0;
+            int max = 0;
+            bool counts = parseCounts(min, max);
+            position = start;
+            return counts;
+        }
+
+        NodePtr parseAtom(unsigned& flags, int depth) {
+            char c = peek();
+            switch (c) {
+                case '(':
+                    return parseGroup(flags, depth);
+                case '[':
+                    return classNode(parseClass(flags), flags);
+                case '.':
+                    ++position;
+                    if (flags & DOT_ALL) return classNode({{0, MAX_CODEPOINT}}, flags);
+                    return classNode({{0, '\n' - 1}, {'\n' + 1, MAX_CODEPOINT}}, flags);
+                case '^':
+                    ++position;
+                    return assertNode(flags & MULTILINE ? Assertion::BEGIN_LINE : Assertion::BEGIN_TEXT, flags);
+                case '$':
+                    ++position;
+                    return assertNode(flags & MULTILINE ? Assertion::END_LINE : Assertion::END_TEXT, flags);
+                case '\\':
+                    return parseEscape(flags);
+                case '*': case '+': case '?':
+                    fail(std::string("'") + c + "' has nothing before it to repeat");
+                case '{':
+                    if (startsCounts()) fail("'{' has nothing before it to repeat");
+                    break;
+                default:
+                    break;
+            }
+            return literalNode(decodeCharacter(), flags);
+        }
+
+        NodePtr parseGroup(unsigned& flags, int depth) {
+            ++position;
+            int group = 0;
+            unsigned group_flags = flags;
+            if (consume('?')) {
+                if (consume(':')) {
+                    // Groups without a number.
+                } else if (!atEnd() && (peek() == '=' || peek() == '!' ||
+                                        (peek() == '<' && position + 1 < pattern.size() && (pattern[position + 1] == '=' || pattern[position + 1] == '!')))) {
+                    fail("lookahead and lookbehind are not supported (matching takes linear time)");
+                } else if (consume('<')) {
+                    group = addGroup(parseGroupName());
+                } else if (consume('P')) {
+                    if (!consume('<')) fail("expected '<' after '(?P'");
+                    group = addGroup(parseGroupName());
+                } else {
+                    // Flags: "(?i)" for the rest of the group, "(?i:...)" for what it holds.
+                    bool on = true;
+                    unsigned changed = flags;
+                    for (;;) {
+                        if (atEnd()) fail("missing ')'");
+                        char c = pattern[position++];
+                        if (c == ')' || c == ':') {
+                            if (c == ')') {
+                                flags = changed;
+                                return nullptr;
+                            }
+                            group_flags = changed;
+                            break;
+                        }
+                        unsigned bit = c == 'i' ? CASE_INSENSITIVE : c == 'm' ? MULTILINE : c == 's' ? DOT_ALL : 0;
+                        if (c == '-' && on) {
+                            on = false;
+                        } else if (bit != 0) {
+                            changed = on ? (changed | bit) : (changed & ~bit);
+                        } else {
+                            --position;
+                            fail(std::string("unknown flag '") + c + "' (flags are i, m and s)");
+                        }
+                    }
+                }
+            } else {
+                group = addGroup("");
+            }
+            NodePtr body = parseAlternation(group_flags, depth + 1);
+            if (!consume(')')) fail("missing ')'");
+            NodePtr node = make(Node::Kind::GROUP);
+            node->group = group;
+            node->children.push_back(std::move(body));
+            return node;
+        }
+
+        std::string parseGroupName() {
+            size_t start = position;
+            while (!atEnd() && peek() != '>') {
+                char c = peek();
+                bool valid = isWordByte(static_cast<unsigned char>(c)) && !(position == start && c >= '0' && c <= '9');
+                if (!valid) fail("group names are letters, digits and '_', not starting with a digit");
+                ++position;
+            }
+            if (atEnd()) fail("missing '>' after the group name");
+            std::string name = pattern.substr(start, position - start);
+            ++position;
+            if (name.empty()) fail("the group name is empty");
+            if (std::find(names.begin(), names.end(), name) != names.end()) fail("there is already a group named '" + name + "'");
+            return name;
+        }
+
+        int addGroup(const std::string& name) {
+            names.push_back(name);
+            return static_cast<int>(names.size());
+        }
+
+        NodePtr parseEscape(unsigned flags) {
+            ++position;
+            if (atEnd()) fail("the pattern ends with '\\'");
+            char c = pattern[position];
+            switch (c) {
+                case 'd': case 'D': case 'w': case 'W': case 's': case 'S':
+                    ++position;
+                    return classNode(perlClass(c), flags);
+                case 'b':
+                    ++position;
+                    return assertNode(Assertion::WORD_BOUNDARY, flags);
+                case 'B':
+                    ++position;
+                    return assertNode(Assertion::NOT_WORD_BOUNDARY, flags);
+                case 'A':
+                    ++position;
+                    return assertNode(Assertion::BEGIN_TEXT, flags);
+                case 'z':
+                    ++position;
+                    return assertNode(Assertion::END_TEXT, flags);
+                default:
+                    if (c >= '1' && c <= '9') fail("backreferences are not supported (matching takes linear time)");
+                    return literalNode(escapedCharacter(), flags);
+            }
+        }
+
+        // The character a "\x" escape stands for, starting at 'x'.
+        std::uint32_t escapedCharacter() {
+            char c = pattern[position++];
+            switch (c) {
+                case 'n': return '\n';
+                case 't': return '\t';
+                case 'r': return '\r';
+                case 'f': return '\f';
+                case 'v': return '\v';
+                case 'a': return '\a';
+                case 'e': return 0x1B;
+                case '0': return 0;
+                case 'x': return parseHex();
+                default:
+                    break;
+            }
+            if (static_cast<unsigned char>(c) < 0x80 && !isWordByte(static_cast<unsigned char>(c)) && c > ' ') return static_cast<unsigned char>(c);
+            --position;
+            fail(std::string("unknown escape '\\") + c + "'");
+        }
+
+        // "\xHH" or "\x{H...}", after the 'x'.
+        std::uint32_t parseHex() {
+            auto digit = [](char c) -> int {
+                if (c >= '0' && c <= '9') return c - '0';
+                if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+                if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+                return -1;
+            };
+            std::uint32_t value = 0;
+            if (consume('{')) {
+                size_t digits = 0;
+                while (!atEnd() && digit(peek()) >= 0) {
+                    value = value * 16 + static_cast<std::uint32_t>(digit(peek()));
+                    if (value > MAX_CODEPOINT) fail("the character code is above 10FFFF");
+                    ++position;
+                    ++digits;
+                }
+                if (digits == 0 || !consume('}')) fail("expected hex digits and '}' after '\\x{'");
+            } else {
+                for (int i = 0; i < 2; ++i) {
+                    if (atEnd() || digit(peek()) < 0) fail("expected two hex digits after '\\x'");
+                    value = value * 16 + static_cast<std::uint32_t>(digit(peek()));
+                    ++position;
+                }
+            }
+            if (value >= 0xD800 && value <= 0xDFFF) fail("surrogates are not characters");
+            return value;
+        }
+
+        std::uint32_t decodeCharacter() {
+            unsigned char lead = static_cast<unsigned char>(pattern[position]);
+            size_t length = lead < 0x80 ? 1 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC2 ? 2 : 0;
+            if (length == 0 || position + length > pattern.size()) fail("the pattern is not valid UTF-8");
+            std::uint32_t codepoint = length == 1 ? lead : lead & (0xFF >> (length + 1));
+            for (size_t i = 1; i < length; ++i) {
+                unsigned char next = static_cast<unsigned char>(pattern[position + i]);
+                if ((next & 0xC0) != 0x80) fail("the pattern is not valid UTF-8");
+                codepoint = (codepoint << 6) | (next & 0x3F);
+            }
+            static const std::uint32_t SMALLEST[] = {0, 0, 0x80, 0x800, 0x10000};
+            if (codepoint < SMALLEST[length] || codepoint > MAX_CODEPOINT || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+                fail("the pattern is not valid UTF-8");
+            }
+            position += length;
+            return codepoint;
+        }
+
+        CodeRanges parseClass(unsigned flags) {
+            ++position;
+            bool negated = consume('^');
+            CodeRanges ranges;
+            bool first = true;
+            for (;;) {
+                if (atEnd()) fail("missing ']'");
+                if (peek() == ']' && !first) {
+                    ++position;
+                    break;
+                }
+                first = false;
+                if (pattern.compare(position, 2, "[:") == 0) {
+                    size_t close = pattern.find(":]", position + 2);
+                    if (close != std::string::npos) {
+                        std::string name = pattern.substr(position + 2, close - position - 2);
+                        if (!posixClass(name, ranges)) fail("unknown class '[:" + name + ":]'");
+                        position = close + 2;
+                        continue;
+                    }
+                }
+                if (peek() == '\\' && position + 1 < pattern.size()) {
+                    char c = pattern[position + 1];
+                    if (c == 'd' || c == 'D' || c == 'w' || c == 'W' || c == 's' || c == 'S') {
+                        position += 2;
+                        CodeRanges members = perlClass(c);
+                        ranges.insert(ranges.end(), members.begin(), members.end());
+                        continue;
+                    }
+                }
+                std::uint32_t low = classCharacter();
+                std::uint32_t high = low;
+                if (!atEnd() && peek() == '-' && position + 1 < pattern.size() && pattern[position + 1] != ']') {
+                    ++position;
+                    high = classCharacter();
+                    if (high < low) fail("the range ends before it starts");
+                }
+                ranges.push_back({low, high});
+            }
+            normalize(ranges);
+            // Folded before negating, so "[^a]" leaves out 'A' too.
+            if (flags & CASE_INSENSITIVE) addOtherCase(ranges);
+            return negated ? negate(ranges) : ranges;
+        }
+
+        std::uint32_t classCharacter() {
+            if (atEnd()) fail("missing ']'");
+            if (peek() != '\\') return decodeCharacter();
+            ++position;
+            if (atEnd()) fail("the pattern ends with '\\'");
+            return escapedCharacter();
+        }
+
+        NodePtr literalNode(std::uint32_t codepoint, unsigned flags) {
+            bool letter = (codepoint >= 'A' && codepoint <= 'Z') || (codepoint >= 'a' && codepoint <= 'z');
+            if (((flags & CASE_INSENSITIVE) && letter) || ((flags & LINES) && codepoint == '\n')) {
+                return classNode({{codepoint, codepoint}}, flags);
+            }
+            NodePtr node = make(Node::Kind::LITERAL);
+            node->codepoint = codepoint;
+            return node;
+        }
+
+        NodePtr classNode(CodeRanges ranges, unsigned flags) {
+            normalize(ranges);
+            if (flags & CASE_INSENSITIVE) addOtherCase(ranges);
+            if (flags & LINES) removeNewline(ranges);
+            if (ranges.size() == 1 && ranges[0].low == ranges[0].high) {
+                NodePtr node = make(Node::Kind::LITERAL);
+                node->codepoint = ranges[0].low;
+                return node;
+            }
+            NodePtr node = make(Node::Kind::CLASS);
+            node->ranges = std::move(ranges);
+            return node;
+        }
+
+        NodePtr assertNode(Assertion assertion, unsigned flags) {
+            // Each line is a text of its own.
+            if (flags & LINES) {
+                if (assertion == Assertion::BEGIN_TEXT) assertion = Assertion::BEGIN_LINE;
+                if (assertion == Assertion::END_TEXT || assertion == Assertion::END_LINE) assertion = Assertion::END_LINE_CR;
+            }
+            NodePtr node = make(Node::Kind::ASSERT);
+            node->assertion = assertion;
+            return node;
+        }
+
+        const std::string& pattern;
+        unsigned initial_flags;
+        size_t position = 0;
+    };
+
+    // ---- Compiling --------------------------------------------------------
+
+    // An instruction of the automaton, which reads bytes.
+    struct Inst {
+        enum class Op : std::uint8_t { RANGE, SPLIT, SAVE, ASSERT, MATCH, NOP, FAIL };
+
+        Op op = Op::NOP;
+        unsigned char low = 0;                       // RANGE: the bytes it reads
+        unsigned char high = 0;
+        Assertion assertion = Assertion::BEGIN_TEXT; // ASSERT
+        std::uint32_t out = 0;                       // the next instruction; SPLIT's preferred one
+        std::uint32_t out1 = 0;                      // SPLIT's other one
+        std::uint32_t slot = 0;                      // SAVE: where the position goes
+    };
+
+    struct Program {
+        std::vector<Inst> insts;
+        std::uint32_t start = 0;     // matches starting here
+        std::uint32_t loop = 0;      // tries `start` at every position, lowest priority first
+        unsigned context_mask = 0;   // the context bits assertions read
+        size_t slot_count = 0;
+        // Bytes that no instruction tells apart share a class; the DFA has a
+        // transition per class rather than per byte. Class `class_count`
+        // stands for the end of the text.
+        std::uint8_t byte_class[256] = {};
+        unsigned class_count = 0;
+        std::vector<unsigned char> class_bytes; // a byte of each class
+    };
+
+    class Compiler {
+    public:
+        Compiler(Program& program, bool reverse, const std::string& pattern) : program(program), reverse(reverse), pattern(pattern) {}
+
+        // The reverse program reads the text backwards, from the end of a
+        // match to its start, and keeps no groups.
+        void compile(const Node& root, size_t group_count) {
+            Fragment body = fragment(root);
+            if (!reverse) body = concat(save(0), concat(body, save(1)));
+            std::uint32_t match = emit(Inst::Op::MATCH);
+            patch(body.holes, match);
+            program.start = body.start;
+            program.loop = emit(Inst::Op::SPLIT);
+            std::uint32_t any = emit(Inst::Op::RANGE);
+            program.insts[any].low = 0;
+            program.insts[any].high = 255;
+            program.insts[any].out = program.loop;
+            program.insts[program.loop].out = program.start;
+            program.insts[program.loop].out1 = any;
+            program.slot_count = 2 * (group_count + 1);
+            computeClasses();
+        }
+
+    private:
+        // A piece of the program with a start and loose ends ("holes"),
+        // each an instruction's out (even) or out1 (odd), to be pointed at
+        // whatever comes next.
+        struct Fragment {
+            std::uint32_t start;
+            std::vector<std::uint32_t> holes;
+        };
+
+        std::uint32_t emit(Inst::Op op) {
+            if (program.insts.size() >= MAX_INSTRUCTIONS) {
+                throw Common::NyxRuntimeException("Invalid regex '" + pattern + "': the pattern is too large once its repetitions are expanded.", 0);
+            }
+            Inst inst;
+            inst.op = op;
+            program.insts.push_back(inst);
+            return static_cast<std::uint32_t>(program.insts.size() - 1);
+        }
+
+        void patch(const std::vector<std::uint32_t>& holes, std::uint32_t target) {
+            for (std::uint32_t hole : holes) {
+                Inst& inst = program.insts[hole / 2];
+                (hole % 2 == 0 ? inst.out : inst.out1) = target;
+            }
+        }
+
+        Fragment single(Inst::Op op) {
+            std::uint32_t pc = emit(op);
+            return {pc, {pc * 2}};
+        }
+
+        Fragment save(std::uint32_t slot) {
+            Fragment fragment = single(Inst::Op::SAVE);
+            program.insts[fragment.start].slot = slot;
+            return fragment;
+        }
+
+        Fragment range(unsigned char low, unsigned char high) {
+            Fragment fragment = single(Inst::Op::RANGE);
+            program.insts[fragment.start].low = low;
+            program.insts[fragment.start].high = high;
+            return fragment;
+        }
+
+        Fragment concat(Fragment first, Fragment second) {
+            patch(first.holes, second.start);
+            return {first.start, std::move(second.holes)};
+        }
+
+        // Prefers `first`.
+        Fragment either(Fragment first, Fragment second) {
+            std::uint32_t split = emit(Inst::Op::SPLIT);
+            program.insts[split].out = first.start;
+            program.insts[split].out1 = second.start;
+            first.holes.insert(first.holes.end(), second.holes.begin(), second.holes.end());
+            return {split, std::move(first.holes)};
+        }
+
+        Fragment optional(Fragment body, bool greedy) {
+            std::uint32_t split = emit(Inst::Op::SPLIT);
+            (greedy ? program.insts[split].out : program.insts[split].out1) = body.start;
+            body.holes.push_back(split * 2 + (greedy ? 1 : 0));
+            return {split, std::move(body.holes)};
+        }
+
+        Fragment star(const Node& child, bool greedy) {
+            std::uint32_t split = emit(Inst::Op::SPLIT);
+            Fragment body = fragment(child);
+            patch(body.holes, split);
+            (greedy ? program.insts[split].out : program.insts[split].out1) = body.start;
+            return {split, {split * 2 + (greedy ? 1 : 0)}};
+        }
+
+        Fragment plus(const Node& child, bool greedy) {
+            Fragment body = fragment(child);
+            std::uint32_t split = emit(Inst::Op::SPLIT);
+            patch(body.holes, split);
+            (greedy ? program.insts[split].out : program.insts[split].out1) = body.start;
+            return {body.start, {split * 2 + (greedy ? 1 : 0)}};
+        }
+
+        Fragment repeat(const Node& node) {
+            const Node& child = *node.children[0];
+            if (node.max == -1) {
+                if (node.min == 0) return star(child, node.greedy);
+                // x{n,} is n - 1 copies of x, then x+.
+                Fragment result = plus(child, node.greedy);
+                for (int i = 1; i < node.min; ++i) result = reverse ? concat(result, fragment(child)) : concat(fragment(child), result);
+                return result;
+            }
+            if (node.max == 0) return single(Inst::Op::NOP);
+            // x{n,m} is n copies of x, then m - n nested optional copies:
+            // x{1,3} is x(x(x)?)?.
+            Fragment tail{0, {}};
+            bool have_tail = false;
+            for (int i = node.min; i < node.max; ++i) {
+                Fragment copy = fragment(child);
+                if (have_tail) copy = reverse ? concat(tail, copy) : concat(copy, tail);
+                tail = optional(std::move(copy), node.greedy);
+                have_tail = true;
+            }
+            Fragment result = have_tail ? std::move(tail) : fragment(child);
+            int fixed = have_tail ? node.min : node.min - 1;
+            for (int i = 0; i < fixed; ++i) result = reverse ? concat(result, fragment(child)) : concat(fragment(child), result);
+            return result;
+        }
+
+        Fragment literal(std::uint32_t codepoint) {
+            unsigned char bytes[4];
+            size_t length = encodeUtf8(codepoint, bytes);
+            if (reverse) std::reverse(bytes, bytes + length);
+            Fragment result = range(bytes[0], bytes[0]);
+            for (size_t i = 1; i < length; ++i) result = concat(std::move(result), range(bytes[i], bytes[i]));
+            return result;
+        }
+
+        // The class's UTF-8 sequences, sharing instructions for common
+        // endings, joined by splits.
+        Fragment characterClass(const CodeRanges& ranges) {
+            std::vector<Utf8Sequence> sequences;
+            for (const CodeRange& range : ranges) utf8Sequences(range.low, range.high, sequences);
+            if (sequences.empty()) return {emit(Inst::Op::FAIL), {}};
+            std::uint32_t join = emit(Inst::Op::NOP);
+            std::map<std::uint64_t, std::uint32_t> shared;
+            auto byteRange = [&](unsigned char low, unsigned char high, std::uint32_t next) {
+                std::uint64_t key = (static_cast<std::uint64_t>(next) << 16) | (static_cast<std::uint64_t>(low) << 8) | high;
+                auto found = shared.find(key);
+                if (found != shared.end()) return found->second;
+                std::uint32_t pc = emit(Inst::Op::RANGE);
+                program.insts[pc].low = low;
+                program.insts[pc].high = high;
+                program.insts[pc].out = next;
+                shared.emplace(key, pc);
+                return pc;
+            };
+            std::vector<std::uint32_t> starts;
+            for (Utf8Sequence& sequence : sequences) {
+                if (reverse) {
+                    std::reverse(sequence.low, sequence.low + sequence.length);
+                    std::reverse(sequence.high, sequence.high + sequence.length);
+                }
+                std::uint32_t next = join;
+                for (size_t i = sequence.length; i-- > 0;) next = byteRange(sequence.low[i], sequence.high[i], next);
+                if (std::find(starts.begin(), starts.end(), next) == starts.end()) starts.push_back(next);
+            }
+            std::uint32_t start = starts.back();
+            for (size_t i = starts.size() - 1; i-- > 0;) {
+                std::uint32_t split = emit(Inst::Op::SPLIT);
+                program.insts[split].out = starts[i];
+                program.insts[split].out1 = start;
+                start = split;
+            }
+            return {start, {join * 2}};
+        }
+
+        Fragment fragment(const Node& node) {
+            switch (node.kind) {
+                case Node::Kind::EMPTY:
+                    return single(Inst::Op::NOP);
+                case Node::Kind::LITERAL:
+                    return literal(node.codepoint);
+                case Node::Kind::CLASS:
+                    return characterClass(node.ranges);
+                case Node::Kind::CONCAT: {
+                    size_t count = node.children.size();
+                    Fragment result = fragment(*node.children[reverse ? count - 1 : 0]);
+                    for (size_t i = 1; i < count; ++i) {
+                        result = concat(std::move(result), fragment(*node.children[reverse ? count - 1 - i : i]));
+                    }
+                    return result;
+                }
+                case Node::Kind::ALTERNATE: {
+                    Fragment result = fragment(*node.children.back());
+                    for (size_t i = node.children.size() - 1; i-- > 0;) result = either(fragment(*node.children[i]), std::move(result));
+                    return result;
+                }
+                case Node::Kind::REPEAT:
+                    return repeat(node);
+                case Node::Kind::GROUP:
+                    if (node.group == 0 || reverse) return fragment(*node.children[0]);
+                    return concat(save(2 * node.group), concat(fragment(*node.children[0]), save(2 * node.group + 1)));
+                case Node::Kind::ASSERT: {
+                    Fragment result = single(Inst::Op::ASSERT);
+                    program.insts[result.start].assertion = reverse ? reversed(node.assertion) : node.assertion;
+                    return result;
+                }
+            }
+            return single(Inst::Op::NOP);
+        }
+
+        void computeClasses() {
+            bool boundary[257] = {};
+            bool word_assertions = false;
+            for (const Inst& inst : program.insts) {
+                if (inst.op == Inst::Op::RANGE) {
+                    boundary[inst.low] = true;
+                    boundary[inst.high + 1] = true;
+                } else if (inst.op == Inst::Op::ASSERT) {
+                    program.context_mask |= contextRead(inst.assertion);
+                    word_assertions = word_assertions || inst.assertion == Assertion::WORD_BOUNDARY || inst.assertion == Assertion::NOT_WORD_BOUNDARY ||
+                                      inst.assertion == Assertion::NOT_WORD_BOUNDARY_REVERSED;
+                }
+            }
+            // Assertions look at the byte that comes next.
+            for (int c : {int('\n'), int('\r')}) boundary[c] = boundary[c + 1] = true;
+            if (word_assertions) {
+                static const int WORD_EDGES[] = {'0', '9' + 1, 'A', 'Z' + 1, '_', '_' + 1, 'a', 'z' + 1, 0x80, 0xC0};
+                for (int c : WORD_EDGES) boundary[c] = true;
+            }
+            unsigned current = 0;
+            for (int c = 0; c < 256; ++c) {
+                if (c > 0 && boundary[c]) ++current;
+                program.byte_class[c] = static_cast<std::uint8_t>(current);
+                if (program.class_bytes.size() == current) program.class_bytes.push_back(static_cast<unsigned char>(c));
+            }
+            program.class_count = current + 1;
+        }
+
+        Program& program;
+        bool reverse;
+        const std::string& pattern;
+    };
+
+    // ---- Literal prefixes -------------------------------------------------
+
+    struct Prefix {
+        std::string text;            // every match starts with this
+        bool complete = true;        // ... and, so far, is nothing else
+        bool has_assertion = false;
+    };
+
+    void collectPrefix(const Node& node, Prefix& prefix) {
+        switch (node.kind) {
+            case Node::Kind::EMPTY:
+                return;
+            case Node::Kind::LITERAL: {
+                unsigned char bytes[4];
+                prefix.text.append(reinterpret_cast<const char*>(bytes), encodeUtf8(node.codepoint, bytes));
+                return;
+            }
+            case Node::Kind::CONCAT:
+                for (const NodePtr& child : node.children) {
+                    collectPrefix(*child, prefix);
+                    if (!prefix.complete) return;
+                }
+                return;
+            case Node::Kind::GROUP:
+                collectPrefix(*node.children[0], prefix);
+                return;
+            case Node::Kind::ASSERT:
+                prefix.has_assertion = true;
+                return;
+            case Node::Kind::REPEAT:
+                if (node.min > 0) collectPrefix(*node.children[0], prefix);
+                if (node.min != 1 || node.max != 1) prefix.complete = false;
+                return;
+            default:
+                prefix.complete = false;
+                return;
+        }
+    }
+
+    // Whether every match starts at the start of the text.
+    bool startsAnchored(const Node& node) {
+        switch (node.kind) {
+            case Node::Kind::ASSERT:
+                return node.assertion == Assertion::BEGIN_TEXT;
+            case Node::Kind::CONCAT:
+            case Node::Kind::GROUP:
+                return startsAnchored(*node.children[0]);
+            case Node::Kind::REPEAT:
+                return node.min > 0 && startsAnchored(*node.children[0]);
+            case Node::Kind::ALTERNATE:
+                for (const NodePtr& child : node.children) {
+                    if (!startsAnchored(*child)) return false;
+                }
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Where a search can skip ahead to: the next place a match could start.
+    struct Prefilter {
+        std::string literal;           // the prefix of every match, or if empty
+        unsigned char bytes[3] = {};   // the bytes every match starts with
+        size_t byte_count = 0;
+
+        size_t find(const unsigned char* text, size_t from, size_t length) const {
+            const char* data = reinterpret_cast<const char*>(text) + from;
+            if (!literal.empty()) return from + RegexKernels::findLiteral(data, length - from, literal.data(), literal.size());
+            return from + RegexKernels::findAnyByte(data, length - from, bytes, byte_count);
+        }
+    };
+
+    // The bytes a match can start with, if there are at most three and no
+    // match is empty.
+    bool firstBytes(const Program& program, Prefilter& prefilter) {
+        std::vector<bool> seen(program.insts.size());
+        std::vector<std::uint32_t> stack{program.start};
+        bool possible[256] = {};
+        while (!stack.empty()) {
+            std::uint32_t pc = stack.back();
+            stack.pop_back();
+            if (seen[pc]) continue;
+            seen[pc] = true;
+            const Inst& inst = program.insts[pc];
+            switch (inst.op) {
+                case Inst::Op::RANGE:
+                    for (int c = inst.low; c <= inst.high; ++c) possible[c] = true;
+                    break;
+                case Inst::Op::SPLIT:
+                    stack.push_back(inst.out1);
+                    stack.push_back(inst.out);
+                    break;
+                case Inst::Op::MATCH:
+                    return false;
+                case Inst::Op::FAIL:
+                    break;
+                default:
+                    // Assertions are taken to hold, which only finds more places.
+                    stack.push_back(inst.out);
+                    break;
+            }
+        }
+        for (int c = 0; c < 256; ++c) {
+            if (!possible[c]) continue;
+            if (prefilter.byte_count == 3) return false;
+            prefilter.bytes[prefilter.byte_count++] = static_cast<unsigned char>(c);
+        }
+        return prefilter.byte_count > 0;
+    }
+
+    // ---- The lazy DFA -----------------------------------------------------
+
+    // A DFA over a program's byte classes, built as searches reach its
+    // states. A state is the ordered list of instructions a search may be
+    // at after reading a byte, before following the empty moves from them,
+    // along with the context the byte leaves for assertions. Following the
+    // empty moves waits for the next byte, when every assertion can be
+    // decided, so a state also records whether a match ended just before
+    // that byte.
+    //
+    // With leftmost-first matching, instructions after a MATCH in priority
+    // order are dropped, as a backtracking engine would never get to them;
+    // with longest matching (the reverse DFA) nothing is dropped.
+    //
+    // States are numbered by their offset in the transition table. Entries
+    // not yet computed hold UNKNOWN; entries leading to states the search
+    // loop has to look at (matches, the dead state, and start states when
+    // there is a prefilter) are tagged SPECIAL. When the states outgrow
+    // MEMORY_LIMIT, they are all thrown away and building starts over, so a
+    // search always moves on by at least one byte per state it builds.
+    class Dfa {
+    public:
+        static constexpr std::uint32_t UNKNOWN = 0x80000000u;
+        static constexpr std::uint32_t SPECIAL = 0x40000000u;
+        static constexpr std::uint32_t STATE_MASK = 0x3FFFFFFFu;
+        static constexpr size_t MEMORY_LIMIT = 2 * 1024 * 1024;
+
+        struct StateInfo {
+            std::uint32_t first_pc;   // into `state_pcs`
+            std::uint32_t pc_count;   // 0 for the dead state, and a match with nothing after it
+            std::uint8_t context;
+            bool match;               // a match ended before the byte that led here
+            bool start;               // holds only the program's loop
+        };
+
+        Dfa(const Program& program, bool longest, bool mark_starts)
+            : program(program), longest(longest), mark_starts(mark_starts), stride(program.class_count + 1),
+              seen(program.insts.size(), 0), stepped(program.insts.size(), 0) {
+            clear();
+        }
+
+        const std::uint32_t* table() const { return transitions.data(); }
+        const std::uint8_t* classes() const { return program.byte_class; }
+        unsigned endClass() const { return program.class_count; }
+        const StateInfo& info(std::uint32_t state) const { return states[state / stride]; }
+
+        // The state a search starts in, tagged like a transition.
+        std::uint32_t start(unsigned context, bool anchored) {
+            std::uint32_t& cached = start_states[anchored ? 1 : 0][context & program.context_mask];
+            if (cached == UNKNOWN) {
+                bool was_cleared = false;
+                next_pcs.assign(1, anchored ? program.start : program.loop);
+                std::uint32_t state = intern(context & program.context_mask, false, was_cleared);
+                // Looked up again: interning may have cleared the cache.
+                start_states[anchored ? 1 : 0][context & program.context_mask] = tagged(state);
+                return tagged(state);
+            }
+            return cached;
+        }
+
+        // The transition from `state` on `byte_class`, built and stored.
+        std::uint32_t next(std::uint32_t state, unsigned byte_class) {
+            const StateInfo from = info(state);
+            int next_byte = byte_class == program.class_count ? END_OF_TEXT : program.class_bytes[byte_class];
+            bool matched = closure(from, next_byte);
+            next_pcs.clear();
+            unsigned context = 0;
+            if (next_byte != END_OF_TEXT) {
+                if (++step_stamp == 0) {
+                    std::fill(stepped.begin(), stepped.end(), 0);
+                    step_stamp = 1;
+                }
+                for (std::uint32_t pc : consuming) {
+                    const Inst& inst = program.insts[pc];
+                    if (next_byte < inst.low || next_byte > inst.high || stepped[inst.out] == step_stamp) continue;
+                    stepped[inst.out] = step_stamp;
+                    next_pcs.push_back(inst.out);
+                }
+                if (!next_pcs.empty()) context = contextAfter(static_cast<unsigned char>(next_byte)) & program.context_mask;
+            }
+            bool was_cleared = false;
+            std::uint32_t target = tagged(intern(context, matched, was_cleared));
+            if (!was_cleared) transitions[state + byte_class] = target;
+            return target;
+        }
+
+    private:
+        // Follows the empty moves from the state's instructions in priority
+        // order, collecting the RANGE instructions reached in `consuming`.
+        // Returns whether a MATCH was reached.
+        bool closure(const StateInfo& from, int next_byte) {
+            consuming.clear();
+            if (++seen_stamp == 0) {
+                std::fill(seen.begin(), seen.end(), 0);
+                seen_stamp = 1;
+            }
+            bool matched = false;
+            for (std::uint32_t k = 0; k < from.pc_count; ++k) {
+                stack.push_back(state_pcs[from.first_pc + k]);
+                while (!stack.empty()) {
+                    std::uint32_t pc = stack.back();
+                    stack.pop_back();
+                    if (seen[pc] == seen_stamp) continue;
+                    seen[pc] = seen_stamp;
+                    const Inst& inst = program.insts[pc];
+                    switch (inst.op) {
+                        case Inst::Op::RANGE:
+                            consuming.push_back(pc);
+                            break;
+                        case Inst::Op::SPLIT:
+                            stack.push_back(inst.out1);
+                            stack.push_back(inst.out);
+                            break;
+                        case Inst::Op::SAVE:
+                        case Inst::Op::NOP:
+                            stack.push_back(inst.out);
+                            break;
+                        case Inst::Op::ASSERT:
+                            if (assertionHolds(inst.assertion, from.context, next_byte)) stack.push_back(inst.out);
+                            break;
+                        case Inst::Op::MATCH:
+                            matched = true;
+                            if (!longest) {
+                                stack.clear();
+                                return true;
+                            }
+                            break;
+                        case Inst::Op::FAIL:
+                            break;
+                    }
+                }
+            }
+            return matched;
+        }
+
+        // The state holding `next_pcs`, made if it is new.
+        std::uint32_t intern(unsigned context, bool match, bool& was_cleared) {
+            key.clear();
+            key.push_back(static_cast<char>(context));
+            key.push_back(match ? 1 : 0);
+            key.append(reinterpret_cast<const char*>(next_pcs.data()), next_pcs.size() * sizeof(std::uint32_t));
+            auto found = index.find(key);
+            if (found != index.end()) return found->second;
+            if (memory_used > MEMORY_LIMIT) {
+                clear();
+                was_cleared = true;
+            }
+            return add(context, match);
+        }
+
+        std::uint32_t add(unsigned context, bool match) {
+            std::uint32_t state = static_cast<std::uint32_t>(states.size() * stride);
+            StateInfo info;
+            info.first_pc = static_cast<std::uint32_t>(state_pcs.size());
+            info.pc_count = static_cast<std::uint32_t>(next_pcs.size());
+            info.context = static_cast<std::uint8_t>(context);
+            info.match = match;
+            info.start = next_pcs.size() == 1 && next_pcs[0] == program.loop && !match;
+            states.push_back(info);
+            state_pcs.insert(state_pcs.end(), next_pcs.begin(), next_pcs.end());
+            transitions.resize(transitions.size() + stride, UNKNOWN);
+            index.emplace(key, state);
+            memory_used += stride * sizeof(std::uint32_t) + next_pcs.size() * 2 * sizeof(std::uint32_t) + key.size() + sizeof(StateInfo) + 64;
+            return state;
+        }
+
+        std::uint32_t tagged(std::uint32_t state) const {
+            const StateInfo& state_info = info(state);
+            bool special = state_info.match || state_info.pc_count == 0 || (state_info.start && mark_starts);
+            return special ? (state | SPECIAL) : state;
+        }
+
+        void clear() {
+            states.clear();
+            state_pcs.clear();
+            transitions.clear();
+            index.clear();
+            memory_used = 0;
+            for (auto& row : start_states) std::fill(std::begin(row), std::end(row), UNKNOWN);
+            // The dead state is always 0. The state being interned, if any,
+            // is put back after it.
+            std::string pending_key;
+            std::vector<std::uint32_t> pending_pcs;
+            std::swap(pending_key, key);
+            std::swap(pending_pcs, next_pcs);
+            key.assign(2, 0);
+            add(0, false);
+            std::swap(pending_key, key);
+            std::swap(pending_pcs, next_pcs);
+        }
+
+        const Program& program;
+        bool longest;
+        bool mark_starts;
+        std::uint32_t stride;
+
+        std::vector<StateInfo> states;
+        std::vector<std::uint32_t> state_pcs;
+        std::vector<std::uint32_t> transitions;
+        std::unordered_map<std::string, std::uint32_t> index;
+        size_t memory_used = 0;
+        std::uint32_t start_states[2][CONTEXT_COUNT];
+
+        // Scratch space for building states.
+        std::vector<std::uint32_t> seen;
+        std::uint32_t seen_stamp = 0;
+        std::vector<std::uint32_t> stepped;
+        std::uint32_t step_stamp = 0;
+        std::vector<std::uint32_t> stack;
+        std::vector<std::uint32_t> consuming;
+        std::vector<std::uint32_t> next_pcs;
+        std::string key;
+    };
+
+    // Runs `dfa` forwards over text[from, length) and returns where the match
+    // it finds ends: the first match end seen with `earliest`, otherwise the
+    // end of the leftmost-first match. NO_POSITION if there is none.
+    size_t scanForward(Dfa& dfa, const Prefilter* prefilter, const unsigned char* text, size_t length, size_t from, bool anchored, bool earliest) {
+        size_t position = from;
+        // A prefilter that finds candidates everywhere costs more than it saves.
+        bool skipping = prefilter != nullptr && !anchored;
+        size_t skips = 0;
+        size_t skipped = 0;
+        if (skipping) {
+            position = prefilter->find(text, from, length);
+            if (position == length) return NO_POSITION;
+        }
+        std::uint32_t state = dfa.start(contextAt(text, position), anchored) & Dfa::STATE_MASK;
+        const std::uint32_t* table = dfa.table();
+        const std::uint8_t* classes = dfa.classes();
+        size_t last = NO_POSITION;
+        while (position < length) {
+            std::uint32_t next = table[state + classes[text[position]]];
+            ++position;
+            if ((next & (Dfa::UNKNOWN | Dfa::SPECIAL)) == 0) {
+                state = next;
+                continue;
+            }
+            if (next & Dfa::UNKNOWN) {
+                next = dfa.next(state, classes[text[position - 1]]);
+                table = dfa.table();
+            }
+            state = next & Dfa::STATE_MASK;
+            if ((next & Dfa::SPECIAL) == 0) continue;
+            const Dfa::StateInfo& info = dfa.info(state);
+            if (info.match) {
+                last = position - 1;
+                if (earliest) return last;
+            }
+            if (info.pc_count == 0) return last;
+            if (info.start && skipping) {
+                size_t candidate = prefilter->find(text, position, length);
+                if (candidate == length) return last;
+                ++skips;
+                skipped += candidate - position;
+                if (candidate != position) {
+                    position = candidate;
+                    state = dfa.start(contextAt(text, position), false) & Dfa::STATE_MASK;
+                    table = dfa.table();
+                }
+                if (skips >= 64 && skipped < skips * 16) skipping = false;
+            }
+        }
+        std::uint32_t next = table[state + dfa.endClass()];
+        if (next & Dfa::UNKNOWN) next = dfa.next(state, dfa.endClass());
+        if (dfa.info(next & Dfa::STATE_MASK).match) last = length;
+        return last;
+    }
+
+    // Runs the reverse program's `dfa` backwards from `end` over text[low, end)
+    // and returns the smallest start of a match that ends at `end`.
+    size_t scanReverse(Dfa& dfa, const unsigned char* text, size_t length, size_t low, size_t end) {
+        // Read backwards, what comes "before" is the byte after `end`.
+        unsigned context = end == length ? AT_START : contextAfter(text[end]);
+        std::uint32_t state = dfa.start(context, true) & Dfa::STATE_MASK;
+        const std::uint32_t* table = dfa.table();
+        const std::uint8_t* classes = dfa.classes();
+        size_t last = NO_POSITION;
+        size_t position = end;
+        while (position > low) {
+            --position;
+            std::uint32_t next = table[state + classes[text[position]]];
+            if ((next & (Dfa::UNKNOWN | Dfa::SPECIAL)) == 0) {
+                state = next;
+                continue;
+            }
+            if (next & Dfa::UNKNOWN) {
+                next = dfa.next(state, classes[text[position]]);
+                table = dfa.table();
+            }
+            state = next & Dfa::STATE_MASK;
+            if ((next & Dfa::SPECIAL) == 0) continue;
+            const Dfa::StateInfo& info = dfa.info(state);
+            if (info.match) last = position + 1;
+            if (info.pc_count == 0) return last;
+        }
+        // The byte before `low` (or the start of the text) decides the
+        // assertions at `low`.
+        unsigned byte_class = low > 0 ? classes[text[low - 1]] : dfa.endClass();
+        std::uint32_t next = table[state + byte_class];
+        if (next & Dfa::UNKNOWN) next = dfa.next(state, byte_class);
+        if (dfa.info(next & Dfa::STATE_MASK).match) last = low;
+        return last;
+    }
+
+    // ---- Groups -----------------------------------------------------------
+
+    // Pike's NFA simulation, keeping each thread's group offsets, for a
+    // match whose ends the DFAs have already found. Of the ways through the
+    // program from `start` that end at `end`, it takes the one a
+    // backtracking engine would try first, which is the one the DFA found.
+    class PikeVm {
+    public:
+        void captures(const Program& program, const unsigned char* text, size_t length, size_t start, size_t end, std::vector<size_t>& slots) {
+            size_t count = program.insts.size();
+            slot_count = program.slot_count;
+            insts = &program;
+            for (ThreadList* list : {&current_list, &next_list}) {
+                list->sparse.resize(count);
+                list->dense.resize(count);
+                list->slots.resize(count * slot_count);
+                list->size = 0;
+            }
+            current.assign(slot_count, NO_POSITION);
+            add(current_list, program.start, start, contextAt(text, start), start < length ? text[start] : END_OF_TEXT);
+            for (size_t position = start;; ++position) {
+                if (position == end) {
+                    for (size_t i = 0; i < current_list.size; ++i) {
+                        std::uint32_t pc = current_list.dense[i];
+                        if (program.insts[pc].op != Inst::Op::MATCH) continue;
+                        const size_t* found = &current_list.slots[pc * slot_count];
+                        slots.assign(found, found + slot_count);
+                        return;
+                    }
+                    break;
+                }
+                next_list.size = 0;
+                unsigned char byte = text[position];
+                unsigned context = contextAfter(byte);
+                int next_byte = position + 1 < length ? text[position + 1] : END_OF_TEXT;
+                for (size_t i = 0; i < current_list.size; ++i) {
+                    std::uint32_t pc = current_list.dense[i];
+                    const Inst& inst = program.insts[pc];
+                    if (inst.op != Inst::Op::RANGE || byte < inst.low || byte > inst.high) continue;
+                    const size_t* thread_slots = &current_list.slots[pc * slot_count];
+                    current.assign(thread_slots, thread_slots + slot_count);
+                    add(next_list, inst.out, position + 1, context, next_byte);
+                }
+                std::swap(current_list, next_list);
+                if (current_list.size == 0) break;
+            }
+            // Not reached when the DFAs and this agree.
+            slots.assign(slot_count, NO_POSITION);
+            slots[0] = start;
+            slots[1] = end;
+        }
+
+    private:
+        struct ThreadList {
+            std::vector<std::uint32_t> sparse;
+            std::vector<std::uint32_t> dense;
+            std::vector<size_t> slots;
+            size_t size = 0;
+
+            bool contains(std::uint32_t pc) const { return sparse[pc] < size && dense[sparse[pc]] == pc; }
+            void insert(std::uint32_t pc) {
+                sparse[pc] = static_cast<std::uint32_t>(size);
+                dense[size++] = pc;
+            }
+        };
+
+        struct Frame {
+            std::uint32_t pc;
+            bool restore;        // puts `value` back in `slot` instead
+            std::uint32_t slot;
+            size_t value;
+        };
+
+        // Adds the thread at `pc`, with the offsets in `current`, and every
+        // thread its empty moves lead to, in priority order.
+        void add(ThreadList& list, std::uint32_t first_pc, size_t position, unsigned context, int next_byte) {
+            stack.push_back({first_pc, false, 0, 0});
+            while (!stack.empty()) {
+                Frame frame = stack.back();
+                stack.pop_back();
+                if (frame.restore) {
+                    current[frame.slot] = frame.value;
+                    continue;
+                }
+                if (list.contains(frame.pc)) continue;
+                list.insert(frame.pc);
+                const Inst& inst = insts->insts[frame.pc];
+                switch (inst.op) {
+                    case Inst::Op::RANGE:
+                    case Inst::Op::MATCH:
+                        std::copy(current.begin(), current.end(), list.slots.begin() + frame.pc * slot_count);
+                        break;
+                    case Inst::Op::SPLIT:
+                        stack.push_back({inst.out1, false, 0, 0});
+                        stack.push_back({inst.out, false, 0, 0});
+                        break;
+                    case Inst::Op::NOP:
+                        stack.push_back({inst.out, false, 0, 0});
+                        break;
+                    case Inst::Op::SAVE:
+                        stack.push_back({0, true, inst.slot, current[inst.slot]});
+                        current[inst.slot] = position;
+                        stack.push_back({inst.out, false, 0, 0});
+                        break;
+                    case Inst::Op::ASSERT:
+                        if (assertionHolds(inst.assertion, context, next_byte)) stack.push_back({inst.out, false, 0, 0});
+                        break;
+                    case Inst::Op::FAIL:
+                        break;
+                }
+            }
+        }
+
+        const Program* insts = nullptr;
+        size_t slot_count = 0;
+        ThreadList current_list;
+        ThreadList next_list;
+        std::vector<size_t> current;
+        std::vector<Frame> stack;
+    };
+
+    // The same answer as PikeVm for short matches, found by backtracking:
+    // it tries the ways through the program in priority order, so the first
+    // that reaches MATCH at `end` is the one wanted, and it does not copy
+    // offsets for threads that lose. A bit per (instruction, position)
+    // remembers what has already failed, which keeps it linear.
+    class Backtracker {
+    public:
+        static constexpr size_t MAX_BITS = 256 * 1024;
+
+        static bool fits(const Program& program, size_t start, size_t end) {
+            return (end - start + 1) <= MAX_BITS / program.insts.size();
+        }
+
+        void captures(const Program& program, const unsigned char* text, size_t length, size_t start, size_t end, std::vector<size_t>& slots) {
+            size_t width = end - start + 1;
+            visited.assign((program.insts.size() * width + 63) / 64, 0);
+            slots.assign(program.slot_count, NO_POSITION);
+            stack.clear();
+            stack.push_back({program.start, start, false, 0});
+            while (!stack.empty()) {
+                Frame frame = stack.back();
+                stack.pop_back();
+                if (frame.restore) {
+                    slots[frame.slot] = frame.position;
+                    continue;
+                }
+                std::uint32_t pc = frame.pc;
+                size_t position = frame.position;
+                for (;;) {
+                    size_t bit = pc * width + (position - start);
+                    if (visited[bit / 64] & (std::uint64_t(1) << (bit % 64))) break;
+                    visited[bit / 64] |= std::uint64_t(1) << (bit % 64);
+                    const Inst& inst = program.insts[pc];
+                    if (inst.op == Inst::Op::RANGE) {
+                        if (position == end || text[position] < inst.low || text[position] > inst.high) break;
+                        ++position;
+                        pc = inst.out;
+                    } else if (inst.op == Inst::Op::SPLIT) {
+                        stack.push_back({inst.out1, position, false, 0});
+                        pc = inst.out;
+                    } else if (inst.op == Inst::Op::SAVE) {
+                        stack.push_back({0, slots[inst.slot], true, inst.slot});
+                        slots[inst.slot] = position;
+                        pc = inst.out;
+                    } else if (inst.op == Inst::Op::ASSERT) {
+                        if (!assertionHolds(inst.assertion, contextAt(text, position), position < length ? text[position] : END_OF_TEXT)) break;
+                        pc = inst.out;
+                    } else if (inst.op == Inst::Op::NOP) {
+                        pc = inst.out;
+                    } else {
+                        if (inst.op == Inst::Op::MATCH && position == end) return;
+                        break;
+                    }
+                }
+            }
+            // Not reached when the DFAs and this agree.
+            slots.assign(program.slot_count, NO_POSITION);
+            slots[0] = start;
+            slots[1] = end;
+        }
+
+    private:
+        struct Frame {
+            std::uint32_t pc;
+            size_t position;     // or the value to put back in `slot`
+            bool restore;
+            std::uint32_t slot;
+        };
+
+        std::vector<std::uint64_t> visited;
+        std::vector<Frame> stack;
+    };
+}
+
+// ---- NyxRegex -------------------------------------------------------------
+
+struct NyxRegex::Compiled {
+    Program forward;
+    Program reverse;            // empty in findLine()'s form, which does not need it
+    bool has_prefilter = false;
+    Prefilter prefilter;
+    // The pattern is nothing but this text, so searches just look for it.
+    bool is_literal = false;
+    std::string literal;
+    bool anchored = false;      // every match starts at the start of the text
+
+    static std::unique_ptr<Compiled> build(const std::string& pattern, unsigned flags, bool with_reverse, std::vector<std::string>* names) {
+        Parser parser(pattern, flags);
+        NodePtr root = parser.parse();
+        auto compiled = std::make_unique<Compiled>();
+        Compiler(compiled->forward, false, pattern).compile(*root, parser.names.size());
+        if (with_reverse) Compiler(compiled->reverse, true, pattern).compile(*root, 0);
+        Prefix prefix;
+        collectPrefix(*root, prefix);
+        compiled->anchored = startsAnchored(*root);
+        compiled->is_literal = prefix.complete && !prefix.has_assertion && parser.names.empty() && !prefix.text.empty();
+        compiled->literal = prefix.text;
+        if (!compiled->anchored) {
+            compiled->prefilter.literal = prefix.text;
+            compiled->has_prefilter = !prefix.text.empty() || firstBytes(compiled->forward, compiled->prefilter);
+        }
+        if (names) *names = std::move(parser.names);
+        return compiled;
+    }
+};
+
+struct NyxRegex::Caches {
+    explicit Caches(const Compiled& compiled)
+        : forward(compiled.forward, false, compiled.has_prefilter), reverse(compiled.reverse, true, false) {}
+
+    Dfa forward;
+    Dfa reverse;
+    std::unique_ptr<Dfa> whole;   // longest matches, for matchWhole()
+    std::unique_ptr<Dfa> lines;   // findLine()'s form
+    Backtracker backtracker;
+    PikeVm pike;
+
+    void captures(const Program& program, const unsigned char* text, size_t length, size_t start, size_t end, std::vector<size_t>& slots) {
+        if (Backtracker::fits(program, start, end)) {
+            backtracker.captures(program, text, length, start, end, slots);
+        } else {
+            pike.captures(program, text, length, start, end, slots);
+        }
+    }
+};
+
+NyxRegex::CacheLease::CacheLease(const NyxRegex& regex) : regex(regex), caches(regex.spare_caches.exchange(nullptr, std::memory_order_acquire)) {
+    if (!caches) caches = new Caches(*regex.compiled);
+}
+
+NyxRegex::CacheLease::~CacheLease() {
+    Caches* expected = nullptr;
+    if (!regex.spare_caches.compare_exchange_strong(expected, caches, std::memory_order_release)) delete caches;
+}
+
+NyxRegex::NyxRegex(std::string pattern, std::string flags) : pattern_text(std::move(pattern)), flag_text(std::move(flags)) {}
+
+NyxRegex::~NyxRegex() {
+    delete spare_caches.load();
+}
+
+std::shared_ptr<const NyxRegex> NyxRegex::compile(const std::string& pattern, const std::string& flags) {
+    unsigned bits = parseFlags(flags);
+    std::shared_ptr<NyxRegex> regex(new NyxRegex(pattern, flags));
+    regex->compiled = Compiled::build(pattern, bits, true, &regex->group_names);
+    return regex;
+}
+
+bool NyxRegex::hasNamedGroups() const {
+    for (const std::string& name : group_names) {
+        if (!name.empty()) return true;
+    }
+    return false;
+}
+
+bool NyxRegex::search(const char* text, size_t length, size_t from, size_t& start, size_t& end, std::vector<size_t>* groups) const {
+    if (from > length) return false;
+    const Compiled& form = *compiled;
+    if (form.is_literal) {
+        size_t found = from + RegexKernels::findLiteral(text + from, length - from, form.literal.data(), form.literal.size());
+        if (found == length) return false;
+        start = found;
+        end = found + form.literal.size();
+        if (groups) groups->assign({start, end});
+        return true;
+    }
+    if (form.anchored && from > 0) return false;
+    auto bytes = reinterpret_cast<const unsigned char*>(text);
+    CacheLease caches(*this);
+    for (;;) {
+        end = scanForward(caches->forward, form.has_prefilter ? &form.prefilter : nullptr, bytes, length, from, form.anchored, false);
+        if (end == NO_POSITION) return false;
+        start = form.anchored ? from : scanReverse(caches->reverse, bytes, length, from, end);
+        // The automaton reads bytes, so an empty match can fall inside a
+        // character; searching goes on from the character's end.
+        if (start != end || start == 0 || start == length || (bytes[start] & 0xC0) != 0x80) break;
+        from = start + 1;
+        while (from < length && (bytes[from] & 0xC0) == 0x80) ++from;
+    }
+    if (groups) {
+        if (group_names.empty()) {
+            groups->assign({start, end});
+        } else {
+            caches->captures(form.forward, bytes, length, start, end, *groups);
+        }
+    }
+    return true;
+}
+
+bool NyxRegex::matchWhole(const char* text, size_t length, std::vector<size_t>* groups) const {
+    const Compiled& form = *compiled;
+    if (form.is_literal) {
+        if (length != form.literal.size() || std::memcmp(text, form.literal.data(), length) != 0) return false;
+        if (groups) groups->assign({0, length});
+        return true;
+    }
+    auto bytes = reinterpret_cast<const unsigned char*>(text);
+    CacheLease caches(*this);
+    if (!caches->whole) caches->whole = std::make_unique<Dfa>(form.forward, true, false);
+    if (scanForward(*caches->whole, nullptr, bytes, length, 0, true, false) != length) return false;
+    if (groups) {
+        if (group_names.empty()) {
+            groups->assign({0, length});
+        } else {
+            caches->captures(form.forward, bytes, length, 0, length, *groups);
+        }
+    }
+    return true;
+}
+
+bool NyxRegex::test(const char* text, size_t length) const {
+    const Compiled& form = *compiled;
+    if (form.is_literal) return RegexKernels::findLiteral(text, length, form.literal.data(), form.literal.size()) != length;
+    CacheLease caches(*this);
+    auto bytes = reinterpret_cast<const unsigned char*>(text);
+    return scanForward(caches->forward, form.has_prefilter ? &form.prefilter : nullptr, bytes, length, 0, form.anchored, true) != NO_POSITION;
+}
+
+const NyxRegex::Compiled& NyxRegex::linesForm() const {
+    std::call_once(lines_once, [this]() {
+        lines_compiled = Compiled::build(pattern_text, parseFlags(flag_text) | MULTILINE | LINES, false, nullptr);
+    });
+    return *lines_compiled;
+}
+
+bool NyxRegex::findLine(const char* text, size_t length, size_t from, size_t& line_start, size_t& line_end) const {
+    const Compiled& form = linesForm();
+    size_t found;
+    if (form.is_literal) {
+        found = from + RegexKernels::findLiteral(text + from, length - from, form.literal.data(), form.literal.size());
+        if (found == length) return false;
+    } else {
+        CacheLease caches(*this);
+        if (!caches->lines) caches->lines = std::make_unique<Dfa>(form.forward, false, form.has_prefilter);
+        auto bytes = reinterpret_cast<const unsigned char*>(text);
+        // Matches cannot cross line breaks here, so the first match to end
+        // is in the first line with a match.
+        found = scanForward(*caches->lines, form.has_prefilter ? &form.prefilter : nullptr, bytes, length, from, false, true);
+        if (found == NO_POSITION) return false;
+    }
+    line_start = found;
+    while (line_start > from && text[line_start - 1] != '\n') --line_start;
+    const void* newline = std::memchr(text + found, '\n', length - found);
+    line_end = newline ? static_cast<size_t>(static_cast<const char*>(newline) - text) : length;
+    return true;
+}
+
+std::string NyxRegex::describe() const {
+    return "<regex /" + pattern_text + "/" + flag_text + ">";
+}
+
+}
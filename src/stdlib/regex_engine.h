@@ -0,0 +1,102 @@
+#ifndef NYX_STDLIB_REGEX_ENGINE_H
+#define NYX_STDLIB_REGEX_ENGINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Nyx {
+
+// A compiled regular expression (see std:regex). Patterns are UTF-8 and are
+// matched against UTF-8 text; offsets are in bytes. There are no
+// backreferences or lookaround, so every search takes time linear in the
+// length of the text: the pattern becomes an automaton over bytes, run as a
+// DFA whose states are built the first time the search reaches them.
+//
+// A search runs the DFA forwards to find where the leftmost match ends, then
+// a DFA of the reversed pattern backwards from there to find where it
+// starts. Only when groups are wanted is the match itself run again, through
+// an NFA simulation that keeps the groups' offsets. Patterns that begin with
+// a literal skip ahead to it with vector compares (see regex_kernels.h).
+//
+// A compiled regex never changes, so it is shared freely between tasks.
+// The DFA states a search builds are kept for the next one, in caches
+// lent out to one search at a time.
+class NyxRegex {
+public:
+    static constexpr size_t NO_POSITION = static_cast<size_t>(-1);
+
+    // `flags` holds any of 'i' (ASCII letters match either case), 'm' ('^'
+    // and '$' match at line breaks too) and 's' ('.' matches "\n" too).
+    // Throws NyxRuntimeException if the pattern or the flags are invalid.
+    static std::shared_ptr<const NyxRegex> compile(const std::string& pattern, const std::string& flags);
+    ~NyxRegex();
+    NyxRegex(const NyxRegex&) = delete;
+    NyxRegex& operator=(const NyxRegex&) = delete;
+
+    const std::string& pattern() const { return pattern_text; }
+    const std::string& flags() const { return flag_text; }
+    // Capture groups, not counting the whole match.
+    size_t groupCount() const { return group_names.size(); }
+    // The name of each group, "" for an unnamed one.
+    const std::vector<std::string>& groupNames() const { return group_names; }
+    bool hasNamedGroups() const;
+
+    // Finds the leftmost match starting at or after `from`; of the matches
+    // starting there, the one a backtracking engine would find first.
+    // `groups`, if given, receives 2 * (groupCount() + 1) offsets: the start
+    // and end of the match, then of each group (NO_POSITION for a group the
+    // match did not go through).
+    bool search(const char* text, size_t length, size_t from, size_t& start, size_t& end, std::vector<size_t>* groups) const;
+    // Whether the whole of the text matches, with `groups` as for search().
+    bool matchWhole(const char* text, size_t length, std::vector<size_t>* groups) const;
+    // Whether there is a match anywhere, stopping at the first one found.
+    bool test(const char* text, size_t length) const;
+    // Finds the first line of text[from, length) with a match in it, as if
+    // each line were searched on its own: '^' and '$' match at the ends of
+    // lines, and nothing matches across a line break. `from` and `length`
+    // must fall at the starts of lines. The line is [line_start, line_end),
+    // without its "\n".
+    bool findLine(const char* text, size_t length, size_t from, size_t& line_start, size_t& line_end) const;
+
+    std::string describe() const;
+
+    struct Compiled;
+    struct Caches;
+
+private:
+    NyxRegex(std::string pattern, std::string flags);
+
+    // Lends out a cache for the length of one search.
+    class CacheLease {
+    public:
+        explicit CacheLease(const NyxRegex& regex);
+        ~CacheLease();
+        Caches& operator*() const { return *caches; }
+        Caches* operator->() const { return caches; }
+
+    private:
+        const NyxRegex& regex;
+        Caches* caches;
+    };
+
+    const Compiled& linesForm() const;
+
+    std::string pattern_text;
+    std::string flag_text;
+    std::vector<std::string> group_names;
+    std::unique_ptr<Compiled> compiled;
+    // The form findLine() runs, compiled the first time it is needed.
+    mutable std::once_flag lines_once;
+    mutable std::unique_ptr<Compiled> lines_compiled;
+    // The cache the last search gave back. Searches that find it taken (by
+    // another thread) make a cache of their own.
+    mutable std::atomic<Caches*> spare_caches{nullptr};
+};
+
+}
+
+#endif
@@ -0,0 +1,150 @@
+#include "./regex_kernels.h"
+#include "./array_kernels.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NYX_REGEX_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define NYX_TARGET_AVX2
+#else
+#define NYX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define NYX_REGEX_X86 0
+#endif
+
+namespace Nyx {
+namespace RegexKernels {
+
+namespace {
+    using ArrayKernels::SimdLevel;
+
+    size_t findLiteralScalar(const char* data, size_t from, size_t n, const char* needle, size_t m) {
+        if (n < m) return n;
+        size_t last_start = n - m;
+        size_t i = from;
+        while (i <= last_start) {
+            const void* first = std::memchr(data + i, needle[0], last_start - i + 1);
+            if (!first) return n;
+            i = static_cast<size_t>(static_cast<const char*>(first) - data);
+            if (std::memcmp(data + i + 1, needle + 1, m - 1) == 0) return i;
+            ++i;
+        }
+        return n;
+    }
+
+    size_t findAnyByteScalar(const char* data, size_t from, size_t n, const unsigned char* bytes, size_t count) {
+        for (size_t i = from; i < n; ++i) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            if (c == bytes[0] || (count > 1 && c == bytes[1]) || (count > 2 && c == bytes[2])) return i;
+        }
+        return n;
+    }
+
+#if NYX_REGEX_X86
+    unsigned lowestBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    size_t findLiteralSse2(const char* data, size_t n, const char* needle, size_t m) {
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i last = _mm_set1_epi8(needle[m - 1]);
+        size_t i = 0;
+        for (; i + m - 1 + 16 <= n; i += 16) {
+            __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + m - 1));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last))));
+            while (mask != 0) {
+                unsigned bit = lowestBit(mask);
+                if (std::memcmp(data + i + bit + 1, needle + 1, m - 2) == 0) return i + bit;
+                mask &= mask - 1;
+            }
+        }
+        return findLiteralScalar(data, i, n, needle, m);
+    }
+
+    NYX_TARGET_AVX2 size_t findLiteralAvx2(const char* data, size_t n, const char* needle, size_t m) {
+        const __m256i first = _mm256_set1_epi8(needle[0]);
+        const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+        size_t i = 0;
+        for (; i + m - 1 + 32 <= n; i += 32) {
+            __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + m - 1));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(head, first), _mm256_cmpeq_epi8(tail, last))));
+            while (mask != 0) {
+                unsigned bit = lowestBit(mask);
+                if (std::memcmp(data + i + bit + 1, needle + 1, m - 2) == 0) return i + bit;
+                mask &= mask - 1;
+            }
+        }
+        return findLiteralScalar(data, i, n, needle, m);
+    }
+
+    size_t findAnyByteSse2(const char* data, size_t n, const unsigned char* bytes, size_t count) {
+        const __m128i a = _mm_set1_epi8(static_cast<char>(bytes[0]));
+        const __m128i b = _mm_set1_epi8(static_cast<char>(bytes[1]));
+        const __m128i c = _mm_set1_epi8(static_cast<char>(bytes[count > 2 ? 2 : 1]));
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, a), _mm_or_si128(_mm_cmpeq_epi8(v, b), _mm_cmpeq_epi8(v, c)));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+            if (mask != 0) return i + lowestBit(mask);
+        }
+        return findAnyByteScalar(data, i, n, bytes, count);
+    }
+
+    NYX_TARGET_AVX2 size_t findAnyByteAvx2(const char* data, size_t n, const unsigned char* bytes, size_t count) {
+        const __m256i a = _mm256_set1_epi8(static_cast<char>(bytes[0]));
+        const __m256i b = _mm256_set1_epi8(static_cast<char>(bytes[1]));
+        const __m256i c = _mm256_set1_epi8(static_cast<char>(bytes[count > 2 ? 2 : 1]));
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, a), _mm256_or_si256(_mm256_cmpeq_epi8(v, b), _mm256_cmpeq_epi8(v, c)));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+            if (mask != 0) return i + lowestBit(mask);
+        }
+        return findAnyByteScalar(data, i, n, bytes, count);
+    }
+#endif
+}
+
+size_t findLiteral(const char* data, size_t n, const char* needle, size_t m) {
+    if (m == 1) {
+        const void* found = std::memchr(data, needle[0], n);
+        return found ? static_cast<size_t>(static_cast<const char*>(found) - data) : n;
+    }
+#if NYX_REGEX_X86
+    static const SimdLevel level = ArrayKernels::simdLevel();
+    if (level >= SimdLevel::AVX2) return findLiteralAvx2(data, n, needle, m);
+    if (level >= SimdLevel::SSE2) return findLiteralSse2(data, n, needle, m);
+#endif
+    return findLiteralScalar(data, 0, n, needle, m);
+}
+
+size_t findAnyByte(const char* data, size_t n, const unsigned char* bytes, size_t count) {
+    if (count == 1) {
+        const void* found = std::memchr(data, bytes[0], n);
+        return found ? static_cast<size_t>(static_cast<const char*>(found) - data) : n;
+    }
+#if NYX_REGEX_X86
+    static const SimdLevel level = ArrayKernels::simdLevel();
+    if (level >= SimdLevel::AVX2) return findAnyByteAvx2(data, n, bytes, count);
+    if (level >= SimdLevel::SSE2) return findAnyByteSse2(data, n, bytes, count);
+#endif
+    return findAnyByteScalar(data, 0, n, bytes, count);
+}
+
+}
+}
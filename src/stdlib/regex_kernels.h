@@ -0,0 +1,27 @@
+#ifndef NYX_STDLIB_REGEX_KERNELS_H
+#define NYX_STDLIB_REGEX_KERNELS_H
+
+#include <cstddef>
+
+namespace Nyx {
+
+// The byte scans std:regex skips ahead with before running its automaton,
+// with SSE2 and AVX2 versions chosen by the same SIMD level as std:array
+// (see array_kernels.h). Every level gives the same results.
+namespace RegexKernels {
+
+// The index of the first occurrence of needle[0, m) in data[0, n), or n.
+// `m` is at least 1. Candidates are found by comparing a vector of bytes
+// against the needle's first byte and the vector m - 1 bytes further on
+// against its last, so only places where both agree are compared in full.
+size_t findLiteral(const char* data, size_t n, const char* needle, size_t m);
+
+// The index of the first byte of data[0, n) equal to one of bytes[0, count),
+// or n. `count` is 1, 2 or 3.
+size_t findAnyByte(const char* data, size_t n, const unsigned char* bytes, size_t count);
+
+}
+
+}
+
+#endif
@@ -0,0 +1,515 @@
+#include "./regex_module.h"
+#include "./regex_engine.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../interpreter/CallbackFrame.h"
+#include "../common/Bytes.h"
+#include "../common/FileHandle.h"
+#include "../common/HashTable.h"
+#include "../common/HeapAccounting.h"
+#include "../common/Iterator.h"
+#include "../common/Utils.h"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace Nyx {
+
+namespace {
+    // Patterns given as strings rather than compiled regexes are compiled
+    // once per thread (so once per interpreter) and kept, up to a limit.
+    constexpr size_t PATTERN_CACHE_LIMIT = 256;
+
+    RegexPtr cachedRegex(const std::string& pattern, const std::string& flags) {
+        thread_local std::unordered_map<std::string, RegexPtr> cache;
+        std::string key = flags;
+        key += '\0';
+        key += pattern;
+        auto found = cache.find(key);
+        if (found != cache.end()) return found->second;
+        RegexPtr regex = NyxRegex::compile(pattern, flags);
+        if (cache.size() >= PATTERN_CACHE_LIMIT) cache.clear();
+        cache.emplace(std::move(key), regex);
+        return regex;
+    }
+
+    const std::string* stringOf(const NyxValue& value) {
+        if (const std::string* text = std::get_if<std::string>(&value.data)) return text;
+        if (const auto* frozen = std::get_if<FrozenValuePtr>(&value.data); frozen && *frozen && (*frozen)->kind == NyxFrozenValue::Kind::STRING) {
+            return &(*frozen)->text;
+        }
+        return nullptr;
+    }
+
+    // A compiled regex, or a pattern string.
+    RegexPtr expectRegex(const NyxValue& value, const std::string& function_name) {
+        if (const auto* regex = std::get_if<RegexPtr>(&value.data); regex && *regex) return *regex;
+        if (const std::string* pattern = stringOf(value)) return cachedRegex(*pattern, "");
+        throw Common::NyxRuntimeException("'" + function_name + "' expects a regex from 'regex.compile' or a pattern string, got " +
+                                         nyxValueTypeToString(value) + ".", 0);
+    }
+
+    struct Text {
+        const char* data;
+        size_t size;
+    };
+
+    // The text to search: a string or bytes.
+    Text expectText(const NyxValue& value, const std::string& function_name) {
+        if (const std::string* text = stringOf(value)) return Text{text->data(), text->size()};
+        if (const auto* bytes = std::get_if<BytesPtr>(&value.data); bytes && *bytes) {
+            return Text{reinterpret_cast<const char*>((*bytes)->data()), (*bytes)->size()};
+        }
+        throw Common::NyxRuntimeException("'" + function_name + "' expects text (a string or bytes), got " + nyxValueTypeToString(value) + ".", 0);
+    }
+
+    size_t expectCount(Interpreter& interpreter, const NyxValue& value, const std::string& function_name, const std::string& what) {
+        const double* number = std::get_if<double>(&value.data);
+        if (!number || *number < 0 || !interpreter.isDoubleInteger(*number)) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects " + what + " to be a whole number of at least 0, got " +
+                                             nyxValueToString(value) + ".", 0);
+        }
+        return static_cast<size_t>(*number);
+    }
+
+    void setEntry(NyxMap& map, const char* key, NyxValue value) {
+        bool inserted = false;
+        map.table.valueAt(map.table.insert(NyxValue(std::string(key)), inserted)) = std::move(value);
+    }
+
+    NyxValue groupText(const Text& text, const std::vector<size_t>& slots, size_t group) {
+        size_t start = slots[2 * group];
+        if (start == NyxRegex::NO_POSITION) return NyxValue(std::monostate{});
+        return NyxValue(std::string(text.data + start, slots[2 * group + 1] - start));
+    }
+
+    // {text, start, end, groups} and, with named groups, {named}.
+    NyxValue matchValue(const NyxRegex& regex, const Text& text, const std::vector<size_t>& slots) {
+        auto match = std::make_shared<NyxMap>();
+        bool named = regex.hasNamedGroups();
+        match->table.reserve(named ? 5 : 4);
+        setEntry(*match, "text", groupText(text, slots, 0));
+        setEntry(*match, "start", NyxValue(static_cast<double>(slots[0])));
+        setEntry(*match, "end", NyxValue(static_cast<double>(slots[1])));
+        NyxList groups;
+        groups.reserve(regex.groupCount());
+        for (size_t group = 1; group <= regex.groupCount(); ++group) groups.push_back(groupText(text, slots, group));
+        setEntry(*match, "groups", NyxValue(std::move(groups)));
+        if (named) {
+            auto names = std::make_shared<NyxMap>();
+            const std::vector<std::string>& group_names = regex.groupNames();
+            for (size_t group = 1; group <= group_names.size(); ++group) {
+                if (!group_names[group - 1].empty()) setEntry(*names, group_names[group - 1].c_str(), groupText(text, slots, group));
+            }
+            setEntry(*match, "named", NyxValue(std::move(names)));
+        }
+        return NyxValue(std::move(match));
+    }
+
+    // Steps through the matches in a text from left to right. An empty
+    // match right where the previous match ended is skipped, and after an
+    // empty match the search moves on by a character, so "x*" finds
+    // "", "xx", "" in "axxb" as in Go and RE2.
+    class MatchCursor {
+    public:
+        MatchCursor(const NyxRegex& regex, const Text& text, bool with_groups) : regex(regex), text(text), with_groups(with_groups) {}
+
+        bool next() {
+            while (position <= text.size) {
+                if (!regex.search(text.data, text.size, position, start, end, with_groups ? &slots : nullptr)) break;
+                bool skip = start == end && start == previous_end;
+                if (start == end) {
+                    position = end + characterLength(end);
+                } else {
+                    position = end;
+                }
+                if (skip) continue;
+                previous_end = end;
+                return true;
+            }
+            position = text.size + 1;
+            return false;
+        }
+
+        size_t start = 0;
+        size_t end = 0;
+        std::vector<size_t> slots;
+
+    private:
+        size_t characterLength(size_t at) const {
+            if (at >= text.size) return 1;
+            unsigned char lead = static_cast<unsigned char>(text.data[at]);
+            size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+            return std::min(length, text.size - at);
+        }
+
+        const NyxRegex& regex;
+        Text text;
+        bool with_groups;
+        size_t position = 0;
+        size_t previous_end = NyxRegex::NO_POSITION;
+    };
+
+    // A replacement string, split into text and group references: $1 or
+    // ${1} for a group by number, ${name} by name, $$ for a '$'.
+    class Replacement {
+    public:
+        Replacement(const std::string& replacement, const NyxRegex& regex) {
+            std::string literal;
+            size_t i = 0;
+            while (i < replacement.size()) {
+                char c = replacement[i];
+                if (c != '$') {
+                    literal += c;
+                    ++i;
+                    continue;
+                }
+                if (i + 1 < replacement.size() && replacement[i + 1] == '$') {
+                    literal += '$';
+                    i += 2;
+                    continue;
+                }
+                std::string reference;
+                size_t next = i + 1;
+                if (next < replacement.size() && replacement[next] == '{') {
+                    size_t close = replacement.find('}', next);
+                    if (close == std::string::npos) fail(replacement, "'${' has no closing '}'");
+                    reference = replacement.substr(next + 1, close - next - 1);
+                    next = close + 1;
+                } else {
+                    while (next < replacement.size() && replacement[next] >= '0' && replacement[next] <= '9') reference += replacement[next++];
+                    if (reference.empty()) fail(replacement, "'$' is followed by neither a group nor another '$' (write $$ for a '$')");
+                }
+                pieces.push_back(Piece{std::move(literal), NO_GROUP});
+                literal.clear();
+                pieces.push_back(Piece{std::string(), groupIndex(reference, regex, replacement)});
+                i = next;
+            }
+            if (!literal.empty()) pieces.push_back(Piece{std::move(literal), NO_GROUP});
+        }
+
+        void append(std::string& out, const Text& text, const std::vector<size_t>& slots) const {
+            for (const Piece& piece : pieces) {
+                if (piece.group == NO_GROUP) {
+                    out += piece.text;
+                } else if (slots[2 * piece.group] != NyxRegex::NO_POSITION) {
+                    out.append(text.data + slots[2 * piece.group], slots[2 * piece.group + 1] - slots[2 * piece.group]);
+                }
+            }
+        }
+
+        bool usesGroups() const {
+            for (const Piece& piece : pieces) {
+                if (piece.group != NO_GROUP && piece.group != 0) return true;
+            }
+            return false;
+        }
+
+    private:
+        static constexpr size_t NO_GROUP = static_cast<size_t>(-1);
+
+        struct Piece {
+            std::string text;
+            size_t group;
+        };
+
+        [[noreturn]] static void fail(const std::string& replacement, const std::string& message) {
+            throw Common::NyxRuntimeException("Invalid replacement '" + replacement + "' for 'regex.replace': " + message + ".", 0);
+        }
+
+        static size_t groupIndex(const std::string& reference, const NyxRegex& regex, const std::string& replacement) {
+            if (!reference.empty() && reference.find_first_not_of("0123456789") == std::string::npos) {
+                size_t group = reference.size() > 6 ? NO_GROUP : std::stoul(reference);
+                if (group > regex.groupCount()) fail(replacement, "the pattern has no group " + reference);
+                return group;
+            }
+            const std::vector<std::string>& names = regex.groupNames();
+            for (size_t group = 0; group < names.size(); ++group) {
+                if (names[group] == reference) return group + 1;
+            }
+            fail(replacement, "the pattern has no group named '" + reference + "'");
+        }
+
+        std::vector<Piece> pieces;
+    };
+
+    // How often natives that collect matches check the heap limit.
+    constexpr size_t HEAP_CHECK_MATCHES = 4096;
+
+    // regex.lines: the lines of a string, bytes or file that hold a match,
+    // found by running the pattern over many lines at once (see
+    // NyxRegex::findLine) rather than line by line. A file is read in views
+    // of its buffer or mapping (see NyxFile::peek); only a line that runs
+    // past the end of a view is copied before it is searched.
+    class LinesIterator : public NyxIterator {
+    public:
+        LinesIterator(RegexPtr regex, const NyxValue& source) : regex(std::move(regex)) {
+            if (const std::string* text = std::get_if<std::string>(&source.data)) {
+                held_text = *text;
+                memory = held_text.data();
+                memory_size = held_text.size();
+            } else if (const auto* frozen = std::get_if<FrozenValuePtr>(&source.data); frozen && *frozen && (*frozen)->kind == NyxFrozenValue::Kind::STRING) {
+                held_frozen = *frozen;
+                memory = held_frozen->text.data();
+                memory_size = held_frozen->text.size();
+            } else if (const auto* bytes = std::get_if<BytesPtr>(&source.data); bytes && *bytes) {
+                held_bytes = *bytes;
+                memory = reinterpret_cast<const char*>(held_bytes->data());
+                memory_size = held_bytes->size();
+            } else if (const auto* file = std::get_if<FilePtr>(&source.data); file && *file) {
+                this->file = *file;
+            } else {
+                throw Common::NyxRuntimeException("'regex.lines' expects text (a string or bytes) or a file opened with 'io.open', got " +
+                                                 nyxValueTypeToString(source) + ".", 0);
+            }
+        }
+
+        bool next(Interpreter&, NyxValue& item) override {
+            size_t line_start = 0;
+            size_t line_end = 0;
+            if (!file) {
+                if (position >= memory_size || !regex->findLine(memory, memory_size, position, line_start, line_end)) {
+                    position = memory_size;
+                    return false;
+                }
+                position = line_end + 1;
+                item = lineValue(memory + line_start, line_end - line_start);
+                return true;
+            }
+            for (;;) {
+                const char* view = nullptr;
+                size_t size = file->peek(VIEW_SIZE, view);
+                if (in_line) {
+                    // Finish the line a view ended in the middle of.
+                    const void* newline = size > 0 ? std::memchr(view, '\n', size) : nullptr;
+                    size_t taken = newline ? static_cast<size_t>(static_cast<const char*>(newline) - view) : size;
+                    carry.append(view, taken);
+                    file->skip(newline ? taken + 1 : taken);
+                    if (newline == nullptr && size > 0) continue;
+                    in_line = false;
+                    bool matched = regex->findLine(carry.data(), carry.size(), 0, line_start, line_end);
+                    if (matched) item = lineValue(carry.data(), carry.size());
+                    carry.clear();
+                    if (matched) return true;
+                    continue;
+                }
+                if (size == 0) return false;
+                size_t complete = size;
+                while (complete > 0 && view[complete - 1] != '\n') --complete;
+                if (complete == 0) {
+                    in_line = true;
+                    continue;
+                }
+                if (regex->findLine(view, complete, 0, line_start, line_end)) {
+                    item = lineValue(view + line_start, line_end - line_start);
+                    file->skip(line_end + 1);
+                    return true;
+                }
+                file->skip(complete);
+            }
+        }
+
+        std::string describe() const override { return "<regex lines>"; }
+
+    private:
+        static constexpr size_t VIEW_SIZE = 1 << 20;
+
+        // Without the "\r" of a "\r\n" line break.
+        static NyxValue lineValue(const char* data, size_t size) {
+            if (size > 0 && data[size - 1] == '\r') --size;
+            return NyxValue(std::string(data, size));
+        }
+
+        RegexPtr regex;
+        std::string held_text;
+        FrozenValuePtr held_frozen;
+        BytesPtr held_bytes;
+        const char* memory = nullptr;
+        size_t memory_size = 0;
+        size_t position = 0;
+        FilePtr file;
+        std::string carry;    // the start of a line that ran past the end of a view
+        bool in_line = false;
+    };
+}
+
+// regex.compile(pattern, [flags]): flags are a string of i, m and s.
+NyxValue native_regex_compile(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty() || args.size() > 2) {
+        throw Common::NyxRuntimeException("'regex.compile' expects 1 or 2 arguments (pattern, [flags]).", 0);
+    }
+    const std::string* pattern = stringOf(args[0]);
+    if (!pattern) throw Common::NyxRuntimeException("'regex.compile' expects a pattern string, got " + nyxValueTypeToString(args[0]) + ".", 0);
+    std::string flags;
+    if (args.size() == 2) {
+        const std::string* text = stringOf(args[1]);
+        if (!text) throw Common::NyxRuntimeException("'regex.compile' expects flags as a string such as \"im\", got " + nyxValueTypeToString(args[1]) + ".", 0);
+        flags = *text;
+    }
+    return NyxValue(cachedRegex(*pattern, flags));
+}
+
+NyxValue native_regex_test(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() != 2) {
+        throw Common::NyxRuntimeException("'regex.test' expects 2 arguments (regex, text).", 0);
+    }
+    RegexPtr regex = expectRegex(args[0], "regex.test");
+    Text text = expectText(args[1], "regex.test");
+    return NyxValue(regex->test(text.data, text.size));
+}
+
+// regex.match(regex, text): the whole text must match.
+NyxValue native_regex_match(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() != 2) {
+        throw Common::NyxRuntimeException("'regex.match' expects 2 arguments (regex, text).", 0);
+    }
+    RegexPtr regex = expectRegex(args[0], "regex.match");
+    Text text = expectText(args[1], "regex.match");
+    std::vector<size_t> slots;
+    if (!regex->matchWhole(text.data, text.size, &slots)) return NyxValue(std::monostate{});
+    return matchValue(*regex, text, slots);
+}
+
+// regex.search(regex, text, [start]): the first match at or after `start`.
+NyxValue native_regex_search(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'regex.search' expects 2 or 3 arguments (regex, text, [start]).", 0);
+    }
+    RegexPtr regex = expectRegex(args[0], "regex.search");
+    Text text = expectText(args[1], "regex.search");
+    size_t from = args.size() == 3 ? expectCount(interpreter, args[2], "regex.search", "the start") : 0;
+    if (from > text.size) return NyxValue(std::monostate{});
+    std::vector<size_t> slots;
+    size_t start = 0;
+    size_t end = 0;
+    if (!regex->search(text.data, text.size, from, start, end, &slots)) return NyxValue(std::monostate{});
+    return matchValue(*regex, text, slots);
+}
+
+NyxValue native_regex_findAll(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() != 2) {
+        throw Common::NyxRuntimeException("'regex.findAll' expects 2 arguments (regex, text).", 0);
+    }
+    RegexPtr regex = expectRegex(args[0], "regex.findAll");
+    Text text = expectText(args[1], "regex.findAll");
+    MatchCursor cursor(*regex, text, true);
+    NyxList matches;
+    while (cursor.next()) {
+        matches.push_back(matchValue(*regex, text, cursor.slots));
+        if (matches.size() % HEAP_CHECK_MATCHES == 0 && HeapAccounting::overLimit()) HeapAccounting::enforceLimit(0);
+    }
+    return NyxValue(std::move(matches));
+}
+
+// regex.replace(regex, text, replacement, [count]): replaces the first
+// `count` matches (all of them by default) with a replacement string, or
+// with what a function returns when given the match.
+NyxValue native_regex_replace(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 3 || args.size() > 4) {
+        throw Common::NyxRuntimeException("'regex.replace' expects 3 or 4 arguments (regex, text, replacement, [count]).", 0);
+    }
+    RegexPtr regex = expectRegex(args[0], "regex.replace");
+    Text text = expectText(args[1], "regex.replace");
+    size_t limit = args.size() == 4 ? expectCount(interpreter, args[3], "regex.replace", "the count") : static_cast<size_t>(-1);
+
+    std::unique_ptr<Replacement> replacement;
+    std::unique_ptr<CallbackFrame> callback;
+    if (const std::string* pattern = stringOf(args[2])) {
+        replacement = std::make_unique<Replacement>(*pattern, *regex);
+    } else {
+        callback = std::make_unique<CallbackFrame>(interpreter, args[2], 1, "regex.replace");
+    }
+    MatchCursor cursor(*regex, text, callback || replacement->usesGroups());
+    std::string out;
+    out.reserve(text.size);
+    size_t copied = 0;
+    for (size_t replaced = 0; replaced < limit && cursor.next(); ++replaced) {
+        out.append(text.data + copied, cursor.start - copied);
+        copied = cursor.end;
+        if (replacement) {
+            if (cursor.slots.empty()) cursor.slots.assign({cursor.start, cursor.end});
+            replacement->append(out, text, cursor.slots);
+            continue;
+        }
+        NyxValue result = callback->call(matchValue(*regex, text, cursor.slots));
+        const std::string* piece = stringOf(result);
+        if (!piece) {
+            throw Common::NyxRuntimeException("'regex.replace' expects the replacement function to return a string, got " + nyxValueTypeToString(result) + ".", 0);
+        }
+        out += *piece;
+    }
+    out.append(text.data + copied, text.size - copied);
+    return NyxValue(std::move(out));
+}
+
+// regex.split(regex, text, [limit]): the pieces between matches, at most
+// `limit` of them. An empty match at the start or end of the text does not
+// split off an empty piece.
+NyxValue native_regex_split(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw Common::NyxRuntimeException("'regex.split' expects 2 or 3 arguments (regex, text, [limit]).", 0);
+    }
+    RegexPtr regex = expectRegex(args[0], "regex.split");
+    Text text = expectText(args[1], "regex.split");
+    size_t limit = args.size() == 3 ? expectCount(interpreter, args[2], "regex.split", "the limit") : static_cast<size_t>(-1);
+    NyxList pieces;
+    if (limit == 0) return NyxValue(std::move(pieces));
+    MatchCursor cursor(*regex, text, false);
+    size_t piece_start = 0;
+    while (pieces.size() + 1 < limit && cursor.next()) {
+        if (cursor.start == cursor.end && (cursor.start == 0 || cursor.start == text.size)) continue;
+        pieces.emplace_back(std::string(text.data + piece_start, cursor.start - piece_start));
+        piece_start = cursor.end;
+        if (pieces.size() % HEAP_CHECK_MATCHES == 0 && HeapAccounting::overLimit()) HeapAccounting::enforceLimit(0);
+    }
+    pieces.emplace_back(std::string(text.data + piece_start, text.size - piece_start));
+    return NyxValue(std::move(pieces));
+}
+
+// regex.escape(text): a pattern matching exactly `text`.
+NyxValue native_regex_escape(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() != 1) {
+        throw Common::NyxRuntimeException("'regex.escape' expects 1 argument (text).", 0);
+    }
+    const std::string* text = stringOf(args[0]);
+    if (!text) throw Common::NyxRuntimeException("'regex.escape' expects a string, got " + nyxValueTypeToString(args[0]) + ".", 0);
+    std::string escaped;
+    escaped.reserve(text->size() * 2);
+    for (char c : *text) {
+        if (std::strchr("\\.+*?()|[]{}^$#&-~", c) && c != '\0') escaped += '\\';
+        escaped += c;
+    }
+    return NyxValue(std::move(escaped));
+}
+
+// regex.lines(regex, source): an iterator over the lines with a match.
+NyxValue native_regex_lines(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() != 2) {
+        throw Common::NyxRuntimeException("'regex.lines' expects 2 arguments (regex, source).", 0);
+    }
+    RegexPtr regex = expectRegex(args[0], "regex.lines");
+    return NyxValue(IteratorPtr(std::make_shared<LinesIterator>(std::move(regex), args[1])));
+}
+
+
+namespace {
+    constexpr NativeModuleMember REGEX_MODULE_MEMBERS[] = {
+        nativeFunction("compile", native_regex_compile, -1),
+        nativeFunction("test", native_regex_test, 2),
+        nativeFunction("match", native_regex_match, 2),
+        nativeFunction("search", native_regex_search, -1),
+        nativeFunction("findAll", native_regex_findAll, 2),
+        nativeFunction("replace", native_regex_replace, -1),
+        nativeFunction("split", native_regex_split, -1),
+        nativeFunction("escape", native_regex_escape, 1),
+        nativeFunction("lines", native_regex_lines, 2),
+    };
+
+    const NativeModuleTable REGEX_MODULE(REGEX_MODULE_MEMBERS);
+}
+
+void registerStdRegexModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:regex", REGEX_MODULE);
+}
+
+}
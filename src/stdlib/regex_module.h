@@ -0,0 +1,25 @@
+#ifndef NYX_STDLIB_REGEX_H
+#define NYX_STDLIB_REGEX_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_regex_compile(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_regex_test(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_regex_match(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_regex_search(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_regex_findAll(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_regex_replace(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_regex_split(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_regex_escape(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_regex_lines(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdRegexModule(Interpreter& interpreter);
+
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "./sdl_module.h"
+#include "./native_module_table.h"
 #include "../interpreter/Interpreter.h"
 #include "../interpreter/Environment.h"
 #include "../common/Utils.h"
@@ -413,112 +414,112 @@ NyxValue native_sdl_createTextureFromSurface(Interpreter& interpreter, const std
 }
 
 
-void registerStdSdlModule(Interpreter& interpreter) {
-    Interpreter::NativeModuleBuilder builder = [&]() {
-        auto module_env = std::make_shared<Environment>(interpreter.globals);
-        
-        module_env->define("init", NyxValue(std::make_shared<NyxNativeFunction>("init", native_sdl_init, 1)));
-        module_env->define("quit", NyxValue(std::make_shared<NyxNativeFunction>("quit", native_sdl_quit, 0)));
-        module_env->define("createWindow", NyxValue(std::make_shared<NyxNativeFunction>("createWindow", native_sdl_createWindow, 6)));
-        module_env->define("createRenderer", NyxValue(std::make_shared<NyxNativeFunction>("createRenderer", native_sdl_createRenderer, 3)));
-        module_env->define("setRenderDrawColor", NyxValue(std::make_shared<NyxNativeFunction>("setRenderDrawColor", native_sdl_setRenderDrawColor, 5)));
-        module_env->define("renderClear", NyxValue(std::make_shared<NyxNativeFunction>("renderClear", native_sdl_renderClear, 1)));
-        module_env->define("renderFillRect", NyxValue(std::make_shared<NyxNativeFunction>("renderFillRect", native_sdl_renderFillRect, 2)));
-        module_env->define("renderCopy", NyxValue(std::make_shared<NyxNativeFunction>("renderCopy", native_sdl_renderCopy, 4)));
-        module_env->define("queryTexture", NyxValue(std::make_shared<NyxNativeFunction>("queryTexture", native_sdl_queryTexture, 1)));
-        module_env->define("renderPresent", NyxValue(std::make_shared<NyxNativeFunction>("renderPresent", native_sdl_renderPresent, 1)));
-        module_env->define("delay", NyxValue(std::make_shared<NyxNativeFunction>("delay", native_sdl_delay, 1)));
-        module_env->define("pollEvent", NyxValue(std::make_shared<NyxNativeFunction>("pollEvent", native_sdl_pollEvent, 0)));
-        
-        module_env->define("ttf_init", NyxValue(std::make_shared<NyxNativeFunction>("ttf_init", native_sdl_ttf_init, 0)));
-        module_env->define("ttf_quit", NyxValue(std::make_shared<NyxNativeFunction>("ttf_quit", native_sdl_ttf_quit, 0)));
-        module_env->define("ttf_openFont", NyxValue(std::make_shared<NyxNativeFunction>("ttf_openFont", native_sdl_ttf_openFont, 2)));
-        module_env->define("ttf_renderTextBlended", NyxValue(std::make_shared<NyxNativeFunction>("ttf_renderTextBlended", native_sdl_ttf_renderTextBlended, 6)));
-        module_env->define("createTextureFromSurface", NyxValue(std::make_shared<NyxNativeFunction>("createTextureFromSurface", native_sdl_createTextureFromSurface, 2)));
-        
-        module_env->define("SDL_INIT_VIDEO", NyxValue(static_cast<double>(SDL_INIT_VIDEO)));
-        module_env->define("SDL_INIT_AUDIO", NyxValue(static_cast<double>(SDL_INIT_AUDIO)));
-        module_env->define("SDL_INIT_TIMER", NyxValue(static_cast<double>(SDL_INIT_TIMER)));
-        module_env->define("SDL_INIT_EVENTS", NyxValue(static_cast<double>(SDL_INIT_EVENTS)));
-        module_env->define("SDL_INIT_EVERYTHING", NyxValue(static_cast<double>(SDL_INIT_EVERYTHING)));
-
-        module_env->define("SDL_WINDOWPOS_UNDEFINED", NyxValue(static_cast<double>(SDL_WINDOWPOS_UNDEFINED)));
-        module_env->define("SDL_WINDOWPOS_CENTERED", NyxValue(static_cast<double>(SDL_WINDOWPOS_CENTERED)));
-        
-        module_env->define("SDL_WINDOW_FULLSCREEN", NyxValue(static_cast<double>(SDL_WINDOW_FULLSCREEN)));
-        module_env->define("SDL_WINDOW_OPENGL", NyxValue(static_cast<double>(SDL_WINDOW_OPENGL)));
-        module_env->define("SDL_WINDOW_SHOWN", NyxValue(static_cast<double>(SDL_WINDOW_SHOWN)));
-        module_env->define("SDL_WINDOW_HIDDEN", NyxValue(static_cast<double>(SDL_WINDOW_HIDDEN)));
-        module_env->define("SDL_WINDOW_BORDERLESS", NyxValue(static_cast<double>(SDL_WINDOW_BORDERLESS)));
-        module_env->define("SDL_WINDOW_RESIZABLE", NyxValue(static_cast<double>(SDL_WINDOW_RESIZABLE)));
-        module_env->define("SDL_WINDOW_MINIMIZED", NyxValue(static_cast<double>(SDL_WINDOW_MINIMIZED)));
-        module_env->define("SDL_WINDOW_MAXIMIZED", NyxValue(static_cast<double>(SDL_WINDOW_MAXIMIZED)));
-
-        module_env->define("SDL_RENDERER_SOFTWARE", NyxValue(static_cast<double>(SDL_RENDERER_SOFTWARE)));
-        module_env->define("SDL_RENDERER_ACCELERATED", NyxValue(static_cast<double>(SDL_RENDERER_ACCELERATED)));
-        module_env->define("SDL_RENDERER_PRESENTVSYNC", NyxValue(static_cast<double>(SDL_RENDERER_PRESENTVSYNC)));
-        module_env->define("SDL_RENDERER_TARGETTEXTURE", NyxValue(static_cast<double>(SDL_RENDERER_TARGETTEXTURE)));
-        
-        Uint32 combined_renderer_flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
-        module_env->define("SDL_RENDERER_ACCELERATED_VSYNC", NyxValue(static_cast<double>(combined_renderer_flags)));
-
-        module_env->define("SDL_QUIT", NyxValue(static_cast<double>(SDL_QUIT)));
-        module_env->define("SDL_KEYDOWN", NyxValue(static_cast<double>(SDL_KEYDOWN)));
-        module_env->define("SDL_KEYUP", NyxValue(static_cast<double>(SDL_KEYUP)));
-        module_env->define("SDL_MOUSEMOTION", NyxValue(static_cast<double>(SDL_MOUSEMOTION)));
-        module_env->define("SDL_MOUSEBUTTONDOWN", NyxValue(static_cast<double>(SDL_MOUSEBUTTONDOWN)));
-        module_env->define("SDL_MOUSEBUTTONUP", NyxValue(static_cast<double>(SDL_MOUSEBUTTONUP)));
-
-        module_env->define("K_UNKNOWN", NyxValue(static_cast<double>(SDLK_UNKNOWN)));
-        module_env->define("K_RETURN", NyxValue(static_cast<double>(SDLK_RETURN)));
-        module_env->define("K_ESCAPE", NyxValue(static_cast<double>(SDLK_ESCAPE)));
-        module_env->define("K_BACKSPACE", NyxValue(static_cast<double>(SDLK_BACKSPACE)));
-        module_env->define("K_TAB", NyxValue(static_cast<double>(SDLK_TAB)));
-        module_env->define("K_SPACE", NyxValue(static_cast<double>(SDLK_SPACE)));
-        module_env->define("K_0", NyxValue(static_cast<double>(SDLK_0)));
-        module_env->define("K_1", NyxValue(static_cast<double>(SDLK_1)));
-        module_env->define("K_2", NyxValue(static_cast<double>(SDLK_2)));
-        module_env->define("K_3", NyxValue(static_cast<double>(SDLK_3)));
-        module_env->define("K_4", NyxValue(static_cast<double>(SDLK_4)));
-        module_env->define("K_5", NyxValue(static_cast<double>(SDLK_5)));
-        module_env->define("K_6", NyxValue(static_cast<double>(SDLK_6)));
-        module_env->define("K_7", NyxValue(static_cast<double>(SDLK_7)));
-        module_env->define("K_8", NyxValue(static_cast<double>(SDLK_8)));
-        module_env->define("K_9", NyxValue(static_cast<double>(SDLK_9)));
-        module_env->define("K_a", NyxValue(static_cast<double>(SDLK_a)));
-        module_env->define("K_b", NyxValue(static_cast<double>(SDLK_b)));
-        module_env->define("K_c", NyxValue(static_cast<double>(SDLK_c)));
-        module_env->define("K_d", NyxValue(static_cast<double>(SDLK_d)));
-        module_env->define("K_e", NyxValue(static_cast<double>(SDLK_e)));
-        module_env->define("K_f", NyxValue(static_cast<double>(SDLK_f)));
-        module_env->define("K_g", NyxValue(static_cast<double>(SDLK_g)));
-        module_env->define("K_h", NyxValue(static_cast<double>(SDLK_h)));
-        module_env->define("K_i", NyxValue(static_cast<double>(SDLK_i)));
-        module_env->define("K_j", NyxValue(static_cast<double>(SDLK_j)));
-        module_env->define("K_k", NyxValue(static_cast<double>(SDLK_k)));
-        module_env->define("K_l", NyxValue(static_cast<double>(SDLK_l)));
-        module_env->define("K_m", NyxValue(static_cast<double>(SDLK_m)));
-        module_env->define("K_n", NyxValue(static_cast<double>(SDLK_n)));
-        module_env->define("K_o", NyxValue(static_cast<double>(SDLK_o)));
-        module_env->define("K_p", NyxValue(static_cast<double>(SDLK_p)));
-        module_env->define("K_q", NyxValue(static_cast<double>(SDLK_q)));
-        module_env->define("K_r", NyxValue(static_cast<double>(SDLK_r)));
-        module_env->define("K_s", NyxValue(static_cast<double>(SDLK_s)));
-        module_env->define("K_t", NyxValue(static_cast<double>(SDLK_t)));
-        module_env->define("K_u", NyxValue(static_cast<double>(SDLK_u)));
-        module_env->define("K_v", NyxValue(static_cast<double>(SDLK_v)));
-        module_env->define("K_w", NyxValue(static_cast<double>(SDLK_w)));
-        module_env->define("K_x", NyxValue(static_cast<double>(SDLK_x)));
-        module_env->define("K_y", NyxValue(static_cast<double>(SDLK_y)));
-        module_env->define("K_z", NyxValue(static_cast<double>(SDLK_z)));
-        module_env->define("K_UP", NyxValue(static_cast<double>(SDLK_UP)));
-        module_env->define("K_DOWN", NyxValue(static_cast<double>(SDLK_DOWN)));
-        module_env->define("K_LEFT", NyxValue(static_cast<double>(SDLK_LEFT)));
-        module_env->define("K_RIGHT", NyxValue(static_cast<double>(SDLK_RIGHT)));
-        
-        return module_env;
+namespace {
+    constexpr NativeModuleMember SDL_MODULE_MEMBERS[] = {
+        nativeFunction("init", native_sdl_init, 1),
+        nativeFunction("quit", native_sdl_quit, 0),
+        nativeFunction("createWindow", native_sdl_createWindow, 6),
+        nativeFunction("createRenderer", native_sdl_createRenderer, 3),
+        nativeFunction("setRenderDrawColor", native_sdl_setRenderDrawColor, 5),
+        nativeFunction("renderClear", native_sdl_renderClear, 1),
+        nativeFunction("renderFillRect", native_sdl_renderFillRect, 2),
+        nativeFunction("renderCopy", native_sdl_renderCopy, 4),
+        nativeFunction("queryTexture", native_sdl_queryTexture, 1),
+        nativeFunction("renderPresent", native_sdl_renderPresent, 1),
+        nativeFunction("delay", native_sdl_delay, 1),
+        nativeFunction("pollEvent", native_sdl_pollEvent, 0),
+
+        nativeFunction("ttf_init", native_sdl_ttf_init, 0),
+        nativeFunction("ttf_quit", native_sdl_ttf_quit, 0),
+        nativeFunction("ttf_openFont", native_sdl_ttf_openFont, 2),
+        nativeFunction("ttf_renderTextBlended", native_sdl_ttf_renderTextBlended, 6),
+        nativeFunction("createTextureFromSurface", native_sdl_createTextureFromSurface, 2),
+
+        nativeConstant("SDL_INIT_VIDEO", static_cast<double>(SDL_INIT_VIDEO)),
+        nativeConstant("SDL_INIT_AUDIO", static_cast<double>(SDL_INIT_AUDIO)),
+        nativeConstant("SDL_INIT_TIMER", static_cast<double>(SDL_INIT_TIMER)),
+        nativeConstant("SDL_INIT_EVENTS", static_cast<double>(SDL_INIT_EVENTS)),
+        nativeConstant("SDL_INIT_EVERYTHING", static_cast<double>(SDL_INIT_EVERYTHING)),
+
+        nativeConstant("SDL_WINDOWPOS_UNDEFINED", static_cast<double>(SDL_WINDOWPOS_UNDEFINED)),
+        nativeConstant("SDL_WINDOWPOS_CENTERED", static_cast<double>(SDL_WINDOWPOS_CENTERED)),
+
+        nativeConstant("SDL_WINDOW_FULLSCREEN", static_cast<double>(SDL_WINDOW_FULLSCREEN)),
+        nativeConstant("SDL_WINDOW_OPENGL", static_cast<double>(SDL_WINDOW_OPENGL)),
+        nativeConstant("SDL_WINDOW_SHOWN", static_cast<double>(SDL_WINDOW_SHOWN)),
+        nativeConstant("SDL_WINDOW_HIDDEN", static_cast<double>(SDL_WINDOW_HIDDEN)),
+        nativeConstant("SDL_WINDOW_BORDERLESS", static_cast<double>(SDL_WINDOW_BORDERLESS)),
+        nativeConstant("SDL_WINDOW_RESIZABLE", static_cast<double>(SDL_WINDOW_RESIZABLE)),
+        nativeConstant("SDL_WINDOW_MINIMIZED", static_cast<double>(SDL_WINDOW_MINIMIZED)),
+        nativeConstant("SDL_WINDOW_MAXIMIZED", static_cast<double>(SDL_WINDOW_MAXIMIZED)),
+
+        nativeConstant("SDL_RENDERER_SOFTWARE", static_cast<double>(SDL_RENDERER_SOFTWARE)),
+        nativeConstant("SDL_RENDERER_ACCELERATED", static_cast<double>(SDL_RENDERER_ACCELERATED)),
+        nativeConstant("SDL_RENDERER_PRESENTVSYNC", static_cast<double>(SDL_RENDERER_PRESENTVSYNC)),
+        nativeConstant("SDL_RENDERER_TARGETTEXTURE", static_cast<double>(SDL_RENDERER_TARGETTEXTURE)),
+
+        nativeConstant("SDL_RENDERER_ACCELERATED_VSYNC", static_cast<double>(SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)),
+
+        nativeConstant("SDL_QUIT", static_cast<double>(SDL_QUIT)),
+        nativeConstant("SDL_KEYDOWN", static_cast<double>(SDL_KEYDOWN)),
+        nativeConstant("SDL_KEYUP", static_cast<double>(SDL_KEYUP)),
+        nativeConstant("SDL_MOUSEMOTION", static_cast<double>(SDL_MOUSEMOTION)),
+        nativeConstant("SDL_MOUSEBUTTONDOWN", static_cast<double>(SDL_MOUSEBUTTONDOWN)),
+        nativeConstant("SDL_MOUSEBUTTONUP", static_cast<double>(SDL_MOUSEBUTTONUP)),
+
+        nativeConstant("K_UNKNOWN", static_cast<double>(SDLK_UNKNOWN)),
+        nativeConstant("K_RETURN", static_cast<double>(SDLK_RETURN)),
+        nativeConstant("K_ESCAPE", static_cast<double>(SDLK_ESCAPE)),
+        nativeConstant("K_BACKSPACE", static_cast<double>(SDLK_BACKSPACE)),
+        nativeConstant("K_TAB", static_cast<double>(SDLK_TAB)),
+        nativeConstant("K_SPACE", static_cast<double>(SDLK_SPACE)),
+        nativeConstant("K_0", static_cast<double>(SDLK_0)),
+        nativeConstant("K_1", static_cast<double>(SDLK_1)),
+        nativeConstant("K_2", static_cast<double>(SDLK_2)),
+        nativeConstant("K_3", static_cast<double>(SDLK_3)),
+        nativeConstant("K_4", static_cast<double>(SDLK_4)),
+        nativeConstant("K_5", static_cast<double>(SDLK_5)),
+        nativeConstant("K_6", static_cast<double>(SDLK_6)),
+        nativeConstant("K_7", static_cast<double>(SDLK_7)),
+        nativeConstant("K_8", static_cast<double>(SDLK_8)),
+        nativeConstant("K_9", static_cast<double>(SDLK_9)),
+        nativeConstant("K_a", static_cast<double>(SDLK_a)),
+        nativeConstant("K_b", static_cast<double>(SDLK_b)),
+        nativeConstant("K_c", static_cast<double>(SDLK_c)),
+        nativeConstant("K_d", static_cast<double>(SDLK_d)),
+        nativeConstant("K_e", static_cast<double>(SDLK_e)),
+        nativeConstant("K_f", static_cast<double>(SDLK_f)),
+        nativeConstant("K_g", static_cast<double>(SDLK_g)),
+        nativeConstant("K_h", static_cast<double>(SDLK_h)),
+        nativeConstant("K_i", static_cast<double>(SDLK_i)),
+        nativeConstant("K_j", static_cast<double>(SDLK_j)),
+        nativeConstant("K_k", static_cast<double>(SDLK_k)),
+        nativeConstant("K_l", static_cast<double>(SDLK_l)),
+        nativeConstant("K_m", static_cast<double>(SDLK_m)),
+        nativeConstant("K_n", static_cast<double>(SDLK_n)),
+        nativeConstant("K_o", static_cast<double>(SDLK_o)),
+        nativeConstant("K_p", static_cast<double>(SDLK_p)),
+        nativeConstant("K_q", static_cast<double>(SDLK_q)),
+        nativeConstant("K_r", static_cast<double>(SDLK_r)),
+        nativeConstant("K_s", static_cast<double>(SDLK_s)),
+        nativeConstant("K_t", static_cast<double>(SDLK_t)),
+        nativeConstant("K_u", static_cast<double>(SDLK_u)),
+        nativeConstant("K_v", static_cast<double>(SDLK_v)),
+        nativeConstant("K_w", static_cast<double>(SDLK_w)),
+        nativeConstant("K_x", static_cast<double>(SDLK_x)),
+        nativeConstant("K_y", static_cast<double>(SDLK_y)),
+        nativeConstant("K_z", static_cast<double>(SDLK_z)),
+        nativeConstant("K_UP", static_cast<double>(SDLK_UP)),
+        nativeConstant("K_DOWN", static_cast<double>(SDLK_DOWN)),
+        nativeConstant("K_LEFT", static_cast<double>(SDLK_LEFT)),
+        nativeConstant("K_RIGHT", static_cast<double>(SDLK_RIGHT)),
     };
-    interpreter.registerNativeModule("std:sdl", builder);
+
+    const NativeModuleTable SDL_MODULE(SDL_MODULE_MEMBERS);
+}
+
+void registerStdSdlModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:sdl", SDL_MODULE);
 }
 
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "./string_module.h"
+#include "./native_module_table.h"
 #include "../interpreter/Interpreter.h"
 #include "../interpreter/Environment.h"
 #include "../common/Utils.h"
@@ -196,24 +197,25 @@ NyxValue native_string_replace(Interpreter& interpreter, const std::vector<NyxVa
 }
 
 
-void registerStdStringModule(Interpreter& interpreter) {
-    Interpreter::NativeModuleBuilder builder = [&]() {
-        auto module_env = std::make_shared<Environment>(interpreter.globals);
-
-        module_env->define("toNumber", NyxValue(std::make_shared<NyxNativeFunction>("toNumber", native_string_toNumber, 1)));
-        module_env->define("trim", NyxValue(std::make_shared<NyxNativeFunction>("trim", native_string_trim, 1)));
-        module_env->define("toLowerCase", NyxValue(std::make_shared<NyxNativeFunction>("toLowerCase", native_string_toLowerCase, 1)));
-        module_env->define("toUpperCase", NyxValue(std::make_shared<NyxNativeFunction>("toUpperCase", native_string_toUpperCase, 1)));
-        module_env->define("contains", NyxValue(std::make_shared<NyxNativeFunction>("contains", native_string_contains, 2)));
-        module_env->define("startsWith", NyxValue(std::make_shared<NyxNativeFunction>("startsWith", native_string_startsWith, 2)));
-        module_env->define("endsWith", NyxValue(std::make_shared<NyxNativeFunction>("endsWith", native_string_endsWith, 2)));
-        module_env->define("split", NyxValue(std::make_shared<NyxNativeFunction>("split", native_string_split, 2)));
-        module_env->define("substring", NyxValue(std::make_shared<NyxNativeFunction>("substring", native_string_substring, -1)));
-        module_env->define("replace", NyxValue(std::make_shared<NyxNativeFunction>("replace", native_string_replace, 3)));
-        
-        return module_env;
+namespace {
+    constexpr NativeModuleMember STRING_MODULE_MEMBERS[] = {
+        nativeFunction("toNumber", native_string_toNumber, 1),
+        nativeFunction("trim", native_string_trim, 1),
+        nativeFunction("toLowerCase", native_string_toLowerCase, 1),
+        nativeFunction("toUpperCase", native_string_toUpperCase, 1),
+        nativeFunction("contains", native_string_contains, 2),
+        nativeFunction("startsWith", native_string_startsWith, 2),
+        nativeFunction("endsWith", native_string_endsWith, 2),
+        nativeFunction("split", native_string_split, 2),
+        nativeFunction("substring", native_string_substring, -1),
+        nativeFunction("replace", native_string_replace, 3),
     };
-    interpreter.registerNativeModule("std:string", builder);
+
+    const NativeModuleTable STRING_MODULE(STRING_MODULE_MEMBERS);
+}
+
+void registerStdStringModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:string", STRING_MODULE);
 }
 
 }
\ No newline at end of file
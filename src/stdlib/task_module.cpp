@@ -0,0 +1,170 @@
+#include "./task_module.h"
+#include "./native_module_table.h"
+#include "../interpreter/Interpreter.h"
+#include "../interpreter/TaskScheduler.h"
+#include "../interpreter/ValueSnapshot.h"
+#include "../common/HeapAccounting.h"
+#include "../common/Utils.h"
+
+namespace Nyx {
+
+namespace {
+    // Runs one task in a fresh interpreter on the current (worker) thread. The
+    // interpreter is destroyed, after waiting for any tasks it spawned itself,
+    // before the future settles.
+    void runTask(NyxTaskFuture& future, const ValueSnapshot& call, const std::string& script_directory, size_t heap_limit) {
+        size_t previous_limit = HeapAccounting::limit();
+        HeapAccounting::setLimit(heap_limit);
+        try {
+            ValueSnapshot result;
+            {
+                Interpreter isolate;
+                isolate.setScriptDirectory(script_directory);
+                std::vector<NyxValue> values = call.materialize();
+                std::vector<NyxValue> arguments(values.begin() + 1, values.end());
+                NyxValue value = isolate.callFunction(values[0], arguments, 0);
+                result = ValueSnapshot({value});
+            }
+            future.resolve(std::move(result));
+        } catch (const Common::NyxException& e) {
+            future.reject(e.what());
+        } catch (const std::exception& e) {
+            future.reject(std::string("Unexpected error: ") + e.what());
+        }
+        HeapAccounting::setLimit(previous_limit);
+    }
+
+    const TaskFuturePtr& expectFuture(const NyxValue& value, const std::string& function_name) {
+        const auto* future = std::get_if<TaskFuturePtr>(&value.data);
+        if (!future || !*future) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects a task returned by 'task.spawn', got " + nyxValueTypeToString(value) + ".", 0);
+        }
+        return *future;
+    }
+
+    std::vector<TaskFuturePtr> expectFutureList(const std::vector<NyxValue>& args, const std::string& function_name) {
+        if (args.size() != 1 || !std::holds_alternative<NyxList>(args[0].data)) {
+            throw Common::NyxRuntimeException("'" + function_name + "' expects one list of tasks.", 0);
+        }
+        std::vector<TaskFuturePtr> futures;
+        for (const NyxValue& element : std::get<NyxList>(args[0].data)) {
+            futures.push_back(expectFuture(element, function_name));
+        }
+        return futures;
+    }
+
+    // Rebuilds a settled task's result in the calling interpreter, or raises its error.
+    NyxValue settledValue(const NyxTaskFuture& future) {
+        if (future.failed()) {
+            throw Common::NyxRuntimeException("Task failed: " + future.error(), 0);
+        }
+        return future.result().materialize()[0];
+    }
+}
+
+NyxValue native_task_spawn(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.empty()) {
+        throw Common::NyxRuntimeException("'task.spawn' expects a function followed by its arguments.", 0);
+    }
+    const auto& callee = args[0].data;
+    if (const auto* function = std::get_if<UserDefinedFunctionPtr>(&callee)) {
+        if (*function && (*function)->arity() != args.size() - 1) {
+            throw Common::NyxRuntimeException("'task.spawn': function '" + (*function)->name() + "' expects " +
+                                              std::to_string((*function)->arity()) + " arguments but got " +
+                                              std::to_string(args.size() - 1) + ".", 0);
+        }
+    } else if (!std::holds_alternative<NativeFunctionPtr>(callee)) {
+        throw Common::NyxRuntimeException("'task.spawn' expects a function as its first argument.", 0);
+    }
+
+    // Copy the function, what it can see and its arguments now, on this
+    // thread; the task gets its own copies and never touches ours.
+    auto call = std::make_shared<const ValueSnapshot>(args);
+    auto future = std::make_shared<NyxTaskFuture>();
+    std::shared_ptr<TaskGroup> group = interpreter.taskGroup();
+    std::string script_directory = interpreter.scriptDirectory();
+    size_t heap_limit = HeapAccounting::limit();
+
+    group->add();
+    TaskScheduler::shared().submit([future, call, group, script_directory, heap_limit]() {
+        runTask(*future, *call, script_directory, heap_limit);
+        group->done();
+    });
+    return NyxValue(future);
+}
+
+NyxValue native_task_await(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() != 1) {
+        throw Common::NyxRuntimeException("'task.await' expects one task.", 0);
+    }
+    TaskFuturePtr future = expectFuture(args[0], "task.await");
+    if (!future->isSettled()) {
+        TaskScheduler::shared().waitUntil([&]() { return future->isSettled(); });
+    }
+    return settledValue(*future);
+}
+
+NyxValue native_task_all(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    std::vector<TaskFuturePtr> futures = expectFutureList(args, "task.all");
+    NyxList results;
+    results.reserve(futures.size());
+    for (const TaskFuturePtr& future : futures) {
+        if (!future->isSettled()) {
+            TaskScheduler::shared().waitUntil([&]() { return future->isSettled(); });
+        }
+        results.push_back(settledValue(*future));
+    }
+    return NyxValue(std::move(results));
+}
+
+NyxValue native_task_race(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    std::vector<TaskFuturePtr> futures = expectFutureList(args, "task.race");
+    if (futures.empty()) {
+        throw Common::NyxRuntimeException("'task.race' expects at least one task.", 0);
+    }
+    const NyxTaskFuture* winner = nullptr;
+    TaskScheduler::shared().waitUntil([&]() {
+        for (const TaskFuturePtr& future : futures) {
+            if (future->isSettled()) {
+                winner = future.get();
+                return true;
+            }
+        }
+        return false;
+    });
+    return settledValue(*winner);
+}
+
+NyxValue native_task_done(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (args.size() != 1) {
+        throw Common::NyxRuntimeException("'task.done' expects one task.", 0);
+    }
+    return NyxValue(expectFuture(args[0], "task.done")->isSettled());
+}
+
+NyxValue native_task_workers(Interpreter& interpreter, const std::vector<NyxValue>& args) {
+    if (!args.empty()) {
+        throw Common::NyxRuntimeException("'task.workers' function takes no arguments.", 0);
+    }
+    return NyxValue(static_cast<double>(TaskScheduler::shared().workerCount()));
+}
+
+
+namespace {
+    constexpr NativeModuleMember TASK_MODULE_MEMBERS[] = {
+        nativeFunction("spawn", native_task_spawn, -1),
+        nativeFunction("await", native_task_await, 1),
+        nativeFunction("all", native_task_all, 1),
+        nativeFunction("race", native_task_race, 1),
+        nativeFunction("done", native_task_done, 1),
+        nativeFunction("workers", native_task_workers, 0),
+    };
+
+    const NativeModuleTable TASK_MODULE(TASK_MODULE_MEMBERS);
+}
+
+void registerStdTaskModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:task", TASK_MODULE);
+}
+
+}
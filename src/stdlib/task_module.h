@@ -0,0 +1,22 @@
+#ifndef NYX_STDLIB_TASK_H
+#define NYX_STDLIB_TASK_H
+
+#include "../common/Value.h"
+#include <vector>
+
+namespace Nyx {
+
+class Interpreter;
+
+NyxValue native_task_spawn(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_task_await(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_task_all(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_task_race(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_task_done(Interpreter& interpreter, const std::vector<NyxValue>& args);
+NyxValue native_task_workers(Interpreter& interpreter, const std::vector<NyxValue>& args);
+
+void registerStdTaskModule(Interpreter& interpreter);
+
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "./time_module.h"
+#include "./native_module_table.h"
 #include "../interpreter/Interpreter.h"
 #include "../interpreter/Environment.h"
 #include "../common/Utils.h"
@@ -66,7 +67,7 @@ NyxValue native_time_getLocalTime(Interpreter& interpreter, const std::vector<Ny
     localtime_s(&local_tm, &now_time_t);
     return NyxValue(tm_to_nyxlist(&local_tm));
 #else
-    std::tm* local_tm_ptr = std::localtime(&now_time_t);
+    std::tm* local_tm_ptr = localtime_r(&now_time_t, &local_tm);
     if (local_tm_ptr) {
         return NyxValue(tm_to_nyxlist(local_tm_ptr));
     }
@@ -85,7 +86,7 @@ NyxValue native_time_getUtcTime(Interpreter& interpreter, const std::vector<NyxV
     gmtime_s(&utc_tm, &now_time_t);
     return NyxValue(tm_to_nyxlist(&utc_tm));
 #else
-    std::tm* utc_tm_ptr = std::gmtime(&now_time_t);
+    std::tm* utc_tm_ptr = gmtime_r(&now_time_t, &utc_tm);
      if (utc_tm_ptr) {
         return NyxValue(tm_to_nyxlist(utc_tm_ptr));
     }
@@ -127,7 +128,7 @@ NyxValue native_time_format(Interpreter& interpreter, const std::vector<NyxValue
     localtime_s(&timeinfo_tm, &time_to_format);
     std::tm* timeinfo = &timeinfo_tm;
 #else
-    std::tm* timeinfo = std::localtime(&time_to_format);
+    std::tm* timeinfo = localtime_r(&time_to_format, &timeinfo_tm);
 #endif
 
     if (!timeinfo) {
@@ -142,22 +143,23 @@ NyxValue native_time_format(Interpreter& interpreter, const std::vector<NyxValue
 }
 
 
-void registerStdTimeModule(Interpreter& interpreter) {
-    Interpreter::NativeModuleBuilder builder = [&]() {
-        auto module_env = std::make_shared<Environment>(interpreter.globals);
+namespace {
+    constexpr NativeModuleMember TIME_MODULE_MEMBERS[] = {
+        nativeFunction("clock", native_time_clock, 0),
+        nativeFunction("now", native_time_now, 0),
 
-        module_env->define("clock", NyxValue(std::make_shared<NyxNativeFunction>("clock", native_time_clock, 0)));
-        module_env->define("now", NyxValue(std::make_shared<NyxNativeFunction>("now", native_time_now, 0)));
+        nativeFunction("sleep", native_time_sleep, 1),
+        nativeFunction("getLocalTime", native_time_getLocalTime, 0),
+        nativeFunction("getUtcTime", native_time_getUtcTime, 0),
+        nativeFunction("monotonic", native_time_monotonic, 0),
+        nativeFunction("format", native_time_format, -1), // Arity -1 for 1 or 2 args
+    };
 
-        module_env->define("sleep", NyxValue(std::make_shared<NyxNativeFunction>("sleep", native_time_sleep, 1)));
-        module_env->define("getLocalTime", NyxValue(std::make_shared<NyxNativeFunction>("getLocalTime", native_time_getLocalTime, 0)));
-        module_env->define("getUtcTime", NyxValue(std::make_shared<NyxNativeFunction>("getUtcTime", native_time_getUtcTime, 0)));
-        module_env->define("monotonic", NyxValue(std::make_shared<NyxNativeFunction>("monotonic", native_time_monotonic, 0)));
-        module_env->define("format", NyxValue(std::make_shared<NyxNativeFunction>("format", native_time_format, -1))); // Arity -1 for 1 or 2 args
+    const NativeModuleTable TIME_MODULE(TIME_MODULE_MEMBERS);
+}
 
-        return module_env;
-    };
-    interpreter.registerNativeModule("std:time", builder);
+void registerStdTimeModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:time", TIME_MODULE);
 }
 
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "./type_utils_module.h"
+#include "./native_module_table.h"
 
 #include "../interpreter/Interpreter.h"
 #include "../interpreter/Environment.h"
@@ -15,13 +16,16 @@ NyxValue native_getType(Interpreter& interpreter, const std::vector<NyxValue>& a
     return NyxValue(nyxValueTypeToString(args[0]));
 }
 
-void registerStdTypeUtilsModule(Interpreter& interpreter) {
-    Interpreter::NativeModuleBuilder builder = [&]() {
-        auto module_env = std::make_shared<Environment>(interpreter.globals);
-        module_env->define("getType", NyxValue(std::make_shared<NyxNativeFunction>("getType", native_getType, 1)));
-        return module_env;
+namespace {
+    constexpr NativeModuleMember TYPE_UTILS_MODULE_MEMBERS[] = {
+        nativeFunction("getType", native_getType, 1),
     };
-    interpreter.registerNativeModule("std:type", builder);
+
+    const NativeModuleTable TYPE_UTILS_MODULE(TYPE_UTILS_MODULE_MEMBERS);
+}
+
+void registerStdTypeUtilsModule(Interpreter& interpreter) {
+    interpreter.registerNativeModule("std:type", TYPE_UTILS_MODULE);
 }
 
 }
\ No newline at end of file
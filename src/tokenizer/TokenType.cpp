@@ -21,6 +21,7 @@ std::string tokenTypeToString(TokenType type) {
         case TokenType::KEYWORD_LEN:        return "KEYWORD_LEN";
         case TokenType::KEYWORD_FUNC:       return "KEYWORD_FUNC";
         case TokenType::KEYWORD_RETURN:     return "KEYWORD_RETURN";
+        case TokenType::KEYWORD_YIELD:      return "KEYWORD_YIELD";
         case TokenType::KEYWORD_IMPORT:     return "KEYWORD_IMPORT";
         case TokenType::KEYWORD_AS:         return "KEYWORD_AS";
         case TokenType::KEYWORD_FOREACH:    return "KEYWORD_FOREACH";
@@ -31,6 +32,11 @@ std::string tokenTypeToString(TokenType type) {
         case TokenType::IDENTIFIER:         return "IDENTIFIER";
         case TokenType::STRING_LITERAL:     return "STRING_LITERAL";
         case TokenType::NUMBER_LITERAL:     return "NUMBER_LITERAL";
+        case TokenType::STRING_INTERPOLATION_START: return "STRING_INTERPOLATION_START";
+        case TokenType::STRING_SEGMENT:     return "STRING_SEGMENT";
+        case TokenType::INTERPOLATION_OPEN: return "INTERPOLATION_OPEN";
+        case TokenType::INTERPOLATION_CLOSE: return "INTERPOLATION_CLOSE";
+        case TokenType::STRING_INTERPOLATION_END: return "STRING_INTERPOLATION_END";
         case TokenType::EQUALS:             return "EQUALS";
         case TokenType::LEFT_PAREN:         return "LEFT_PAREN";
         case TokenType::RIGHT_PAREN:        return "RIGHT_PAREN";
@@ -22,6 +22,7 @@ enum class TokenType {
     KEYWORD_LEN,        // len
     KEYWORD_FUNC,       // func
     KEYWORD_RETURN,     // return
+    KEYWORD_YIELD,      // yield
     KEYWORD_IMPORT,     // import
     KEYWORD_AS,         // as
     KEYWORD_FOREACH,    // foreach
@@ -35,6 +36,13 @@ enum class TokenType {
     STRING_LITERAL,     // "a string"
     NUMBER_LITERAL,     // 123, 3.14
 
+    // String Interpolation
+    STRING_INTERPOLATION_START, // opening " of a string containing #{...}
+    STRING_SEGMENT,             // literal text between interpolations
+    INTERPOLATION_OPEN,         // #{
+    INTERPOLATION_CLOSE,        // } closing an interpolation
+    STRING_INTERPOLATION_END,   // closing "
+
     // Single-character Punctuation & Operators
     EQUALS,             // =
     LEFT_PAREN,         // (
@@ -4,7 +4,8 @@
 
 namespace Nyx {
 
-Tokenizer::Tokenizer(std::string source) : source_code(std::move(source)) {
+Tokenizer::Tokenizer(std::string source, std::ostream& diagnostics_stream)
+    : source_code(std::move(source)), diagnostics(diagnostics_stream) {
     keywords["auto"] = TokenType::KEYWORD_AUTO;
     keywords["output"] = TokenType::KEYWORD_OUTPUT;
     keywords["put"] = TokenType::KEYWORD_PUT;
@@ -22,6 +23,7 @@ Tokenizer::Tokenizer(std::string source) : source_code(std::move(source)) {
     keywords["len"] = TokenType::KEYWORD_LEN;
     keywords["func"] = TokenType::KEYWORD_FUNC;
     keywords["return"] = TokenType::KEYWORD_RETURN;
+    keywords["yield"] = TokenType::KEYWORD_YIELD;
     keywords["import"] = TokenType::KEYWORD_IMPORT;
     keywords["as"] = TokenType::KEYWORD_AS;
     keywords["foreach"] = TokenType::KEYWORD_FOREACH;
@@ -29,6 +31,7 @@ Tokenizer::Tokenizer(std::string source) : source_code(std::move(source)) {
     keywords["case"] = TokenType::KEYWORD_CASE;
     keywords["default"] = TokenType::KEYWORD_DEFAULT;
     keywords["struct"] = TokenType::KEYWORD_STRUCT;
+    scan_limit = source_code.length();
 }
 
 char Tokenizer::peek() {
@@ -58,7 +61,7 @@ char Tokenizer::advance() {
 }
 
 bool Tokenizer::isAtEnd() {
-    return current_pos >= source_code.length();
+    return current_pos >= scan_limit;
 }
 
 void Tokenizer::skipWhitespaceAndComments() {
@@ -95,7 +98,93 @@ Token Tokenizer::makeToken(TokenType type, const std::string& lexeme) const {
      return Token(type, lexeme, current_line);
 }
 
+size_t Tokenizer::findClosingQuote(size_t from, bool& has_interpolation) const {
+    const size_t length = source_code.length();
+    bool seen_open = false;
+    size_t i = from;
+    while (i < length) {
+        char c = source_code[i];
+        if (c == '\\' && i + 1 < length && (source_code[i + 1] == '"' || source_code[i + 1] == '\\')) {
+            i += 2;
+            continue;
+        }
+        if (c == '"') {
+            return i;
+        }
+        if (c == '#' && i + 1 < length && source_code[i + 1] == '{') {
+            seen_open = true;
+            i += 2;
+            continue;
+        }
+        if (c == '}' && seen_open) {
+            has_interpolation = true;
+        }
+        i++;
+    }
+    return length;
+}
+
+Token Tokenizer::interpolationText() {
+    if (current_pos >= interpolation_end) {
+        advance();
+        interpolation_mode = InterpolationMode::NONE;
+        return makeToken(TokenType::STRING_INTERPOLATION_END, "\"");
+    }
+
+    if (source_code[current_pos] == '#' && current_pos + 1 < interpolation_end && source_code[current_pos + 1] == '{') {
+        current_pos += 2;
+        interpolation_mode = InterpolationMode::EXPRESSION;
+        interpolation_brace_depth = 0;
+        scan_limit = interpolation_end;
+        return makeToken(TokenType::INTERPOLATION_OPEN, "#{");
+    }
+
+    std::string value;
+    while (current_pos < interpolation_end) {
+        char c = source_code[current_pos];
+        char next = current_pos + 1 < interpolation_end ? source_code[current_pos + 1] : '\0';
+        if (c == '\\' && (next == '"' || next == '\\')) {
+            advance();
+            value += advance();
+        } else if (c == '#' && next == '{') {
+            break;
+        } else {
+            value += advance();
+        }
+    }
+    return makeToken(TokenType::STRING_SEGMENT, value);
+}
+
+Token Tokenizer::escapedStringLiteral() {
+    advance();
+    advance();
+    std::string value;
+    while (!isAtEnd() && !(peek() == '\\' && peekNext() == '"')) {
+        if (peek() == '\\' && peekNext() == '\\') {
+            advance();
+        }
+        value += advance();
+    }
+
+    if (isAtEnd()) {
+        diagnostics << "Tokenizer Error on line " << current_line << ": Unterminated string literal inside interpolation." << std::endl;
+        return makeToken(TokenType::UNKNOWN, value);
+    }
+
+    advance();
+    advance();
+    return makeToken(TokenType::STRING_LITERAL, value);
+}
+
 Token Tokenizer::stringLiteral() {
+    bool has_interpolation = false;
+    size_t closing_quote = findClosingQuote(current_pos, has_interpolation);
+    if (has_interpolation && closing_quote < source_code.length()) {
+        interpolation_mode = InterpolationMode::TEXT;
+        interpolation_end = closing_quote;
+        return makeToken(TokenType::STRING_INTERPOLATION_START, "\"");
+    }
+
     size_t start = current_pos + 1;
     std::string value;
     while (peek() != '"' && !isAtEnd()) {
@@ -112,7 +201,7 @@ Token Tokenizer::stringLiteral() {
     }
 
     if (isAtEnd()) {
-        std::cerr << "Tokenizer Error on line " << current_line << ": Unterminated string literal." << std::endl;
+        diagnostics << "Tokenizer Error on line " << current_line << ": Unterminated string literal." << std::endl;
         return makeToken(TokenType::UNKNOWN, source_code.substr(start -1, current_pos - (start -1) ));
     }
 
@@ -136,7 +225,29 @@ Token Tokenizer::numberLiteral() {
 }
 
 Token Tokenizer::scanToken() {
+    if (interpolation_mode == InterpolationMode::TEXT) {
+        return interpolationText();
+    }
+
     skipWhitespaceAndComments();
+
+    if (interpolation_mode == InterpolationMode::EXPRESSION) {
+        if (isAtEnd()) {
+            scan_limit = source_code.length();
+            interpolation_mode = InterpolationMode::TEXT;
+            return interpolationText();
+        }
+        if (peek() == '}' && interpolation_brace_depth == 0) {
+            advance();
+            scan_limit = source_code.length();
+            interpolation_mode = InterpolationMode::TEXT;
+            return makeToken(TokenType::INTERPOLATION_CLOSE, "}");
+        }
+        if (peek() == '\\' && peekNext() == '"') {
+            return escapedStringLiteral();
+        }
+    }
+
     if (isAtEnd()) return makeToken(TokenType::END_OF_FILE);
 
     char c_peeked = peek();
@@ -173,8 +284,16 @@ Token Tokenizer::scanToken() {
     switch (c_advanced) {
         case '(': return makeToken(TokenType::LEFT_PAREN, "(");
         case ')': return makeToken(TokenType::RIGHT_PAREN, ")");
-        case '{': return makeToken(TokenType::LEFT_BRACE, "{");
-        case '}': return makeToken(TokenType::RIGHT_BRACE, "}");
+        case '{':
+            if (interpolation_mode == InterpolationMode::EXPRESSION) {
+                interpolation_brace_depth++;
+            }
+            return makeToken(TokenType::LEFT_BRACE, "{");
+        case '}':
+            if (interpolation_mode == InterpolationMode::EXPRESSION) {
+                interpolation_brace_depth--;
+            }
+            return makeToken(TokenType::RIGHT_BRACE, "}");
         case ';': return makeToken(TokenType::SEMICOLON, ";");
         case ':': return makeToken(TokenType::COLON, ":");
         case '.': return makeToken(TokenType::DOT, ".");
@@ -222,9 +341,9 @@ Token Tokenizer::scanToken() {
 
 std::vector<Token> Tokenizer::tokenize() {
     std::vector<Token> tokens;
-    while (!isAtEnd()) {
-        Token token = scanToken();
-        tokens.push_back(token);
+    while (!isAtEnd() || interpolation_mode != InterpolationMode::NONE) {
+        tokens.push_back(scanToken());
+        const Token& token = tokens.back();
         if (token.type == TokenType::END_OF_FILE) break;
         if (token.type == TokenType::UNKNOWN && token.lexeme.empty() && isAtEnd()){
              if (tokens.size() > 1 && tokens[tokens.size()-2].type == TokenType::END_OF_FILE) {
@@ -2,21 +2,31 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <iostream>
 #include "./Token.h"
 
 namespace Nyx {
 
 class Tokenizer {
 public:
-    Tokenizer(std::string source);
+    Tokenizer(std::string source, std::ostream& diagnostics = std::cerr);
     std::vector<Token> tokenize();
 
 private:
     std::string source_code;
+    std::ostream& diagnostics;
     size_t current_pos = 0;
     int current_line = 1;
     std::map<std::string, TokenType> keywords;
 
+    // Interpolated strings are lexed in place: TEXT emits segments, EXPRESSION
+    // scans ordinary tokens bounded by the string's closing quote.
+    enum class InterpolationMode { NONE, TEXT, EXPRESSION };
+    InterpolationMode interpolation_mode = InterpolationMode::NONE;
+    size_t interpolation_end = 0;
+    int interpolation_brace_depth = 0;
+    size_t scan_limit = 0;
+
     char peek();
     char peekNext();
     char advance();
@@ -29,6 +39,9 @@ private:
     Token makeToken(TokenType type, const std::string& lexeme) const;
 
     Token stringLiteral();
+    size_t findClosingQuote(size_t from, bool& has_interpolation) const;
+    Token interpolationText();
+    Token escapedStringLiteral();
     Token numberLiteral();
 };
 
@@ -18,3 +18,38 @@ target("nyx")
     )
 
     add_packages("sdl2", "sdl2_ttf")
+
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+    if is_plat("windows") then
+        add_syslinks("psapi")
+    end
+
+-- Parse-time and allocation benchmark: xmake build parse_bench
+target("parse_bench")
+    set_kind("binary")
+    set_default(false)
+    set_languages("cxx17")
+
+    add_includedirs("src")
+
+    add_files(
+        "bench/parse_bench.cpp",
+        "src/*.cpp",
+        "src/common/*.cpp",
+        "src/tokenizer/*.cpp",
+        "src/parser/*.cpp",
+        "src/interpreter/*.cpp",
+        "src/stdlib/*.cpp"
+    )
+    remove_files("src/main.cpp")
+
+    add_packages("sdl2", "sdl2_ttf")
+
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+    if is_plat("windows") then
+        add_syslinks("psapi")
+    end